@@ -152,6 +152,49 @@ enum bt_att_chan_opt {
 	BT_ATT_CHAN_OPT_ENHANCED_ONLY = BIT(1),
 };
 
+/** @brief ATT TX traffic classes. */
+enum bt_att_tx_class {
+	/** Requests and indications, which wait for a response */
+	BT_ATT_TX_CLASS_REQ,
+	/** Notifications and commands */
+	BT_ATT_TX_CLASS_NTF,
+
+	/** Number of traffic classes, must be at the end of the enum */
+	BT_ATT_TX_CLASS_NUM,
+};
+
+#if defined(CONFIG_BT_ATT_TX_STATS)
+/** @brief ATT TX queue statistics of a traffic class. */
+struct bt_att_tx_stats {
+	/** Number of PDUs waiting to be sent */
+	uint16_t queued;
+	/** Highest number of PDUs that waited at the same time */
+	uint16_t queued_max;
+	/** Number of PDUs handed over to L2CAP */
+	uint32_t sent;
+	/** Average time the sent PDUs waited, in milliseconds */
+	uint32_t latency_avg_ms;
+	/** Longest time a sent PDU waited, in milliseconds */
+	uint32_t latency_max_ms;
+};
+
+/** @brief Get the ATT TX queue statistics of a connection.
+ *
+ * The latency of a PDU is the time from it being queued by GATT to it
+ * being handed over to L2CAP on one of the ATT bearers of the connection.
+ *
+ * @param conn The connection to get the statistics for.
+ * @param tx_class The traffic class to get the statistics for.
+ * @param stats Statistics of the traffic class.
+ *
+ * @retval 0 in case of success.
+ * @retval -EINVAL if @p tx_class is not valid.
+ * @retval -ENOTCONN if ATT is not connected on @p conn.
+ */
+int bt_att_tx_stats_get(struct bt_conn *conn, enum bt_att_tx_class tx_class,
+			struct bt_att_tx_stats *stats);
+#endif /* CONFIG_BT_ATT_TX_STATS */
+
 #ifdef __cplusplus
 }
 #endif
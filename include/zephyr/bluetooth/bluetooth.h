@@ -1931,7 +1931,14 @@ enum {
 	/** Convenience value when no options are specified. */
 	BT_LE_SCAN_OPT_NONE = 0,
 
-	/** Filter duplicates. */
+	/**
+	 * @brief Filter duplicates.
+	 *
+	 * With @kconfig{CONFIG_BT_SCAN_DEDUP} the host also drops reports with
+	 * the same advertiser, Advertising Set Identifier, properties and data
+	 * as a report delivered less than
+	 * @kconfig{CONFIG_BT_SCAN_DEDUP_TIMEOUT} milliseconds before.
+	 */
 	BT_LE_SCAN_OPT_FILTER_DUPLICATE = BIT(0),
 
 	/** Filter using filter accept list. */
@@ -2204,6 +2211,60 @@ void bt_le_scan_cb_register(struct bt_le_scan_cb *cb);
  */
 void bt_le_scan_cb_unregister(struct bt_le_scan_cb *cb);
 
+enum {
+	/** Convenience value when no filter options are specified. */
+	BT_LE_SCAN_FILTER_NONE = 0,
+
+	/** Filter on the minimum signal strength. */
+	BT_LE_SCAN_FILTER_RSSI = BIT(0),
+
+	/** Filter on the Company Identifier of the Manufacturer Specific Data. */
+	BT_LE_SCAN_FILTER_COMPANY_ID = BIT(1),
+
+	/** Filter on a service UUID, listed or with Service Data. */
+	BT_LE_SCAN_FILTER_UUID = BIT(2),
+};
+
+/** LE scan report filter */
+struct bt_le_scan_filter {
+	/** Bit-field of BT_LE_SCAN_FILTER_* options. */
+	uint8_t options;
+
+	/** Minimum signal strength, in dBm. */
+	int8_t rssi;
+
+	/** Company Identifier the Manufacturer Specific Data must start with. */
+	uint16_t company_id;
+
+	/**
+	 * @brief Service UUID.
+	 *
+	 * Matches the Service UUID lists and the Service Data of the same
+	 * UUID size.
+	 */
+	const struct bt_uuid *uuid;
+};
+
+/**
+ * @brief Set the advertising report filter.
+ *
+ * Advertising reports that do not match all the options of the filter are
+ * dropped by the host, they are neither given to the callback of
+ * @ref bt_le_scan_start nor to the callbacks registered with
+ * @ref bt_le_scan_cb_register. Each report is matched on its own, so
+ * advertising data and scan response data are matched separately.
+ *
+ * The filter is compiled once when set, matching it only walks the
+ * advertising data once and does not allocate.
+ *
+ * @param filter Filter to apply, or NULL to deliver all reports.
+ *
+ * @return Zero on success or (negative) error code otherwise.
+ * @return -EINVAL if the filter is invalid.
+ * @return -EBUSY if scanning is ongoing.
+ */
+int bt_le_scan_filter_set(const struct bt_le_scan_filter *filter);
+
 /**
  * @brief Add device (LE) to filter accept list.
  *
@@ -1064,6 +1064,14 @@ int bt_gatt_notify_cb(struct bt_conn *conn,
  *  The GATT Server will send a single ATT_MULTIPLE_HANDLE_VALUE_NTF PDU
  *  containing all the notifications passed to this API.
  *
+ *  If @p conn is NULL, each connected peer is sent the values it is
+ *  subscribed to, packed in as few ATT_MULTIPLE_HANDLE_VALUE_NTF PDUs as its
+ *  ATT MTU allows. Peers that don't support that PDU get an
+ *  ATT_HANDLE_VALUE_NTF per value instead. A failure to notify one peer does
+ *  not keep the other peers from being notified, so the values may only
+ *  have reached some of the peers. An error is then only returned if no
+ *  peer could be notified.
+ *
  *  All `params` must have the same `func` and `user_data` (due to
  *  implementation limitation). But `func(user_data)` will be invoked for each
  *  parameter.
@@ -1073,7 +1081,7 @@ int bt_gatt_notify_cb(struct bt_conn *conn,
  *
  *  The peer's GATT Client must write to this device's Client Supported Features
  *  attribute and set the bit for Multiple Handle Value Notifications before
- *  this API can be used.
+ *  this API can be used with its connection.
  *
  *  Only use this API to force the use of the ATT_MULTIPLE_HANDLE_VALUE_NTF PDU.
  *  For standard applications, `bt_gatt_notify_cb` is preferred, as it will use
@@ -1084,9 +1092,7 @@ int bt_gatt_notify_cb(struct bt_conn *conn,
  *  references and not UUIDs like `bt_gatt_notify` and `bt_gatt_notify_cb`.
  *
  *  @param conn
- *    Target client.
- *    Notifying all connected clients by passing `NULL` is not yet supported,
- *    please use `bt_gatt_notify` instead.
+ *    Target client, or `NULL` to notify all connected clients.
  *  @param num_params
  *    Element count of `params` array. Has to be greater than 1.
  *  @param params
@@ -1109,6 +1115,12 @@ int bt_gatt_notify_cb(struct bt_conn *conn,
  *    attributes.
  *  @retval -EOPNOTSUPP
  *    The peer hasn't yet communicated that it supports this PDU type.
+ *  @retval -ENOTCONN
+ *    `conn` is `NULL` and no connected client is subscribed to any of the
+ *    characteristics.
+ *
+ *  If `conn` is `NULL`, 0 is returned if at least one peer was notified,
+ *  otherwise the error of the last peer that could not be notified.
  */
 int bt_gatt_notify_multiple(struct bt_conn *conn,
 			    uint16_t num_params,
@@ -47,6 +47,12 @@ struct bt_mesh_statistic {
 	uint32_t tx_friend_planned;
 	/** Counter of frames that succeeded to send over friend bearer. */
 	uint32_t tx_friend_succeeded;
+	/** Received frames dropped since no network key has a matching NID. */
+	uint32_t rx_nid_unknown;
+	/** Header deobfuscations done while looking for a matching network key. */
+	uint32_t rx_deobfuscate_attempts;
+	/** Decryptions done while looking for a matching network key. */
+	uint32_t rx_decrypt_attempts;
 };
 
 /** @brief Get mesh frame handling statistic.
@@ -249,6 +249,42 @@ struct gptp_clk_src_time_invoke_params {
 	uint16_t time_base_indicator;
 };
 
+/** Number of buckets in the servo offset and jitter histograms. */
+#define GPTP_SERVO_HIST_BUCKETS 20
+
+/**
+ * @brief Clock servo statistics.
+ *
+ * Bucket n of the histograms counts the samples whose absolute value
+ * in nanoseconds is in the range [2^n - 1, 2^(n+1) - 1), the last bucket
+ * counts all the larger values.
+ */
+struct gptp_servo_stats {
+	/** Histogram of the offset from the master clock. */
+	uint32_t offset_hist[GPTP_SERVO_HIST_BUCKETS];
+
+	/** Histogram of the offset change between consecutive samples. */
+	uint32_t jitter_hist[GPTP_SERVO_HIST_BUCKETS];
+
+	/** Last offset from the master clock in nanoseconds. */
+	int64_t offset;
+
+	/** Filtered offset jitter in nanoseconds. */
+	uint32_t jitter;
+
+	/** Current frequency adjustment in parts per billion. */
+	int32_t freq_adj;
+
+	/** Number of samples processed by the servo. */
+	uint32_t samples;
+
+	/** Number of samples rejected as outliers. */
+	uint32_t outliers;
+
+	/** Number of times the clock was stepped instead of slewed. */
+	uint32_t steps;
+};
+
 /**
  * @brief Register a phase discontinuity callback.
  *
@@ -281,6 +317,16 @@ void gptp_call_phase_dis_cb(void);
  */
 int gptp_event_capture(struct net_ptp_time *slave_time, bool *gm_present);
 
+/**
+ * @brief Get the statistics of the local clock servo.
+ *
+ * @param stats Where the statistics are copied to.
+ *
+ * @return 0 if ok, -ENOTSUP if the PI servo is not enabled with
+ *         CONFIG_NET_GPTP_SERVO_PI.
+ */
+int gptp_get_servo_stats(struct gptp_servo_stats *stats);
+
 /**
  * @brief Utility function to print clock id to a user supplied buffer.
  *
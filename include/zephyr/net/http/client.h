@@ -22,6 +22,7 @@
 
 #include <zephyr/kernel.h>
 #include <zephyr/net/net_ip.h>
+#include <zephyr/net/tls_credentials.h>
 #include <zephyr/net/http/parser.h>
 
 #ifdef __cplusplus
@@ -93,6 +94,26 @@ typedef void (*http_response_cb_t)(struct http_response *rsp,
 				   enum http_final_call final_data,
 				   void *user_data);
 
+/**
+ * @typedef http_body_cb_t
+ * @brief Callback used to stream the response body to a sink.
+ *
+ * Called for every body fragment as soon as it has been parsed. The data
+ * points directly into the receive buffer and any chunked transfer coding
+ * has already been removed, so the fragment can be written to its final
+ * destination (flash stream, file, ...) without an intermediate copy.
+ *
+ * @param rsp HTTP response information
+ * @param data Body fragment
+ * @param len Length of the body fragment
+ * @param user_data User specified data specified in http_client_req()
+ *
+ * @return 0 to continue receiving the response, <0 to abort it
+ */
+typedef int (*http_body_cb_t)(struct http_response *rsp,
+			      const uint8_t *data, size_t len,
+			      void *user_data);
+
 /**
  * HTTP response from the server.
  */
@@ -193,6 +214,11 @@ struct http_response {
 
 	uint8_t cl_present : 1;
 	uint8_t body_found : 1;
+
+	/** Set when the whole response is parsed. Not set when the callback
+	 * is called with HTTP_DATA_FINAL for a response that could not be
+	 * parsed.
+	 */
 	uint8_t message_complete : 1;
 };
 
@@ -215,6 +241,15 @@ struct http_client_internal_data {
 
 	/** HTTP socket */
 	int sock;
+
+	/** Amount of response data received for the request */
+	size_t received;
+
+	/** A connection closed by the server before any response data was
+	 * received is reported as -ECONNRESET instead of as a null response.
+	 * Set by the connection pool so that the request can be retried.
+	 */
+	uint8_t no_null_response : 1;
 };
 
 /**
@@ -304,6 +339,11 @@ struct http_request {
 	 * headers will be placed into this field.
 	 */
 	const char **optional_headers;
+
+	/** User supplied callback function to call for every received body
+	 * fragment, may be NULL. See @ref http_body_cb_t.
+	 */
+	http_body_cb_t body_cb;
 };
 
 /**
@@ -319,11 +359,74 @@ struct http_request {
  *        The timeout value is in milliseconds.
  * @param user_data User specified data that is passed to the callback.
  *
- * @return <0 if error, >=0 amount of data sent to the server
+ * @return <0 if error, >=0 amount of data sent to the server. -EBADMSG if
+ *         the response cannot be parsed, the data received until then is
+ *         given to the callback as the final data.
  */
 int http_client_req(int sock, struct http_request *req,
 		    int32_t timeout, void *user_data);
 
+/**
+ * Server address and connection parameters of a pooled connection.
+ */
+struct http_client_pool_host {
+	/** Server address */
+	struct sockaddr addr;
+
+	/** Length of the server address */
+	socklen_t addrlen;
+
+	/** Socket protocol, IPPROTO_TCP or one of the IPPROTO_TLS_* values */
+	int proto;
+
+	/** TLS credentials used when connecting with TLS, may be NULL */
+	const sec_tag_t *sec_tag_list;
+
+	/** Number of entries in sec_tag_list */
+	size_t sec_tag_count;
+
+	/** Hostname used for TLS server name verification, may be NULL */
+	const char *tls_hostname;
+};
+
+/**
+ * @brief Do a HTTP request over a pooled connection.
+ *
+ * Works like http_client_req() but the connection to the server is taken
+ * from a connection pool. A persistent connection to the same host is
+ * reused if one is idle, otherwise a new connection is established. After
+ * the response has been received the connection is returned to the pool if
+ * the server allows it to be kept alive, and closed otherwise. Requests to
+ * the same host are thus sent one after another over the same connection
+ * without a new TCP or TLS handshake.
+ *
+ * If a reused connection turns out to have been closed by the server before
+ * any part of the response was received, an idempotent request (GET, HEAD,
+ * OPTIONS, TRACE, PUT or DELETE) without payload or header callbacks is sent
+ * again over a new connection. The response callbacks are not called for the
+ * failed attempt. Other requests are not retried.
+ *
+ * @param host Server to connect to. The structure is compared against the
+ *        parameters of the idle connections, it must stay valid as long as
+ *        the connection is in the pool.
+ * @param req HTTP request information
+ * @param timeout Max timeout to wait for the data, in milliseconds.
+ * @param user_data User specified data that is passed to the callbacks.
+ *
+ * @return <0 if error, >=0 amount of data sent to the server.
+ *         -EBUSY if all the pooled connections are in use.
+ */
+int http_client_pool_req(const struct http_client_pool_host *host,
+			 struct http_request *req, int32_t timeout,
+			 void *user_data);
+
+/**
+ * @brief Close all the idle pooled connections.
+ *
+ * Connections that are in use by an ongoing request are not affected.
+ */
+void http_client_pool_close_all(void);
+
 #ifdef __cplusplus
 }
 #endif
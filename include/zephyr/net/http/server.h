@@ -0,0 +1,161 @@
+/** @file
+ * @brief HTTP server API
+ */
+
+/*
+ * Copyright The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef ZEPHYR_INCLUDE_NET_HTTP_SERVER_H_
+#define ZEPHYR_INCLUDE_NET_HTTP_SERVER_H_
+
+/**
+ * @brief HTTP server API
+ * @defgroup http_server HTTP server API
+ * @ingroup networking
+ * @{
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include <zephyr/sys/util.h>
+#include <zephyr/net/http/method.h>
+#include <zephyr/net/http/service.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Helper for building the supported methods bitmask of a resource. Only
+ * methods with a value below 32 can be allowed, requests with any other
+ * method are answered with "405 Method Not Allowed".
+ */
+#define HTTP_METHOD_BIT(_method) BIT(_method)
+
+/** Type of an HTTP resource, selects how the resource detail is interpreted. */
+enum http_resource_type {
+	/** Constant data that is sent as is, see @ref http_resource_detail_static */
+	HTTP_RESOURCE_TYPE_STATIC,
+	/** Data generated per request, see @ref http_resource_detail_dynamic */
+	HTTP_RESOURCE_TYPE_DYNAMIC,
+};
+
+/**
+ * @brief Common part of the resource detail.
+ *
+ * The @p detail pointer given to @ref HTTP_RESOURCE_DEFINE must point to
+ * one of the typed resource details below, all of which start with this
+ * structure.
+ */
+struct http_resource_detail {
+	/** Bitmask of allowed methods, see @ref HTTP_METHOD_BIT */
+	uint32_t bitmask_of_supported_http_methods;
+
+	/** Resource type */
+	enum http_resource_type type;
+
+	/** Value of the Content-Type header, or NULL to omit it */
+	const char *content_type;
+
+	/** Value of the Content-Encoding header, or NULL to omit it */
+	const char *content_encoding;
+};
+
+/**
+ * @brief Static resource detail.
+ *
+ * The data is sent directly from where it is stored (typically flash or
+ * rodata), it is never copied into an intermediate server buffer.
+ */
+struct http_resource_detail_static {
+	/** Common resource detail */
+	struct http_resource_detail common;
+
+	/** Resource data */
+	const void *static_data;
+
+	/** Length of the resource data */
+	size_t static_data_len;
+};
+
+/** Request information passed to a dynamic resource handler. */
+struct http_server_request {
+	/** Request method */
+	enum http_method method;
+
+	/** Request target, not NUL terminated */
+	const char *url;
+
+	/** Length of the request target */
+	size_t url_len;
+
+	/** Request body */
+	const uint8_t *body;
+
+	/** Length of the request body */
+	size_t body_len;
+};
+
+/**
+ * @typedef http_resource_dynamic_cb_t
+ * @brief Callback used to generate the response of a dynamic resource.
+ *
+ * The callback is called from the server thread once the complete request
+ * has been received.
+ *
+ * @param req Received request.
+ * @param rsp_buf Buffer where the response body is written.
+ * @param rsp_buf_len Size of the response buffer.
+ * @param user_data User data given in the resource detail.
+ *
+ * @return Length of the response body, or <0 on error in which case
+ *         "500 Internal Server Error" is sent to the client.
+ */
+typedef int (*http_resource_dynamic_cb_t)(const struct http_server_request *req,
+					  uint8_t *rsp_buf, size_t rsp_buf_len, void *user_data);
+
+/** Dynamic resource detail. */
+struct http_resource_detail_dynamic {
+	/** Common resource detail */
+	struct http_resource_detail common;
+
+	/** Response generator */
+	http_resource_dynamic_cb_t cb;
+
+	/** User data passed to the callback */
+	void *user_data;
+};
+
+/**
+ * @brief Start the HTTP server.
+ *
+ * Opens a listening socket for every service defined with
+ * @ref HTTP_SERVICE_DEFINE or @ref HTTP_SERVICE_DEFINE_EMPTY and starts the
+ * server thread. A single thread serves all the services and clients.
+ *
+ * @return 0 if ok, <0 if error
+ */
+int http_server_start(void);
+
+/**
+ * @brief Stop the HTTP server.
+ *
+ * All the client connections and listening sockets are closed.
+ *
+ * @return 0 if ok, <0 if error
+ */
+int http_server_stop(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+/**
+ * @}
+ */
+
+#endif /* ZEPHYR_INCLUDE_NET_HTTP_SERVER_H_ */
@@ -90,6 +90,77 @@ void sntp_close(struct sntp_ctx *ctx);
 int sntp_simple(const char *server, uint32_t timeout,
 		struct sntp_time *time);
 
+/** Clock synchronization status, see sntp_sync_poll() */
+struct sntp_sync_status {
+	/** Offset of the local clock from the selected servers, in
+	 *  microseconds. Positive if the local clock was behind.
+	 */
+	int64_t offset_us;
+
+	/** Estimated jitter of the offset, in microseconds. */
+	uint32_t jitter_us;
+
+	/** Interval until the next poll, in seconds. */
+	uint32_t poll_interval;
+
+	/** Number of servers that responded. */
+	uint8_t responding;
+
+	/** Number of servers that agreed with the majority and were used. */
+	uint8_t selected;
+
+	/** The clock was stepped instead of slewed. */
+	bool stepped;
+};
+
+/**
+ * @brief Set the servers used for clock synchronization
+ *
+ * Any previously configured servers are released.
+ *
+ * @param servers Array of server addresses.
+ * @param count Number of servers, at most CONFIG_SNTP_SYNC_MAX_SERVERS.
+ *
+ * @return 0 if ok, <0 if error.
+ */
+int sntp_sync_init(const struct sockaddr *servers, size_t count);
+
+/**
+ * @brief Synchronize CLOCK_REALTIME once
+ *
+ * Queries all the servers, selects the ones that agree on the time and
+ * slews the clock towards it. The clock is stepped only if the offset is
+ * larger than CONFIG_SNTP_SYNC_STEP_THRESHOLD_MS.
+ *
+ * @param timeout Time to wait for each query of the burst (in milliseconds).
+ * @param status Synchronization status (output), may be NULL.
+ *
+ * @return 0 if ok, -ETIMEDOUT if no server responded, -EAGAIN if the
+ *         servers do not agree on the time, <0 on other errors.
+ */
+int sntp_sync_poll(uint32_t timeout, struct sntp_sync_status *status);
+
+/**
+ * @brief Get the status of the last synchronization
+ *
+ * @param status Synchronization status (output).
+ */
+void sntp_sync_get_status(struct sntp_sync_status *status);
+
+/**
+ * @brief Start synchronizing the clock in the background
+ *
+ * A thread calls sntp_sync_poll() repeatedly at the adaptive poll interval.
+ *
+ * @return 0 if ok, <0 if error.
+ */
+int sntp_sync_start(void);
+
+/**
+ * @brief Stop the background synchronization and release the servers
+ */
+void sntp_sync_stop(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -36,8 +36,18 @@ extern "C" {
  */
 #define TFTP_HEADER_SIZE         4
 
+/**
+ * RFC2348: Largest block size the client negotiates with the server. Larger
+ * blocks need fewer round trips to transfer a file.
+ */
+#if defined(CONFIG_TFTPC_MAX_BLOCK_SIZE)
+#define TFTPC_MAX_BLOCK_SIZE     CONFIG_TFTPC_MAX_BLOCK_SIZE
+#else
+#define TFTPC_MAX_BLOCK_SIZE     TFTP_BLOCK_SIZE
+#endif
+
 /** Maximum amount of data that can be sent or received */
-#define TFTPC_MAX_BUF_SIZE       (TFTP_BLOCK_SIZE + TFTP_HEADER_SIZE)
+#define TFTPC_MAX_BUF_SIZE       (TFTPC_MAX_BLOCK_SIZE + TFTP_HEADER_SIZE)
 
 /**
  * @name TFTP client error codes.
@@ -49,6 +59,7 @@ extern "C" {
 #define TFTPC_UNKNOWN_FAILURE    -3 /**< Unknown failure. */
 #define TFTPC_REMOTE_ERROR       -4 /**< Remote server error. */
 #define TFTPC_RETRIES_EXHAUSTED  -5 /**< Retries exhausted. */
+#define TFTPC_SINK_FAILURE       -6 /**< Data sink failed. */
 /**
  * @}
  */
@@ -116,6 +127,21 @@ struct tftp_evt {
  */
 typedef void (*tftp_callback_t)(const struct tftp_evt *evt);
 
+/**
+ * @typedef tftp_sink_t
+ *
+ * @brief Data sink receiving the file content of a GET request, in order.
+ *
+ * @param[in] user_data User data registered along with the sink.
+ * @param[in] data Received data.
+ * @param[in] len Length of the received data, may be 0 for the last call.
+ * @param[in] last True for the last data of the file.
+ *
+ * @return 0 on success, a negative error code to abort the transfer.
+ */
+typedef int (*tftp_sink_t)(void *user_data, const uint8_t *data, size_t len,
+			   bool last);
+
 /**
  * @brief TFTP client definition to maintain information relevant to the
  *        client.
@@ -130,6 +156,19 @@ struct tftpc {
 	/** Event notification callback. No notification if NULL */
 	tftp_callback_t callback;
 
+	/** Optional data sink. If set, the received data is passed to it
+	 *  instead of being notified as TFTP_EVT_DATA events.
+	 */
+	tftp_sink_t sink;
+
+	/** User data passed to the data sink */
+	void *sink_user_data;
+
+	/** Transfer size announced by the server (RFC2349), 0 if unknown.
+	 *  Set by tftp_get() before the first data is delivered.
+	 */
+	uint32_t tsize;
+
 	/** Buffer for internal usage */
 	uint8_t tftp_buf[TFTPC_MAX_BUF_SIZE];
 };
@@ -137,6 +176,10 @@ struct tftpc {
 /**
  * @brief This function gets data from a "file" on the remote server.
  *
+ * The client asks the server for the block size, window size (RFC7440) and
+ * transfer size options. If the server does not support them, the transfer
+ * falls back to 512 bytes blocks, each one acknowledged separately.
+ *
  * @param client      Client information of type @ref tftpc.
  * @param remote_file Name of the remote file to get.
  * @param mode        TFTP Client "mode" setting.
@@ -145,7 +188,9 @@ struct tftpc {
  * @retval TFTPC_BUFFER_OVERFLOW if the file is larger than the user buffer.
  * @retval TFTPC_REMOTE_ERROR if the server failed to process our request.
  * @retval TFTPC_RETRIES_EXHAUSTED if the client timed out waiting for server.
- * @retval -EINVAL if `client` is NULL.
+ * @retval TFTPC_SINK_FAILURE if the data sink failed.
+ * @retval -EINVAL if `client` is NULL or if `remote_file` and `mode` do not fit
+ *         into a request.
  *
  * @note This function blocks until the transfer is completed or network error happens. The
  *       integrity of the `client` structure must be ensured until the function returns.
@@ -165,7 +210,8 @@ int tftp_get(struct tftpc *client,
  * @retval The size of data being sent if the operation completed successfully.
  * @retval TFTPC_REMOTE_ERROR if the server failed to process our request.
  * @retval TFTPC_RETRIES_EXHAUSTED if the client timed out waiting for server.
- * @retval -EINVAL if `client` or `user_buf` is NULL or if `user_buf_size` is zero.
+ * @retval -EINVAL if `client` or `user_buf` is NULL, if `user_buf_size` is zero or
+ *         if `remote_file` and `mode` do not fit into a request.
  *
  * @note This function blocks until the transfer is completed or network error happens. The
  *       integrity of the `client` structure must be ensured until the function returns.
@@ -174,6 +220,25 @@ int tftp_put(struct tftpc *client,
 	     const char *remote_file, const char *mode,
 	     const uint8_t *user_buf, uint32_t user_buf_size);
 
+/**
+ * @brief Data sink writing the received data to flash.
+ *
+ * Can be registered as the @ref tftpc sink to write a file directly to
+ * flash, for example a firmware image. The data is buffered and written
+ * by the stream flash library, which is flushed on the last data.
+ *
+ * @note Requires CONFIG_STREAM_FLASH.
+ *
+ * @param user_data Stream flash context of type struct stream_flash_ctx.
+ * @param data Received data.
+ * @param len Length of the received data.
+ * @param last True for the last data of the file.
+ *
+ * @return 0 on success, a negative error code if writing to flash failed.
+ */
+int tftp_stream_flash_sink(void *user_data, const uint8_t *data, size_t len,
+			   bool last);
+
 #ifdef __cplusplus
 }
 #endif
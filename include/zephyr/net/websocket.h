@@ -145,7 +145,11 @@ int websocket_connect(int http_sock, struct websocket_request *req,
  * @param timeout How long to try to send the message. The value is in
  *        milliseconds. Value SYS_FOREVER_MS means to wait forever.
  *
- * @return <0 if error, >=0 amount of bytes sent
+ * @retval >=0 amount of bytes sent.
+ * @retval -ECONNABORTED if sending failed after part of a masked message was
+ *         sent. The Websocket can't be used anymore and must be closed.
+ * @retval -ENOTCONN if the Websocket was aborted by an earlier send.
+ * @retval -errno other negative errno value in case of failure.
  */
 int websocket_send_msg(int ws_sock, const uint8_t *payload, size_t payload_len,
 		       enum websocket_opcode opcode, bool mask, bool final,
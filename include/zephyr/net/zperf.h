@@ -29,11 +29,24 @@ enum zperf_status {
 	ZPERF_SESSION_ERROR
 } __packed;
 
+/** Number of buckets in the zperf latency and jitter histograms. */
+#define ZPERF_HIST_BUCKETS 16
+
 struct zperf_upload_params {
 	struct sockaddr peer_addr;
 	uint32_t duration_ms;
 	uint32_t rate_kbps;
 	uint16_t packet_size;
+	/** Number of parallel streams, each one using its own socket.
+	 *  0 is treated as 1. Limited by CONFIG_NET_ZPERF_MAX_STREAMS.
+	 */
+	uint8_t num_streams;
+	/** UDP only: ask the peer to send traffic back to us at the same
+	 *  time (iPerf dual test). A zperf peer only does so with
+	 *  CONFIG_NET_ZPERF_UDP_REVERSE, and sends to the address and port
+	 *  the upload comes from.
+	 */
+	bool bidirectional;
 	struct {
 		uint8_t tos;
 		int tcp_nodelay;
@@ -57,6 +70,22 @@ struct zperf_results {
 	uint32_t client_time_in_us;
 	uint32_t packet_size;
 	uint32_t nb_packets_errors;
+	/** Non-idle CPU cycles used during the test. For the total of an
+	 *  upload this is the whole system (including the network stack),
+	 *  for a single stream of a multi-stream upload it is the stream's
+	 *  own thread. 0 if CONFIG_THREAD_RUNTIME_STATS is not enabled.
+	 */
+	uint64_t cpu_cycles;
+	/** UDP receiver only: one-way latency histogram. Bucket 0 counts
+	 *  values below 1 us, bucket n values in [2^(n-1), 2^n) us and the
+	 *  last bucket everything above. The latency is only meaningful
+	 *  when both ends share the same clock, e.g. over loopback.
+	 */
+	uint32_t latency_hist[ZPERF_HIST_BUCKETS];
+	/** UDP receiver only: histogram of the transit time variation
+	 *  between consecutive packets, same buckets as @a latency_hist.
+	 */
+	uint32_t jitter_hist[ZPERF_HIST_BUCKETS];
 };
 
 /**
@@ -74,6 +103,9 @@ typedef void (*zperf_callback)(enum zperf_status status,
  * @brief Synchronous UDP upload operation. The function blocks until the upload
  *        is complete.
  *
+ * If @a param->num_streams is above 1, the streams are run in parallel and
+ * @a result holds their aggregated results.
+ *
  * @param param Upload parameters.
  * @param result Session results.
  *
@@ -86,6 +118,9 @@ int zperf_udp_upload(const struct zperf_upload_params *param,
  * @brief Synchronous TCP upload operation. The function blocks until the upload
  *        is complete.
  *
+ * If @a param->num_streams is above 1, the streams are run in parallel and
+ * @a result holds their aggregated results.
+ *
  * @param param Upload parameters.
  * @param result Session results.
  *
@@ -94,6 +129,40 @@ int zperf_udp_upload(const struct zperf_upload_params *param,
 int zperf_tcp_upload(const struct zperf_upload_params *param,
 		     struct zperf_results *result);
 
+/**
+ * @brief Synchronous multi-stream UDP upload operation. Runs
+ *        @a param->num_streams uploads in parallel, each one from its own
+ *        thread and socket, and blocks until all of them are complete.
+ *
+ * @param param Upload parameters.
+ * @param stream_results Array of @a param->num_streams entries receiving
+ *        the results of each stream, may be NULL.
+ * @param total Aggregated results of all the streams.
+ *
+ * @return 0 if all the streams completed successfully, a negative error
+ *         code otherwise.
+ */
+int zperf_udp_upload_streams(const struct zperf_upload_params *param,
+			     struct zperf_results *stream_results,
+			     struct zperf_results *total);
+
+/**
+ * @brief Synchronous multi-stream TCP upload operation. Runs
+ *        @a param->num_streams uploads in parallel, each one from its own
+ *        thread and socket, and blocks until all of them are complete.
+ *
+ * @param param Upload parameters.
+ * @param stream_results Array of @a param->num_streams entries receiving
+ *        the results of each stream, may be NULL.
+ * @param total Aggregated results of all the streams.
+ *
+ * @return 0 if all the streams completed successfully, a negative error
+ *         code otherwise.
+ */
+int zperf_tcp_upload_streams(const struct zperf_upload_params *param,
+			     struct zperf_results *stream_results,
+			     struct zperf_results *total);
+
 /**
  * @brief Asynchronous UDP upload operation.
  *
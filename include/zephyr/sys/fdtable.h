@@ -68,7 +68,9 @@ int z_alloc_fd(void *obj, const struct fd_op_vtable *vtable);
  * @brief Release reserved file descriptor.
  *
  * This function may be called once after z_reserve_fd(), and should
- * not be called in any other case.
+ * not be called in any other case. The object is detached from the
+ * descriptor right away, but the entry is only reused once all users
+ * holding it with z_lock_fd() have released it.
  *
  * @param fd File descriptor previously returned by z_reserve_fd()
  */
@@ -107,6 +109,37 @@ void *z_get_fd_obj(int fd, const struct fd_op_vtable *vtable, int err);
 void *z_get_fd_obj_and_vtable(int fd, const struct fd_op_vtable **vtable,
 			      struct k_mutex **lock);
 
+/**
+ * @brief Get underlying object and vtable pointers with the descriptor locked.
+ *
+ * This is the lookup to use around an operation on the object. The
+ * descriptor mutex is taken and the entry is referenced, so the entry
+ * can't be reused until z_unlock_fd() is called, even if the descriptor
+ * is closed in the meantime. A descriptor closed before the mutex could
+ * be taken is reported as invalid. No table-wide lock is involved.
+ *
+ * @param fd File descriptor previously returned by z_reserve_fd()
+ * @param obj A pointer to a pointer variable to store the object
+ * @param vtable A pointer to a pointer variable to store the vtable
+ * @param lock An optional pointer to a pointer variable to store the mutex
+ *        held by the caller. Pass NULL if not needed by the caller.
+ *
+ * @return 0 on success, -1 with errno set otherwise. On success,
+ *         z_unlock_fd() must be called once the object is no longer used.
+ */
+int z_lock_fd(int fd, void **obj, const struct fd_op_vtable **vtable,
+	      struct k_mutex **lock);
+
+/**
+ * @brief Release a descriptor locked with z_lock_fd().
+ *
+ * If the descriptor was closed while locked, its entry becomes available
+ * for reuse here.
+ *
+ * @param fd File descriptor previously locked with z_lock_fd()
+ */
+void z_unlock_fd(int fd);
+
 /**
  * @brief Get the mutex and condition variable associated with the given object and vtable.
  *
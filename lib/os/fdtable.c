@@ -75,6 +75,23 @@ static int z_fd_ref(int fd)
 	return atomic_inc(&fdtable[fd].refcount) + 1;
 }
 
+static bool z_fd_ref_if_used(int fd)
+{
+	atomic_val_t old_rc;
+
+	/* A free entry must not be revived, only take a reference if the
+	 * entry is still in use.
+	 */
+	do {
+		old_rc = atomic_get(&fdtable[fd].refcount);
+		if (!old_rc) {
+			return false;
+		}
+	} while (!atomic_cas(&fdtable[fd].refcount, old_rc, old_rc + 1));
+
+	return true;
+}
+
 static int z_fd_unref(int fd)
 {
 	atomic_val_t old_rc;
@@ -231,6 +248,61 @@ void *z_get_fd_obj_and_vtable(int fd, const struct fd_op_vtable **vtable,
 	return entry->obj;
 }
 
+int z_lock_fd(int fd, void **obj, const struct fd_op_vtable **vtable,
+	      struct k_mutex **lock)
+{
+	struct fd_entry *entry;
+
+	if (fd < 0 || fd >= ARRAY_SIZE(fdtable)) {
+		errno = EBADF;
+		return -1;
+	}
+
+	fd = k_array_index_sanitize(fd, ARRAY_SIZE(fdtable));
+
+	/* The reference keeps the entry, and so its lock, from being reused
+	 * while the caller is using it, a concurrent close only detaches
+	 * the object.
+	 */
+	if (!z_fd_ref_if_used(fd)) {
+		errno = EBADF;
+		return -1;
+	}
+
+	entry = &fdtable[fd];
+
+	(void)k_mutex_lock(&entry->lock, K_FOREVER);
+
+	/* The object is only detached or replaced with the lock held, so
+	 * it is stable from now on. Detached entries have no vtable, the
+	 * object pointer itself may legitimately be NULL (stdio).
+	 */
+	if (entry->vtable == NULL) {
+		k_mutex_unlock(&entry->lock);
+		(void)z_fd_unref(fd);
+		errno = EBADF;
+		return -1;
+	}
+
+	*obj = entry->obj;
+	*vtable = entry->vtable;
+
+	if (lock) {
+		*lock = &entry->lock;
+	}
+
+	return 0;
+}
+
+void z_unlock_fd(int fd)
+{
+	/* Assumes fd was already locked with z_lock_fd(). */
+	fd = k_array_index_sanitize(fd, ARRAY_SIZE(fdtable));
+
+	k_mutex_unlock(&fdtable[fd].lock);
+	(void)z_fd_unref(fd);
+}
+
 int z_reserve_fd(void)
 {
 	int fd;
@@ -281,6 +353,16 @@ void z_finalize_fd(int fd, void *obj, const struct fd_op_vtable *vtable)
 void z_free_fd(int fd)
 {
 	/* Assumes fd was already bounds-checked. */
+	if (!atomic_get(&fdtable[fd].refcount)) {
+		return;
+	}
+
+	/* Detach the object now, the entry itself is released once the
+	 * users that locked it are done with it.
+	 */
+	fdtable[fd].obj = NULL;
+	fdtable[fd].vtable = NULL;
+
 	(void)z_fd_unref(fd);
 }
 
@@ -300,17 +382,17 @@ int z_alloc_fd(void *obj, const struct fd_op_vtable *vtable)
 
 ssize_t read(int fd, void *buf, size_t sz)
 {
+	const struct fd_op_vtable *vtable;
 	ssize_t res;
+	void *obj;
 
-	if (_check_fd(fd) < 0) {
+	if (z_lock_fd(fd, &obj, &vtable, NULL) < 0) {
 		return -1;
 	}
 
-	(void)k_mutex_lock(&fdtable[fd].lock, K_FOREVER);
-
-	res = fdtable[fd].vtable->read(fdtable[fd].obj, buf, sz);
+	res = vtable->read(obj, buf, sz);
 
-	k_mutex_unlock(&fdtable[fd].lock);
+	z_unlock_fd(fd);
 
 	return res;
 }
@@ -318,17 +400,17 @@ FUNC_ALIAS(read, _read, ssize_t);
 
 ssize_t write(int fd, const void *buf, size_t sz)
 {
+	const struct fd_op_vtable *vtable;
 	ssize_t res;
+	void *obj;
 
-	if (_check_fd(fd) < 0) {
+	if (z_lock_fd(fd, &obj, &vtable, NULL) < 0) {
 		return -1;
 	}
 
-	(void)k_mutex_lock(&fdtable[fd].lock, K_FOREVER);
+	res = vtable->write(obj, buf, sz);
 
-	res = fdtable[fd].vtable->write(fdtable[fd].obj, buf, sz);
-
-	k_mutex_unlock(&fdtable[fd].lock);
+	z_unlock_fd(fd);
 
 	return res;
 }
@@ -336,20 +418,23 @@ FUNC_ALIAS(write, _write, ssize_t);
 
 int close(int fd)
 {
+	const struct fd_op_vtable *vtable;
 	int res;
+	void *obj;
 
-	if (_check_fd(fd) < 0) {
+	if (z_lock_fd(fd, &obj, &vtable, NULL) < 0) {
 		return -1;
 	}
 
-	(void)k_mutex_lock(&fdtable[fd].lock, K_FOREVER);
-
-	res = fdtable[fd].vtable->close(fdtable[fd].obj);
-
-	k_mutex_unlock(&fdtable[fd].lock);
+	res = vtable->close(obj);
 
+	/* Detach the object while still locked, so that the pending users
+	 * of the descriptor see it closed.
+	 */
 	z_free_fd(fd);
 
+	z_unlock_fd(fd);
+
 	return res;
 }
 FUNC_ALIAS(close, _close, int);
@@ -20,6 +20,45 @@
 static struct timespec rt_clock_base;
 static struct k_spinlock rt_clock_base_lock;
 
+/*
+ * Offset that `adjtime` is still to apply to `CLOCK_REALTIME`, and the
+ * uptime at which the slew started. The offset is applied gradually at
+ * RT_CLOCK_SLEW_RATE_PPM so that the clock never jumps and never runs
+ * backwards.
+ */
+static int64_t rt_clock_slew;
+static uint64_t rt_clock_slew_start;
+
+#define RT_CLOCK_SLEW_RATE_PPM 500
+
+/* Part of the slew already applied at the given uptime, called with
+ * rt_clock_base_lock held. The uptime must be read with the lock held too,
+ * so that it is never older than rt_clock_slew_start.
+ */
+static int64_t rt_clock_slewed(uint64_t uptime_ns)
+{
+	uint64_t max = (uptime_ns - rt_clock_slew_start) /
+		(USEC_PER_SEC / RT_CLOCK_SLEW_RATE_PPM);
+
+	if (rt_clock_slew >= 0) {
+		return MIN((uint64_t)rt_clock_slew, max);
+	}
+
+	return -(int64_t)MIN((uint64_t)-rt_clock_slew, max);
+}
+
+static void timespec_add_ns(struct timespec *ts, int64_t ns)
+{
+	ns += (int64_t)ts->tv_sec * NSEC_PER_SEC + ts->tv_nsec;
+
+	ts->tv_sec = ns / NSEC_PER_SEC;
+	ts->tv_nsec = ns % NSEC_PER_SEC;
+	if (ts->tv_nsec < 0) {
+		ts->tv_sec--;
+		ts->tv_nsec += NSEC_PER_SEC;
+	}
+}
+
 /**
  * @brief Get clock time specified by clock_id.
  *
@@ -29,16 +68,23 @@ int z_impl_clock_gettime(clockid_t clock_id, struct timespec *ts)
 {
 	struct timespec base;
 	k_spinlock_key_t key;
+	uint64_t ticks;
 
 	switch (clock_id) {
 	case CLOCK_MONOTONIC:
+		ticks = k_uptime_ticks();
 		base.tv_sec = 0;
 		base.tv_nsec = 0;
 		break;
 
 	case CLOCK_REALTIME:
 		key = k_spin_lock(&rt_clock_base_lock);
+		ticks = k_uptime_ticks();
 		base = rt_clock_base;
+		if (rt_clock_slew != 0) {
+			timespec_add_ns(&base,
+					rt_clock_slewed(k_ticks_to_ns_floor64(ticks)));
+		}
 		k_spin_unlock(&rt_clock_base_lock, key);
 		break;
 
@@ -47,7 +93,6 @@ int z_impl_clock_gettime(clockid_t clock_id, struct timespec *ts)
 		return -1;
 	}
 
-	uint64_t ticks = k_uptime_ticks();
 	uint64_t elapsed_secs = ticks / CONFIG_SYS_CLOCK_TICKS_PER_SEC;
 	uint64_t nremainder = ticks - elapsed_secs * CONFIG_SYS_CLOCK_TICKS_PER_SEC;
 
@@ -101,11 +146,54 @@ int clock_settime(clockid_t clock_id, const struct timespec *tp)
 
 	key = k_spin_lock(&rt_clock_base_lock);
 	rt_clock_base = base;
+	/* Setting the time cancels any ongoing adjustment */
+	rt_clock_slew = 0;
 	k_spin_unlock(&rt_clock_base_lock, key);
 
 	return 0;
 }
 
+/**
+ * @brief Gradually adjust the time of the `CLOCK_REALTIME` clock.
+ *
+ * The clock is sped up or slowed down until it has been corrected by
+ * @p delta, replacing any adjustment still in progress. The remaining
+ * part of the previous adjustment is returned in @p olddelta.
+ *
+ * This is the BSD adjtime() call.
+ */
+int adjtime(const struct timeval *delta, struct timeval *olddelta)
+{
+	uint64_t uptime_ns;
+	k_spinlock_key_t key;
+	int64_t remaining;
+	int64_t applied;
+
+	key = k_spin_lock(&rt_clock_base_lock);
+
+	uptime_ns = k_ticks_to_ns_floor64(k_uptime_ticks());
+	applied = rt_clock_slewed(uptime_ns);
+	remaining = rt_clock_slew - applied;
+
+	if (delta != NULL) {
+		/* Make the part applied so far permanent */
+		timespec_add_ns(&rt_clock_base, applied);
+
+		rt_clock_slew = (int64_t)delta->tv_sec * NSEC_PER_SEC +
+				(int64_t)delta->tv_usec * NSEC_PER_USEC;
+		rt_clock_slew_start = uptime_ns;
+	}
+
+	k_spin_unlock(&rt_clock_base_lock, key);
+
+	if (olddelta != NULL) {
+		olddelta->tv_sec = remaining / NSEC_PER_SEC;
+		olddelta->tv_usec = (remaining % NSEC_PER_SEC) / NSEC_PER_USEC;
+	}
+
+	return 0;
+}
+
 /**
  * @brief Suspend execution for a nanosecond interval, or
  * until some absolute time relative to the specified clock.
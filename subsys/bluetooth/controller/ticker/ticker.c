@@ -299,6 +299,13 @@ struct ticker_instance {
 	uint8_t  ticker_id_head;	/* Index of first ticker node (next to
 					 * expire)
 					 */
+	uint8_t  ticker_id_tail;	/* Index of last ticker node, or
+					 * TICKER_NULL if not known
+					 */
+	uint32_t ticks_to_expire_tail;	/* Ticks until expiration of the last
+					 * ticker node, valid if ticker_id_tail
+					 * is not TICKER_NULL
+					 */
 	uint8_t  job_guard;		/* Flag preventing ticker_worker from
 					 * running if ticker_job is active
 					 */
@@ -551,6 +558,7 @@ static uint8_t ticker_enqueue(struct ticker_instance *instance, uint8_t id)
 	struct ticker_node *ticker_current;
 	struct ticker_node *ticker_new;
 	uint32_t ticks_to_expire_current;
+	uint32_t ticks_to_expire_new;
 	struct ticker_node *node;
 	uint32_t ticks_to_expire;
 	uint8_t previous;
@@ -558,7 +566,8 @@ static uint8_t ticker_enqueue(struct ticker_instance *instance, uint8_t id)
 
 	node = &instance->nodes[0];
 	ticker_new = &node[id];
-	ticks_to_expire = ticker_new->ticks_to_expire;
+	ticks_to_expire_new = ticker_new->ticks_to_expire;
+	ticks_to_expire = ticks_to_expire_new;
 	current = instance->ticker_id_head;
 
 	/* Find insertion point for new ticker node and adjust ticks_to_expire
@@ -566,6 +575,17 @@ static uint8_t ticker_enqueue(struct ticker_instance *instance, uint8_t id)
 	 */
 	previous = TICKER_NULL;
 
+	/* A node expiring after the last node would pass all nodes in the
+	 * list, append it directly. Periodic nodes re-inserted on expiry
+	 * usually end up here.
+	 */
+	if ((instance->ticker_id_tail != TICKER_NULL) &&
+	    (ticks_to_expire > instance->ticks_to_expire_tail)) {
+		ticks_to_expire -= instance->ticks_to_expire_tail;
+		previous = instance->ticker_id_tail;
+		current = TICKER_NULL;
+	}
+
 	while ((current != TICKER_NULL) && (ticks_to_expire >=
 		(ticks_to_expire_current =
 		(ticker_current = &node[current])->ticks_to_expire))) {
@@ -598,6 +618,9 @@ static uint8_t ticker_enqueue(struct ticker_instance *instance, uint8_t id)
 
 	if (current != TICKER_NULL) {
 		node[current].ticks_to_expire -= ticks_to_expire;
+	} else {
+		instance->ticker_id_tail = id;
+		instance->ticks_to_expire_tail = ticks_to_expire_new;
 	}
 
 	return id;
@@ -625,6 +648,7 @@ static uint8_t ticker_enqueue(struct ticker_instance *instance, uint8_t id)
 	struct ticker_node *ticker_new;
 	uint32_t ticks_to_expire_current;
 	uint8_t ticker_id_slot_previous;
+	uint32_t ticks_to_expire_new;
 	uint32_t ticks_slot_previous;
 	struct ticker_node *node;
 	uint32_t ticks_to_expire;
@@ -634,7 +658,8 @@ static uint8_t ticker_enqueue(struct ticker_instance *instance, uint8_t id)
 
 	node = &instance->nodes[0];
 	ticker_new = &node[id];
-	ticks_to_expire = ticker_new->ticks_to_expire;
+	ticks_to_expire_new = ticker_new->ticks_to_expire;
+	ticks_to_expire = ticks_to_expire_new;
 
 	collide = ticker_id_slot_previous = TICKER_NULL;
 	current = instance->ticker_id_head;
@@ -685,6 +710,9 @@ static uint8_t ticker_enqueue(struct ticker_instance *instance, uint8_t id)
 
 		if (current != TICKER_NULL) {
 			node[current].ticks_to_expire -= ticks_to_expire;
+		} else {
+			instance->ticker_id_tail = id;
+			instance->ticks_to_expire_tail = ticks_to_expire_new;
 		}
 	} else {
 		/* Collision - no ticker node insertion, set id to that of
@@ -763,10 +791,17 @@ static uint32_t ticker_dequeue(struct ticker_instance *instance, uint8_t id)
 	node[previous].next = ticker_current->next;
 
 	/* If this is not the last ticker, increment the
-	 * next ticker by this ticker timeout
+	 * next ticker by this ticker timeout, else the previous ticker
+	 * becomes the last one
 	 */
 	if (ticker_current->next != TICKER_NULL) {
 		node[ticker_current->next].ticks_to_expire += timeout;
+	} else if (previous == current) {
+		instance->ticker_id_tail = TICKER_NULL;
+		instance->ticks_to_expire_tail = 0U;
+	} else {
+		instance->ticker_id_tail = previous;
+		instance->ticks_to_expire_tail = total;
 	}
 
 	return (total + timeout);
@@ -2027,12 +2062,14 @@ static inline void ticker_job_worker_bh(struct ticker_instance *instance,
 		ticks_to_expire = ticker->ticks_to_expire;
 		if (ticks_elapsed < ticks_to_expire) {
 			ticker->ticks_to_expire -= ticks_elapsed;
+			instance->ticks_to_expire_tail -= ticks_elapsed;
 			break;
 		}
 
 		/* decrement ticks_elapsed and collect expired ticks */
 		ticks_elapsed -= ticks_to_expire;
 		ticks_expired += ticks_to_expire;
+		instance->ticks_to_expire_tail -= ticks_to_expire;
 
 		state = (ticker->req - ticker->ack) & 0xff;
 
@@ -2074,6 +2111,10 @@ static inline void ticker_job_worker_bh(struct ticker_instance *instance,
 
 		/* remove the expired ticker from head */
 		instance->ticker_id_head = ticker->next;
+		if (instance->ticker_id_head == TICKER_NULL) {
+			instance->ticker_id_tail = TICKER_NULL;
+			instance->ticks_to_expire_tail = 0U;
+		}
 
 		/* Ticker will be restarted if periodic or to be re-scheduled */
 		if ((ticker->ticks_periodic != 0U) ||
@@ -2555,6 +2596,11 @@ static uint8_t ticker_job_reschedule_in_window(struct ticker_instance *instance,
 			nodes[ticker_id_prev].next = ticker_id_resched;
 		}
 
+		/* Delta times were adjusted in place, last node is not known
+		 * until the list is walked to its end again.
+		 */
+		instance->ticker_id_tail = TICKER_NULL;
+
 		/* Remove latency added in ticker_worker */
 		ticker_resched->lazy_current--;
 
@@ -3264,6 +3310,8 @@ uint8_t ticker_init(uint8_t instance_index, uint8_t count_node, void *node,
 	instance->trigger_set_cb = trigger_set_cb;
 
 	instance->ticker_id_head = TICKER_NULL;
+	instance->ticker_id_tail = TICKER_NULL;
+	instance->ticks_to_expire_tail = 0U;
 	instance->ticks_current = cntr_cnt_get();
 	instance->ticks_elapsed_first = 0U;
 	instance->ticks_elapsed_last = 0U;
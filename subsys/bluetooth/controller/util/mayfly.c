@@ -8,6 +8,7 @@
 #include <stddef.h>
 
 #include <soc.h>
+#include <zephyr/kernel.h>
 #include <zephyr/types.h>
 #include <zephyr/sys/printk.h>
 
@@ -28,6 +29,11 @@ static struct {
 static memq_link_t mfl[MAYFLY_CALLEE_COUNT][MAYFLY_CALLER_COUNT];
 static uint8_t mfp[MAYFLY_CALLEE_COUNT];
 
+#if defined(CONFIG_BT_MAYFLY_LATENCY)
+/* Latency of the mayflies called, written only in the callee context */
+static struct mayfly_latency mfl_latency[MAYFLY_CALLEE_COUNT];
+#endif /* CONFIG_BT_MAYFLY_LATENCY */
+
 #if defined(MAYFLY_UT)
 static uint8_t _state;
 #endif /* MAYFLY_UT */
@@ -91,6 +97,14 @@ uint32_t mayfly_enqueue(uint8_t caller_id, uint8_t callee_id, uint8_t chain,
 	if (state != 0U) {
 		if (chain) {
 			if (state != 1U) {
+#if defined(CONFIG_BT_MAYFLY_LATENCY)
+				/* stamp before marking ready so the callee
+				 * never reads a stale enqueue time
+				 */
+				m->_enqueued = k_cycle_get_32();
+				cpu_dmb();
+#endif /* CONFIG_BT_MAYFLY_LATENCY */
+
 				/* mark as ready in queue */
 				m->_req = ack + 1;
 
@@ -114,6 +128,9 @@ uint32_t mayfly_enqueue(uint8_t caller_id, uint8_t callee_id, uint8_t chain,
 	}
 
 	/* new, add as ready in the queue */
+#if defined(CONFIG_BT_MAYFLY_LATENCY)
+	m->_enqueued = k_cycle_get_32();
+#endif /* CONFIG_BT_MAYFLY_LATENCY */
 	m->_req = ack + 1;
 	memq_enqueue(m->_link, m, &mft[callee_id][caller_id].tail);
 
@@ -176,8 +193,34 @@ static void dequeue(uint8_t callee_id, uint8_t caller_id, memq_link_t *link,
 	}
 }
 
+#if defined(CONFIG_BT_MAYFLY_LATENCY)
+static void latency_record(uint8_t callee_id, struct mayfly *m)
+{
+	struct mayfly_latency *latency = &mfl_latency[callee_id];
+
+	latency->last = k_cycle_get_32() - m->_enqueued;
+	if (latency->last > latency->max) {
+		latency->max = latency->last;
+	}
+	latency->count++;
+}
+
+void mayfly_latency_get(uint8_t callee_id, struct mayfly_latency *latency)
+{
+	*latency = mfl_latency[callee_id];
+}
+
+void mayfly_latency_reset(uint8_t callee_id)
+{
+	mfl_latency[callee_id] = (struct mayfly_latency){ 0 };
+}
+#endif /* CONFIG_BT_MAYFLY_LATENCY */
+
 void mayfly_run(uint8_t callee_id)
 {
+#if defined(CONFIG_BT_MAYFLY_YIELD_AFTER_CALL)
+	uint8_t calls = 0U;
+#endif /* CONFIG_BT_MAYFLY_YIELD_AFTER_CALL */
 	uint8_t disable = 0U;
 	uint8_t enable = 0U;
 	uint8_t caller_id;
@@ -213,6 +256,10 @@ void mayfly_run(uint8_t callee_id)
 				/* mark mayfly as ran */
 				m->_ack--;
 
+#if defined(CONFIG_BT_MAYFLY_LATENCY)
+				latency_record(callee_id, m);
+#endif /* CONFIG_BT_MAYFLY_LATENCY */
+
 				/* call the mayfly function */
 				m->fp(m->param);
 			}
@@ -236,10 +283,11 @@ void mayfly_run(uint8_t callee_id)
  * consequence.
  */
 #if defined(CONFIG_BT_MAYFLY_YIELD_AFTER_CALL)
-			/* yield out of mayfly_run if a mayfly function was
-			 * called.
+			/* yield out of mayfly_run once the configured number
+			 * of mayfly functions were called.
 			 */
-			if (state == 1U) {
+			if ((state == 1U) &&
+			    (++calls >= CONFIG_BT_MAYFLY_YIELD_AFTER_CALL_COUNT)) {
 				/* pend callee (tailchain) if mayfly queue is
 				 * not empty or all caller queues are not
 				 * processed.
@@ -18,6 +18,15 @@ struct mayfly {
 	memq_link_t *_link;
 	void *param;
 	void (*fp)(void *);
+#if defined(CONFIG_BT_MAYFLY_LATENCY)
+	uint32_t _enqueued;
+#endif /* CONFIG_BT_MAYFLY_LATENCY */
+};
+
+struct mayfly_latency {
+	uint32_t last;
+	uint32_t max;
+	uint32_t count;
 };
 
 void mayfly_init(void);
@@ -25,6 +34,8 @@ void mayfly_enable(uint8_t caller_id, uint8_t callee_id, uint8_t enable);
 uint32_t mayfly_enqueue(uint8_t caller_id, uint8_t callee_id, uint8_t chain,
 		     struct mayfly *m);
 void mayfly_run(uint8_t callee_id);
+void mayfly_latency_get(uint8_t callee_id, struct mayfly_latency *latency);
+void mayfly_latency_reset(uint8_t callee_id);
 
 extern void mayfly_enable_cb(uint8_t caller_id, uint8_t callee_id, uint8_t enable);
 extern uint32_t mayfly_is_enabled(uint8_t caller_id, uint8_t callee_id);
@@ -642,10 +642,94 @@ static int hci_set_adv_ext_fragmented(struct bt_le_ext_adv *adv, uint16_t hci_op
 	return 0;
 }
 
+static uint64_t ad_digest_update(uint64_t digest, const uint8_t *data, size_t len)
+{
+	/* 64-bit FNV-1a */
+	for (size_t i = 0; i < len; i++) {
+		digest ^= data[i];
+		digest *= 0x100000001b3ULL;
+	}
+
+	return digest;
+}
+
+static uint64_t ad_digest(const struct bt_ad *ad, size_t ad_len)
+{
+	uint64_t digest = 0xcbf29ce484222325ULL;
+
+	for (size_t i = 0; i < ad_len; i++) {
+		for (size_t j = 0; j < ad[i].len; j++) {
+			const struct bt_data *data = &ad[i].data[j];
+			const uint8_t hdr[] = { data->data_len, data->type };
+
+			digest = ad_digest_update(digest, hdr, sizeof(hdr));
+			digest = ad_digest_update(digest, data->data,
+						  data->data_len);
+		}
+	}
+
+	return digest;
+}
+
+static uint64_t *adv_data_digest(struct bt_le_ext_adv *adv, uint16_t hci_op)
+{
+#if defined(CONFIG_BT_EXT_ADV)
+	if (hci_op == BT_HCI_OP_LE_SET_EXT_ADV_DATA) {
+		return &adv->ad_digest;
+	}
+
+	return &adv->sd_digest;
+#else
+	return NULL;
+#endif /* defined(CONFIG_BT_EXT_ADV) */
+}
+
+static void adv_data_digest_clear(struct bt_le_ext_adv *adv)
+{
+#if defined(CONFIG_BT_EXT_ADV)
+	adv->ad_digest = 0;
+	adv->sd_digest = 0;
+#endif /* defined(CONFIG_BT_EXT_ADV) */
+}
+
+static int hci_set_adv_ext_unchanged(struct bt_le_ext_adv *adv, uint16_t hci_op,
+				     size_t total_data_len)
+{
+	struct bt_hci_cp_le_set_ext_adv_data *set_data;
+	struct net_buf *buf;
+
+	/* The controller already holds this data. Only the advertising data
+	 * of a running extended advertising set needs a command, so that the
+	 * controller still updates the Advertising DID for scanners.
+	 */
+	if (hci_op != BT_HCI_OP_LE_SET_EXT_ADV_DATA || total_data_len == 0 ||
+	    !atomic_test_bit(adv->flags, BT_ADV_EXT_ADV) ||
+	    !atomic_test_bit(adv->flags, BT_ADV_ENABLED)) {
+		return 0;
+	}
+
+	buf = bt_hci_cmd_create(hci_op, sizeof(*set_data));
+	if (!buf) {
+		return -ENOBUFS;
+	}
+
+	set_data = net_buf_add(buf, sizeof(*set_data));
+	(void)memset(set_data, 0, sizeof(*set_data));
+
+	set_data->handle = adv->handle;
+	set_data->op = BT_HCI_LE_EXT_ADV_OP_UNCHANGED_DATA;
+	set_data->frag_pref = BT_HCI_LE_EXT_ADV_FRAG_DISABLED;
+
+	return bt_hci_cmd_send_sync(hci_op, buf, NULL);
+}
+
 static int hci_set_ad_ext(struct bt_le_ext_adv *adv, uint16_t hci_op,
 			  const struct bt_ad *ad, size_t ad_len)
 {
+	uint64_t *digest = adv_data_digest(adv, hci_op);
+	uint64_t new_digest = ad_digest(ad, ad_len);
 	size_t total_len_bytes = 0;
+	int err;
 
 	for (size_t i = 0; i < ad_len; i++) {
 		for (size_t j = 0; j < ad[i].len; j++) {
@@ -653,6 +737,10 @@ static int hci_set_ad_ext(struct bt_le_ext_adv *adv, uint16_t hci_op,
 		}
 	}
 
+	if (digest != NULL && *digest != 0 && *digest == new_digest) {
+		return hci_set_adv_ext_unchanged(adv, hci_op, total_len_bytes);
+	}
+
 	if ((total_len_bytes > BT_HCI_LE_EXT_ADV_FRAG_MAX_LEN) &&
 	    atomic_test_bit(adv->flags, BT_ADV_ENABLED)) {
 		/* It is not allowed to set advertising data in multiple
@@ -661,16 +749,25 @@ static int hci_set_ad_ext(struct bt_le_ext_adv *adv, uint16_t hci_op,
 		return -EAGAIN;
 	}
 
+	/* The controller content is unknown until the update has completed */
+	if (digest != NULL) {
+		*digest = 0;
+	}
+
 	if (total_len_bytes <= BT_HCI_LE_EXT_ADV_FRAG_MAX_LEN) {
 		/* If possible, set all data at once.
 		 * This allows us to update advertising data while advertising.
 		 */
-		return hci_set_adv_ext_complete(adv, hci_op, total_len_bytes, ad, ad_len);
+		err = hci_set_adv_ext_complete(adv, hci_op, total_len_bytes, ad, ad_len);
 	} else {
-		return hci_set_adv_ext_fragmented(adv, hci_op, ad, ad_len);
+		err = hci_set_adv_ext_fragmented(adv, hci_op, ad, ad_len);
 	}
 
-	return 0;
+	if (!err && digest != NULL) {
+		*digest = new_digest;
+	}
+
+	return err;
 }
 
 static int set_ad(struct bt_le_ext_adv *adv, const struct bt_ad *ad,
@@ -698,6 +795,11 @@ static int set_sd(struct bt_le_ext_adv *adv, const struct bt_ad *sd,
 }
 
 #if defined(CONFIG_BT_PER_ADV)
+/* Digest of the periodic advertising data last written to each set, zero if
+ * unknown. Kept aside as the periodic advertising API takes a const set.
+ */
+static uint64_t per_adv_data_digest[CONFIG_BT_EXT_ADV_MAX_ADV_SET];
+
 static int hci_set_per_adv_data(const struct bt_le_ext_adv *adv,
 				const struct bt_data *ad, size_t ad_len)
 {
@@ -705,6 +807,18 @@ static int hci_set_per_adv_data(const struct bt_le_ext_adv *adv,
 	struct ad_stream stream;
 	struct bt_ad d = { .data = ad, .len = ad_len };
 	bool is_first_iteration = true;
+	uint64_t *digest = &per_adv_data_digest[adv - adv_pool];
+	uint64_t new_digest = ad_digest(&d, 1);
+
+	/* With ADI included every update has to reach the controller so that
+	 * the Advertising DID changes.
+	 */
+	if (*digest != 0 && *digest == new_digest &&
+	    !atomic_test_bit(adv->flags, BT_PER_ADV_INCLUDE_ADI)) {
+		return 0;
+	}
+
+	*digest = 0;
 
 	err = ad_stream_new(&stream, &d, 1);
 	if (err) {
@@ -746,6 +860,8 @@ static int hci_set_per_adv_data(const struct bt_le_ext_adv *adv,
 		is_first_iteration = false;
 	}
 
+	*digest = new_digest;
+
 	return 0;
 }
 #endif /* CONFIG_BT_PER_ADV */
@@ -1224,6 +1340,11 @@ static int le_ext_adv_param_set(struct bt_le_ext_adv *adv,
 
 	net_buf_unref(rsp);
 
+	/* Changing the advertising properties may discard the data held by
+	 * the controller.
+	 */
+	adv_data_digest_clear(adv);
+
 	atomic_set_bit(adv->flags, BT_ADV_PARAMS_SET);
 
 	if (atomic_test_and_clear_bit(adv->flags, BT_ADV_RANDOM_ADDR_PENDING)) {
@@ -1860,6 +1981,8 @@ int bt_le_per_adv_set_param(struct bt_le_ext_adv *adv,
 		atomic_clear_bit(adv->flags, BT_PER_ADV_INCLUDE_ADI);
 	}
 
+	per_adv_data_digest[bt_le_ext_adv_get_index(adv)] = 0;
+
 	atomic_set_bit(adv->flags, BT_PER_ADV_PARAMS_SET);
 
 	return 0;
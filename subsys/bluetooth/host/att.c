@@ -89,6 +89,10 @@ struct bt_att_tx_meta_data {
 	bt_gatt_complete_func_t func;
 	void *user_data;
 	enum bt_att_chan_opt chan_opt;
+#if defined(CONFIG_BT_ATT_TX_STATS)
+	/* Uptime (ms) at which the PDU was queued */
+	uint32_t queued_at;
+#endif /* CONFIG_BT_ATT_TX_STATS */
 };
 
 struct bt_att_tx_meta {
@@ -150,6 +154,22 @@ struct bt_att {
 		uint8_t prev_conn_req_missing_chans;
 	} eatt;
 #endif /* CONFIG_BT_EATT */
+#if defined(CONFIG_BT_ATT_TX_SCHED)
+	/* Deficit round robin state of the TX classes */
+	struct {
+		uint32_t deficit[BT_ATT_TX_CLASS_NUM];
+		uint8_t cur;
+	} tx_sched;
+#endif /* CONFIG_BT_ATT_TX_SCHED */
+#if defined(CONFIG_BT_ATT_TX_STATS)
+	struct att_tx_stats {
+		uint16_t queued;
+		uint16_t queued_max;
+		uint32_t sent;
+		uint64_t latency_sum;
+		uint32_t latency_max;
+	} tx_stats[BT_ATT_TX_CLASS_NUM];
+#endif /* CONFIG_BT_ATT_TX_STATS */
 };
 
 K_MEM_SLAB_DEFINE(att_slab, sizeof(struct bt_att),
@@ -409,13 +429,67 @@ static struct bt_att_req *get_first_req_matching_chan(sys_slist_t *reqs, struct
 	}
 }
 
+#if defined(CONFIG_BT_ATT_TX_STATS)
+static void att_tx_stats_queued(struct bt_att *att, enum bt_att_tx_class tx_class,
+				struct net_buf *buf)
+{
+	struct att_tx_stats *stats = &att->tx_stats[tx_class];
+
+	bt_att_tx_meta_data(buf)->queued_at = k_uptime_get_32();
+
+	stats->queued++;
+	stats->queued_max = MAX(stats->queued_max, stats->queued);
+}
+
+static void att_tx_stats_removed(struct bt_att *att, enum bt_att_tx_class tx_class)
+{
+	__ASSERT_NO_MSG(att->tx_stats[tx_class].queued > 0);
+
+	att->tx_stats[tx_class].queued--;
+}
+
+/* The meta data may be released as soon as the PDU is sent, so the queuing
+ * time has to be read before sending it.
+ */
+static uint32_t att_tx_stats_queued_at(struct net_buf *buf)
+{
+	return bt_att_tx_meta_data(buf)->queued_at;
+}
+
+static void att_tx_stats_sent(struct bt_att *att, enum bt_att_tx_class tx_class,
+			      uint32_t queued_at)
+{
+	struct att_tx_stats *stats = &att->tx_stats[tx_class];
+	uint32_t latency = k_uptime_get_32() - queued_at;
+
+	att_tx_stats_removed(att, tx_class);
+
+	stats->sent++;
+	stats->latency_sum += latency;
+	stats->latency_max = MAX(stats->latency_max, latency);
+}
+#else
+static inline void att_tx_stats_queued(struct bt_att *att, enum bt_att_tx_class tx_class,
+				       struct net_buf *buf) {}
+static inline void att_tx_stats_removed(struct bt_att *att, enum bt_att_tx_class tx_class) {}
+static inline uint32_t att_tx_stats_queued_at(struct net_buf *buf)
+{
+	return 0;
+}
+static inline void att_tx_stats_sent(struct bt_att *att, enum bt_att_tx_class tx_class,
+				     uint32_t queued_at) {}
+#endif /* CONFIG_BT_ATT_TX_STATS */
+
 static int process_queue(struct bt_att_chan *chan, struct k_fifo *queue)
 {
 	struct net_buf *buf;
+	uint32_t queued_at;
 	int err;
 
 	buf = get_first_buf_matching_chan(queue, chan);
 	if (buf) {
+		queued_at = att_tx_stats_queued_at(buf);
+
 		err = bt_att_chan_send(chan, buf);
 		if (err) {
 			/* Push it back if it could not be send */
@@ -423,6 +497,10 @@ static int process_queue(struct bt_att_chan *chan, struct k_fifo *queue)
 			return err;
 		}
 
+		if (queue == &chan->att->tx_queue) {
+			att_tx_stats_sent(chan->att, BT_ATT_TX_CLASS_NTF, queued_at);
+		}
+
 		return 0;
 	}
 
@@ -433,6 +511,7 @@ static int process_queue(struct bt_att_chan *chan, struct k_fifo *queue)
 static int chan_req_send(struct bt_att_chan *chan, struct bt_att_req *req)
 {
 	struct net_buf *buf;
+	uint32_t queued_at;
 	int err;
 
 	if (bt_att_mtu(chan) < net_buf_frags_len(req->buf)) {
@@ -447,16 +526,147 @@ static int chan_req_send(struct bt_att_chan *chan, struct bt_att_req *req)
 	buf = req->buf;
 	req->buf = NULL;
 
+	queued_at = att_tx_stats_queued_at(buf);
+
 	err = bt_att_chan_send(chan, buf);
 	if (err) {
 		/* We still have the ownership of the buffer */
 		req->buf = buf;
 		chan->req = NULL;
+	} else {
+		att_tx_stats_sent(chan->att, BT_ATT_TX_CLASS_REQ, queued_at);
+	}
+
+	return err;
+}
+
+#if defined(CONFIG_BT_ATT_TX_SCHED)
+static const uint16_t att_tx_quantum[BT_ATT_TX_CLASS_NUM] = {
+	[BT_ATT_TX_CLASS_REQ] = CONFIG_BT_ATT_TX_SCHED_REQ_QUANTUM,
+	[BT_ATT_TX_CLASS_NTF] = CONFIG_BT_ATT_TX_SCHED_NTF_QUANTUM,
+};
+
+/* Length of the next PDU of a class, or 0 if the class has nothing that can
+ * be sent on the bearer. This is the head of the queue, which is not the PDU
+ * that gets sent if it is restricted to the other kind of bearer, but it is
+ * close enough for the accounting.
+ */
+static size_t att_tx_class_next_len(struct bt_att_chan *chan, enum bt_att_tx_class tx_class)
+{
+	struct bt_att *att = chan->att;
+	struct net_buf *buf;
+
+	if (tx_class == BT_ATT_TX_CLASS_REQ) {
+		sys_snode_t *node = sys_slist_peek_head(&att->reqs);
+
+		/* There can only be one transaction at a time on a bearer */
+		if (chan->req || !node) {
+			return 0;
+		}
+
+		return net_buf_frags_len(ATT_REQ(node)->buf);
+	}
+
+	buf = k_fifo_peek_head(&att->tx_queue);
+
+	return buf ? net_buf_frags_len(buf) : 0;
+}
+
+static int att_tx_class_send(struct bt_att_chan *chan, enum bt_att_tx_class tx_class)
+{
+	struct bt_att *att = chan->att;
+	struct bt_att_req *req;
+	int err;
+
+	if (tx_class == BT_ATT_TX_CLASS_NTF) {
+		return process_queue(chan, &att->tx_queue);
+	}
+
+	req = get_first_req_matching_chan(&att->reqs, chan);
+	if (!req) {
+		return -ENOENT;
+	}
+
+	err = chan_req_send(chan, req);
+	if (err) {
+		/* Prepend back to the list as it could not be sent */
+		sys_slist_prepend(&att->reqs, &req->node);
 	}
 
 	return err;
 }
 
+/* Send the next queued PDU of the connection on the bearer, picking the class
+ * with a deficit round robin: the current class keeps its turn for as long
+ * as its deficit covers its next PDU, and the next class then gets its
+ * quantum added to its deficit. A class with nothing queued loses its
+ * deficit, so it can't save up while idle.
+ */
+static int att_tx_sched_send(struct bt_att_chan *chan)
+{
+	struct bt_att *att = chan->att;
+	size_t len[BT_ATT_TX_CLASS_NUM];
+	int pending = 0;
+
+	if (sys_slist_is_empty(&att->reqs)) {
+		att->tx_sched.deficit[BT_ATT_TX_CLASS_REQ] = 0;
+	}
+
+	if (k_fifo_is_empty(&att->tx_queue)) {
+		att->tx_sched.deficit[BT_ATT_TX_CLASS_NTF] = 0;
+	}
+
+	for (int i = 0; i < BT_ATT_TX_CLASS_NUM; i++) {
+		len[i] = att_tx_class_next_len(chan, i);
+		if (len[i]) {
+			pending++;
+		}
+	}
+
+	while (pending) {
+		uint8_t cur = att->tx_sched.cur;
+
+		if (len[cur] && len[cur] <= att->tx_sched.deficit[cur]) {
+			if (!att_tx_class_send(chan, cur)) {
+				att->tx_sched.deficit[cur] -= len[cur];
+				return 0;
+			}
+
+			/* Nothing of this class can be sent on the bearer */
+			len[cur] = 0;
+			pending--;
+			continue;
+		}
+
+		cur = (cur + 1) % BT_ATT_TX_CLASS_NUM;
+		att->tx_sched.cur = cur;
+
+		if (len[cur]) {
+			att->tx_sched.deficit[cur] += att_tx_quantum[cur];
+		}
+	}
+
+	return -ENOENT;
+}
+
+static void att_tx_sched_process(struct bt_att *att)
+{
+	struct bt_att_chan *chan, *tmp;
+
+	SYS_SLIST_FOR_EACH_CONTAINER_SAFE(&att->chans, chan, tmp, node) {
+		if (!att_tx_sched_send(chan)) {
+			return;
+		}
+	}
+}
+#else
+static inline int att_tx_sched_send(struct bt_att_chan *chan)
+{
+	return -ENOTSUP;
+}
+static inline void att_tx_sched_process(struct bt_att *att) {}
+#endif /* CONFIG_BT_ATT_TX_SCHED */
+
 static void bt_att_sent(struct bt_l2cap_chan *ch)
 {
 	struct bt_att_chan *chan = ATT_CHAN(ch);
@@ -472,6 +682,18 @@ static void bt_att_sent(struct bt_l2cap_chan *ch)
 		return;
 	}
 
+	if (IS_ENABLED(CONFIG_BT_ATT_TX_SCHED)) {
+		/* Responses and confirmations can only go on this bearer, and
+		 * the peer is waiting for them, so they don't wait for a turn.
+		 */
+		if (!process_queue(chan, &chan->tx_queue)) {
+			return;
+		}
+
+		(void)att_tx_sched_send(chan);
+		return;
+	}
+
 	/* Process pending requests first since they require a response they
 	 * can only be processed one at time while if other queues were
 	 * processed before they may always contain a buffer starving the
@@ -768,6 +990,11 @@ static void att_send_process(struct bt_att *att)
 	struct bt_att_chan *chan, *tmp, *prev = NULL;
 	int err = 0;
 
+	if (IS_ENABLED(CONFIG_BT_ATT_TX_SCHED)) {
+		att_tx_sched_process(att);
+		return;
+	}
+
 	SYS_SLIST_FOR_EACH_CONTAINER_SAFE(&att->chans, chan, tmp, node) {
 		if (err == -ENOENT && prev &&
 		    (bt_att_is_enhanced(chan) == bt_att_is_enhanced(prev))) {
@@ -904,6 +1131,11 @@ static void att_req_send_process(struct bt_att *att)
 	struct bt_att_req *req = NULL;
 	struct bt_att_chan *chan, *tmp, *prev = NULL;
 
+	if (IS_ENABLED(CONFIG_BT_ATT_TX_SCHED)) {
+		att_tx_sched_process(att);
+		return;
+	}
+
 	SYS_SLIST_FOR_EACH_CONTAINER_SAFE(&att->chans, chan, tmp, node) {
 		/* If there is an ongoing transaction, do not use the channel */
 		if (chan->req) {
@@ -3281,6 +3513,11 @@ static void bt_att_status(struct bt_l2cap_chan *ch, atomic_t *status)
 		return;
 	}
 
+	if (IS_ENABLED(CONFIG_BT_ATT_TX_SCHED)) {
+		(void)att_tx_sched_send(chan);
+		return;
+	}
+
 	/* Pull next request from the list */
 	node = sys_slist_get(&chan->att->reqs);
 	if (!node) {
@@ -3893,6 +4130,8 @@ int bt_att_send(struct bt_conn *conn, struct net_buf *buf)
 		return -ENOTCONN;
 	}
 
+	att_tx_stats_queued(att, BT_ATT_TX_CLASS_NTF, buf);
+
 	net_buf_put(&att->tx_queue, buf);
 	att_send_process(att);
 
@@ -3913,6 +4152,8 @@ int bt_att_req_send(struct bt_conn *conn, struct bt_att_req *req)
 		return -ENOTCONN;
 	}
 
+	att_tx_stats_queued(att, BT_ATT_TX_CLASS_REQ, req->buf);
+
 	sys_slist_append(&att->reqs, &req->node);
 	att_req_send_process(att);
 
@@ -3957,7 +4198,9 @@ void bt_att_req_cancel(struct bt_conn *conn, struct bt_att_req *req)
 	}
 
 	/* Remove request from the list */
-	sys_slist_find_and_remove(&att->reqs, &req->node);
+	if (sys_slist_find_and_remove(&att->reqs, &req->node)) {
+		att_tx_stats_removed(att, BT_ATT_TX_CLASS_REQ);
+	}
 
 	bt_att_req_free(req);
 }
@@ -3988,6 +4231,36 @@ struct bt_att_req *bt_att_find_req_by_user_data(struct bt_conn *conn, const void
 	return NULL;
 }
 
+#if defined(CONFIG_BT_ATT_TX_STATS)
+int bt_att_tx_stats_get(struct bt_conn *conn, enum bt_att_tx_class tx_class,
+			struct bt_att_tx_stats *stats)
+{
+	struct att_tx_stats *tx_stats;
+	struct bt_att *att;
+
+	__ASSERT_NO_MSG(stats);
+
+	if (tx_class >= BT_ATT_TX_CLASS_NUM) {
+		return -EINVAL;
+	}
+
+	att = att_get(conn);
+	if (!att) {
+		return -ENOTCONN;
+	}
+
+	tx_stats = &att->tx_stats[tx_class];
+
+	stats->queued = tx_stats->queued;
+	stats->queued_max = tx_stats->queued_max;
+	stats->sent = tx_stats->sent;
+	stats->latency_avg_ms = tx_stats->sent ? tx_stats->latency_sum / tx_stats->sent : 0;
+	stats->latency_max_ms = tx_stats->latency_max;
+
+	return 0;
+}
+#endif /* CONFIG_BT_ATT_TX_STATS */
+
 bool bt_att_fixed_chan_only(struct bt_conn *conn)
 {
 #if defined(CONFIG_BT_EATT)
@@ -94,6 +94,8 @@ static void deferred_work(struct k_work *work);
 static void notify_connected(struct bt_conn *conn);
 
 static struct bt_conn acl_conns[CONFIG_BT_MAX_CONN];
+/* First connection served by the next round of the TX thread */
+static uint8_t acl_first;
 NET_BUF_POOL_DEFINE(acl_tx_pool, CONFIG_BT_L2CAP_TX_BUF_COUNT,
 		    BT_L2CAP_BUF_SIZE(CONFIG_BT_L2CAP_TX_MTU),
 		    CONFIG_BT_CONN_TX_USER_DATA_SIZE, NULL);
@@ -742,6 +744,16 @@ static int send_buf(struct bt_conn *conn, struct net_buf *buf)
 	}
 
 	while (buf->len > conn_mtu(conn)) {
+		/* Don't allocate a fragment before the controller can take it.
+		 * Only the TX thread takes controller buffers, so the count
+		 * can't drop before send_frag() is called.
+		 */
+		if (!k_sem_count_get(bt_conn_get_pkts(conn))) {
+			LOG_DBG("no controller bufs");
+			tx_data(buf)->is_cont = flags != FRAG_START;
+			return -ENOBUFS;
+		}
+
 		frag = create_frag(conn, buf);
 		if (!frag) {
 			return -ENOMEM;
@@ -874,13 +886,19 @@ int bt_conn_prepare_events(struct k_poll_event events[])
 			  K_POLL_MODE_NOTIFY_ONLY, &conn_change);
 
 #if defined(CONFIG_BT_CONN)
+	/* The TX thread serves the connections in the order of their events,
+	 * and the first one served gets the controller buffers. Rotate the
+	 * order so that the links share them in a round robin fashion.
+	 */
 	for (i = 0; i < ARRAY_SIZE(acl_conns); i++) {
-		conn = &acl_conns[i];
+		conn = &acl_conns[(acl_first + i) % ARRAY_SIZE(acl_conns)];
 
 		if (!conn_prepare_events(conn, &events[ev_count])) {
 			ev_count++;
 		}
 	}
+
+	acl_first = (acl_first + 1) % ARRAY_SIZE(acl_conns);
 #endif /* CONFIG_BT_CONN */
 
 #if defined(CONFIG_BT_ISO)
@@ -910,33 +928,49 @@ void bt_conn_process_tx(struct bt_conn *conn)
 		return;
 	}
 
-	/* Get next ACL packet for connection. The buffer will only get dequeued
-	 * if there is a free controller buffer to put it in.
-	 *
-	 * Important: no operations should be done on `buf` until it is properly
-	 * dequeued from the FIFO, using the `net_buf_get()` API.
+	/* Send up to CONFIG_BT_CONN_TX_BATCH buffers in one go, for as long as
+	 * the controller has buffers for them, so that streams of small packets
+	 * don't need a TX thread wake-up per packet.
 	 */
-	buf = k_fifo_peek_head(&conn->tx_queue);
-	BT_ASSERT(buf);
+	for (int i = 0; i < CONFIG_BT_CONN_TX_BATCH; i++) {
+		/* Get next ACL packet for connection. The buffer will only get
+		 * dequeued if there is a free controller buffer to put it in.
+		 *
+		 * Important: no operations should be done on `buf` until it is
+		 * properly dequeued from the FIFO, using the `net_buf_get()` API.
+		 */
+		buf = k_fifo_peek_head(&conn->tx_queue);
+		if (i == 0) {
+			BT_ASSERT(buf);
+		} else if (!buf) {
+			break;
+		}
 
-	/* Since we used `peek`, the queue still owns the reference to the
-	 * buffer, so we need to take an explicit additional reference here.
-	 */
-	buf = net_buf_ref(buf);
-	err = send_buf(conn, buf);
-	net_buf_unref(buf);
+		/* Since we used `peek`, the queue still owns the reference to
+		 * the buffer, so we need to take an explicit additional
+		 * reference here.
+		 */
+		buf = net_buf_ref(buf);
+		err = send_buf(conn, buf);
+		net_buf_unref(buf);
 
-	if (err  == -EIO) {
-		struct bt_conn_tx *tx = tx_data(buf)->tx;
+		if (err == -EIO) {
+			struct bt_conn_tx *tx = tx_data(buf)->tx;
 
-		tx_data(buf)->tx = NULL;
+			tx_data(buf)->tx = NULL;
 
-		/* destroy the buffer */
-		net_buf_unref(buf);
+			/* destroy the buffer */
+			net_buf_unref(buf);
 
-		/* destroy the tx context (and any associated meta-data) */
-		if (tx) {
-			conn_tx_destroy(conn, tx);
+			/* destroy the tx context (and any associated meta-data) */
+			if (tx) {
+				conn_tx_destroy(conn, tx);
+			}
+		}
+
+		if (err || conn->state != BT_CONN_CONNECTED ||
+		    !k_sem_count_get(bt_conn_get_pkts(conn))) {
+			break;
 		}
 	}
 }
@@ -16,6 +16,7 @@
 #include <zephyr/sys/iterable_sections.h>
 #include <zephyr/sys/util.h>
 #include <zephyr/sys/check.h>
+#include <zephyr/sys/crc.h>
 
 #include <zephyr/settings/settings.h>
 
@@ -94,6 +95,201 @@ enum gatt_global_flags {
 
 static ATOMIC_DEFINE(gatt_flags, GATT_NUM_FLAGS);
 
+#if defined(CONFIG_BT_GATT_DB_INDEX)
+/* Index of the local database services, in ascending handle order. Each
+ * entry also summarizes the attribute UUIDs of the service in a bitmap so
+ * that searches by UUID can skip services without comparing attributes.
+ */
+struct db_index_entry {
+	const struct bt_gatt_attr *attrs;
+	uint32_t uuid_map;
+	uint16_t attr_count;
+	uint16_t start_handle;
+	uint16_t end_handle;
+	/* Static service attributes have implicit, contiguous handles */
+	bool is_static;
+};
+
+static struct {
+	struct db_index_entry entries[CONFIG_BT_GATT_DB_INDEX_SIZE];
+	uint8_t count;
+	bool valid;
+} db_index;
+
+static const struct bt_uuid_128 uuid_base =
+	BT_UUID_INIT_128(BT_UUID_128_ENCODE(0, 0, 0x1000, 0x8000, 0x00805F9B34FB));
+
+static uint32_t db_index_uuid_bit(const struct bt_uuid *uuid)
+{
+	const uint8_t *val;
+	uint32_t key;
+
+	/* The key must be the same for all the representations of a UUID
+	 * that bt_uuid_cmp() considers equal.
+	 */
+	switch (uuid->type) {
+	case BT_UUID_TYPE_16:
+		key = BT_UUID_16(uuid)->val;
+		break;
+	case BT_UUID_TYPE_32:
+		key = BT_UUID_32(uuid)->val;
+		break;
+	default:
+		val = BT_UUID_128(uuid)->val;
+		key = sys_get_le32(&val[12]);
+
+		if (memcmp(val, uuid_base.val, 12) != 0) {
+			key ^= sys_get_le32(&val[0]) ^ sys_get_le32(&val[4]) ^
+			       sys_get_le32(&val[8]);
+		}
+		break;
+	}
+
+	key ^= key >> 16;
+	key ^= key >> 5;
+
+	return BIT(key & 31);
+}
+
+static bool db_index_add(const struct bt_gatt_attr *attrs, uint16_t count,
+			 uint16_t start_handle, bool is_static)
+{
+	struct db_index_entry *entry;
+
+	if (db_index.count == ARRAY_SIZE(db_index.entries)) {
+		return false;
+	}
+
+	entry = &db_index.entries[db_index.count++];
+	entry->attrs = attrs;
+	entry->attr_count = count;
+	entry->start_handle = start_handle;
+	entry->end_handle = is_static ? start_handle + count - 1 :
+			    attrs[count - 1].handle;
+	entry->is_static = is_static;
+	entry->uuid_map = 0;
+
+	for (uint16_t i = 0; i < count; i++) {
+		entry->uuid_map |= db_index_uuid_bit(attrs[i].uuid);
+	}
+
+	return true;
+}
+
+static void db_index_rebuild(void)
+{
+#if defined(CONFIG_BT_GATT_DYNAMIC_DB)
+	struct bt_gatt_service *svc;
+#endif /* CONFIG_BT_GATT_DYNAMIC_DB */
+	uint16_t handle = 1;
+
+	db_index.valid = false;
+	db_index.count = 0;
+
+	STRUCT_SECTION_FOREACH(bt_gatt_service_static, static_svc) {
+		if (!db_index_add(static_svc->attrs, static_svc->attr_count,
+				  handle, true)) {
+			goto overflow;
+		}
+
+		handle += static_svc->attr_count;
+	}
+
+#if defined(CONFIG_BT_GATT_DYNAMIC_DB)
+	SYS_SLIST_FOR_EACH_CONTAINER(&db, svc, node) {
+		if (!db_index_add(svc->attrs, svc->attr_count,
+				  svc->attrs[0].handle, false)) {
+			goto overflow;
+		}
+	}
+#endif /* CONFIG_BT_GATT_DYNAMIC_DB */
+
+	db_index.valid = true;
+
+	return;
+
+overflow:
+	LOG_WRN("GATT database index too small, using linear lookups");
+}
+
+/* Returns the first service ending at or after the given handle */
+static size_t db_index_find(uint16_t handle)
+{
+	size_t lo = 0;
+	size_t hi = db_index.count;
+
+	while (lo < hi) {
+		size_t mid = (lo + hi) / 2;
+
+		if (db_index.entries[mid].end_handle < handle) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
+	}
+
+	return lo;
+}
+
+/* Returns the first attribute of the service at or after the given handle */
+static uint16_t db_index_find_attr(const struct db_index_entry *entry,
+				   uint16_t handle)
+{
+	uint16_t lo = 0;
+	uint16_t hi = entry->attr_count;
+
+	if (handle <= entry->start_handle) {
+		return 0;
+	}
+
+	if (entry->is_static) {
+		return handle - entry->start_handle;
+	}
+
+	/* Dynamic services may have gaps in their handles */
+	while (lo < hi) {
+		uint16_t mid = (lo + hi) / 2;
+
+		if (entry->attrs[mid].handle < handle) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
+	}
+
+	return lo;
+}
+#else
+static inline void db_index_rebuild(void)
+{
+}
+#endif /* CONFIG_BT_GATT_DB_INDEX */
+
+#if defined(CONFIG_BT_GATT_NOTIFY_MULTIPLE)
+/* Value handle and CCC descriptor, which holds the subscribers, of a
+ * characteristic notified to all peers with bt_gatt_notify_multiple().
+ */
+struct gatt_nfy_sub {
+	const struct bt_gatt_attr *attr;
+	const struct bt_gatt_attr *ccc;
+	uint16_t handle;
+};
+#endif /* CONFIG_BT_GATT_NOTIFY_MULTIPLE */
+
+#if defined(CONFIG_BT_GATT_NOTIFY_MULTIPLE) && (CONFIG_BT_GATT_NOTIFY_MULTIPLE_CACHE_SIZE > 0)
+/* Direct mapped by attribute address */
+static struct gatt_nfy_sub nfy_sub_cache[CONFIG_BT_GATT_NOTIFY_MULTIPLE_CACHE_SIZE];
+
+static inline void nfy_sub_cache_clear(void)
+{
+	(void)memset(nfy_sub_cache, 0, sizeof(nfy_sub_cache));
+}
+#else
+static inline void nfy_sub_cache_clear(void)
+{
+}
+#endif /* CONFIG_BT_GATT_NOTIFY_MULTIPLE_CACHE_SIZE > 0 */
+
 static ssize_t read_name(struct bt_conn *conn, const struct bt_gatt_attr *attr,
 			 void *buf, uint16_t len, uint16_t offset)
 {
@@ -306,10 +502,36 @@ static struct gatt_sc {
 #endif /* defined(CONFIG_BT_GATT_SERVICE_CHANGED) */
 
 #if defined(CONFIG_BT_GATT_CACHING)
+/* Hash state once the attributes of a service have been added */
+struct db_hash_seg {
+	const struct bt_gatt_attr *attrs;
+	uint16_t start_handle;
+	uint16_t end_handle;
+	struct tc_cmac_struct state;
+	uint32_t crc;
+};
+
+/* Persistent storage format for the Database Hash */
+struct db_hash_storage {
+	uint8_t hash[16];
+	/* CRC of the hash input, to detect an unchanged database without
+	 * generating the hash.
+	 */
+	uint32_t crc;
+} __packed;
+
 static struct db_hash {
 	uint8_t hash[16];
 #if defined(CONFIG_BT_SETTINGS)
 	 uint8_t stored_hash[16];
+	 uint32_t stored_crc;
+	 bool stored_crc_valid;
+	 uint32_t crc;
+#endif
+	struct tc_aes_key_sched_struct sched;
+#if CONFIG_BT_GATT_DB_HASH_CACHE_SIZE > 0
+	struct db_hash_seg segs[CONFIG_BT_GATT_DB_HASH_CACHE_SIZE];
+	size_t seg_count;
 #endif
 	struct k_work_delayable work;
 	struct k_work_sync sync;
@@ -694,6 +916,11 @@ static ssize_t cf_write(struct bt_conn *conn, const struct bt_gatt_attr *attr,
 
 struct gen_hash_state {
 	struct tc_cmac_struct state;
+	uint32_t crc;
+	/* Only the CRC of the hash input is needed */
+	bool crc_only;
+	/* The services so far are unchanged since the last generation */
+	bool cached;
 	int err;
 };
 
@@ -732,6 +959,21 @@ union hash_attr_value {
 	} __packed cep;
 } __packed;
 
+static int gen_hash_update(struct gen_hash_state *state, const uint8_t *data,
+			   size_t len)
+{
+#if defined(CONFIG_BT_SETTINGS)
+	state->crc = crc32_ieee_update(state->crc, data, len);
+#endif
+
+	if (!state->crc_only &&
+	    tc_cmac_update(&state->state, data, len) == TC_CRYPTO_FAIL) {
+		state->err = -EINVAL;
+	}
+
+	return state->err;
+}
+
 static uint8_t gen_hash_m(const struct bt_gatt_attr *attr, uint16_t handle,
 			  void *user_data)
 {
@@ -754,16 +996,13 @@ static uint8_t gen_hash_m(const struct bt_gatt_attr *attr, uint16_t handle,
 	case BT_UUID_GATT_CHRC_VAL:
 	case BT_UUID_GATT_CEP_VAL:
 		value = sys_cpu_to_le16(handle);
-		if (tc_cmac_update(&state->state, (uint8_t *)&value,
-				   sizeof(handle)) == TC_CRYPTO_FAIL) {
-			state->err = -EINVAL;
+		if (gen_hash_update(state, (uint8_t *)&value, sizeof(handle))) {
 			return BT_GATT_ITER_STOP;
 		}
 
 		value = sys_cpu_to_le16(u16->val);
-		if (tc_cmac_update(&state->state, (uint8_t *)&value,
-				   sizeof(u16->val)) == TC_CRYPTO_FAIL) {
-			state->err = -EINVAL;
+		if (gen_hash_update(state, (uint8_t *)&value,
+				    sizeof(u16->val))) {
 			return BT_GATT_ITER_STOP;
 		}
 
@@ -773,9 +1012,7 @@ static uint8_t gen_hash_m(const struct bt_gatt_attr *attr, uint16_t handle,
 			return BT_GATT_ITER_STOP;
 		}
 
-		if (tc_cmac_update(&state->state, data, len) ==
-		    TC_CRYPTO_FAIL) {
-			state->err = -EINVAL;
+		if (gen_hash_update(state, data, len)) {
 			return BT_GATT_ITER_STOP;
 		}
 
@@ -787,16 +1024,13 @@ static uint8_t gen_hash_m(const struct bt_gatt_attr *attr, uint16_t handle,
 	case BT_UUID_GATT_CPF_VAL:
 	case BT_UUID_GATT_CAF_VAL:
 		value = sys_cpu_to_le16(handle);
-		if (tc_cmac_update(&state->state, (uint8_t *)&value,
-				   sizeof(handle)) == TC_CRYPTO_FAIL) {
-			state->err = -EINVAL;
+		if (gen_hash_update(state, (uint8_t *)&value, sizeof(handle))) {
 			return BT_GATT_ITER_STOP;
 		}
 
 		value = sys_cpu_to_le16(u16->val);
-		if (tc_cmac_update(&state->state, (uint8_t *)&value,
-				   sizeof(u16->val)) == TC_CRYPTO_FAIL) {
-			state->err = -EINVAL;
+		if (gen_hash_update(state, (uint8_t *)&value,
+				    sizeof(u16->val))) {
 			return BT_GATT_ITER_STOP;
 		}
 		break;
@@ -810,9 +1044,13 @@ static uint8_t gen_hash_m(const struct bt_gatt_attr *attr, uint16_t handle,
 static void db_hash_store(void)
 {
 #if defined(CONFIG_BT_SETTINGS)
+	struct db_hash_storage storage;
 	int err;
 
-	err = bt_settings_store_hash(&db_hash.hash, sizeof(db_hash.hash));
+	memcpy(storage.hash, db_hash.hash, sizeof(storage.hash));
+	storage.crc = db_hash.crc;
+
+	err = bt_settings_store_hash(&storage, sizeof(storage));
 	if (err) {
 		LOG_ERR("Failed to save Database Hash (err %d)", err);
 	}
@@ -821,18 +1059,116 @@ static void db_hash_store(void)
 #endif	/* CONFIG_BT_SETTINGS */
 }
 
+static void db_hash_segment(struct gen_hash_state *state, size_t index,
+			    const struct bt_gatt_attr *attrs,
+			    uint16_t start_handle, uint16_t end_handle)
+{
+#if CONFIG_BT_GATT_DB_HASH_CACHE_SIZE > 0
+	struct db_hash_seg *seg = NULL;
+
+	if (index < ARRAY_SIZE(db_hash.segs)) {
+		seg = &db_hash.segs[index];
+	}
+
+	/* The cached states form a chain, a service can only be skipped if
+	 * all the services before it were.
+	 */
+	if (state->cached && seg && index < db_hash.seg_count &&
+	    seg->attrs == attrs && seg->start_handle == start_handle &&
+	    seg->end_handle == end_handle) {
+		state->state = seg->state;
+		state->crc = seg->crc;
+		return;
+	}
+
+	state->cached = false;
+#endif /* CONFIG_BT_GATT_DB_HASH_CACHE_SIZE > 0 */
+
+	if (state->err) {
+		return;
+	}
+
+	bt_gatt_foreach_attr(start_handle, end_handle, gen_hash_m, state);
+
+#if CONFIG_BT_GATT_DB_HASH_CACHE_SIZE > 0
+	if (seg && !state->err && !state->crc_only) {
+		seg->attrs = attrs;
+		seg->start_handle = start_handle;
+		seg->end_handle = end_handle;
+		seg->state = state->state;
+		seg->crc = state->crc;
+		db_hash.seg_count = index + 1;
+	}
+#endif /* CONFIG_BT_GATT_DB_HASH_CACHE_SIZE > 0 */
+}
+
+#if defined(CONFIG_BT_GATT_DYNAMIC_DB)
+/* The database changed from the handle on: the hash no longer matches it and
+ * the cached states of the services from there on may have been built from
+ * other attributes, even if the service is registered again with the same
+ * attributes and handles.
+ */
+static void db_hash_invalidate(uint16_t start_handle)
+{
+	atomic_clear_bit(gatt_sc.flags, DB_HASH_VALID);
+
+#if CONFIG_BT_GATT_DB_HASH_CACHE_SIZE > 0
+	while (db_hash.seg_count > 0 &&
+	       db_hash.segs[db_hash.seg_count - 1].end_handle >= start_handle) {
+		db_hash.seg_count--;
+	}
+#endif /* CONFIG_BT_GATT_DB_HASH_CACHE_SIZE > 0 */
+}
+#endif /* CONFIG_BT_GATT_DYNAMIC_DB */
+
+/* Hash the database one service at a time, in handle order. This is the
+ * same input as a walk over the whole database, but it allows resuming
+ * from the cached state of the unchanged services.
+ */
+static void db_hash_gen_segments(struct gen_hash_state *state)
+{
+#if defined(CONFIG_BT_GATT_DYNAMIC_DB)
+	struct bt_gatt_service *svc;
+#endif /* CONFIG_BT_GATT_DYNAMIC_DB */
+	uint16_t handle = 1;
+	size_t index = 0;
+
+	STRUCT_SECTION_FOREACH(bt_gatt_service_static, static_svc) {
+		if (!static_svc->attr_count) {
+			continue;
+		}
+
+		db_hash_segment(state, index++, static_svc->attrs, handle,
+				handle + static_svc->attr_count - 1);
+		handle += static_svc->attr_count;
+	}
+
+#if defined(CONFIG_BT_GATT_DYNAMIC_DB)
+	SYS_SLIST_FOR_EACH_CONTAINER(&db, svc, node) {
+		db_hash_segment(state, index++, svc->attrs,
+				svc->attrs[0].handle,
+				svc->attrs[svc->attr_count - 1].handle);
+	}
+#endif /* CONFIG_BT_GATT_DYNAMIC_DB */
+}
+
 static void db_hash_gen(void)
 {
 	uint8_t key[16] = {};
-	struct tc_aes_key_sched_struct sched;
-	struct gen_hash_state state;
+	struct gen_hash_state state = {
+		.cached = true,
+	};
 
-	if (tc_cmac_setup(&state.state, key, &sched) == TC_CRYPTO_FAIL) {
+	if (tc_cmac_setup(&state.state, key, &db_hash.sched) == TC_CRYPTO_FAIL) {
 		LOG_ERR("Unable to setup AES CMAC");
 		return;
 	}
 
-	bt_gatt_foreach_attr(0x0001, 0xffff, gen_hash_m, &state);
+	db_hash_gen_segments(&state);
+	if (state.err) {
+		LOG_ERR("Unable to hash database (err %d)", state.err);
+		return;
+	}
 
 	if (tc_cmac_final(db_hash.hash, &state.state) == TC_CRYPTO_FAIL) {
 		LOG_ERR("Unable to calculate hash");
@@ -850,10 +1186,43 @@ static void db_hash_gen(void)
 
 	LOG_HEXDUMP_DBG(db_hash.hash, sizeof(db_hash.hash), "Hash: ");
 
+#if defined(CONFIG_BT_SETTINGS)
+	db_hash.crc = state.crc;
+#endif
+
 	atomic_set_bit(gatt_sc.flags, DB_HASH_VALID);
 }
 
 #if defined(CONFIG_BT_SETTINGS)
+/* Use the stored hash as is if the database is the one it was generated
+ * for, which is checked with the CRC of the hash input. This avoids the
+ * AES-CMAC computation on boot when the database didn't change.
+ */
+static bool db_hash_restore(void)
+{
+	struct gen_hash_state state = {
+		.crc_only = true,
+	};
+
+	if (!db_hash.stored_crc_valid) {
+		return false;
+	}
+
+	db_hash_gen_segments(&state);
+	if (state.err || state.crc != db_hash.stored_crc) {
+		return false;
+	}
+
+	memcpy(db_hash.hash, db_hash.stored_hash, sizeof(db_hash.hash));
+	db_hash.crc = state.crc;
+
+	LOG_DBG("Database unchanged, using stored hash");
+
+	atomic_set_bit(gatt_sc.flags, DB_HASH_VALID);
+
+	return true;
+}
+
 static void sc_indicate(uint16_t start, uint16_t end);
 #endif
 
@@ -861,10 +1230,6 @@ static void do_db_hash(void)
 {
 	bool new_hash = !atomic_test_bit(gatt_sc.flags, DB_HASH_VALID);
 
-	if (new_hash) {
-		db_hash_gen();
-	}
-
 #if defined(CONFIG_BT_SETTINGS)
 	bool hash_loaded_from_settings =
 		atomic_test_bit(gatt_sc.flags, DB_HASH_LOAD);
@@ -872,12 +1237,24 @@ static void do_db_hash(void)
 		atomic_test_bit(gatt_sc.flags, DB_HASH_LOAD_PROC);
 
 	if (!hash_loaded_from_settings) {
-		/* we want to generate the hash, but not overwrite the hash
-		 * stored in settings, that we haven't yet loaded.
+		/* we don't want to overwrite the hash stored in settings, that
+		 * we haven't yet loaded, and it may spare generating the hash.
+		 * It is generated on demand if read in the meantime.
 		 */
 		return;
 	}
 
+	if (new_hash && !already_processed && db_hash_restore()) {
+		new_hash = false;
+	}
+#endif /* defined(CONFIG_BT_SETTINGS) */
+
+	if (new_hash) {
+		db_hash_gen();
+	}
+
+#if defined(CONFIG_BT_SETTINGS)
+
 	if (already_processed) {
 		/* hash has been loaded from settings and we have already
 		 * executed the special case below once. we can now safely save
@@ -1232,6 +1609,9 @@ populate:
 
 	gatt_insert(svc, last_handle);
 
+	db_index_rebuild();
+	nfy_sub_cache_clear();
+
 	return 0;
 }
 #endif /* CONFIG_BT_GATT_DYNAMIC_DB */
@@ -1453,6 +1833,8 @@ static void bt_gatt_service_init(void)
 	STRUCT_SECTION_FOREACH(bt_gatt_service_static, svc) {
 		last_static_handle += svc->attr_count;
 	}
+
+	db_index_rebuild();
 }
 
 void bt_gatt_init(void)
@@ -1555,8 +1937,6 @@ static void db_changed(void)
 	struct bt_conn *conn;
 	int i;
 
-	atomic_clear_bit(gatt_sc.flags, DB_HASH_VALID);
-
 	if (IS_ENABLED(CONFIG_BT_LONG_WQ)) {
 		bt_long_wq_reschedule(&db_hash.work, DB_HASH_TIMEOUT);
 	} else {
@@ -1630,6 +2010,9 @@ static int gatt_unregister(struct bt_gatt_service *svc)
 		return -ENOENT;
 	}
 
+	db_index_rebuild();
+	nfy_sub_cache_clear();
+
 	for (uint16_t i = 0; i < svc->attr_count; i++) {
 		struct bt_gatt_attr *attr = &svc->attrs[i];
 
@@ -1673,6 +2056,10 @@ int bt_gatt_service_register(struct bt_gatt_service *svc)
 		return err;
 	}
 
+#if defined(CONFIG_BT_GATT_CACHING)
+	db_hash_invalidate(svc->attrs[0].handle);
+#endif
+
 	/* Don't submit any work until the stack is initialized */
 	if (!atomic_test_bit(gatt_flags, GATT_INITIALIZED)) {
 		k_sched_unlock();
@@ -1703,6 +2090,10 @@ int bt_gatt_service_unregister(struct bt_gatt_service *svc)
 		return err;
 	}
 
+#if defined(CONFIG_BT_GATT_CACHING)
+	db_hash_invalidate(svc->attrs[0].handle);
+#endif
+
 	/* Don't submit any work until the stack is initialized */
 	if (!atomic_test_bit(gatt_flags, GATT_INITIALIZED)) {
 		k_sched_unlock();
@@ -1816,11 +2207,7 @@ uint16_t bt_gatt_attr_get_handle(const struct bt_gatt_attr *attr)
 			continue;
 		}
 
-		for (size_t i = 0; i < static_svc->attr_count; i++, handle++) {
-			if (attr == &static_svc->attrs[i]) {
-				return handle;
-			}
-		}
+		return handle + (attr - static_svc->attrs);
 	}
 
 	return 0;
@@ -1990,6 +2377,43 @@ static void foreach_attr_type_dyndb(uint16_t start_handle, uint16_t end_handle,
 #endif /* CONFIG_BT_GATT_DYNAMIC_DB */
 }
 
+#if defined(CONFIG_BT_GATT_DB_INDEX)
+static void foreach_attr_type_index(uint16_t start_handle, uint16_t end_handle,
+				    const struct bt_uuid *uuid,
+				    const void *attr_data, uint16_t num_matches,
+				    bt_gatt_attr_func_t func, void *user_data)
+{
+	uint32_t uuid_bit = uuid ? db_index_uuid_bit(uuid) : 0;
+
+	for (size_t i = db_index_find(start_handle); i < db_index.count; i++) {
+		const struct db_index_entry *entry = &db_index.entries[i];
+
+		if (entry->start_handle > end_handle) {
+			return;
+		}
+
+		/* Skip services that can't contain the UUID */
+		if (uuid && !(entry->uuid_map & uuid_bit)) {
+			continue;
+		}
+
+		for (uint16_t j = db_index_find_attr(entry, start_handle);
+		     j < entry->attr_count; j++) {
+			const struct bt_gatt_attr *attr = &entry->attrs[j];
+			uint16_t handle = entry->is_static ?
+					  entry->start_handle + j : attr->handle;
+
+			if (gatt_foreach_iter(attr, handle, start_handle,
+					      end_handle, uuid, attr_data,
+					      &num_matches, func, user_data) ==
+			    BT_GATT_ITER_STOP) {
+				return;
+			}
+		}
+	}
+}
+#endif /* CONFIG_BT_GATT_DB_INDEX */
+
 void bt_gatt_foreach_attr_type(uint16_t start_handle, uint16_t end_handle,
 			       const struct bt_uuid *uuid,
 			       const void *attr_data, uint16_t num_matches,
@@ -2001,6 +2425,15 @@ void bt_gatt_foreach_attr_type(uint16_t start_handle, uint16_t end_handle,
 		num_matches = UINT16_MAX;
 	}
 
+#if defined(CONFIG_BT_GATT_DB_INDEX)
+	if (db_index.valid) {
+		foreach_attr_type_index(start_handle, end_handle, uuid,
+					attr_data, num_matches, func,
+					user_data);
+		return;
+	}
+#endif /* CONFIG_BT_GATT_DB_INDEX */
+
 	if (start_handle <= last_static_handle) {
 		uint16_t handle = 1;
 
@@ -2851,17 +3284,15 @@ static int gatt_notify_multiple_verify_args(struct bt_conn *conn,
 		return -EINVAL;
 	}
 
-	CHECKIF(conn == NULL) {
-		/* Use the standard notification API to send to all connected
-		 * peers.
-		 */
-		return -EINVAL;
-	}
-
 	if (!atomic_test_bit(bt_dev.flags, BT_DEV_READY)) {
 		return -EAGAIN;
 	}
 
+	/* The peers are checked one by one when notifying all of them */
+	if (!conn) {
+		return 0;
+	}
+
 	if (conn->state != BT_CONN_CONNECTED) {
 		return -ENOTCONN;
 	}
@@ -2944,6 +3375,254 @@ static int gatt_notify_multiple_verify_params(struct bt_conn *conn,
 	return 0;
 }
 
+#if (CONFIG_BT_GATT_NOTIFY_MULTIPLE_CACHE_SIZE > 0)
+static struct gatt_nfy_sub *nfy_sub_cache_entry(const struct bt_gatt_attr *attr)
+{
+	return &nfy_sub_cache[(POINTER_TO_UINT(attr) / sizeof(*attr)) %
+			      ARRAY_SIZE(nfy_sub_cache)];
+}
+#endif /* CONFIG_BT_GATT_NOTIFY_MULTIPLE_CACHE_SIZE > 0 */
+
+/* Look up the value handle and the CCC descriptor of a characteristic the
+ * same way as bt_gatt_notify_cb() does.
+ */
+static int gatt_nfy_sub_get(const struct bt_gatt_attr *attr, struct gatt_nfy_sub *sub)
+{
+	struct notify_data data;
+
+#if (CONFIG_BT_GATT_NOTIFY_MULTIPLE_CACHE_SIZE > 0)
+	struct gatt_nfy_sub *entry = nfy_sub_cache_entry(attr);
+
+	if (entry->attr == attr) {
+		*sub = *entry;
+		return 0;
+	}
+#endif /* CONFIG_BT_GATT_NOTIFY_MULTIPLE_CACHE_SIZE > 0 */
+
+	data.attr = attr;
+	data.handle = bt_gatt_attr_get_handle(attr);
+	if (!data.handle) {
+		return -EINVAL;
+	}
+
+	/* Check if attribute is a characteristic then adjust the handle */
+	if (!bt_uuid_cmp(attr->uuid, BT_UUID_GATT_CHRC)) {
+		struct bt_gatt_chrc *chrc = attr->user_data;
+
+		if (!(chrc->properties & BT_GATT_CHRC_NOTIFY)) {
+			return -EINVAL;
+		}
+
+		data.handle = bt_gatt_attr_value_handle(attr);
+	}
+
+	sub->attr = attr;
+	sub->handle = data.handle;
+
+	if (!gatt_find_by_uuid(&data, BT_UUID_GATT_CCC) ||
+	    data.attr->write != bt_gatt_attr_write_ccc) {
+		return -EINVAL;
+	}
+
+	sub->ccc = data.attr;
+
+#if (CONFIG_BT_GATT_NOTIFY_MULTIPLE_CACHE_SIZE > 0)
+	*entry = *sub;
+#endif /* CONFIG_BT_GATT_NOTIFY_MULTIPLE_CACHE_SIZE > 0 */
+
+	return 0;
+}
+
+static bool gatt_nfy_sub_match(struct bt_conn *conn, const struct gatt_nfy_sub *sub)
+{
+	const struct _bt_gatt_ccc *ccc = sub->ccc->user_data;
+
+	/* Confirm match if cfg is managed by application */
+	if (ccc->cfg_match && !ccc->cfg_match(conn, sub->ccc)) {
+		return false;
+	}
+
+	for (size_t i = 0; i < ARRAY_SIZE(ccc->cfg); i++) {
+		const struct bt_gatt_ccc_cfg *cfg = &ccc->cfg[i];
+
+		if ((cfg->value & BT_GATT_CCC_NOTIFY) &&
+		    bt_conn_is_peer_addr_le(conn, cfg->id, &cfg->peer)) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+struct notify_mult_data {
+	struct bt_gatt_notify_params *params;
+	uint16_t num_params;
+	/* Peers sent at least one of the values */
+	uint8_t sent;
+	int err;
+};
+
+/* Send the values a peer is subscribed to, in as few PDUs as its MTU
+ * allows, or one by one if it doesn't support multiple notifications.
+ */
+static int notify_mult_conn(struct bt_conn *conn, struct notify_mult_data *data)
+{
+	struct net_buf *buf = NULL;
+	bool mult = gatt_cf_notify_multi(conn);
+	uint16_t mtu = bt_att_get_mtu(conn);
+	int count = 0;
+	int err = 0;
+
+	if (mult) {
+		/* Send any outstanding notifications first */
+		gatt_notify_flush(conn);
+	}
+
+	for (uint16_t i = 0; i < data->num_params; i++) {
+		struct bt_gatt_notify_params *params = &data->params[i];
+		size_t len = sizeof(struct bt_att_notify_mult) + params->len;
+		struct gatt_nfy_sub sub;
+
+		err = gatt_nfy_sub_get(params->attr, &sub);
+		if (err) {
+			break;
+		}
+
+		if (!gatt_nfy_sub_match(conn, &sub)) {
+			continue;
+		}
+
+		if (bt_gatt_check_perm(conn, params->attr, BT_GATT_PERM_READ_ENCRYPT_MASK)) {
+			LOG_WRN("Link is not encrypted");
+			continue;
+		}
+
+		if (!mult) {
+			err = gatt_notify(conn, sub.handle, params);
+			if (err) {
+				break;
+			}
+
+			count++;
+			continue;
+		}
+
+		if (1 + len > mtu) {
+			err = -ERANGE;
+			break;
+		}
+
+		/* Send the PDU once it is full and start a new one */
+		if (buf && (buf->len + len > mtu || net_buf_tailroom(buf) < len)) {
+			err = gatt_notify_mult_send(conn, buf);
+			buf = NULL;
+			if (err < 0) {
+				break;
+			}
+		}
+
+		if (!buf) {
+			buf = bt_att_create_pdu(conn, BT_ATT_OP_NOTIFY_MULT, len);
+			if (!buf) {
+				err = -ENOMEM;
+				break;
+			}
+
+			bt_att_set_tx_meta_data(buf, params->func, params->user_data,
+						BT_ATT_CHAN_OPT(params));
+		} else {
+			bt_att_increment_tx_meta_data_attr_count(buf, 1);
+		}
+
+		gatt_add_nfy_to_buf(buf, sub.handle, params);
+		count++;
+	}
+
+	/* Whatever was added to the PDU goes out, even after an error */
+	if (buf) {
+		int ret = gatt_notify_mult_send(conn, buf);
+
+		if (!err) {
+			err = ret;
+		}
+	}
+
+	if (err < 0) {
+		return err;
+	}
+
+	return count;
+}
+
+static void notify_mult_all(struct bt_conn *conn, void *user_data)
+{
+	struct notify_mult_data *data = user_data;
+	int ret;
+
+	if (conn->state != BT_CONN_CONNECTED) {
+		return;
+	}
+
+#if defined(CONFIG_BT_GATT_ENFORCE_CHANGE_UNAWARE)
+	if (!bt_gatt_change_aware(conn, false)) {
+		return;
+	}
+#endif
+
+	if (IS_ENABLED(CONFIG_BT_EATT) &&
+	    !bt_att_chan_opt_valid(conn, BT_ATT_CHAN_OPT(data->params))) {
+		return;
+	}
+
+	/* A failure with one peer does not keep the others from being
+	 * notified, the error is only reported if no peer was.
+	 */
+	ret = notify_mult_conn(conn, data);
+	if (ret < 0) {
+		LOG_DBG("Notifying %p failed (err %d)", conn, ret);
+		data->err = ret;
+	} else if (ret > 0) {
+		data->sent++;
+	}
+}
+
+static int gatt_notify_multiple_all(uint16_t num_params,
+				    struct bt_gatt_notify_params params[])
+{
+	struct notify_mult_data data = {
+		.params = params,
+		.num_params = num_params,
+		.err = -ENOTCONN,
+	};
+
+	for (uint16_t i = 0; i < num_params; i++) {
+		/* The current implementation requires the same callbacks and
+		 * user_data.
+		 */
+		if ((params[0].func != params[i].func) ||
+		    (params[0].user_data != params[i].user_data)) {
+			return -EINVAL;
+		}
+
+		/* This API doesn't support passing UUIDs. */
+		if (params[i].uuid) {
+			return -EINVAL;
+		}
+	}
+
+	/* Each peer gets the values it is subscribed to. The subscribers of
+	 * the characteristics are found from the peers, which only takes
+	 * address comparisons once the CCC descriptors are cached.
+	 */
+	bt_conn_foreach(BT_CONN_TYPE_LE, notify_mult_all, &data);
+
+	if (data.sent > 0) {
+		return 0;
+	}
+
+	return data.err;
+}
+
 int bt_gatt_notify_multiple(struct bt_conn *conn,
 			    uint16_t num_params,
 			    struct bt_gatt_notify_params params[])
@@ -2958,6 +3637,10 @@ int bt_gatt_notify_multiple(struct bt_conn *conn,
 		return err;
 	}
 
+	if (!conn) {
+		return gatt_notify_multiple_all(num_params, params);
+	}
+
 	/* Validate all the attributes that we want to notify.
 	 * Also gets us the total length of the PDU as a side-effect.
 	 */
@@ -6093,14 +6776,21 @@ BT_SETTINGS_DEFINE(cf, "cf", cf_set, NULL);
 static int db_hash_set(const char *name, size_t len_rd,
 		       settings_read_cb read_cb, void *cb_arg)
 {
+	struct db_hash_storage storage = {};
 	ssize_t len;
 
-	len = read_cb(cb_arg, db_hash.stored_hash, sizeof(db_hash.stored_hash));
+	len = read_cb(cb_arg, &storage, sizeof(storage));
 	if (len < 0) {
 		LOG_ERR("Failed to decode value (err %zd)", len);
 		return len;
 	}
 
+	memcpy(db_hash.stored_hash, storage.hash, sizeof(db_hash.stored_hash));
+
+	/* Older versions only stored the hash */
+	db_hash.stored_crc = storage.crc;
+	db_hash.stored_crc_valid = (len == sizeof(storage));
+
 	LOG_HEXDUMP_DBG(db_hash.stored_hash, sizeof(db_hash.stored_hash), "Stored Hash: ");
 
 	return 0;
@@ -153,6 +153,12 @@ struct bt_le_ext_adv {
 
 	/* TX Power in use by the controller */
 	int8_t                    tx_power;
+
+	/* Digest of the advertising and scan response data last written to
+	 * the controller, zero if unknown.
+	 */
+	uint64_t                  ad_digest;
+	uint64_t                  sd_digest;
 #endif /* defined(CONFIG_BT_EXT_ADV) */
 
 	struct k_work_delayable	lim_adv_timeout_work;
@@ -36,6 +36,28 @@ LOG_MODULE_REGISTER(bt_keys);
 
 static struct bt_keys key_pool[CONFIG_BT_MAX_PAIRED];
 
+/* Index of key_pool by identity and address, using open addressing. An
+ * entry holds the pool slot plus one, zero marks a free entry. Entries are
+ * checked against the pool when looked up, so an entry going stale when its
+ * slot is cleared or reused is harmless. The index is rebuilt from the pool
+ * once stale entries have filled it up.
+ */
+#define KEYS_INDEX_SIZE (2 * CONFIG_BT_MAX_PAIRED + 1)
+
+static uint8_t keys_index[KEYS_INDEX_SIZE];
+
+#if CONFIG_BT_KEYS_RPA_CACHE_SIZE > 0
+/* Recently seen RPAs that none of the stored IRKs resolve */
+struct rpa_miss {
+	bt_addr_t rpa;
+	uint8_t id;
+	bool valid;
+	uint32_t timestamp;
+};
+
+static struct rpa_miss rpa_miss_cache[CONFIG_BT_KEYS_RPA_CACHE_SIZE];
+#endif /* CONFIG_BT_KEYS_RPA_CACHE_SIZE > 0 */
+
 #define BT_KEYS_STORAGE_LEN_COMPAT (BT_KEYS_STORAGE_LEN - sizeof(uint32_t))
 
 #if defined(CONFIG_BT_KEYS_OVERWRITE_OLDEST)
@@ -80,6 +102,123 @@ static bool key_is_in_use(uint8_t id)
 }
 #endif /* CONFIG_BT_KEYS_OVERWRITE_OLDEST */
 
+static size_t keys_index_hash(uint8_t id, const bt_addr_le_t *addr)
+{
+	/* FNV-1a */
+	uint32_t hash = 2166136261U;
+
+	hash = (hash ^ id) * 16777619U;
+	hash = (hash ^ addr->type) * 16777619U;
+
+	for (size_t i = 0; i < sizeof(addr->a.val); i++) {
+		hash = (hash ^ addr->a.val[i]) * 16777619U;
+	}
+
+	return hash % KEYS_INDEX_SIZE;
+}
+
+static bool keys_index_add(struct bt_keys *keys)
+{
+	size_t pos = keys_index_hash(keys->id, &keys->addr);
+
+	for (size_t i = 0; i < KEYS_INDEX_SIZE; i++) {
+		if (keys_index[pos] == 0U) {
+			keys_index[pos] = (keys - key_pool) + 1;
+			return true;
+		}
+
+		pos = (pos + 1) % KEYS_INDEX_SIZE;
+	}
+
+	return false;
+}
+
+static void keys_index_rebuild(void)
+{
+	(void)memset(keys_index, 0, sizeof(keys_index));
+
+	for (size_t i = 0; i < ARRAY_SIZE(key_pool); i++) {
+		if (!bt_addr_le_eq(&key_pool[i].addr, BT_ADDR_LE_ANY)) {
+			(void)keys_index_add(&key_pool[i]);
+		}
+	}
+}
+
+static void keys_index_insert(struct bt_keys *keys)
+{
+	if (!keys_index_add(keys)) {
+		/* The index is larger than the pool, so only stale entries can
+		 * have filled it. The rebuilt index includes the new keys.
+		 */
+		keys_index_rebuild();
+	}
+}
+
+static struct bt_keys *keys_index_find(uint8_t id, const bt_addr_le_t *addr)
+{
+	size_t pos = keys_index_hash(id, addr);
+
+	for (size_t i = 0; i < KEYS_INDEX_SIZE && keys_index[pos] != 0U; i++) {
+		struct bt_keys *keys = &key_pool[keys_index[pos] - 1];
+
+		if (keys->id == id && bt_addr_le_eq(&keys->addr, addr)) {
+			return keys;
+		}
+
+		pos = (pos + 1) % KEYS_INDEX_SIZE;
+	}
+
+	return NULL;
+}
+
+#if CONFIG_BT_KEYS_RPA_CACHE_SIZE > 0
+static struct rpa_miss *rpa_miss_get(const bt_addr_t *rpa)
+{
+	/* The lower 24 bits of an RPA are a hash, they are as good as random */
+	return &rpa_miss_cache[sys_get_le24(rpa->val) % ARRAY_SIZE(rpa_miss_cache)];
+}
+
+static bool rpa_miss_find(uint8_t id, const bt_addr_t *rpa)
+{
+	struct rpa_miss *miss = rpa_miss_get(rpa);
+
+	if (!miss->valid || miss->id != id || !bt_addr_eq(&miss->rpa, rpa)) {
+		return false;
+	}
+
+	if ((k_uptime_get_32() - miss->timestamp) >=
+	    (CONFIG_BT_KEYS_RPA_CACHE_TIMEOUT * MSEC_PER_SEC)) {
+		miss->valid = false;
+		return false;
+	}
+
+	return true;
+}
+
+static void rpa_miss_add(uint8_t id, const bt_addr_t *rpa)
+{
+	struct rpa_miss *miss = rpa_miss_get(rpa);
+
+	bt_addr_copy(&miss->rpa, rpa);
+	miss->id = id;
+	miss->timestamp = k_uptime_get_32();
+	miss->valid = true;
+}
+
+static void rpa_miss_clear(void)
+{
+	(void)memset(rpa_miss_cache, 0, sizeof(rpa_miss_cache));
+}
+#else
+static inline bool rpa_miss_find(uint8_t id, const bt_addr_t *rpa)
+{
+	return false;
+}
+
+static inline void rpa_miss_add(uint8_t id, const bt_addr_t *rpa) {}
+static inline void rpa_miss_clear(void) {}
+#endif /* CONFIG_BT_KEYS_RPA_CACHE_SIZE > 0 */
+
 struct bt_keys *bt_keys_get_addr(uint8_t id, const bt_addr_le_t *addr)
 {
 	struct bt_keys *keys;
@@ -90,15 +229,15 @@ struct bt_keys *bt_keys_get_addr(uint8_t id, const bt_addr_le_t *addr)
 
 	LOG_DBG("%s", bt_addr_le_str(addr));
 
-	for (i = 0; i < ARRAY_SIZE(key_pool); i++) {
-		keys = &key_pool[i];
+	keys = keys_index_find(id, addr);
+	if (keys) {
+		return keys;
+	}
 
-		if (keys->id == id && bt_addr_le_eq(&keys->addr, addr)) {
-			return keys;
-		}
-		if (first_free_slot == ARRAY_SIZE(key_pool) &&
-		    bt_addr_le_eq(&keys->addr, BT_ADDR_LE_ANY)) {
+	for (i = 0; i < ARRAY_SIZE(key_pool); i++) {
+		if (bt_addr_le_eq(&key_pool[i].addr, BT_ADDR_LE_ANY)) {
 			first_free_slot = i;
+			break;
 		}
 	}
 
@@ -138,6 +277,7 @@ struct bt_keys *bt_keys_get_addr(uint8_t id, const bt_addr_le_t *addr)
 		keys = &key_pool[first_free_slot];
 		keys->id = id;
 		bt_addr_le_copy(&keys->addr, addr);
+		keys_index_insert(keys);
 #if defined(CONFIG_BT_KEYS_OVERWRITE_OLDEST)
 		keys->aging_counter = ++aging_counter_val;
 		last_keys_updated = keys;
@@ -187,17 +327,15 @@ void bt_keys_foreach_type(enum bt_keys_type type, void (*func)(struct bt_keys *k
 
 struct bt_keys *bt_keys_find(enum bt_keys_type type, uint8_t id, const bt_addr_le_t *addr)
 {
-	int i;
+	struct bt_keys *keys;
 
 	__ASSERT_NO_MSG(addr != NULL);
 
 	LOG_DBG("type %d %s", type, bt_addr_le_str(addr));
 
-	for (i = 0; i < ARRAY_SIZE(key_pool); i++) {
-		if ((key_pool[i].keys & type) && key_pool[i].id == id &&
-		    bt_addr_le_eq(&key_pool[i].addr, addr)) {
-			return &key_pool[i];
-		}
+	keys = keys_index_find(id, addr);
+	if (keys && (keys->keys & type)) {
+		return keys;
 	}
 
 	return NULL;
@@ -251,6 +389,11 @@ struct bt_keys *bt_keys_find_irk(uint8_t id, const bt_addr_le_t *addr)
 		}
 	}
 
+	if (rpa_miss_find(id, &addr->a)) {
+		LOG_DBG("No IRK for %s (cached)", bt_addr_le_str(addr));
+		return NULL;
+	}
+
 	for (i = 0; i < ARRAY_SIZE(key_pool); i++) {
 		if (!(key_pool[i].keys & BT_KEYS_IRK)) {
 			continue;
@@ -272,34 +415,41 @@ struct bt_keys *bt_keys_find_irk(uint8_t id, const bt_addr_le_t *addr)
 
 	LOG_DBG("No IRK for %s", bt_addr_le_str(addr));
 
+	rpa_miss_add(id, &addr->a);
+
 	return NULL;
 }
 
 struct bt_keys *bt_keys_find_addr(uint8_t id, const bt_addr_le_t *addr)
 {
-	int i;
-
 	__ASSERT_NO_MSG(addr != NULL);
 
 	LOG_DBG("%s", bt_addr_le_str(addr));
 
-	for (i = 0; i < ARRAY_SIZE(key_pool); i++) {
-		if (key_pool[i].id == id &&
-		    bt_addr_le_eq(&key_pool[i].addr, addr)) {
-			return &key_pool[i];
-		}
-	}
-
-	return NULL;
+	return keys_index_find(id, addr);
 }
 
 void bt_keys_add_type(struct bt_keys *keys, enum bt_keys_type type)
 {
 	__ASSERT_NO_MSG(keys != NULL);
 
+	if (type & BT_KEYS_IRK) {
+		/* The new IRK may resolve addresses that no IRK resolved so far */
+		rpa_miss_clear();
+	}
+
 	keys->keys |= type;
 }
 
+void bt_keys_set_addr(struct bt_keys *keys, const bt_addr_le_t *addr)
+{
+	__ASSERT_NO_MSG(keys != NULL);
+	__ASSERT_NO_MSG(addr != NULL);
+
+	bt_addr_le_copy(&keys->addr, addr);
+	keys_index_insert(keys);
+}
+
 void bt_keys_clear(struct bt_keys *keys)
 {
 	__ASSERT_NO_MSG(keys != NULL);
@@ -316,6 +466,8 @@ void bt_keys_clear(struct bt_keys *keys)
 	}
 
 	(void)memset(keys, 0, sizeof(*keys));
+
+	keys_index_rebuild();
 }
 
 #if defined(CONFIG_BT_SETTINGS)
@@ -417,6 +569,10 @@ static int keys_set(const char *name, size_t len_rd, settings_read_cb read_cb,
 		memcpy(keys->storage_start, val, len);
 	}
 
+	if (keys->keys & BT_KEYS_IRK) {
+		rpa_miss_clear();
+	}
+
 	LOG_DBG("Successfully restored keys for %s", bt_addr_le_str(&addr));
 #if defined(CONFIG_BT_KEYS_OVERWRITE_OLDEST)
 	if (aging_counter_val < keys->aging_counter) {
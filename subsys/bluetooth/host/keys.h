@@ -169,6 +169,17 @@ struct bt_keys *bt_keys_find_addr(uint8_t id, const bt_addr_le_t *addr);
  */
 void bt_keys_add_type(struct bt_keys *keys, enum bt_keys_type type);
 
+/**
+ * @brief Change the address of a keys item
+ *
+ * Keys are looked up by address, so their address must only be changed
+ * through this function once they have been created.
+ *
+ * @param keys Keys item to be updated.
+ * @param addr New address of the keys item.
+ */
+void bt_keys_set_addr(struct bt_keys *keys, const bt_addr_le_t *addr);
+
 /**
  * @brief Clear a key contents
  *
@@ -16,6 +16,7 @@
 #include <zephyr/bluetooth/addr.h>
 #include <zephyr/bluetooth/hci.h>
 #include <zephyr/bluetooth/hci_vs.h>
+#include <zephyr/bluetooth/uuid.h>
 
 #include "addr_internal.h"
 #include "hci_core.h"
@@ -32,6 +33,38 @@ LOG_MODULE_REGISTER(bt_scan);
 static bt_le_scan_cb_t *scan_dev_found_cb;
 static sys_slist_t scan_cbs = SYS_SLIST_STATIC_INIT(&scan_cbs);
 
+/* Advertising report filter, compiled from struct bt_le_scan_filter into the
+ * AD types and little endian values to look for in the advertising data.
+ */
+static struct scan_filter {
+	uint8_t options;
+	int8_t rssi;
+	uint8_t company_id[2];
+	/* UUID list types, then Service Data type, for the UUID size */
+	uint8_t uuid_types[3];
+	uint8_t uuid_len;
+	uint8_t uuid[BT_UUID_SIZE_128];
+} scan_filter;
+
+/* Advertiser of the last scannable report that passed the filter. Its scan
+ * response carries the rest of its data and is let through as well.
+ */
+static bt_addr_le_t scan_filter_rsp_addr;
+
+#if defined(CONFIG_BT_SCAN_DEDUP)
+/* Recently delivered advertising reports, stored by hash */
+struct scan_dedup {
+	bt_addr_le_t addr;
+	uint8_t sid;
+	bool valid;
+	uint16_t adv_props;
+	uint32_t hash;
+	uint32_t timestamp;
+};
+
+static struct scan_dedup scan_dedup_table[CONFIG_BT_SCAN_DEDUP_SIZE];
+#endif /* CONFIG_BT_SCAN_DEDUP */
+
 #if defined(CONFIG_BT_EXT_ADV)
 /* A buffer used to reassemble advertisement data from the controller. */
 NET_BUF_SIMPLE_DEFINE(ext_scan_buf, CONFIG_BT_EXT_SCAN_BUF_SIZE);
@@ -403,6 +436,34 @@ failed:
 	bt_conn_unref(conn);
 	bt_le_scan_update(false);
 }
+
+/* Whether a connection waits for a connectable report of its peer, see
+ * check_pending_conn().
+ */
+static bool scan_conn_pending(uint8_t adv_props)
+{
+	struct bt_conn *conn;
+
+	if (atomic_test_bit(bt_dev.flags, BT_DEV_EXPLICIT_SCAN) ||
+	    !(adv_props & BT_HCI_LE_ADV_EVT_TYPE_CONN)) {
+		return false;
+	}
+
+	conn = bt_conn_lookup_state_le(BT_ID_DEFAULT, NULL,
+				       BT_CONN_CONNECTING_SCAN);
+	if (!conn) {
+		return false;
+	}
+
+	bt_conn_unref(conn);
+
+	return true;
+}
+#else
+static inline bool scan_conn_pending(uint8_t adv_props)
+{
+	return false;
+}
 #endif /* CONFIG_BT_CENTRAL */
 
 /* Convert Legacy adv report evt_type field to adv props */
@@ -436,43 +497,179 @@ static uint8_t get_adv_props_legacy(uint8_t evt_type)
 	}
 }
 
-static void le_adv_recv(bt_addr_le_t *addr, struct bt_le_scan_recv_info *info,
-			struct net_buf_simple *buf, uint16_t len)
+static bool scan_filter_uuid_match(uint8_t type, const uint8_t *data, uint8_t len)
 {
-	struct bt_le_scan_cb *listener, *next;
-	struct net_buf_simple_state state;
-	bt_addr_le_t id_addr;
+	const struct scan_filter *filter = &scan_filter;
 
-	LOG_DBG("%s event %u, len %u, rssi %d dBm", bt_addr_le_str(addr), info->adv_type, len,
-		info->rssi);
+	if (type == filter->uuid_types[2]) {
+		/* Service Data starts with the UUID */
+		return len >= filter->uuid_len && !memcmp(data, filter->uuid, filter->uuid_len);
+	}
 
-	if (!IS_ENABLED(CONFIG_BT_PRIVACY) &&
-	    !IS_ENABLED(CONFIG_BT_SCAN_WITH_IDENTITY) &&
-	    atomic_test_bit(bt_dev.flags, BT_DEV_EXPLICIT_SCAN) &&
-	    (info->adv_props & BT_HCI_LE_ADV_PROP_DIRECT)) {
-		LOG_DBG("Dropped direct adv report");
-		return;
+	if (type != filter->uuid_types[0] && type != filter->uuid_types[1]) {
+		return false;
 	}
 
-	if (bt_addr_le_is_resolved(addr)) {
-		bt_addr_le_copy_resolved(&id_addr, addr);
-	} else if (addr->type == BT_HCI_PEER_ADDR_ANONYMOUS) {
-		bt_addr_le_copy(&id_addr, BT_ADDR_LE_ANY);
-	} else {
-		bt_addr_le_copy(&id_addr,
-				bt_lookup_id_addr(BT_ID_DEFAULT, addr));
+	for (uint8_t i = 0; i + filter->uuid_len <= len; i += filter->uuid_len) {
+		if (!memcmp(&data[i], filter->uuid, filter->uuid_len)) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+static bool scan_filter_match(const struct bt_le_scan_recv_info *info, const uint8_t *data,
+			      uint16_t len)
+{
+	const struct scan_filter *filter = &scan_filter;
+	uint8_t matched = 0U;
+
+	if (filter->options & BT_LE_SCAN_FILTER_RSSI) {
+		if (info->rssi == BT_HCI_LE_RSSI_NOT_AVAILABLE || info->rssi < filter->rssi) {
+			return false;
+		}
+
+		matched |= BT_LE_SCAN_FILTER_RSSI;
+	}
+
+	/* Single walk over the AD structures, stopping as soon as everything
+	 * has matched.
+	 */
+	while (matched != filter->options && len > 1) {
+		uint8_t ad_len = data[0];
+
+		/* Early termination, or malformed data */
+		if (ad_len == 0U || ad_len > len - 1) {
+			break;
+		}
+
+		if ((filter->options & BT_LE_SCAN_FILTER_COMPANY_ID) &&
+		    data[1] == BT_DATA_MANUFACTURER_DATA && ad_len > sizeof(filter->company_id) &&
+		    !memcmp(&data[2], filter->company_id, sizeof(filter->company_id))) {
+			matched |= BT_LE_SCAN_FILTER_COMPANY_ID;
+		}
+
+		if ((filter->options & BT_LE_SCAN_FILTER_UUID) &&
+		    scan_filter_uuid_match(data[1], &data[2], ad_len - 1)) {
+			matched |= BT_LE_SCAN_FILTER_UUID;
+		}
+
+		data += ad_len + 1;
+		len -= ad_len + 1;
+	}
+
+	return matched == filter->options;
+}
+
+#if defined(CONFIG_BT_SCAN_DEDUP)
+static uint32_t fnv1a(uint32_t hash, const uint8_t *data, size_t len)
+{
+	for (size_t i = 0; i < len; i++) {
+		hash = (hash ^ data[i]) * 16777619U;
+	}
+
+	return hash;
+}
+
+static uint32_t scan_dedup_hash(const bt_addr_le_t *addr, uint8_t sid, const uint8_t *data,
+				uint16_t len)
+{
+	uint32_t hash = 2166136261U;
+
+	hash = fnv1a(hash, (const uint8_t *)addr, sizeof(*addr));
+	hash = fnv1a(hash, &sid, sizeof(sid));
+
+	return fnv1a(hash, data, len);
+}
+
+static void scan_dedup_clear(void)
+{
+	(void)memset(scan_dedup_table, 0, sizeof(scan_dedup_table));
+}
+
+/* Returns true if the report duplicates a recently delivered one */
+static bool scan_dedup_check(const bt_addr_le_t *addr, const struct bt_le_scan_recv_info *info,
+			     const uint8_t *data, uint16_t len)
+{
+	uint32_t hash = scan_dedup_hash(addr, info->sid, data, len);
+	uint32_t now = k_uptime_get_32();
+	struct scan_dedup *entry = &scan_dedup_table[hash % ARRAY_SIZE(scan_dedup_table)];
+
+	if (entry->valid && entry->hash == hash && entry->sid == info->sid &&
+	    entry->adv_props == info->adv_props && bt_addr_le_eq(&entry->addr, addr) &&
+	    (now - entry->timestamp) < CONFIG_BT_SCAN_DEDUP_TIMEOUT) {
+		return true;
 	}
 
+	bt_addr_le_copy(&entry->addr, addr);
+	entry->sid = info->sid;
+	entry->adv_props = info->adv_props;
+	entry->hash = hash;
+	entry->timestamp = now;
+	entry->valid = true;
+
+	return false;
+}
+#else
+static inline void scan_dedup_clear(void) {}
+
+static inline bool scan_dedup_check(const bt_addr_le_t *addr,
+				    const struct bt_le_scan_recv_info *info,
+				    const uint8_t *data, uint16_t len)
+{
+	return false;
+}
+#endif /* CONFIG_BT_SCAN_DEDUP */
+
+static bool le_adv_filter(const bt_addr_le_t *addr, const struct bt_le_scan_recv_info *info,
+			  const uint8_t *data, uint16_t len)
+{
+	bool match = scan_filter_match(info, data, len);
+
+	if (info->adv_props & BT_GAP_ADV_PROP_SCAN_RESPONSE) {
+		return match || bt_addr_le_eq(addr, &scan_filter_rsp_addr);
+	}
+
+	if (info->adv_props & BT_GAP_ADV_PROP_SCANNABLE) {
+		bt_addr_le_copy(&scan_filter_rsp_addr, match ? addr : BT_ADDR_LE_NONE);
+	}
+
+	return match;
+}
+
+static bool le_adv_accept(const bt_addr_le_t *addr, const struct bt_le_scan_recv_info *info,
+			  const struct net_buf_simple *buf, uint16_t len)
+{
+	if (scan_filter.options && !le_adv_filter(addr, info, buf->data, len)) {
+		return false;
+	}
+
+	if (IS_ENABLED(CONFIG_BT_SCAN_DEDUP) &&
+	    atomic_test_bit(bt_dev.flags, BT_DEV_SCAN_FILTER_DUP) &&
+	    scan_dedup_check(addr, info, buf->data, len)) {
+		return false;
+	}
+
+	return true;
+}
+
+static void le_adv_deliver(const bt_addr_le_t *id_addr, struct bt_le_scan_recv_info *info,
+			   struct net_buf_simple *buf, uint16_t len)
+{
+	struct bt_le_scan_cb *listener, *next;
+	struct net_buf_simple_state state;
+
 	if (scan_dev_found_cb) {
 		net_buf_simple_save(buf, &state);
 
 		buf->len = len;
-		scan_dev_found_cb(&id_addr, info->rssi, info->adv_type, buf);
+		scan_dev_found_cb(id_addr, info->rssi, info->adv_type, buf);
 
 		net_buf_simple_restore(buf, &state);
 	}
 
-	info->addr = &id_addr;
+	info->addr = id_addr;
 
 	SYS_SLIST_FOR_EACH_CONTAINER_SAFE(&scan_cbs, listener, next, node) {
 		if (listener->recv) {
@@ -487,6 +684,44 @@ static void le_adv_recv(bt_addr_le_t *addr, struct bt_le_scan_recv_info *info,
 
 	/* Clear pointer to this stack frame before returning to calling function */
 	info->addr = NULL;
+}
+
+static void le_adv_recv(bt_addr_le_t *addr, struct bt_le_scan_recv_info *info,
+			struct net_buf_simple *buf, uint16_t len)
+{
+	bt_addr_le_t id_addr;
+	bool accept;
+
+	LOG_DBG("%s event %u, len %u, rssi %d dBm", bt_addr_le_str(addr), info->adv_type, len,
+		info->rssi);
+
+	if (!IS_ENABLED(CONFIG_BT_PRIVACY) &&
+	    !IS_ENABLED(CONFIG_BT_SCAN_WITH_IDENTITY) &&
+	    atomic_test_bit(bt_dev.flags, BT_DEV_EXPLICIT_SCAN) &&
+	    (info->adv_props & BT_HCI_LE_ADV_PROP_DIRECT)) {
+		LOG_DBG("Dropped direct adv report");
+		return;
+	}
+
+	accept = le_adv_accept(addr, info, buf, len);
+
+	/* Filtered reports are still needed to connect to pending devices */
+	if (!accept && !scan_conn_pending(info->adv_props)) {
+		return;
+	}
+
+	if (bt_addr_le_is_resolved(addr)) {
+		bt_addr_le_copy_resolved(&id_addr, addr);
+	} else if (addr->type == BT_HCI_PEER_ADDR_ANONYMOUS) {
+		bt_addr_le_copy(&id_addr, BT_ADDR_LE_ANY);
+	} else {
+		bt_addr_le_copy(&id_addr,
+				bt_lookup_id_addr(BT_ID_DEFAULT, addr));
+	}
+
+	if (accept) {
+		le_adv_deliver(&id_addr, info, buf, len);
+	}
 
 #if defined(CONFIG_BT_CENTRAL)
 	check_pending_conn(&id_addr, addr, info->adv_props);
@@ -1484,6 +1719,9 @@ int bt_le_scan_start(const struct bt_le_scan_param *param, bt_le_scan_cb_t cb)
 	atomic_set_bit_to(bt_dev.flags, BT_DEV_SCAN_FILTER_DUP,
 			  param->options & BT_LE_SCAN_OPT_FILTER_DUPLICATE);
 
+	/* The controller restarts duplicate filtering as well */
+	scan_dedup_clear();
+
 #if defined(CONFIG_BT_FILTER_ACCEPT_LIST)
 	atomic_set_bit_to(bt_dev.flags, BT_DEV_SCAN_FILTERED,
 			  param->options & BT_LE_SCAN_OPT_FILTER_ACCEPT_LIST);
@@ -1571,6 +1809,68 @@ void bt_le_scan_cb_unregister(struct bt_le_scan_cb *cb)
 	sys_slist_find_and_remove(&scan_cbs, &cb->node);
 }
 
+int bt_le_scan_filter_set(const struct bt_le_scan_filter *filter)
+{
+	struct scan_filter compiled = { 0 };
+
+	if (atomic_test_bit(bt_dev.flags, BT_DEV_SCANNING)) {
+		return -EBUSY;
+	}
+
+	bt_addr_le_copy(&scan_filter_rsp_addr, BT_ADDR_LE_NONE);
+
+	if (filter == NULL) {
+		scan_filter = compiled;
+		return 0;
+	}
+
+	if (filter->options & ~(BT_LE_SCAN_FILTER_RSSI |
+				BT_LE_SCAN_FILTER_COMPANY_ID |
+				BT_LE_SCAN_FILTER_UUID)) {
+		return -EINVAL;
+	}
+
+	compiled.options = filter->options;
+	compiled.rssi = filter->rssi;
+	sys_put_le16(filter->company_id, compiled.company_id);
+
+	if (filter->options & BT_LE_SCAN_FILTER_UUID) {
+		if (filter->uuid == NULL) {
+			return -EINVAL;
+		}
+
+		switch (filter->uuid->type) {
+		case BT_UUID_TYPE_16:
+			compiled.uuid_types[0] = BT_DATA_UUID16_SOME;
+			compiled.uuid_types[1] = BT_DATA_UUID16_ALL;
+			compiled.uuid_types[2] = BT_DATA_SVC_DATA16;
+			compiled.uuid_len = BT_UUID_SIZE_16;
+			sys_put_le16(BT_UUID_16(filter->uuid)->val, compiled.uuid);
+			break;
+		case BT_UUID_TYPE_32:
+			compiled.uuid_types[0] = BT_DATA_UUID32_SOME;
+			compiled.uuid_types[1] = BT_DATA_UUID32_ALL;
+			compiled.uuid_types[2] = BT_DATA_SVC_DATA32;
+			compiled.uuid_len = BT_UUID_SIZE_32;
+			sys_put_le32(BT_UUID_32(filter->uuid)->val, compiled.uuid);
+			break;
+		case BT_UUID_TYPE_128:
+			compiled.uuid_types[0] = BT_DATA_UUID128_SOME;
+			compiled.uuid_types[1] = BT_DATA_UUID128_ALL;
+			compiled.uuid_types[2] = BT_DATA_SVC_DATA128;
+			compiled.uuid_len = BT_UUID_SIZE_128;
+			memcpy(compiled.uuid, BT_UUID_128(filter->uuid)->val, BT_UUID_SIZE_128);
+			break;
+		default:
+			return -EINVAL;
+		}
+	}
+
+	scan_filter = compiled;
+
+	return 0;
+}
+
 #if defined(CONFIG_BT_PER_ADV_SYNC)
 uint8_t bt_le_per_adv_sync_get_index(struct bt_le_per_adv_sync *per_adv_sync)
 {
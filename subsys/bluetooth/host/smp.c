@@ -3898,7 +3898,7 @@ static uint8_t smp_ident_addr_info(struct bt_smp *smp, struct net_buf *buf)
 				bt_conn_foreach(BT_CONN_TYPE_LE,
 						convert_to_id_on_match,
 						&addr_match);
-				bt_addr_le_copy(&keys->addr, &req->addr);
+				bt_keys_set_addr(keys, &req->addr);
 
 				bt_conn_identity_resolved(conn);
 			}
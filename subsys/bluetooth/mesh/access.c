@@ -993,6 +993,110 @@ static void mod_init(struct bt_mesh_model *mod, struct bt_mesh_elem *elem,
 	}
 }
 
+#if CONFIG_BT_MESH_ACCESS_OP_TABLE_SIZE > 0
+/* OpCodes of all models, sorted by OpCode and element index. Entries with the
+ * same OpCode and element keep their composition order, so the first of them
+ * is the model that the linear lookup in find_op() would pick.
+ */
+static struct op_entry {
+	const struct bt_mesh_model_op *op;
+	struct bt_mesh_model *mod;
+} op_table[CONFIG_BT_MESH_ACCESS_OP_TABLE_SIZE];
+
+/* Number of entries in op_table, or 0 if the table is not in use. */
+static size_t op_table_len;
+
+static int op_entry_cmp(uint32_t opcode, uint8_t elem_idx, const struct op_entry *entry)
+{
+	if (opcode != entry->op->opcode) {
+		return opcode < entry->op->opcode ? -1 : 1;
+	}
+
+	return (int)elem_idx - (int)entry->mod->elem_idx;
+}
+
+static void op_table_add(struct bt_mesh_model *mod, struct bt_mesh_elem *elem,
+			 bool vnd, bool primary, void *user_data)
+{
+	const struct bt_mesh_model_op *op;
+	bool *overflow = user_data;
+	size_t i;
+
+	for (op = mod->op; op->func && !*overflow; op++) {
+		/* Skip OpCodes that find_op() never looks up in this model. */
+		if ((BT_MESH_MODEL_OP_LEN(op->opcode) < 3) == vnd) {
+			continue;
+		}
+
+		if (IS_ENABLED(CONFIG_BT_MESH_MODEL_VND_MSG_CID_FORCE) && vnd &&
+		    (uint16_t)(op->opcode & 0xffff) != mod->vnd.company) {
+			continue;
+		}
+
+		if (op_table_len == ARRAY_SIZE(op_table)) {
+			*overflow = true;
+			return;
+		}
+
+		/* Insertion sort keeps equal keys in composition order. */
+		for (i = op_table_len++;
+		     i > 0 && op_entry_cmp(op->opcode, mod->elem_idx, &op_table[i - 1]) < 0;
+		     i--) {
+			op_table[i] = op_table[i - 1];
+		}
+
+		op_table[i].op = op;
+		op_table[i].mod = mod;
+	}
+}
+
+static void op_table_build(void)
+{
+	bool overflow = false;
+
+	op_table_len = 0;
+
+	bt_mesh_model_foreach(op_table_add, &overflow);
+
+	if (overflow) {
+		LOG_WRN("Too many OpCodes for the dispatch table, increase "
+			"CONFIG_BT_MESH_ACCESS_OP_TABLE_SIZE");
+		op_table_len = 0;
+	}
+}
+
+static const struct bt_mesh_model_op *op_table_find(struct bt_mesh_elem *elem,
+						    uint32_t opcode,
+						    struct bt_mesh_model **model)
+{
+	uint8_t elem_idx = elem - dev_comp->elem;
+	size_t lo = 0;
+	size_t hi = op_table_len;
+
+	while (lo < hi) {
+		size_t mid = lo + (hi - lo) / 2;
+
+		if (op_entry_cmp(opcode, elem_idx, &op_table[mid]) > 0) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
+	}
+
+	if (lo < op_table_len && op_entry_cmp(opcode, elem_idx, &op_table[lo]) == 0) {
+		*model = op_table[lo].mod;
+		return op_table[lo].op;
+	}
+
+	*model = NULL;
+	return NULL;
+}
+#else
+static inline void op_table_build(void)
+{
+}
+#endif /* CONFIG_BT_MESH_ACCESS_OP_TABLE_SIZE > 0 */
+
 int bt_mesh_comp_register(const struct bt_mesh_comp *comp)
 {
 	int err;
@@ -1012,6 +1116,10 @@ int bt_mesh_comp_register(const struct bt_mesh_comp *comp)
 
 	bt_mesh_model_foreach(mod_init, &err);
 
+	if (!err) {
+		op_table_build();
+	}
+
 	if (IS_ENABLED(CONFIG_BT_MESH_COMP_PAGE_1)) {
 		int i;
 
@@ -1337,6 +1445,12 @@ static const struct bt_mesh_model_op *find_op(struct bt_mesh_elem *elem,
 	uint32_t cid = UINT32_MAX;
 	struct bt_mesh_model *models;
 
+#if CONFIG_BT_MESH_ACCESS_OP_TABLE_SIZE > 0
+	if (op_table_len) {
+		return op_table_find(elem, opcode, model);
+	}
+#endif
+
 	/* SIG models cannot contain 3-byte (vendor) OpCodes, and
 	 * vendor models cannot contain SIG (1- or 2-byte) OpCodes, so
 	 * we only need to do the lookup in one of the model lists.
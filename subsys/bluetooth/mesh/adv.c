@@ -71,12 +71,23 @@ static void bt_mesh_adv_send_end(int err, struct bt_mesh_adv const *adv)
 	}
 }
 
+#if defined(CONFIG_BT_MESH_RELAY_ADAPTIVE_RETRANSMIT)
+/* Number of relay buffers currently allocated. */
+static atomic_t relay_buf_used;
+#endif
+
 static void adv_buf_destroy(struct net_buf *buf)
 {
 	struct bt_mesh_adv adv = *BT_MESH_ADV(buf);
 
 	net_buf_destroy(buf);
 
+#if defined(CONFIG_BT_MESH_RELAY_ADAPTIVE_RETRANSMIT)
+	if (adv.tag & BT_MESH_RELAY_ADV) {
+		atomic_dec(&relay_buf_used);
+	}
+#endif
+
 	bt_mesh_adv_send_end(0, &adv);
 }
 
@@ -133,15 +144,45 @@ static struct net_buf *bt_mesh_adv_create_from_pool(struct net_buf_pool *buf_poo
 	return buf;
 }
 
+#if defined(CONFIG_BT_MESH_RELAY_ADAPTIVE_RETRANSMIT)
+uint8_t bt_mesh_adv_relay_xmit_adapt(uint8_t xmit)
+{
+#if CONFIG_BT_MESH_RELAY_BUF_COUNT > 1
+	/* Relay buffers left once the message has taken one */
+	uint32_t left = CONFIG_BT_MESH_RELAY_BUF_COUNT - 1 -
+			MIN(atomic_get(&relay_buf_used), CONFIG_BT_MESH_RELAY_BUF_COUNT - 1);
+	uint8_t count = BT_MESH_TRANSMIT_COUNT(xmit);
+
+	/* Round up, so that a short backlog keeps the configured count, and
+	 * only the message taking the last buffer is sent once.
+	 */
+	count = DIV_ROUND_UP(count * left, CONFIG_BT_MESH_RELAY_BUF_COUNT - 1);
+
+	return (xmit & ~BIT_MASK(3)) | count;
+#else
+	return xmit;
+#endif
+}
+#endif /* CONFIG_BT_MESH_RELAY_ADAPTIVE_RETRANSMIT */
+
 struct net_buf *bt_mesh_adv_create(enum bt_mesh_adv_type type,
 				   enum bt_mesh_adv_tag tag,
 				   uint8_t xmit, k_timeout_t timeout)
 {
 #if defined(CONFIG_BT_MESH_RELAY)
 	if (tag & BT_MESH_RELAY_ADV) {
-		return bt_mesh_adv_create_from_pool(&relay_buf_pool,
-						    adv_relay_pool, type,
-						    tag, xmit, timeout);
+		struct net_buf *buf;
+
+		buf = bt_mesh_adv_create_from_pool(&relay_buf_pool,
+						   adv_relay_pool, type,
+						   tag, xmit, timeout);
+#if defined(CONFIG_BT_MESH_RELAY_ADAPTIVE_RETRANSMIT)
+		if (buf) {
+			atomic_inc(&relay_buf_used);
+		}
+#endif
+
+		return buf;
 	}
 #endif
 
@@ -158,6 +199,11 @@ struct net_buf *bt_mesh_adv_create(enum bt_mesh_adv_type type,
 }
 
 #if CONFIG_BT_MESH_RELAY_ADV_SETS || CONFIG_BT_MESH_ADV_EXT_FRIEND_SEPARATE
+#if defined(CONFIG_BT_MESH_ADV_EXT_RELAY_USING_MAIN_ADV_SET)
+/* Whether the main advertising set checks the relay queue first next time. */
+static bool relay_first;
+#endif
+
 static struct net_buf *process_events(struct k_poll_event *ev, int count)
 {
 	for (; count; ev++, count--) {
@@ -199,7 +245,27 @@ struct net_buf *bt_mesh_adv_buf_get(k_timeout_t timeout)
 		return NULL;
 	}
 
+#if defined(CONFIG_BT_MESH_ADV_EXT_RELAY_USING_MAIN_ADV_SET)
+	/* Take turns between the local and the relay queue, so that a busy
+	 * relay can't hold back local messages on the main advertising set,
+	 * and the other way around.
+	 */
+	struct net_buf *buf = NULL;
+
+	if (relay_first) {
+		buf = process_events(&events[1], 1);
+	}
+
+	if (!buf) {
+		buf = process_events(events, ARRAY_SIZE(events));
+	}
+
+	relay_first = buf && !(BT_MESH_ADV(buf)->tag & BT_MESH_RELAY_ADV);
+
+	return buf;
+#else
 	return process_events(events, ARRAY_SIZE(events));
+#endif
 }
 
 struct net_buf *bt_mesh_adv_buf_get_by_tag(uint8_t tag, k_timeout_t timeout)
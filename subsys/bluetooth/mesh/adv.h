@@ -55,6 +55,11 @@ struct net_buf *bt_mesh_adv_create(enum bt_mesh_adv_type type,
 void bt_mesh_adv_send(struct net_buf *buf, const struct bt_mesh_send_cb *cb,
 		      void *cb_data);
 
+/* Scale the Relay Retransmit Count in xmit with the share of relay buffers
+ * that are still free, so that a relay backlog drains instead of growing.
+ */
+uint8_t bt_mesh_adv_relay_xmit_adapt(uint8_t xmit);
+
 struct net_buf *bt_mesh_adv_buf_get(k_timeout_t timeout);
 
 struct net_buf *bt_mesh_adv_buf_get_by_tag(uint8_t tag, k_timeout_t timeout);
@@ -200,6 +200,7 @@ static void friend_clear(struct bt_mesh_friend *frnd)
 
 	frnd->counter++;
 	frnd->subnet = NULL;
+	bt_mesh_net_cred_nid_invalidate();
 	frnd->established = 0U;
 	frnd->pending_buf = 0U;
 	frnd->fsn = 0U;
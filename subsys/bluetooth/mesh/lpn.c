@@ -281,6 +281,7 @@ static void clear_friendship(bool force, bool disable)
 	lpn->established = 0U;
 	lpn->clear_success = 0U;
 	lpn->sub = NULL;
+	bt_mesh_net_cred_nid_invalidate();
 
 	group_zero(lpn->added);
 	group_zero(lpn->pending);
@@ -687,6 +688,7 @@ int bt_mesh_lpn_friend_offer(struct bt_mesh_net_rx *rx,
 		lpn->frnd = BT_MESH_ADDR_UNASSIGNED;
 		lpn->recv_win = 0U;
 		lpn->queue_size = 0U;
+		bt_mesh_net_cred_nid_invalidate();
 		return err;
 	}
 
@@ -76,11 +76,25 @@ struct iv_val {
 	      iv_duration:7;
 } __packed;
 
-static struct {
-	uint32_t src : 15, /* MSb of source is always 0 */
-	      seq : 17;
-} msg_cache[CONFIG_BT_MESH_MSG_CACHE_SIZE];
-static uint16_t msg_cache_next;
+/* Twice the cache size, so that probe sequences in the index stay short */
+#define FIFO_CACHE_INDEX_SIZE (2 * CONFIG_BT_MESH_MSG_CACHE_SIZE)
+
+/* Fixed size FIFO of 32-bit keys with an open addressing index for lookups.
+ * The index holds the slot of a key plus one, zero marks a free entry.
+ */
+struct fifo_cache {
+	uint32_t keys[CONFIG_BT_MESH_MSG_CACHE_SIZE];
+	uint16_t index[FIFO_CACHE_INDEX_SIZE];
+	uint16_t next;
+};
+
+/* Network message cache, keyed by the source address (MSb is always 0) and
+ * the 17 least significant bits of the sequence number.
+ */
+#define MSG_CACHE_KEY(src, seq) \
+	((((uint32_t)(src) & BIT_MASK(15)) << 17) | ((seq) & BIT_MASK(17)))
+
+static struct fifo_cache msg_cache;
 
 /* Singleton network context (the implementation only supports one) */
 struct bt_mesh_net bt_mesh = {
@@ -115,62 +129,129 @@ K_MEM_SLAB_DEFINE(loopback_buf_pool,
 		  sizeof(struct loopback_buf),
 		  CONFIG_BT_MESH_LOOPBACK_BUFS, __alignof__(struct loopback_buf));
 
-static uint32_t dup_cache[CONFIG_BT_MESH_MSG_CACHE_SIZE];
-static int   dup_cache_next;
+static struct fifo_cache dup_cache;
 
-static bool check_dup(struct net_buf_simple *data)
+static uint32_t fifo_cache_hash(uint32_t key)
 {
-	const uint8_t *tail = net_buf_simple_tail(data);
-	uint32_t val;
-	int i;
+	/* MurmurHash3 finalizer, spreads sequential keys over the index */
+	key ^= key >> 16;
+	key *= 0x85ebca6bU;
+	key ^= key >> 13;
+	key *= 0xc2b2ae35U;
+	key ^= key >> 16;
+
+	return key % FIFO_CACHE_INDEX_SIZE;
+}
 
-	val = sys_get_be32(tail - 4) ^ sys_get_be32(tail - 8);
+static uint32_t fifo_cache_index_next(uint32_t pos)
+{
+	return (pos + 1) % FIFO_CACHE_INDEX_SIZE;
+}
 
-	for (i = dup_cache_next; i > 0;) {
-		if (dup_cache[--i] == val) {
-			return true;
-		}
-	}
+static bool fifo_cache_has(const struct fifo_cache *cache, uint32_t key)
+{
+	uint32_t pos;
 
-	for (i = ARRAY_SIZE(dup_cache); i > dup_cache_next;) {
-		if (dup_cache[--i] == val) {
+	/* The index is never more than half full, so there is always a free
+	 * entry to end the probe sequence.
+	 */
+	for (pos = fifo_cache_hash(key); cache->index[pos] != 0U;
+	     pos = fifo_cache_index_next(pos)) {
+		if (cache->keys[cache->index[pos] - 1] == key) {
 			return true;
 		}
 	}
 
-	dup_cache_next %= ARRAY_SIZE(dup_cache);
-	dup_cache[dup_cache_next++] = val;
-
 	return false;
 }
 
-static bool msg_cache_match(struct net_buf_simple *pdu)
+static void fifo_cache_index_remove(struct fifo_cache *cache, uint16_t slot)
 {
-	uint16_t i;
+	uint32_t pos = fifo_cache_hash(cache->keys[slot]);
+	uint32_t i;
 
-	for (i = msg_cache_next; i > 0U;) {
-		if (msg_cache[--i].src == SRC(pdu->data) &&
-		    msg_cache[i].seq == (SEQ(pdu->data) & BIT_MASK(17))) {
-			return true;
+	while (cache->index[pos] != slot + 1) {
+		if (cache->index[pos] == 0U) {
+			/* Slot is not in use */
+			return;
 		}
+
+		pos = fifo_cache_index_next(pos);
 	}
 
-	for (i = ARRAY_SIZE(msg_cache); i > msg_cache_next;) {
-		if (msg_cache[--i].src == SRC(pdu->data) &&
-		    msg_cache[i].seq == (SEQ(pdu->data) & BIT_MASK(17))) {
-			return true;
+	/* Backward shift deletion: move following entries of the probe
+	 * sequence into the hole unless their home position lies after it.
+	 */
+	cache->index[pos] = 0U;
+
+	for (i = fifo_cache_index_next(pos); cache->index[i] != 0U;
+	     i = fifo_cache_index_next(i)) {
+		uint32_t home = fifo_cache_hash(cache->keys[cache->index[i] - 1]);
+
+		if ((i > pos) ? (home <= pos || home > i) :
+				(home <= pos && home > i)) {
+			cache->index[pos] = cache->index[i];
+			cache->index[i] = 0U;
+			pos = i;
 		}
 	}
+}
+
+static void fifo_cache_add(struct fifo_cache *cache, uint32_t key)
+{
+	uint32_t pos;
+
+	cache->next %= ARRAY_SIZE(cache->keys);
+
+	/* Evict the oldest key */
+	fifo_cache_index_remove(cache, cache->next);
+	cache->keys[cache->next] = key;
+
+	for (pos = fifo_cache_hash(key); cache->index[pos] != 0U;
+	     pos = fifo_cache_index_next(pos)) {
+	}
+
+	cache->index[pos] = cache->next + 1;
+	cache->next++;
+}
+
+/* Forget the most recently added key */
+static void fifo_cache_rewind(struct fifo_cache *cache)
+{
+	if (cache->next == 0U) {
+		return;
+	}
+
+	cache->next--;
+	fifo_cache_index_remove(cache, cache->next);
+	cache->keys[cache->next] = 0U;
+}
+
+static bool check_dup(struct net_buf_simple *data)
+{
+	const uint8_t *tail = net_buf_simple_tail(data);
+	uint32_t val;
+
+	val = sys_get_be32(tail - 4) ^ sys_get_be32(tail - 8);
+
+	if (fifo_cache_has(&dup_cache, val)) {
+		return true;
+	}
+
+	fifo_cache_add(&dup_cache, val);
 
 	return false;
 }
 
+static bool msg_cache_match(struct net_buf_simple *pdu)
+{
+	return fifo_cache_has(&msg_cache,
+			      MSG_CACHE_KEY(SRC(pdu->data), SEQ(pdu->data)));
+}
+
 static void msg_cache_add(struct bt_mesh_net_rx *rx)
 {
-	msg_cache_next %= ARRAY_SIZE(msg_cache);
-	msg_cache[msg_cache_next].src = rx->ctx.addr;
-	msg_cache[msg_cache_next].seq = rx->seq;
-	msg_cache_next++;
+	fifo_cache_add(&msg_cache, MSG_CACHE_KEY(rx->ctx.addr, rx->seq));
 }
 
 static void store_iv(bool only_duration)
@@ -214,8 +295,7 @@ int bt_mesh_net_create(uint16_t idx, uint8_t flags, const struct bt_mesh_key *ke
 		return err;
 	}
 
-	(void)memset(msg_cache, 0, sizeof(msg_cache));
-	msg_cache_next = 0U;
+	(void)memset(&msg_cache, 0, sizeof(msg_cache));
 
 	bt_mesh.iv_index = iv_index;
 	atomic_set_bit_to(bt_mesh.flags, BT_MESH_IVU_IN_PROGRESS,
@@ -636,6 +716,10 @@ static bool net_decrypt(struct bt_mesh_net_rx *rx, struct net_buf_simple *in,
 	net_buf_simple_reset(out);
 	net_buf_simple_add_mem(out, in->data, in->len);
 
+	if (IS_ENABLED(CONFIG_BT_MESH_STATISTIC)) {
+		bt_mesh_stat_rx_deobfuscate();
+	}
+
 	if (bt_mesh_net_obfuscate(out->data, BT_MESH_NET_IVI_RX(rx),
 				  &cred->privacy)) {
 		return false;
@@ -659,6 +743,10 @@ static bool net_decrypt(struct bt_mesh_net_rx *rx, struct net_buf_simple *in,
 
 	LOG_DBG("src 0x%04x", rx->ctx.addr);
 
+	if (IS_ENABLED(CONFIG_BT_MESH_STATISTIC)) {
+		bt_mesh_stat_rx_decrypt();
+	}
+
 	return bt_mesh_net_decrypt(&cred->enc, out, BT_MESH_NET_IVI_RX(rx),
 				   proxy) == 0;
 }
@@ -708,6 +796,10 @@ static void bt_mesh_net_relay(struct net_buf_simple *sbuf,
 	 */
 	if (rx->net_if == BT_MESH_NET_IF_ADV && !rx->friend_cred) {
 		transmit = bt_mesh_relay_retransmit_get();
+
+		if (IS_ENABLED(CONFIG_BT_MESH_RELAY_ADAPTIVE_RETRANSMIT)) {
+			transmit = bt_mesh_adv_relay_xmit_adapt(transmit);
+		}
 	} else {
 		transmit = bt_mesh_net_transmit_get();
 	}
@@ -796,6 +888,15 @@ int bt_mesh_net_decode(struct net_buf_simple *in, enum bt_mesh_net_if net_if,
 
 	rx->net_if = net_if;
 
+	if (!bt_mesh_net_cred_nid_known(NID(in->data))) {
+		LOG_DBG("No network credentials for NID 0x%02x", NID(in->data));
+		if (IS_ENABLED(CONFIG_BT_MESH_STATISTIC)) {
+			bt_mesh_stat_rx_nid_unknown();
+		}
+
+		return -ENOENT;
+	}
+
 	if (!bt_mesh_net_cred_find(rx, in, out, net_decrypt)) {
 		LOG_DBG("Unable to find matching net for packet");
 		return -ENOENT;
@@ -884,8 +985,8 @@ void bt_mesh_net_recv(struct net_buf_simple *data, int8_t rssi,
 		 */
 		LOG_WRN("Removing rejected message from Network Message Cache");
 		/* Rewind the next index now that we're not using this entry */
-		msg_cache[--msg_cache_next].src = BT_MESH_ADDR_UNASSIGNED;
-		dup_cache[--dup_cache_next] = 0;
+		fifo_cache_rewind(&msg_cache);
+		fifo_cache_rewind(&dup_cache);
 		return;
 	} else if (err == -EBADMSG) {
 		LOG_DBG("Not relaying message rejected by the Transport layer");
@@ -38,6 +38,17 @@ struct rpl_val {
 static struct bt_mesh_rpl replay_list[CONFIG_BT_MESH_CRPL];
 static ATOMIC_DEFINE(store, CONFIG_BT_MESH_CRPL);
 
+/* Index of replay_list by source address, using open addressing. An entry
+ * holds the list slot plus one, zero marks a free entry. Entries are checked
+ * against the list when looked up, so stale entries are harmless. While the
+ * list is being compacted the index is not used, and it is rebuilt once the
+ * entries have settled.
+ */
+#define RPL_INDEX_SIZE (2 * CONFIG_BT_MESH_CRPL + 1)
+
+static uint16_t rpl_index[RPL_INDEX_SIZE];
+static bool rpl_index_valid = true;
+
 enum {
 	PENDING_CLEAR,
 	PENDING_RESET,
@@ -49,6 +60,98 @@ static inline int rpl_idx(const struct bt_mesh_rpl *rpl)
 	return rpl - &replay_list[0];
 }
 
+static uint32_t rpl_index_hash(uint16_t src)
+{
+	/* Knuth's multiplicative hash */
+	return (src * 2654435761U) % RPL_INDEX_SIZE;
+}
+
+static bool rpl_index_add(const struct bt_mesh_rpl *rpl)
+{
+	uint32_t pos = rpl_index_hash(rpl->src);
+
+	for (int i = 0; i < RPL_INDEX_SIZE; i++) {
+		if (!rpl_index[pos]) {
+			rpl_index[pos] = rpl_idx(rpl) + 1;
+			return true;
+		}
+
+		pos = (pos + 1) % RPL_INDEX_SIZE;
+	}
+
+	return false;
+}
+
+static void rpl_index_rebuild(void)
+{
+	(void)memset(rpl_index, 0, sizeof(rpl_index));
+
+	for (int i = 0; i < ARRAY_SIZE(replay_list); i++) {
+		if (replay_list[i].src) {
+			(void)rpl_index_add(&replay_list[i]);
+		}
+	}
+
+	rpl_index_valid = true;
+}
+
+static void rpl_index_insert(const struct bt_mesh_rpl *rpl)
+{
+	if (!rpl_index_valid) {
+		/* Picked up when the index is rebuilt */
+		return;
+	}
+
+	if (!rpl_index_add(rpl)) {
+		/* The index is larger than the list, so only stale entries
+		 * can have filled it. The rebuilt index includes the new entry.
+		 */
+		rpl_index_rebuild();
+	}
+}
+
+static struct bt_mesh_rpl *rpl_index_find(uint16_t src)
+{
+	uint32_t pos = rpl_index_hash(src);
+
+	for (int i = 0; i < RPL_INDEX_SIZE && rpl_index[pos]; i++) {
+		struct bt_mesh_rpl *rpl = &replay_list[rpl_index[pos] - 1];
+
+		if (rpl->src == src) {
+			return rpl;
+		}
+
+		pos = (pos + 1) % RPL_INDEX_SIZE;
+	}
+
+	return NULL;
+}
+
+/* Get the entry for the given source address or, if there is none, the first
+ * free entry.
+ */
+static struct bt_mesh_rpl *rpl_get(uint16_t src)
+{
+	struct bt_mesh_rpl *rpl;
+
+	if (rpl_index_valid) {
+		rpl = rpl_index_find(src);
+		if (rpl) {
+			return rpl;
+		}
+	}
+
+	for (int i = 0; i < ARRAY_SIZE(replay_list); i++) {
+		rpl = &replay_list[i];
+
+		if (!rpl->src || rpl->src == src) {
+			return rpl;
+		}
+	}
+
+	return NULL;
+}
+
 static void clear_rpl(struct bt_mesh_rpl *rpl)
 {
 	int err;
@@ -92,7 +195,11 @@ void bt_mesh_rpl_update(struct bt_mesh_rpl *rpl,
 		rpl->seg = 0;
 	}
 
-	rpl->src = rx->ctx.addr;
+	if (rpl->src != rx->ctx.addr) {
+		rpl->src = rx->ctx.addr;
+		rpl_index_insert(rpl);
+	}
+
 	rpl->seq = rx->seq;
 	rpl->old_iv = rx->old_iv;
 
@@ -110,7 +217,6 @@ bool bt_mesh_rpl_check(struct bt_mesh_net_rx *rx,
 		struct bt_mesh_rpl **match)
 {
 	struct bt_mesh_rpl *rpl;
-	int i;
 
 	/* Don't bother checking messages from ourselves */
 	if (rx->net_if == BT_MESH_NET_IF_LOCAL) {
@@ -122,43 +228,37 @@ bool bt_mesh_rpl_check(struct bt_mesh_net_rx *rx,
 		return false;
 	}
 
-	for (i = 0; i < ARRAY_SIZE(replay_list); i++) {
-		rpl = &replay_list[i];
+	rpl = rpl_get(rx->ctx.addr);
+	if (!rpl) {
+		LOG_ERR("RPL is full!");
+		return true;
+	}
 
-		/* Empty slot */
-		if (!rpl->src) {
+	/* Existing slot for given address */
+	if (rpl->src) {
+		if (!rpl->old_iv &&
+		    atomic_test_bit(&rpl_flags, PENDING_RESET) &&
+		    !atomic_test_bit(store, rpl_idx(rpl))) {
+			/* Until rpl reset is finished, entry with old_iv == false and
+			 * without "store" bit set will be removed, therefore it can be
+			 * reused. If such entry is reused, "store" bit will be set and
+			 * the entry won't be removed.
+			 */
 			goto match;
 		}
 
-		/* Existing slot for given address */
-		if (rpl->src == rx->ctx.addr) {
-			if (!rpl->old_iv &&
-			    atomic_test_bit(&rpl_flags, PENDING_RESET) &&
-			    !atomic_test_bit(store, i)) {
-				/* Until rpl reset is finished, entry with old_iv == false and
-				 * without "store" bit set will be removed, therefore it can be
-				 * reused. If such entry is reused, "store" bit will be set and
-				 * the entry won't be removed.
-				 */
-				goto match;
-			}
-
-			if (rx->old_iv && !rpl->old_iv) {
-				return true;
-			}
+		if (rx->old_iv && !rpl->old_iv) {
+			return true;
+		}
 
-			if ((!rx->old_iv && rpl->old_iv) ||
-			    rpl->seq < rx->seq) {
-				goto match;
-			} else {
-				return true;
-			}
+		if ((!rx->old_iv && rpl->old_iv) ||
+		    rpl->seq < rx->seq) {
+			goto match;
+		} else {
+			return true;
 		}
 	}
 
-	LOG_ERR("RPL is full!");
-	return true;
-
 match:
 	if (match) {
 		*match = rpl;
@@ -175,6 +275,7 @@ void bt_mesh_rpl_clear(void)
 
 	if (!IS_ENABLED(CONFIG_BT_SETTINGS)) {
 		(void)memset(replay_list, 0, sizeof(replay_list));
+		rpl_index_rebuild();
 		return;
 	}
 
@@ -187,6 +288,10 @@ static struct bt_mesh_rpl *bt_mesh_rpl_find(uint16_t src)
 {
 	int i;
 
+	if (rpl_index_valid) {
+		return rpl_index_find(src);
+	}
+
 	for (i = 0; i < ARRAY_SIZE(replay_list); i++) {
 		if (replay_list[i].src == src) {
 			return &replay_list[i];
@@ -203,6 +308,7 @@ static struct bt_mesh_rpl *bt_mesh_rpl_alloc(uint16_t src)
 	for (i = 0; i < ARRAY_SIZE(replay_list); i++) {
 		if (!replay_list[i].src) {
 			replay_list[i].src = src;
+			rpl_index_insert(&replay_list[i]);
 			return &replay_list[i];
 		}
 	}
@@ -261,6 +367,8 @@ void bt_mesh_rpl_reset(void)
 		}
 
 		(void)memset(&replay_list[last - shift + 1], 0, sizeof(struct bt_mesh_rpl) * shift);
+
+		rpl_index_rebuild();
 	}
 }
 
@@ -361,6 +469,11 @@ void bt_mesh_rpl_pending_store(uint16_t addr)
 	clr = atomic_test_and_clear_bit(&rpl_flags, PENDING_CLEAR);
 	rst = atomic_test_bit(&rpl_flags, PENDING_RESET);
 
+	/* Entries may move below, look them up by walking the list meanwhile */
+	if (clr || rst) {
+		rpl_index_valid = false;
+	}
+
 	for (int i = 0; i < ARRAY_SIZE(replay_list); i++) {
 		struct bt_mesh_rpl *rpl = &replay_list[i];
 
@@ -403,4 +516,8 @@ void bt_mesh_rpl_pending_store(uint16_t addr)
 	if (addr == BT_MESH_ADDR_ALL_NODES) {
 		(void)memset(&replay_list[last - shift + 1], 0, sizeof(struct bt_mesh_rpl) * shift);
 	}
+
+	if (!rpl_index_valid) {
+		rpl_index_rebuild();
+	}
 }
@@ -1622,6 +1622,11 @@ static int cmd_stat_get(const struct shell *sh, size_t argc, char *argv[])
 	shell_print(sh, "local adv:   %d - %d", st.tx_local_planned, st.tx_local_succeeded);
 	shell_print(sh, "friend:      %d - %d", st.tx_friend_planned, st.tx_friend_succeeded);
 
+	shell_print(sh, "Network key lookup:");
+	shell_print(sh, "unknown NID: %d", st.rx_nid_unknown);
+	shell_print(sh, "deobfuscate: %d", st.rx_deobfuscate_attempts);
+	shell_print(sh, "decrypt:     %d", st.rx_decrypt_attempts);
+
 	return 0;
 }
 
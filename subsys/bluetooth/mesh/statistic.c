@@ -62,3 +62,18 @@ void bt_mesh_stat_rx(enum bt_mesh_net_if net_if)
 		break;
 	}
 }
+
+void bt_mesh_stat_rx_nid_unknown(void)
+{
+	stat.rx_nid_unknown++;
+}
+
+void bt_mesh_stat_rx_deobfuscate(void)
+{
+	stat.rx_deobfuscate_attempts++;
+}
+
+void bt_mesh_stat_rx_decrypt(void)
+{
+	stat.rx_decrypt_attempts++;
+}
@@ -10,5 +10,8 @@
 void bt_mesh_stat_planned_count(struct bt_mesh_adv *adv);
 void bt_mesh_stat_succeeded_count(struct bt_mesh_adv *adv);
 void bt_mesh_stat_rx(enum bt_mesh_net_if net_if);
+void bt_mesh_stat_rx_nid_unknown(void);
+void bt_mesh_stat_rx_deobfuscate(void);
+void bt_mesh_stat_rx_decrypt(void);
 
 #endif /* ZEPHYR_SUBSYS_BLUETOOTH_MESH_STATISTIC_H_ */
@@ -66,6 +66,13 @@ static struct bt_mesh_subnet subnets[CONFIG_BT_MESH_SUBNET_COUNT] = {
 	},
 };
 
+/* NIDs of the credentials bt_mesh_net_cred_find() may try. The map is rebuilt
+ * on the next lookup after any credential has been published or removed, so
+ * that PDUs for other networks are dropped without walking the credentials.
+ */
+static ATOMIC_DEFINE(nid_map, 128);
+static atomic_t nid_map_dirty = ATOMIC_INIT(1);
+
 static void subnet_evt(struct bt_mesh_subnet *sub, enum bt_mesh_key_evt evt)
 {
 	STRUCT_SECTION_FOREACH(bt_mesh_subnet_cb, cb) {
@@ -239,6 +246,8 @@ static void key_refresh(struct bt_mesh_subnet *sub, uint8_t new_phase)
 		break;
 	}
 
+	bt_mesh_net_cred_nid_invalidate();
+
 	if (IS_ENABLED(CONFIG_BT_SETTINGS)) {
 		LOG_DBG("Storing Updated NetKey persistently");
 		bt_mesh_subnet_store(sub->net_idx);
@@ -297,6 +306,8 @@ static void subnet_del(struct bt_mesh_subnet *sub)
 	subnet_evt(sub, BT_MESH_KEY_DELETED);
 	(void)memset(sub, 0, sizeof(*sub));
 	sub->net_idx = BT_MESH_KEY_UNUSED;
+
+	bt_mesh_net_cred_nid_invalidate();
 }
 
 static int msg_cred_create(struct bt_mesh_net_cred *cred, const uint8_t *p,
@@ -403,6 +414,8 @@ uint8_t bt_mesh_subnet_add(uint16_t net_idx, const uint8_t key[16])
 		sub->node_id = BT_MESH_NODE_IDENTITY_NOT_SUPPORTED;
 	}
 
+	bt_mesh_net_cred_nid_invalidate();
+
 	subnet_evt(sub, BT_MESH_KEY_ADDED);
 
 	if (IS_ENABLED(CONFIG_BT_SETTINGS)) {
@@ -500,7 +513,14 @@ int bt_mesh_friend_cred_create(struct bt_mesh_net_cred *cred, uint16_t lpn_addr,
 		return err;
 	}
 
-	return msg_cred_create(cred, p, sizeof(p), raw_key);
+	err = msg_cred_create(cred, p, sizeof(p), raw_key);
+	if (err) {
+		return err;
+	}
+
+	bt_mesh_net_cred_nid_invalidate();
+
+	return 0;
 }
 
 void bt_mesh_friend_cred_destroy(struct bt_mesh_net_cred *cred)
@@ -804,6 +824,8 @@ int bt_mesh_subnet_set(uint16_t net_idx, uint8_t kr_phase, const struct bt_mesh_
 		sub->node_id = BT_MESH_NODE_IDENTITY_NOT_SUPPORTED;
 	}
 
+	bt_mesh_net_cred_nid_invalidate();
+
 	/* Make sure we have valid beacon data to be sent */
 	bt_mesh_beacon_update(sub);
 
@@ -880,6 +902,74 @@ void bt_mesh_net_keys_reset(void)
 	}
 }
 
+#if defined(CONFIG_BT_MESH_LOW_POWER) || defined(CONFIG_BT_MESH_FRIEND)
+static void nid_map_add(atomic_t *map, const struct bt_mesh_subnet *sub,
+			const struct bt_mesh_net_cred *cred, size_t count)
+{
+	for (size_t j = 0; j < count; j++) {
+		if (sub->keys[j].valid) {
+			atomic_set_bit(map, cred[j].nid);
+		}
+	}
+}
+#endif /* CONFIG_BT_MESH_LOW_POWER || CONFIG_BT_MESH_FRIEND */
+
+static void nid_map_rebuild(void)
+{
+	ATOMIC_DEFINE(map, 128) = { 0 };
+	int i;
+
+#if defined(CONFIG_BT_MESH_LOW_POWER)
+	if (bt_mesh.lpn.sub) {
+		nid_map_add(map, bt_mesh.lpn.sub, bt_mesh.lpn.cred,
+			    ARRAY_SIZE(bt_mesh.lpn.cred));
+	}
+#endif
+
+#if defined(CONFIG_BT_MESH_FRIEND)
+	for (i = 0; i < ARRAY_SIZE(bt_mesh.frnd); i++) {
+		struct bt_mesh_friend *frnd = &bt_mesh.frnd[i];
+
+		if (frnd->subnet) {
+			nid_map_add(map, frnd->subnet, frnd->cred,
+				    ARRAY_SIZE(frnd->cred));
+		}
+	}
+#endif
+
+	for (i = 0; i < ARRAY_SIZE(subnets); i++) {
+		struct bt_mesh_subnet *sub = &subnets[i];
+
+		if (sub->net_idx == BT_MESH_KEY_UNUSED) {
+			continue;
+		}
+
+		for (int j = 0; j < ARRAY_SIZE(sub->keys); j++) {
+			if (sub->keys[j].valid) {
+				atomic_set_bit(map, sub->keys[j].msg.nid);
+			}
+		}
+	}
+
+	for (i = 0; i < ARRAY_SIZE(map); i++) {
+		atomic_set(&nid_map[i], atomic_get(&map[i]));
+	}
+}
+
+void bt_mesh_net_cred_nid_invalidate(void)
+{
+	atomic_set(&nid_map_dirty, 1);
+}
+
+bool bt_mesh_net_cred_nid_known(uint8_t nid)
+{
+	if (atomic_cas(&nid_map_dirty, 1, 0)) {
+		nid_map_rebuild();
+	}
+
+	return atomic_test_bit(nid_map, nid & 0x7f);
+}
+
 bool bt_mesh_net_cred_find(struct bt_mesh_net_rx *rx, struct net_buf_simple *in,
 			   struct net_buf_simple *out,
 			   bool (*cb)(struct bt_mesh_net_rx *rx,
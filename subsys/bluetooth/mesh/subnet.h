@@ -160,6 +160,9 @@ int bt_mesh_subnet_set(uint16_t net_idx, uint8_t kr_phase,
 		       const struct bt_mesh_key *key, const struct bt_mesh_key *new_key);
 
 /** @brief Create Friendship credentials.
+ *
+ *  The friendship must already refer to its subnet, the credentials are
+ *  known to bt_mesh_net_cred_nid_known() as soon as they are created.
  *
  *  @param cred Credential object to create.
  *  @param lpn_addr Address of the LPN node in the friendship.
@@ -181,6 +184,26 @@ int bt_mesh_friend_cred_create(struct bt_mesh_net_cred *cred,
  */
 void bt_mesh_friend_cred_destroy(struct bt_mesh_net_cred *cred);
 
+/** @brief Invalidate the map of known NIDs.
+ *
+ *  The map is rebuilt on the next call to bt_mesh_net_cred_nid_known(). Must
+ *  be called after network credentials have been made available to
+ *  bt_mesh_net_cred_find(), or have been removed from it.
+ */
+void bt_mesh_net_cred_nid_invalidate(void);
+
+/** @brief Check whether any network credential uses the given NID.
+ *
+ *  Network PDUs with an unknown NID can be dropped before trying to decrypt
+ *  them with any of the credentials.
+ *
+ *  @param nid Network ID of a received Network PDU.
+ *
+ *  @returns Whether any credential passed to the bt_mesh_net_cred_find()
+ *           callback may have this NID.
+ */
+bool bt_mesh_net_cred_nid_known(uint8_t nid);
+
 /** @brief Iterate through all valid network credentials to decrypt a message.
  *
  *  @param rx Network RX parameters, passed to the callback.
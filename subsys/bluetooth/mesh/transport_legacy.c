@@ -1232,6 +1232,22 @@ static bool seg_rx_is_valid(struct seg_rx *rx, struct bt_mesh_net_rx *net_rx,
 	return true;
 }
 
+static uint32_t seg_rx_pending_count(void)
+{
+	uint32_t count = 0;
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(seg_rx); i++) {
+		struct seg_rx *rx = &seg_rx[i];
+
+		if (rx->in_use) {
+			count += rx->seg_n + 1 - POPCOUNT(rx->block);
+		}
+	}
+
+	return count;
+}
+
 static struct seg_rx *seg_rx_alloc(struct bt_mesh_net_rx *net_rx,
 				   const uint8_t *hdr, const uint64_t *seq_auth,
 				   uint8_t seg_n)
@@ -1239,9 +1255,14 @@ static struct seg_rx *seg_rx_alloc(struct bt_mesh_net_rx *net_rx,
 	int i;
 
 	/* No race condition on this check, as this function only executes in
-	 * the collaborative Bluetooth rx thread:
+	 * the collaborative Bluetooth rx thread.
+	 *
+	 * Only start a new session if all of its segments fit next to the ones
+	 * the sessions in progress are still waiting for. Otherwise, parallel
+	 * sessions could each hold a part of the pool, and none of them would
+	 * complete before being discarded.
 	 */
-	if (k_mem_slab_num_free_get(&segs) < 1) {
+	if (k_mem_slab_num_free_get(&segs) < seg_rx_pending_count() + seg_n + 1) {
 		LOG_WRN("Not enough segments for incoming message");
 		return NULL;
 	}
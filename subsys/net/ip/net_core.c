@@ -434,6 +434,10 @@ int net_recv_data(struct net_if *iface, struct net_pkt *pkt)
 
 	net_pkt_set_iface(pkt, iface);
 
+	if (IS_ENABLED(CONFIG_NET_GPTP_RX_PRIORITY)) {
+		net_gptp_set_rx_priority(iface, pkt);
+	}
+
 	if (!net_pkt_filter_recv_ok(pkt)) {
 		/* silently drop the packet */
 		net_pkt_unref(pkt);
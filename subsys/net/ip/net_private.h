@@ -156,9 +156,18 @@ void net_gptp_init(void);
  * @return Return the policy for network buffer.
  */
 enum net_verdict net_gptp_recv(struct net_if *iface, struct net_pkt *pkt);
+
+/**
+ * @brief Raise the priority of a received ptp message before it is queued.
+ *
+ * @param iface Network interface the packet was received from.
+ * @param pkt Received packet, not yet processed by L2.
+ */
+void net_gptp_set_rx_priority(struct net_if *iface, struct net_pkt *pkt);
 #else
 #define net_gptp_init()
 #define net_gptp_recv(iface, pkt) NET_DROP
+#define net_gptp_set_rx_priority(iface, pkt)
 #endif /* CONFIG_NET_GPTP */
 
 #if defined(CONFIG_NET_IPV4_FRAGMENT)
@@ -87,7 +87,10 @@ LOG_MODULE_REGISTER(net_shell, LOG_LEVEL_DBG);
 #include "net_stats.h"
 
 #include <zephyr/sys/fdtable.h>
+
+#if defined(CONFIG_WEBSOCKET_CLIENT)
 #include "websocket/websocket_internal.h"
+#endif
 
 #define PR(fmt, ...)						\
 	shell_fprintf(sh, SHELL_NORMAL, fmt, ##__VA_ARGS__)
@@ -348,6 +348,37 @@ enum net_verdict net_gptp_recv(struct net_if *iface, struct net_pkt *pkt)
 	return NET_DROP;
 }
 
+#if defined(CONFIG_NET_GPTP_RX_PRIORITY)
+void net_gptp_set_rx_priority(struct net_if *iface, struct net_pkt *pkt)
+{
+	struct net_eth_vlan_hdr *hdr;
+	uint16_t type;
+
+	/* The packet is not parsed yet, peek at the Ethernet header which is
+	 * always in the first fragment.
+	 */
+	if (net_if_l2(iface) != &NET_L2_GET_NAME(ETHERNET) ||
+	    pkt->buffer->len < sizeof(struct net_eth_hdr)) {
+		return;
+	}
+
+	hdr = (struct net_eth_vlan_hdr *)net_pkt_data(pkt);
+	type = ntohs(hdr->vlan.tpid);
+
+	if (type == NET_ETH_PTYPE_VLAN) {
+		if (pkt->buffer->len < sizeof(struct net_eth_vlan_hdr)) {
+			return;
+		}
+
+		type = ntohs(hdr->type);
+	}
+
+	if (type == NET_ETH_PTYPE_PTP) {
+		net_pkt_set_priority(pkt, NET_PRIORITY_NC);
+	}
+}
+#endif /* CONFIG_NET_GPTP_RX_PRIORITY */
+
 static void gptp_init_clock_ds(void)
 {
 	struct gptp_global_ds *global_ds;
@@ -749,12 +749,16 @@ static void gptp_update_local_port_clock(void)
 
 	port_ds = GPTP_PORT_DS(port);
 
-	/* Check if the last neighbor rate ratio can still be used */
-	if (!port_ds->neighbor_rate_ratio_valid) {
-		return;
-	}
+	/* Check if the last neighbor rate ratio can still be used. The servo
+	 * measures the rate itself, so it can use every Sync message.
+	 */
+	if (!IS_ENABLED(CONFIG_NET_GPTP_SERVO_PI)) {
+		if (!port_ds->neighbor_rate_ratio_valid) {
+			return;
+		}
 
-	port_ds->neighbor_rate_ratio_valid = false;
+		port_ds->neighbor_rate_ratio_valid = false;
+	}
 
 	second_diff = global_ds->sync_receipt_time.second -
 		(global_ds->sync_receipt_local_time / NSEC_PER_SEC);
@@ -777,7 +781,9 @@ static void gptp_update_local_port_clock(void)
 		nanosecond_diff = -(int64_t)NSEC_PER_SEC + nanosecond_diff;
 	}
 
-	ptp_clock_rate_adjust(clk, port_ds->neighbor_rate_ratio);
+	if (!IS_ENABLED(CONFIG_NET_GPTP_SERVO_PI)) {
+		ptp_clock_rate_adjust(clk, port_ds->neighbor_rate_ratio);
+	}
 
 	/* If time difference is too high, set the clock value.
 	 * Otherwise, adjust it.
@@ -825,9 +831,22 @@ static void gptp_update_local_port_clock(void)
 
 		ptp_clock_set(clk, &tm);
 
+#if defined(CONFIG_NET_GPTP_SERVO_PI)
+		ptp_clock_rate_adjust(clk,
+				      gptp_servo_step(&state->servo,
+						      second_diff * NSEC_PER_SEC +
+						      nanosecond_diff,
+						      global_ds->sync_receipt_local_time));
+#endif
+
 	skip_clock_set:
 		irq_unlock(key);
 	} else {
+#if defined(CONFIG_NET_GPTP_SERVO_PI)
+		ptp_clock_rate_adjust(clk,
+				      gptp_servo_sample(&state->servo, nanosecond_diff,
+							global_ds->sync_receipt_local_time));
+#else
 		if (nanosecond_diff < -200) {
 			nanosecond_diff = -200;
 		} else if (nanosecond_diff > 200) {
@@ -835,6 +854,7 @@ static void gptp_update_local_port_clock(void)
 		}
 
 		ptp_clock_adjust(clk, nanosecond_diff);
+#endif
 	}
 }
 #endif /* CONFIG_NET_GPTP_USE_DEFAULT_CLOCK_UPDATE */
@@ -848,6 +868,9 @@ static void gptp_mi_clk_slave_sync_state_machine(void)
 	switch (state->state) {
 	case GPTP_CLK_SLAVE_SYNC_INITIALIZING:
 		state->rcvd_pss = false;
+#if defined(CONFIG_NET_GPTP_SERVO_PI)
+		gptp_servo_reset(&state->servo);
+#endif
 		state->state = GPTP_CLK_SLAVE_SYNC_SEND_SYNC_IND;
 		break;
 
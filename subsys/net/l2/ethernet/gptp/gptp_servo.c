@@ -0,0 +1,171 @@
+/*
+ * Copyright The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Proportional-integral clock servo. The offset samples are taken from
+ * the Sync messages. Samples that deviate from the previous one much more
+ * than the observed jitter are considered to be delayed by queueing and
+ * are ignored, so a single late timestamp does not kick the clock.
+ */
+
+#include <string.h>
+#include <zephyr/sys_clock.h>
+#include <zephyr/sys/math_extras.h>
+#include <zephyr/sys/util.h>
+
+#include "gptp_servo.h"
+
+#define KP (CONFIG_NET_GPTP_SERVO_KP / 1000.0)
+#define KI (CONFIG_NET_GPTP_SERVO_KI / 1000.0)
+
+/* Limit the adjustment to what typical PTP clock hardware can do. */
+#define MAX_FREQ_ADJ_PPB 500000.0
+
+/* A sample is an outlier if its offset changed more than this many times
+ * the filtered jitter, or at least OUTLIER_MIN_NS.
+ */
+#define OUTLIER_JITTER_MULT 4
+#define OUTLIER_MIN_NS 1000
+
+/* Accept the sample anyway after this many consecutive outliers, the
+ * offset has then really changed.
+ */
+#define MAX_OUTLIERS 2
+
+/* Samples needed before the jitter estimate is trusted, large offset
+ * changes are expected while the servo is still acquiring the frequency.
+ */
+#define LOCK_SAMPLES 8
+
+static void hist_add(uint32_t *hist, int64_t value)
+{
+	uint64_t v = (value < 0) ? -(uint64_t)value : (uint64_t)value;
+	unsigned int bucket;
+
+	bucket = 63 - u64_count_leading_zeros(v + 1);
+	bucket = MIN(bucket, GPTP_SERVO_HIST_BUCKETS - 1);
+
+	hist[bucket]++;
+}
+
+static double clamp_freq(double ppb)
+{
+	return CLAMP(ppb, -MAX_FREQ_ADJ_PPB, MAX_FREQ_ADJ_PPB);
+}
+
+/* Switch to a new frequency adjustment, return the ratio for the clock
+ * driver which applies it on top of the previous one.
+ */
+static double set_freq(struct gptp_servo *servo, double ppb)
+{
+	double ratio;
+
+	ratio = (1.0 + ppb / NSEC_PER_SEC) / (1.0 + servo->freq_adj / NSEC_PER_SEC);
+
+	servo->freq_adj = ppb;
+	servo->stats.freq_adj = (int32_t)ppb;
+
+	return ratio;
+}
+
+void gptp_servo_reset(struct gptp_servo *servo)
+{
+	memset(servo, 0, sizeof(*servo));
+}
+
+double gptp_servo_step(struct gptp_servo *servo, int64_t offset,
+		       uint64_t local_time)
+{
+	double ratio = 1.0;
+	double interval;
+
+	servo->stats.steps++;
+	servo->stats.offset = offset;
+	hist_add(servo->stats.offset_hist, offset);
+
+	/* The offset accumulated since the previous sample is still a valid
+	 * frequency error measurement, even if it was too large to slew.
+	 */
+	if (servo->count > 0 && local_time > servo->last_local_time) {
+		interval = (double)(local_time - servo->last_local_time) /
+			   NSEC_PER_SEC;
+
+		servo->integral = clamp_freq(servo->freq_adj +
+					     (offset - servo->last_offset) / interval);
+		ratio = set_freq(servo, servo->integral);
+	}
+
+	/* The offset is zero right after the step */
+	servo->last_offset = 0;
+	servo->last_local_time = local_time + offset;
+	servo->count = 1;
+	servo->outliers = 0;
+
+	return ratio;
+}
+
+double gptp_servo_sample(struct gptp_servo *servo, int64_t offset,
+			 uint64_t local_time)
+{
+	int64_t delta = offset - servo->last_offset;
+	uint64_t abs_delta;
+	double interval;
+	double ppb;
+
+	servo->stats.samples++;
+	servo->stats.offset = offset;
+	hist_add(servo->stats.offset_hist, offset);
+
+	if (servo->count == 0 || local_time <= servo->last_local_time) {
+		servo->last_offset = offset;
+		servo->last_local_time = local_time;
+		servo->count = 1;
+
+		return 1.0;
+	}
+
+	hist_add(servo->stats.jitter_hist, delta);
+	abs_delta = (delta < 0) ? -(uint64_t)delta : (uint64_t)delta;
+
+	if (servo->count >= LOCK_SAMPLES &&
+	    abs_delta > MAX(OUTLIER_MIN_NS,
+			    OUTLIER_JITTER_MULT * (servo->jitter_x16 / 16)) &&
+	    servo->outliers < MAX_OUTLIERS) {
+		servo->outliers++;
+		servo->stats.outliers++;
+
+		return 1.0;
+	}
+
+	servo->outliers = 0;
+
+	/* RFC 3550 style jitter estimate, J += (|D| - J) / 16 */
+	servo->jitter_x16 += MIN(abs_delta, UINT16_MAX) - (servo->jitter_x16 + 8) / 16;
+	servo->stats.jitter = servo->jitter_x16 / 16;
+
+	interval = (double)(local_time - servo->last_local_time) / NSEC_PER_SEC;
+
+	if (servo->count == 1) {
+		/* The drift between the first two samples gives the remaining
+		 * frequency error directly, start the integrator from there.
+		 */
+		servo->integral = clamp_freq(servo->freq_adj + delta / interval);
+		ppb = servo->integral;
+	} else {
+		servo->integral = clamp_freq(servo->integral +
+					     KI * offset / interval);
+		ppb = clamp_freq(KP * offset / interval + servo->integral);
+	}
+
+	if (servo->count < UINT8_MAX) {
+		servo->count++;
+	}
+
+	servo->last_offset = offset;
+	servo->last_local_time = local_time;
+
+	return set_freq(servo, ppb);
+}
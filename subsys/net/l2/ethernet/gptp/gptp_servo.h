@@ -0,0 +1,94 @@
+/*
+ * Copyright The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief gPTP local clock servo
+ *
+ * This is not to be included by the application.
+ */
+
+#ifndef __GPTP_SERVO_H
+#define __GPTP_SERVO_H
+
+#include <stdint.h>
+#include <zephyr/net/gptp.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief PI servo state.
+ */
+struct gptp_servo {
+	/** Statistics exported to the application. */
+	struct gptp_servo_stats stats;
+
+	/** Integral term, i.e. the estimated frequency error in ppb. */
+	double integral;
+
+	/** Frequency adjustment currently applied to the clock in ppb. */
+	double freq_adj;
+
+	/** Offset of the previous accepted sample in ns. */
+	int64_t last_offset;
+
+	/** Local receipt time of the previous accepted sample in ns. */
+	uint64_t last_local_time;
+
+	/** Filtered jitter in ns, scaled by 16. */
+	uint32_t jitter_x16;
+
+	/** Number of accepted samples since the last reset or step. */
+	uint8_t count;
+
+	/** Number of consecutive samples rejected as outliers. */
+	uint8_t outliers;
+};
+
+/**
+ * @brief Reset the servo, including the learned frequency.
+ *
+ * @param servo Servo state.
+ */
+void gptp_servo_reset(struct gptp_servo *servo);
+
+/**
+ * @brief Notify the servo that the clock is stepped to the master time.
+ *
+ * The offset is still used to correct the frequency, the phase history
+ * is discarded.
+ *
+ * @param servo Servo state.
+ * @param offset Offset of the master clock from the local clock in ns.
+ * @param local_time Local time at which the offset was measured, before
+ *        the step, in ns.
+ *
+ * @return Rate ratio to pass to ptp_clock_rate_adjust(). It is relative to
+ *         the previously applied adjustment, 1.0 means no change.
+ */
+double gptp_servo_step(struct gptp_servo *servo, int64_t offset,
+		       uint64_t local_time);
+
+/**
+ * @brief Feed a new offset sample to the servo.
+ *
+ * @param servo Servo state.
+ * @param offset Offset of the master clock from the local clock in ns.
+ * @param local_time Local time at which the offset was measured in ns.
+ *
+ * @return Rate ratio to pass to ptp_clock_rate_adjust(). It is relative to
+ *         the previously applied adjustment, 1.0 means no change.
+ */
+double gptp_servo_sample(struct gptp_servo *servo, int64_t offset,
+			 uint64_t local_time);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __GPTP_SERVO_H */
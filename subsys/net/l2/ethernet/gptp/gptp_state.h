@@ -14,6 +14,7 @@
 #define __GPTP_STATE_H
 
 #include "gptp_mi.h"
+#include "gptp_servo.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -381,6 +382,11 @@ struct gptp_clk_slave_sync_state {
 
 	/** The local clock has expired. */
 	bool rcvd_local_clk_tick;
+
+#if defined(CONFIG_NET_GPTP_SERVO_PI)
+	/** Servo disciplining the local clock. */
+	struct gptp_servo servo;
+#endif
 };
 
 /* ClockMasterSyncOffset state machine variables. */
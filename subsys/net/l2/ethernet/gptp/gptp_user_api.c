@@ -92,3 +92,20 @@ void gptp_clk_src_time_invoke(struct gptp_clk_src_time_invoke_params *arg)
 
 	state->rcvd_clock_source_req = true;
 }
+
+int gptp_get_servo_stats(struct gptp_servo_stats *stats)
+{
+#if defined(CONFIG_NET_GPTP_SERVO_PI)
+	unsigned int key;
+
+	key = irq_lock();
+	memcpy(stats, &GPTP_STATE()->clk_slave_sync.servo.stats, sizeof(*stats));
+	irq_unlock(key);
+
+	return 0;
+#else
+	ARG_UNUSED(stats);
+
+	return -ENOTSUP;
+#endif
+}
@@ -5,6 +5,7 @@
  */
 
 #include <string.h>
+#include <strings.h>
 #include <zephyr/net/buf.h>
 
 #include "dns_pack.h"
@@ -581,3 +582,99 @@ int dns_unpack_query(struct dns_msg_t *dns_msg, struct net_buf *buf,
 
 	return ret;
 }
+
+int dns_skip_question(const struct dns_msg_t *dns_msg, uint16_t pos)
+{
+	int name_len;
+
+	if (pos >= dns_msg->msg_size) {
+		return -EINVAL;
+	}
+
+	name_len = skip_fqdn(dns_msg->msg + pos, dns_msg->msg_size - pos);
+	if (name_len < 0) {
+		return name_len;
+	}
+
+	pos += name_len + DNS_QTYPE_LEN + DNS_QCLASS_LEN;
+	if (pos > dns_msg->msg_size) {
+		return -EINVAL;
+	}
+
+	return pos;
+}
+
+int dns_unpack_rr(const struct dns_msg_t *dns_msg, uint16_t pos,
+		  struct dns_rr_info *rr)
+{
+	uint8_t *answer = dns_msg->msg + pos;
+	int name_len;
+
+	if (pos >= dns_msg->msg_size) {
+		return -EINVAL;
+	}
+
+	name_len = skip_fqdn(answer, dns_msg->msg_size - pos);
+	if (name_len < 0) {
+		return name_len;
+	}
+
+	/* See RFC-1035 4.1.3. Resource record format */
+	if (pos + name_len + sizeof(struct dns_rr) > dns_msg->msg_size) {
+		return -EINVAL;
+	}
+
+	rr->name_pos = pos;
+	rr->type = dns_answer_type(name_len, answer);
+	rr->class_ = dns_answer_class(name_len, answer);
+	rr->ttl = dns_answer_ttl(name_len, answer);
+	rr->rdlength = dns_answer_rdlength(name_len, answer);
+	rr->rdata_pos = pos + name_len + sizeof(struct dns_rr);
+
+	if (rr->rdata_pos + rr->rdlength > dns_msg->msg_size) {
+		return -EINVAL;
+	}
+
+	return rr->rdata_pos + rr->rdlength;
+}
+
+bool dns_name_equal(const struct dns_msg_t *dns_msg, uint16_t pos,
+		    const char *const *labels, size_t count)
+{
+	const uint8_t *msg = dns_msg->msg;
+	int pointers = 0;
+	size_t i = 0;
+
+	while (pos < dns_msg->msg_size) {
+		uint8_t len = msg[pos];
+
+		if ((len & NS_CMPRSFLGS) == NS_CMPRSFLGS) {
+			if (pos + 1 >= dns_msg->msg_size ||
+			    ++pointers > DNS_NAME_MAX_SIZE / 2) {
+				return false;
+			}
+
+			pos = ((len & ~NS_CMPRSFLGS) << 8) | msg[pos + 1];
+			continue;
+		}
+
+		if (len > DNS_LABEL_MAX_SIZE) {
+			return false;
+		}
+
+		if (len == 0) {
+			return i == count;
+		}
+
+		if (i == count || pos + 1 + len > dns_msg->msg_size ||
+		    strlen(labels[i]) != len ||
+		    strncasecmp(labels[i], (const char *)&msg[pos + 1], len) != 0) {
+			return false;
+		}
+
+		pos += 1 + len;
+		i++;
+	}
+
+	return false;
+}
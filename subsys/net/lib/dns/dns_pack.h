@@ -11,6 +11,7 @@
 #include <zephyr/net/buf.h>
 
 #include <zephyr/types.h>
+#include <stdbool.h>
 #include <stddef.h>
 #include <errno.h>
 
@@ -179,6 +180,16 @@ struct dns_aaaa_rdata {
 	uint8_t address[16];
 } __packed;
 
+/* Position and fixed fields of a resource record in a DNS message */
+struct dns_rr_info {
+	uint16_t name_pos;
+	uint16_t rdata_pos;
+	uint16_t rdlength;
+	uint16_t type;
+	uint16_t class_;
+	uint32_t ttl;
+};
+
 /** It returns the ID field in the DNS msg header	*/
 static inline int dns_header_id(uint8_t *header)
 {
@@ -462,4 +473,45 @@ int dns_unpack_query(struct dns_msg_t *dns_msg, struct net_buf *buf,
 		     enum dns_rr_type *qtype,
 		     enum dns_class *qclass);
 
+/**
+ * @brief Skips a question of a DNS message.
+ *
+ * @param dns_msg Structure containing the message.
+ * @param pos Position of the question in the message.
+ * @retval Position of the next question or record on success
+ * @retval -EINVAL if the question is malformed
+ */
+int dns_skip_question(const struct dns_msg_t *dns_msg, uint16_t pos);
+
+/**
+ * @brief Unpacks the fixed fields of a resource record.
+ *
+ * @details The owner name and the record data are not copied, their
+ *          positions are returned so that they can be compared in place.
+ *
+ * @param dns_msg Structure containing the message.
+ * @param pos Position of the record in the message.
+ * @param rr Record information returned to the caller
+ * @retval Position of the next record on success
+ * @retval -EINVAL if the record is malformed
+ */
+int dns_unpack_rr(const struct dns_msg_t *dns_msg, uint16_t pos,
+		  struct dns_rr_info *rr);
+
+/**
+ * @brief Compares a name of a DNS message with a name given as labels.
+ *
+ * @details The name may be compressed (RFC 1035, 4.1.4). The comparison
+ *          is case insensitive, as required by RFC 1035, 2.3.3.
+ *
+ * @param dns_msg Structure containing the message.
+ * @param pos Position of the name in the message.
+ * @param labels Labels of the other name, without the root label
+ * @param count Number of labels
+ * @retval true if the names are equal
+ * @retval false if they differ or if the name is malformed
+ */
+bool dns_name_equal(const struct dns_msg_t *dns_msg, uint16_t pos,
+		    const char *const *labels, size_t count);
+
 #endif
@@ -707,6 +707,39 @@ static inline bool port_in_use(uint16_t proto, uint16_t port, const struct in_ad
 #endif /* CONFIG_NET_TEST */
 
 
+int dns_sd_rec_check(const struct dns_sd_rec *inst, const struct in_addr *addr4,
+		     const struct in6_addr *addr6)
+{
+	uint16_t proto;
+
+	if (!rec_is_valid(inst)) {
+		return -EINVAL;
+	}
+
+	if (*(inst->port) == 0) {
+		NET_DBG("Ephemeral port %u for %s.%s.%s.%s not initialized",
+			ntohs(*(inst->port)), inst->instance, inst->service, inst->proto,
+			inst->domain);
+		return -EHOSTDOWN;
+	}
+
+	if (strncmp("_tcp", inst->proto, DNS_SD_PROTO_SIZE) == 0) {
+		proto = IPPROTO_TCP;
+	} else if (strncmp("_udp", inst->proto, DNS_SD_PROTO_SIZE) == 0) {
+		proto = IPPROTO_UDP;
+	} else {
+		NET_DBG("invalid protocol %s", inst->proto);
+		return -EINVAL;
+	}
+
+	if (!port_in_use(proto, ntohs(*(inst->port)), addr4, addr6)) {
+		/* Service is not yet bound, so do not advertise */
+		return -EHOSTDOWN;
+	}
+
+	return 0;
+}
+
 int dns_sd_handle_ptr_query(const struct dns_sd_rec *inst, const struct in_addr *addr4,
 			    const struct in6_addr *addr6, uint8_t *buf, uint16_t buf_size)
 {
@@ -728,7 +761,6 @@ int dns_sd_handle_ptr_query(const struct dns_sd_rec *inst, const struct in_addr
 	uint16_t service_offset;
 	uint16_t domain_offset;
 	uint16_t host_offset;
-	uint16_t proto;
 	uint16_t offset = sizeof(struct dns_header);
 	struct dns_header *rsp = (struct dns_header *)buf;
 	uint32_t tmp;
@@ -736,29 +768,9 @@ int dns_sd_handle_ptr_query(const struct dns_sd_rec *inst, const struct in_addr
 
 	memset(rsp, 0, sizeof(*rsp));
 
-	if (!rec_is_valid(inst)) {
-		return -EINVAL;
-	}
-
-	if (*(inst->port) == 0) {
-		NET_DBG("Ephemeral port %u for %s.%s.%s.%s not initialized",
-			ntohs(*(inst->port)), inst->instance, inst->service, inst->proto,
-			inst->domain);
-		return -EHOSTDOWN;
-	}
-
-	if (strncmp("_tcp", inst->proto, DNS_SD_PROTO_SIZE) == 0) {
-		proto = IPPROTO_TCP;
-	} else if (strncmp("_udp", inst->proto, DNS_SD_PROTO_SIZE) == 0) {
-		proto = IPPROTO_UDP;
-	} else {
-		NET_DBG("invalid protocol %s", inst->proto);
-		return -EINVAL;
-	}
-
-	if (!port_in_use(proto, ntohs(*(inst->port)), addr4, addr6)) {
-		/* Service is not yet bound, so do not advertise */
-		return -EHOSTDOWN;
+	r = dns_sd_rec_check(inst, addr4, addr6);
+	if (r < 0) {
+		return r;
 	}
 
 	/* first add the answer record */
@@ -827,37 +839,16 @@ int dns_sd_handle_service_type_enum(const struct dns_sd_rec *inst,
 	static const char query[] = { "\x09_services\x07_dns-sd\x04_udp\x05local" };
 	/* offset of '.local' in the above */
 	uint16_t domain_offset = DNS_SD_PTR_MASK | 35;
-	uint16_t proto;
 	int name_size;
 	uint16_t service_size;
 	uint16_t offset = sizeof(struct dns_header);
 	struct dns_rr *rr;
 	struct dns_header *const rsp = (struct dns_header *)buf;
+	int ret;
 
-	if (!rec_is_valid(inst)) {
-		return -EINVAL;
-	}
-
-	if (*(inst->port) == 0) {
-		NET_DBG("Ephemeral port %u for %s.%s.%s.%s "
-			"not initialized",
-			ntohs(*(inst->port)), inst->instance, inst->service, inst->proto,
-			inst->domain);
-		return -EHOSTDOWN;
-	}
-
-	if (strncmp("_tcp", inst->proto, DNS_SD_PROTO_SIZE) == 0) {
-		proto = IPPROTO_TCP;
-	} else if (strncmp("_udp", inst->proto, DNS_SD_PROTO_SIZE) == 0) {
-		proto = IPPROTO_UDP;
-	} else {
-		NET_DBG("invalid protocol %s", inst->proto);
-		return -EINVAL;
-	}
-
-	if (!port_in_use(proto, ntohs(*(inst->port)), addr4, addr6)) {
-		/* Service is not yet bound, so do not advertise */
-		return -EHOSTDOWN;
+	ret = dns_sd_rec_check(inst, addr4, addr6);
+	if (ret < 0) {
+		return ret;
 	}
 
 	service_size = strlen(inst->service);
@@ -140,6 +140,22 @@ int dns_sd_extract_service_proto_domain(const uint8_t *query,
 bool dns_sd_rec_match(const struct dns_sd_rec *record,
 	const struct dns_sd_rec *filter);
 
+/**
+ * @brief Check that a DNS-SD record can be advertised
+ *
+ * The record must be valid, and its service must be bound to its port.
+ *
+ * @param inst the DNS-SD record to check
+ * @param addr4 pointer to the IPv4 address, or NULL
+ * @param addr6 pointer to the IPv6 address, or NULL
+ *
+ * @return 0 if the record can be advertised
+ * @return -EINVAL if the record is invalid
+ * @return -EHOSTDOWN if the service is not bound yet
+ */
+int dns_sd_rec_check(const struct dns_sd_rec *inst,
+	const struct in_addr *addr4, const struct in6_addr *addr6);
+
 /**
  * @brief Handle a DNS PTR Query with DNS Service Discovery
  *
@@ -63,6 +63,59 @@ static int setup_dst_addr(struct net_context *ctx, sa_family_t family,
 NET_BUF_POOL_DEFINE(mdns_msg_pool, DNS_RESOLVER_BUF_CTR,
 		    DNS_RESOLVER_MAX_BUF_SIZE, 0, NULL);
 
+/* Answer section of a query, where the querier lists the answers it
+ * already knows (RFC 6762 ch 7.1).
+ */
+struct known_answers {
+	uint16_t pos;
+	uint16_t count;
+};
+
+/* RFC 6762 ch 6 limits the rate of multicast answers per link, so the
+ * time an answer was last sent is kept per interface. Every interface the
+ * responder receives on has an IPv4 or IPv6 configuration.
+ */
+#if defined(CONFIG_NET_IPV4) && defined(CONFIG_NET_IPV6)
+#define MDNS_MAX_IFACES (CONFIG_NET_IF_MAX_IPV4_COUNT + CONFIG_NET_IF_MAX_IPV6_COUNT)
+#elif defined(CONFIG_NET_IPV4)
+#define MDNS_MAX_IFACES CONFIG_NET_IF_MAX_IPV4_COUNT
+#else
+#define MDNS_MAX_IFACES CONFIG_NET_IF_MAX_IPV6_COUNT
+#endif
+
+/* Interface of each slot of the per interface tables */
+static atomic_ptr_t iface_slots[MDNS_MAX_IFACES];
+
+/* Time our answers to the hostname were last multicast, per interface,
+ * per address family of the responder context and per record type
+ * (A, AAAA).
+ */
+static int64_t host_last_sent[MDNS_MAX_IFACES][2][2];
+
+#if defined(CONFIG_MDNS_RESPONDER_DNS_SD)
+/* A DNS-SD response only depends on the record, on its port and on the
+ * local addresses. It is built once and sent again as long as these do
+ * not change.
+ */
+struct sd_template {
+	const struct dns_sd_rec *record;
+	struct in_addr addr4;
+	struct in6_addr addr6;
+	int64_t last_used;
+	int64_t last_sent[MDNS_MAX_IFACES];
+	sa_family_t family;
+	uint16_t port;
+	uint16_t len;
+	uint8_t service_type_enum : 1;
+	uint8_t has_addr4 : 1;
+	uint8_t has_addr6 : 1;
+	uint8_t buf[DNS_RESOLVER_MAX_BUF_SIZE];
+};
+
+static struct sd_template sd_templates[CONFIG_MDNS_RESPONDER_DNS_SD_TEMPLATES];
+static K_MUTEX_DEFINE(sd_templates_lock);
+#endif /* CONFIG_MDNS_RESPONDER_DNS_SD */
+
 static void create_ipv6_addr(struct sockaddr_in6 *addr)
 {
 	addr->sin6_family = AF_INET6;
@@ -250,17 +303,115 @@ static int create_answer(struct net_context *ctx,
 	return 0;
 }
 
+static const char *qtype_to_string(int qtype)
+{
+	switch (qtype) {
+	case DNS_RR_TYPE_A: return "A";
+	case DNS_RR_TYPE_CNAME: return "CNAME";
+	case DNS_RR_TYPE_PTR: return "PTR";
+	case DNS_RR_TYPE_TXT: return "TXT";
+	case DNS_RR_TYPE_AAAA: return "AAAA";
+	case DNS_RR_TYPE_SRV: return "SRV";
+	default: return "<unknown type>";
+	}
+}
+
+/* Slot of the interface in the per interface tables, taken on first use.
+ * Returns -1 if all the slots are taken by other interfaces.
+ */
+static int iface_slot(struct net_if *iface)
+{
+	for (int i = 0; i < ARRAY_SIZE(iface_slots); i++) {
+		if (atomic_ptr_cas(&iface_slots[i], NULL, iface) ||
+		    atomic_ptr_get(&iface_slots[i]) == iface) {
+			return i;
+		}
+	}
+
+	return -1;
+}
+
+/* RFC 6762 ch 6: a record must not be multicast again on the same link
+ * less than one second after it was last multicast.
+ */
+static bool rate_limited(const int64_t *last_sent)
+{
+	return CONFIG_MDNS_RESPONDER_RATE_LIMIT > 0 && last_sent != NULL &&
+	       *last_sent != 0 &&
+	       k_uptime_get() - *last_sent < CONFIG_MDNS_RESPONDER_RATE_LIMIT;
+}
+
+/* RFC 6762 ch 7.1: do not answer if the querier already knows the answer
+ * with at least half of its TTL remaining. The record data is given either
+ * as a name (PTR target) or as raw bytes.
+ */
+static bool is_known_answer(const struct dns_msg_t *dns_msg,
+			    const struct known_answers *known,
+			    enum dns_rr_type type, uint32_t ttl,
+			    const char *const *name, size_t name_count,
+			    const char *const *target, size_t target_count,
+			    const void *rdata, uint16_t rdlength)
+{
+	struct dns_rr_info rr;
+	int pos = known->pos;
+
+	for (int i = 0; i < known->count; i++) {
+		pos = dns_unpack_rr(dns_msg, pos, &rr);
+		if (pos < 0) {
+			return false;
+		}
+
+		if (rr.type != type || rr.ttl < ttl / 2 ||
+		    (rr.class_ & ~DNS_CLASS_FLUSH) != DNS_CLASS_IN) {
+			continue;
+		}
+
+		if (target != NULL) {
+			if (!dns_name_equal(dns_msg, rr.rdata_pos, target,
+					    target_count)) {
+				continue;
+			}
+		} else if (rr.rdlength != rdlength ||
+			   memcmp(dns_msg->msg + rr.rdata_pos, rdata, rdlength) != 0) {
+			continue;
+		}
+
+		if (dns_name_equal(dns_msg, rr.name_pos, name, name_count)) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
 static int send_response(struct net_context *ctx,
 			 struct net_if *iface,
 			 sa_family_t family,
 			 const void *src_addr,
+			 const struct dns_msg_t *dns_msg,
+			 const struct known_answers *known,
 			 struct net_buf *query,
 			 enum dns_rr_type qtype)
 {
+	const char *name[] = { net_hostname_get(), "local" };
+	int64_t *last_sent = NULL;
 	struct sockaddr dst;
 	socklen_t dst_len;
+	int slot;
 	int ret;
 
+	slot = iface_slot(iface);
+	if (slot >= 0) {
+		last_sent = &host_last_sent[slot][family == AF_INET6]
+					   [qtype == DNS_RR_TYPE_AAAA];
+	}
+
+	if (rate_limited(last_sent)) {
+		NET_DBG("%s answer sent less than %d ms ago",
+			qtype_to_string(qtype), CONFIG_MDNS_RESPONDER_RATE_LIMIT);
+		return 0;
+	}
+
 	ret = setup_dst_addr(ctx, family, &dst, &dst_len);
 	if (ret < 0) {
 		NET_DBG("unable to set up the response address");
@@ -279,6 +430,13 @@ static int send_response(struct net_context *ctx,
 			addr = net_if_ipv4_select_src_addr(iface, &tmp_addr.sin_addr);
 		}
 
+		if (is_known_answer(dns_msg, known, qtype, MDNS_TTL,
+				    name, ARRAY_SIZE(name), NULL, 0,
+				    addr, sizeof(struct in_addr))) {
+			NET_DBG("Known answer, not sent");
+			return 0;
+		}
+
 		ret = create_answer(ctx, query, qtype, sizeof(struct in_addr), (uint8_t *)addr);
 		if (ret != 0) {
 			return ret;
@@ -295,6 +453,13 @@ static int send_response(struct net_context *ctx,
 			addr = net_if_ipv6_select_src_addr(iface, &tmp_addr.sin6_addr);
 		}
 
+		if (is_known_answer(dns_msg, known, qtype, MDNS_TTL,
+				    name, ARRAY_SIZE(name), NULL, 0,
+				    addr, sizeof(struct in6_addr))) {
+			NET_DBG("Known answer, not sent");
+			return 0;
+		}
+
 		ret = create_answer(ctx, query, qtype, sizeof(struct in6_addr), (uint8_t *)addr);
 		if (ret != 0) {
 			return -ENOMEM;
@@ -308,22 +473,138 @@ static int send_response(struct net_context *ctx,
 				 dst_len, NULL, K_NO_WAIT, NULL);
 	if (ret < 0) {
 		NET_DBG("Cannot send mDNS reply (%d)", ret);
+	} else if (last_sent != NULL) {
+		*last_sent = k_uptime_get();
 	}
 
 	return ret;
 }
 
-static const char *qtype_to_string(int qtype)
+#if defined(CONFIG_MDNS_RESPONDER_DNS_SD)
+static bool sd_template_is_valid(const struct sd_template *t,
+				 const struct in_addr *addr4,
+				 const struct in6_addr *addr6)
 {
-	switch (qtype) {
-	case DNS_RR_TYPE_A: return "A";
-	case DNS_RR_TYPE_CNAME: return "CNAME";
-	case DNS_RR_TYPE_PTR: return "PTR";
-	case DNS_RR_TYPE_TXT: return "TXT";
-	case DNS_RR_TYPE_AAAA: return "AAAA";
-	case DNS_RR_TYPE_SRV: return "SRV";
-	default: return "<unknown type>";
+	if (t->port != *(t->record->port) ||
+	    t->has_addr4 != (addr4 != NULL) || t->has_addr6 != (addr6 != NULL)) {
+		return false;
+	}
+
+	if (addr4 != NULL && !net_ipv4_addr_cmp(&t->addr4, addr4)) {
+		return false;
+	}
+
+	if (addr6 != NULL && !net_ipv6_addr_cmp(&t->addr6, addr6)) {
+		return false;
 	}
+
+	return true;
+}
+
+/* Return the response to send for the record, building it again only
+ * if the record port or the local addresses changed since it was last
+ * built. Must be called with sd_templates_lock held.
+ */
+static struct sd_template *sd_template_get(const struct dns_sd_rec *record,
+					   bool service_type_enum,
+					   sa_family_t family,
+					   const struct in_addr *addr4,
+					   const struct in6_addr *addr6)
+{
+	struct sd_template *t = NULL;
+	int ret;
+
+	for (size_t i = 0; i < ARRAY_SIZE(sd_templates); i++) {
+		struct sd_template *it = &sd_templates[i];
+
+		if (it->record == record && it->family == family &&
+		    it->service_type_enum == service_type_enum) {
+			t = it;
+			break;
+		}
+
+		/* Otherwise replace the least recently used one */
+		if (t == NULL || (t->record != NULL &&
+				  (it->record == NULL || it->last_used < t->last_used))) {
+			t = it;
+		}
+	}
+
+	t->last_used = k_uptime_get();
+
+	if (t->record == record && t->family == family &&
+	    t->service_type_enum == service_type_enum &&
+	    sd_template_is_valid(t, addr4, addr6)) {
+		return t;
+	}
+
+	if (t->record != record || t->family != family ||
+	    t->service_type_enum != service_type_enum) {
+		memset(t->last_sent, 0, sizeof(t->last_sent));
+	}
+
+	if (service_type_enum) {
+		ret = dns_sd_handle_service_type_enum(record, addr4, addr6,
+						      t->buf, sizeof(t->buf));
+	} else {
+		ret = dns_sd_handle_ptr_query(record, addr4, addr6,
+					      t->buf, sizeof(t->buf));
+	}
+
+	if (ret < 0) {
+		NET_DBG("Cannot build DNS-SD response (%d)", ret);
+		t->record = NULL;
+		return NULL;
+	}
+
+	NET_DBG("Built DNS-SD response for %s.%s.%s.%s (%d bytes)",
+		record->instance, record->service, record->proto,
+		record->domain, ret);
+
+	t->record = record;
+	t->family = family;
+	t->service_type_enum = service_type_enum;
+	t->port = *(record->port);
+	t->has_addr4 = addr4 != NULL;
+	t->has_addr6 = addr6 != NULL;
+	t->len = ret;
+
+	if (addr4 != NULL) {
+		t->addr4 = *addr4;
+	}
+
+	if (addr6 != NULL) {
+		t->addr6 = *addr6;
+	}
+
+	return t;
+}
+
+static bool sd_is_known_answer(const struct dns_msg_t *dns_msg,
+			       const struct known_answers *known,
+			       const struct dns_sd_rec *record,
+			       bool service_type_enum)
+{
+	static const char * const services[] = {
+		"_services", "_dns-sd", "_udp", "local",
+	};
+	const char *instance[] = {
+		record->instance, record->service, record->proto, record->domain,
+	};
+
+	if (known->count == 0) {
+		return false;
+	}
+
+	if (service_type_enum) {
+		return is_known_answer(dns_msg, known, DNS_RR_TYPE_PTR,
+				       DNS_SD_PTR_TTL, services, ARRAY_SIZE(services),
+				       &instance[1], ARRAY_SIZE(instance) - 1, NULL, 0);
+	}
+
+	return is_known_answer(dns_msg, known, DNS_RR_TYPE_PTR, DNS_SD_PTR_TTL,
+			       &instance[1], ARRAY_SIZE(instance) - 1,
+			       instance, ARRAY_SIZE(instance), NULL, 0);
 }
 
 static void send_sd_response(struct net_context *ctx,
@@ -331,7 +612,7 @@ static void send_sd_response(struct net_context *ctx,
 			     sa_family_t family,
 			     const void *src_addr,
 			     struct dns_msg_t *dns_msg,
-			     struct net_buf *result)
+			     const struct known_answers *known)
 {
 	int ret;
 	/* filter must be zero-initialized for "wildcard" port */
@@ -353,6 +634,7 @@ static void send_sd_response(struct net_context *ctx,
 		ARRAY_SIZE(domain_buf),
 	};
 	size_t n = ARRAY_SIZE(label);
+	int slot;
 
 	BUILD_ASSERT(ARRAY_SIZE(label) == ARRAY_SIZE(size), "");
 
@@ -395,6 +677,8 @@ static void send_sd_response(struct net_context *ctx,
 		}
 	}
 
+	slot = iface_slot(iface);
+
 	ret = dns_sd_query_extract(dns_msg->msg,
 		dns_msg->msg_size, &filter, label, size, &n);
 	if (ret < 0) {
@@ -418,44 +702,67 @@ static void send_sd_response(struct net_context *ctx,
 	}
 
 	DNS_SD_FOREACH(record) {
+		struct sd_template *t;
+
 		/* Checks validity and then compare */
-		if (dns_sd_rec_match(record, &filter)) {
-			NET_DBG("matched query: %s.%s.%s.%s port: %u",
-				record->instance, record->service,
-				record->proto, record->domain,
-				ntohs(*(record->port)));
-
-			/* Construct the response */
-			if (service_type_enum) {
-				ret = dns_sd_handle_service_type_enum(record, addr4, addr6,
-					result->data, result->size);
-				if (ret < 0) {
-					NET_DBG("dns_sd_handle_service_type_enum() failed (%d)",
-						ret);
-					continue;
-				}
-			} else {
-				ret = dns_sd_handle_ptr_query(record, addr4, addr6,
-					result->data, result->size);
-				if (ret < 0) {
-					NET_DBG("dns_sd_handle_ptr_query() failed (%d)", ret);
-					continue;
-				}
-			}
+		if (!dns_sd_rec_match(record, &filter)) {
+			continue;
+		}
 
-			result->len = ret;
+		NET_DBG("matched query: %s.%s.%s.%s port: %u",
+			record->instance, record->service,
+			record->proto, record->domain,
+			ntohs(*(record->port)));
 
-			/* Send the response */
-			ret = net_context_sendto(ctx, result->data,
-				result->len, &dst, dst_len, NULL,
-				K_NO_WAIT, NULL);
-			if (ret < 0) {
-				NET_DBG("Cannot send mDNS reply (%d)", ret);
-				continue;
-			}
+		if (sd_is_known_answer(dns_msg, known, record, service_type_enum)) {
+			NET_DBG("Known answer, not sent");
+			continue;
+		}
+
+		/* The service may have been closed since the response
+		 * was built.
+		 */
+		ret = dns_sd_rec_check(record, addr4, addr6);
+		if (ret < 0) {
+			continue;
 		}
+
+		k_mutex_lock(&sd_templates_lock, K_FOREVER);
+
+		t = sd_template_get(record, service_type_enum, family, addr4, addr6);
+		if (t == NULL) {
+			goto next;
+		}
+
+		if (slot >= 0 && rate_limited(&t->last_sent[slot])) {
+			NET_DBG("Response sent less than %d ms ago",
+				CONFIG_MDNS_RESPONDER_RATE_LIMIT);
+			goto next;
+		}
+
+		/* Send the response */
+		ret = net_context_sendto(ctx, t->buf, t->len, &dst, dst_len,
+					 NULL, K_NO_WAIT, NULL);
+		if (ret < 0) {
+			NET_DBG("Cannot send mDNS reply (%d)", ret);
+		} else if (slot >= 0) {
+			t->last_sent[slot] = k_uptime_get();
+		}
+
+next:
+		k_mutex_unlock(&sd_templates_lock);
 	}
 }
+#else
+static inline void send_sd_response(struct net_context *ctx,
+				    struct net_if *iface,
+				    sa_family_t family,
+				    const void *src_addr,
+				    struct dns_msg_t *dns_msg,
+				    const struct known_answers *known)
+{
+}
+#endif /* CONFIG_MDNS_RESPONDER_DNS_SD */
 
 static int dns_read(struct net_context *ctx,
 		    struct net_pkt *pkt,
@@ -465,6 +772,7 @@ static int dns_read(struct net_context *ctx,
 	/* Helper struct to track the dns msg received from the server */
 	const char *hostname = net_hostname_get();
 	int hostname_len = strlen(hostname);
+	struct known_answers known = { 0 };
 	struct net_buf *result;
 	struct dns_msg_t dns_msg;
 	const void *src_addr;
@@ -501,6 +809,19 @@ static int dns_read(struct net_context *ctx,
 
 	queries = ret;
 
+	/* The known answers follow the questions */
+	known.count = dns_unpack_header_ancount(dns_msg.msg);
+	ret = DNS_MSG_HEADER_SIZE;
+	for (int i = 0; i < queries && ret > 0 && known.count > 0; i++) {
+		ret = dns_skip_question(&dns_msg, ret);
+	}
+
+	if (ret < 0) {
+		known.count = 0;
+	} else {
+		known.pos = ret;
+	}
+
 	src_addr = net_pkt_family(pkt) == AF_INET
 		 ? (const void *)&NET_IPV4_HDR(pkt)->src : (const void *)&NET_IPV6_HDR(pkt)->src;
 
@@ -541,11 +862,11 @@ static int dns_read(struct net_context *ctx,
 			NET_DBG("mDNS query to our hostname %s.local",
 				hostname);
 			send_response(ctx, net_pkt_iface(pkt), net_pkt_family(pkt), src_addr,
-				      result, qtype);
+				      &dns_msg, &known, result, qtype);
 		} else if (IS_ENABLED(CONFIG_MDNS_RESPONDER_DNS_SD)
 			&& qtype == DNS_RR_TYPE_PTR) {
 			send_sd_response(ctx, net_pkt_iface(pkt), net_pkt_family(pkt), src_addr,
-					 &dns_msg, result);
+					 &dns_msg, &known);
 		}
 
 	} while (--queries);
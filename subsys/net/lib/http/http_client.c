@@ -272,6 +272,17 @@ static int on_body(struct http_parser *parser, const char *at, size_t length)
 		req->internal.response.http_cb->on_body(parser, at, length);
 	}
 
+	if (req->body_cb) {
+		int ret;
+
+		ret = req->body_cb(&req->internal.response, (const uint8_t *)at,
+				   length, req->internal.user_data);
+		if (ret < 0) {
+			NET_DBG("Body sink aborted the transfer (%d)", ret);
+			return ret;
+		}
+	}
+
 	/* Reset the body_frag_start pointer for each fragment. */
 	if (!req->internal.response.body_frag_start) {
 		req->internal.response.body_frag_start = (uint8_t *)at;
@@ -447,22 +458,32 @@ static int http_wait_data(int sock, struct http_request *req, int32_t timeout)
 		} else if (fds[0].revents & ZSOCK_POLLHUP) {
 			/* Connection closed */
 			LOG_DBG("Connection closed");
-			goto finalize_data;
+			goto closed;
 		} else if (fds[0].revents & ZSOCK_POLLIN) {
 			received = zsock_recv(sock, req->internal.response.recv_buf + offset,
 					      req->internal.response.recv_buf_len - offset, 0);
 			if (received == 0) {
 				/* Connection closed */
 				LOG_DBG("Connection closed");
-				goto finalize_data;
+				goto closed;
 			} else if (received < 0) {
 				goto error;
 			} else {
+				req->internal.received += received;
 				req->internal.response.data_len += received;
 
 				(void)http_parser_execute(
 					&req->internal.parser, &req->internal.parser_settings,
 					req->internal.response.recv_buf + offset, received);
+
+				if (HTTP_PARSER_ERRNO(&req->internal.parser) != HPE_OK) {
+					/* The rest of the response cannot be parsed */
+					LOG_DBG("Parse error (%s)",
+						http_errno_name(HTTP_PARSER_ERRNO(
+							&req->internal.parser)));
+					total_received += received;
+					goto parse_error;
+				}
 			}
 
 			total_received += received;
@@ -511,12 +532,30 @@ static int http_wait_data(int sock, struct http_request *req, int32_t timeout)
 
 	return ret;
 
+closed:
+	if (total_received == 0 && req->internal.no_null_response) {
+		return -ECONNRESET;
+	}
+
 finalize_data:
 	ret = total_received;
 
 	http_data_final_null_resp(req);
 	return ret;
 
+parse_error:
+	/* What was received is given as the final data, the response is not
+	 * complete so message_complete tells that it failed.
+	 */
+	req->internal.response.message_complete = 0;
+
+	if (req->internal.response.cb) {
+		req->internal.response.cb(&req->internal.response, HTTP_DATA_FINAL,
+					  req->internal.user_data);
+	}
+
+	return -EBADMSG;
+
 error:
 	LOG_DBG("Connection error (%d)", errno);
 	ret = -errno;
@@ -547,6 +586,7 @@ int http_client_req(int sock, struct http_request *req,
 	req->internal.response.recv_buf_len = req->recv_buf_len;
 	req->internal.user_data = user_data;
 	req->internal.sock = sock;
+	req->internal.received = 0;
 
 	method = http_method_str(req->method);
 
@@ -717,6 +757,10 @@ int http_client_req(int sock, struct http_request *req,
 	total_recv = http_wait_data(sock, req, timeout);
 	if (total_recv < 0) {
 		NET_DBG("Wait data failure (%d)", total_recv);
+
+		if (req->internal.no_null_response || total_recv == -EBADMSG) {
+			return total_recv;
+		}
 	} else {
 		NET_DBG("Received %d bytes", total_recv);
 	}
@@ -0,0 +1,333 @@
+/** @file
+ * @brief HTTP client connection pool
+ *
+ * Keeps persistent connections open between HTTP client requests.
+ */
+
+/*
+ * Copyright The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(net_http, CONFIG_NET_HTTP_LOG_LEVEL);
+
+#include <zephyr/kernel.h>
+#include <string.h>
+#include <errno.h>
+#include <stdbool.h>
+
+#include <zephyr/net/net_ip.h>
+#include <zephyr/net/socket.h>
+#include <zephyr/net/http/client.h>
+
+#include "net_private.h"
+
+#define IDLE_TIMEOUT_MS (CONFIG_HTTP_CLIENT_POOL_IDLE_TIMEOUT * MSEC_PER_SEC)
+
+struct http_client_conn {
+	/* Server the connection is for */
+	struct http_client_pool_host host;
+
+	/* Time the connection was last returned to the pool */
+	int64_t last_used;
+
+	int sock;
+
+	uint8_t is_open : 1;
+	uint8_t in_use : 1;
+};
+
+static struct http_client_conn conns[CONFIG_HTTP_CLIENT_POOL_SIZE];
+static K_MUTEX_DEFINE(pool_lock);
+
+static bool addr_equal(const struct sockaddr *a, const struct sockaddr *b)
+{
+	if (a->sa_family != b->sa_family) {
+		return false;
+	}
+
+	if (IS_ENABLED(CONFIG_NET_IPV4) && a->sa_family == AF_INET) {
+		return net_sin(a)->sin_port == net_sin(b)->sin_port &&
+		       net_ipv4_addr_cmp(&net_sin(a)->sin_addr,
+					 &net_sin(b)->sin_addr);
+	}
+
+	if (IS_ENABLED(CONFIG_NET_IPV6) && a->sa_family == AF_INET6) {
+		return net_sin6(a)->sin6_port == net_sin6(b)->sin6_port &&
+		       net_ipv6_addr_cmp(&net_sin6(a)->sin6_addr,
+					 &net_sin6(b)->sin6_addr);
+	}
+
+	return false;
+}
+
+static bool host_equal(const struct http_client_pool_host *a,
+		       const struct http_client_pool_host *b)
+{
+	if (a->proto != b->proto || !addr_equal(&a->addr, &b->addr)) {
+		return false;
+	}
+
+	if (a->sec_tag_list != b->sec_tag_list ||
+	    a->sec_tag_count != b->sec_tag_count) {
+		return false;
+	}
+
+	if (a->tls_hostname == NULL || b->tls_hostname == NULL) {
+		return a->tls_hostname == b->tls_hostname;
+	}
+
+	return strcmp(a->tls_hostname, b->tls_hostname) == 0;
+}
+
+static void conn_close(struct http_client_conn *conn)
+{
+	if (conn->is_open) {
+		NET_DBG("[%p] Closing connection (sock %d)", conn, conn->sock);
+
+		(void)zsock_close(conn->sock);
+		conn->is_open = 0;
+	}
+}
+
+static int conn_open(struct http_client_conn *conn,
+		     const struct http_client_pool_host *host)
+{
+	int sock, ret;
+
+	sock = zsock_socket(host->addr.sa_family, SOCK_STREAM, host->proto);
+	if (sock < 0) {
+		return -errno;
+	}
+
+#if defined(CONFIG_NET_SOCKETS_SOCKOPT_TLS)
+	if (host->sec_tag_list != NULL && host->sec_tag_count > 0) {
+		ret = zsock_setsockopt(sock, SOL_TLS, TLS_SEC_TAG_LIST,
+				       host->sec_tag_list,
+				       host->sec_tag_count * sizeof(sec_tag_t));
+		if (ret < 0) {
+			goto fail;
+		}
+	}
+
+	if (host->tls_hostname != NULL) {
+		ret = zsock_setsockopt(sock, SOL_TLS, TLS_HOSTNAME,
+				       host->tls_hostname,
+				       strlen(host->tls_hostname));
+		if (ret < 0) {
+			goto fail;
+		}
+	}
+#endif
+
+	ret = zsock_connect(sock, &host->addr, host->addrlen);
+	if (ret < 0) {
+		goto fail;
+	}
+
+	conn->sock = sock;
+	conn->is_open = 1;
+
+	NET_DBG("[%p] Connected (sock %d)", conn, sock);
+
+	return 0;
+
+fail:
+	ret = -errno;
+	(void)zsock_close(sock);
+
+	return ret;
+}
+
+/* An idle connection must not have anything to read. If it is readable the
+ * server has either closed it or sent something we cannot match to any
+ * request, in both cases the connection is useless.
+ */
+static bool conn_is_stale(struct http_client_conn *conn)
+{
+	struct zsock_pollfd pfd = {
+		.fd = conn->sock,
+		.events = ZSOCK_POLLIN,
+	};
+
+	if (k_uptime_get() - conn->last_used > IDLE_TIMEOUT_MS) {
+		return true;
+	}
+
+	return zsock_poll(&pfd, 1, 0) != 0;
+}
+
+/* Reserve a connection slot for the host. Returns the slot, with an open
+ * connection if an idle one could be reused, or NULL if all the slots are
+ * in use.
+ */
+static struct http_client_conn *pool_acquire(const struct http_client_pool_host *host)
+{
+	struct http_client_conn *conn = NULL;
+	struct http_client_conn *lru = NULL;
+
+	k_mutex_lock(&pool_lock, K_FOREVER);
+
+	for (size_t i = 0; i < ARRAY_SIZE(conns); i++) {
+		struct http_client_conn *c = &conns[i];
+
+		if (c->in_use) {
+			continue;
+		}
+
+		if (c->is_open && host_equal(&c->host, host)) {
+			if (!conn_is_stale(c)) {
+				conn = c;
+				break;
+			}
+
+			conn_close(c);
+		}
+
+		if (!c->is_open) {
+			if (lru == NULL || lru->is_open) {
+				lru = c;
+			}
+		} else if (lru == NULL ||
+			   (lru->is_open && c->last_used < lru->last_used)) {
+			lru = c;
+		}
+	}
+
+	if (conn == NULL && lru != NULL) {
+		/* Prefer a free slot, otherwise evict the least recently
+		 * used idle connection.
+		 */
+		conn = lru;
+		conn_close(conn);
+		conn->host = *host;
+	}
+
+	if (conn != NULL) {
+		conn->in_use = 1;
+	}
+
+	k_mutex_unlock(&pool_lock);
+
+	return conn;
+}
+
+/* A request can be sent again without side effects only if the method is
+ * idempotent (RFC 7231, section 4.2.2) and the request can be generated
+ * again without calling back to the application.
+ */
+static bool req_is_retryable(const struct http_request *req)
+{
+	switch (req->method) {
+	case HTTP_GET:
+	case HTTP_HEAD:
+	case HTTP_OPTIONS:
+	case HTTP_TRACE:
+	case HTTP_PUT:
+	case HTTP_DELETE:
+		break;
+	default:
+		return false;
+	}
+
+	return req->payload_cb == NULL && req->optional_headers_cb == NULL;
+}
+
+static void pool_release(struct http_client_conn *conn, bool keep)
+{
+	k_mutex_lock(&pool_lock, K_FOREVER);
+
+	if (!keep) {
+		conn_close(conn);
+	}
+
+	conn->last_used = k_uptime_get();
+	conn->in_use = 0;
+
+	k_mutex_unlock(&pool_lock);
+}
+
+int http_client_pool_req(const struct http_client_pool_host *host,
+			 struct http_request *req, int32_t timeout,
+			 void *user_data)
+{
+	struct http_client_conn *conn;
+	bool retry;
+	bool keep;
+	int ret;
+
+	if (host == NULL || req == NULL) {
+		return -EINVAL;
+	}
+
+	conn = pool_acquire(host);
+	if (conn == NULL) {
+		NET_DBG("No free connection in the pool");
+		return -EBUSY;
+	}
+
+	/* The connection is reserved for us, so it can be used without
+	 * holding the pool lock while connecting and waiting for data.
+	 */
+	retry = conn->is_open && req_is_retryable(req);
+	if (!conn->is_open) {
+		ret = conn_open(conn, host);
+		if (ret < 0) {
+			NET_DBG("Cannot connect (%d)", ret);
+			pool_release(conn, false);
+			return ret;
+		}
+	}
+
+	/* On a reused connection a close before any response data is reported
+	 * as an error, the response callback is then not called and the
+	 * request can be sent again.
+	 */
+	req->internal.no_null_response = retry;
+
+	ret = http_client_req(conn->sock, req, timeout, user_data);
+	if (ret < 0 && ret != -EINVAL && retry && req->internal.received == 0) {
+		/* The server dropped the idle connection just before the
+		 * request arrived. Nothing has been received, so the request
+		 * is sent again over a new connection.
+		 */
+		NET_DBG("[%p] Reused connection failed (%d), reconnecting",
+			conn, ret);
+
+		conn_close(conn);
+		req->internal.no_null_response = 0U;
+
+		ret = conn_open(conn, host);
+		if (ret == 0) {
+			ret = http_client_req(conn->sock, req, timeout, user_data);
+		}
+	}
+
+	req->internal.no_null_response = 0U;
+
+	/* Keep the connection only if the response was fully read and the
+	 * server did not ask to close it, otherwise the next response would
+	 * be parsed from the middle of this one.
+	 */
+	keep = ret >= 0 && req->internal.response.message_complete &&
+	       http_should_keep_alive(&req->internal.parser);
+
+	pool_release(conn, keep);
+
+	return ret;
+}
+
+void http_client_pool_close_all(void)
+{
+	k_mutex_lock(&pool_lock, K_FOREVER);
+
+	for (size_t i = 0; i < ARRAY_SIZE(conns); i++) {
+		if (!conns[i].in_use) {
+			conn_close(&conns[i]);
+		}
+	}
+
+	k_mutex_unlock(&pool_lock);
+}
@@ -476,6 +476,48 @@ int parser_header_state(struct http_parser *parser, char ch, char c)
 	return 0;
 }
 
+/* Return a pointer to the first CR or LF in [p, end), or end if there is
+ * none. Header values are long compared to the rest of a header line, so
+ * the bulk of the scan is done one machine word at a time.
+ */
+static const char *find_eol(const char *p, const char *end)
+{
+	const uintptr_t ones = (uintptr_t)-1 / 0xff;
+	const uintptr_t highs = ones * 0x80;
+	const uintptr_t cr = ones * CR;
+	const uintptr_t lf = ones * LF;
+	uintptr_t word, x, y;
+
+	while (p != end && ((uintptr_t)p % sizeof(word)) != 0) {
+		if (*p == CR || *p == LF) {
+			return p;
+		}
+
+		p++;
+	}
+
+	/* A byte of x or y is zero where the word holds CR or LF. */
+	while ((size_t)(end - p) >= sizeof(word)) {
+		memcpy(&word, p, sizeof(word));
+		x = word ^ cr;
+		y = word ^ lf;
+
+		if ((((x - ones) & ~x) | ((y - ones) & ~y)) & highs) {
+			break;
+		}
+
+		p += sizeof(word);
+	}
+
+	for (; p != end; p++) {
+		if (*p == CR || *p == LF) {
+			return p;
+		}
+	}
+
+	return end;
+}
+
 static
 int header_states(struct http_parser *parser, const char *data, size_t len,
 		  const char **ptr, enum state *p_state,
@@ -488,20 +530,12 @@ int header_states(struct http_parser *parser, const char *data, size_t len,
 	switch (h_state) {
 	case h_general: {
 		size_t limit = data + len - p;
-		const char *p_cr;
-		const char *p_lf;
+		const char *p_eol;
 
 		limit = MIN(limit, HTTP_MAX_HEADER_SIZE);
-		p_cr = (const char *)memchr(p, CR, limit);
-		p_lf = (const char *)memchr(p, LF, limit);
-		if (p_cr != NULL) {
-			if (p_lf != NULL && p_cr >= p_lf) {
-				p = p_lf;
-			} else {
-				p = p_cr;
-			}
-		} else if (UNLIKELY(p_lf != NULL)) {
-			p = p_lf;
+		p_eol = find_eol(p, p + limit);
+		if (p_eol != p + limit) {
+			p = p_eol;
 		} else {
 			p = data + len;
 		}
@@ -1550,6 +1584,20 @@ reexecute:
 				if (!c) {
 					break;
 				}
+
+				/* The name can no longer match any of the
+				 * headers the parser is interested in, so only
+				 * look for the end of the token.
+				 */
+				if (parser->header_state == h_general) {
+					while (p + 1 != data + len &&
+					       TOKEN(p[1])) {
+						p++;
+					}
+
+					continue;
+				}
+
 				parser_header_state(parser, ch, c);
 			}
 
@@ -0,0 +1,823 @@
+/** @file
+ * @brief HTTP server
+ *
+ * Event driven HTTP/1.1 server serving the services and resources defined
+ * with HTTP_SERVICE_DEFINE() and HTTP_RESOURCE_DEFINE().
+ */
+
+/*
+ * Copyright The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(net_http_server, CONFIG_NET_HTTP_SERVER_LOG_LEVEL);
+
+#include <zephyr/kernel.h>
+#include <string.h>
+#include <errno.h>
+#include <stdbool.h>
+
+#include <zephyr/net/net_core.h>
+#include <zephyr/net/net_ip.h>
+#include <zephyr/net/socket.h>
+#include <zephyr/net/http/parser.h>
+#include <zephyr/net/http/server.h>
+#include <zephyr/net/http/status.h>
+
+#define MAX_SERVICES CONFIG_HTTP_SERVER_MAX_SERVICES
+#define MAX_CLIENTS CONFIG_HTTP_SERVER_MAX_CLIENTS
+
+/* Control socket, listening sockets and clients */
+#define MAX_POLL_FD (1 + MAX_SERVICES + MAX_CLIENTS)
+
+#define INACTIVITY_TIMEOUT_MS \
+	(CONFIG_HTTP_SERVER_CLIENT_INACTIVITY_TIMEOUT * MSEC_PER_SEC)
+
+#define MAX_HEADER_LEN 192
+
+#define THREAD_PRIORITY K_PRIO_PREEMPT(CONFIG_NUM_PREEMPT_PRIORITIES - 1)
+
+struct http_client_ctx {
+	/** Client socket, -1 if the slot is free */
+	int fd;
+
+	/** Service the client connected to */
+	const struct http_service_desc *service;
+
+	/** Request parser, keeps its state between received segments */
+	struct http_parser parser;
+
+	/** Uptime after which an idle connection is closed */
+	int64_t expiry;
+
+	/** Request target and body of the request being received */
+	size_t url_len;
+	size_t body_len;
+	char url[CONFIG_HTTP_SERVER_MAX_URL_LENGTH];
+	uint8_t body[CONFIG_HTTP_SERVER_MAX_REQUEST_BODY];
+
+	/** Request target did not fit into url buffer */
+	uint8_t url_overflow : 1;
+
+	/** Request body did not fit into body buffer */
+	uint8_t body_overflow : 1;
+
+	/** Connection is closed after the current response */
+	uint8_t close : 1;
+
+	/** Response being sent. Sockets are used in non-blocking mode, what
+	 * the socket does not take at once is sent when it becomes writable.
+	 */
+	const uint8_t *tx_body;
+	size_t tx_body_len;
+	size_t tx_hdr_len;
+	size_t tx_sent;
+	char tx_hdr[MAX_HEADER_LEN];
+
+	/** Buffer where dynamic resources generate their response */
+	uint8_t rsp_buf[CONFIG_HTTP_SERVER_RESPONSE_BUFFER_SIZE];
+};
+
+static struct http_server_ctx {
+	/** Poll set, rebuilt on every iteration of the event loop */
+	struct zsock_pollfd fds[MAX_POLL_FD];
+
+	/** Listening socket per service */
+	int listen_fds[MAX_SERVICES];
+	const struct http_service_desc *services[MAX_SERVICES];
+	size_t num_services;
+
+	/** Socketpair used to wake up the server thread */
+	int control_fds[2];
+
+	struct http_client_ctx clients[MAX_CLIENTS];
+
+	/** The event loop is single threaded so this can be shared by all
+	 * the clients.
+	 */
+	uint8_t rx_buf[CONFIG_HTTP_SERVER_RX_BUFFER_SIZE];
+
+	struct k_thread thread;
+	atomic_t running;
+} server;
+
+static K_THREAD_STACK_DEFINE(http_server_stack, CONFIG_HTTP_SERVER_STACK_SIZE);
+
+static const char *status_str(enum http_status status)
+{
+	switch (status) {
+	case HTTP_200_OK:
+		return "OK";
+	case HTTP_400_BAD_REQUEST:
+		return "Bad Request";
+	case HTTP_404_NOT_FOUND:
+		return "Not Found";
+	case HTTP_405_METHOD_NOT_ALLOWED:
+		return "Method Not Allowed";
+	case HTTP_413_PAYLOAD_TOO_LARGE:
+		return "Payload Too Large";
+	case HTTP_414_URI_TOO_LONG:
+		return "URI Too Long";
+	default:
+		break;
+	}
+
+	return "Internal Server Error";
+}
+
+static bool client_tx_pending(const struct http_client_ctx *client)
+{
+	return client->tx_sent < client->tx_hdr_len + client->tx_body_len;
+}
+
+/* Send as much of the pending response as the socket takes without
+ * blocking, so that a client that does not read its responses cannot stall
+ * the other clients.
+ */
+static int client_send(struct http_client_ctx *client)
+{
+	struct iovec io_vector[2];
+	struct msghdr msg;
+	int ret;
+
+	while (client_tx_pending(client)) {
+		if (client->tx_sent < client->tx_hdr_len) {
+			io_vector[0].iov_base = &client->tx_hdr[client->tx_sent];
+			io_vector[0].iov_len = client->tx_hdr_len - client->tx_sent;
+			io_vector[1].iov_base = (void *)client->tx_body;
+			io_vector[1].iov_len = client->tx_body_len;
+		} else {
+			io_vector[0].iov_base = (void *)&client->tx_body[client->tx_sent -
+									 client->tx_hdr_len];
+			io_vector[0].iov_len = client->tx_hdr_len + client->tx_body_len -
+					       client->tx_sent;
+			io_vector[1].iov_base = NULL;
+			io_vector[1].iov_len = 0;
+		}
+
+		memset(&msg, 0, sizeof(msg));
+		msg.msg_iov = io_vector;
+		msg.msg_iovlen = ARRAY_SIZE(io_vector);
+
+		ret = zsock_sendmsg(client->fd, &msg, ZSOCK_MSG_DONTWAIT);
+		if (ret < 0) {
+			if (errno == EAGAIN) {
+				return 0;
+			}
+
+			return -errno;
+		}
+
+		client->tx_sent += ret;
+		client->expiry = k_uptime_get() + INACTIVITY_TIMEOUT_MS;
+	}
+
+	return 0;
+}
+
+/* Send the response header and the body. The body is given to the socket
+ * layer from where it is stored, so static resources are never copied into
+ * a server buffer. What cannot be sent right away is sent from the event
+ * loop once the socket is writable.
+ */
+static int send_response(struct http_client_ctx *client,
+			 enum http_status status,
+			 const struct http_resource_detail *detail,
+			 const void *body, size_t body_len, bool send_body)
+{
+	char *hdr = client->tx_hdr;
+	int len;
+
+	len = snprintk(hdr, MAX_HEADER_LEN,
+		       "HTTP/1.1 %d %s\r\n"
+		       "Content-Length: %zu\r\n"
+		       "%s%s%s"
+		       "%s%s%s"
+		       "%s"
+		       "\r\n",
+		       status, status_str(status), body_len,
+		       (detail && detail->content_type) ? "Content-Type: " : "",
+		       (detail && detail->content_type) ? detail->content_type : "",
+		       (detail && detail->content_type) ? "\r\n" : "",
+		       (detail && detail->content_encoding) ? "Content-Encoding: " : "",
+		       (detail && detail->content_encoding) ?
+				detail->content_encoding : "",
+		       (detail && detail->content_encoding) ? "\r\n" : "",
+		       client->close ? "Connection: close\r\n" : "");
+	if (len < 0 || len >= MAX_HEADER_LEN) {
+		NET_ERR("Response header does not fit (%d)", len);
+		return -ENOMEM;
+	}
+
+	client->tx_hdr_len = len;
+	client->tx_body = body;
+	client->tx_body_len = send_body ? body_len : 0;
+	client->tx_sent = 0;
+
+	return client_send(client);
+}
+
+static int send_error(struct http_client_ctx *client, enum http_status status)
+{
+	return send_response(client, status, NULL, NULL, 0, false);
+}
+
+static struct http_resource_desc *find_resource(const struct http_service_desc *svc,
+						const char *path, size_t path_len)
+{
+	HTTP_SERVICE_FOREACH_RESOURCE(svc, res) {
+		if (strlen(res->resource) == path_len &&
+		    strncmp(res->resource, path, path_len) == 0) {
+			return res;
+		}
+	}
+
+	return NULL;
+}
+
+static int handle_request(struct http_client_ctx *client)
+{
+	enum http_method method = client->parser.method;
+	const struct http_resource_detail *detail;
+	struct http_resource_desc *res;
+	uint32_t method_bit;
+	size_t path_len;
+	bool send_body = true;
+	int ret;
+
+	if (!http_should_keep_alive(&client->parser)) {
+		client->close = 1U;
+	}
+
+	if (client->url_overflow) {
+		return send_error(client, HTTP_414_URI_TOO_LONG);
+	}
+
+	if (client->body_overflow) {
+		return send_error(client, HTTP_413_PAYLOAD_TOO_LARGE);
+	}
+
+	for (path_len = 0; path_len < client->url_len; path_len++) {
+		if (client->url[path_len] == '?' || client->url[path_len] == '#') {
+			break;
+		}
+	}
+
+	res = find_resource(client->service, client->url, path_len);
+	if (res == NULL || res->detail == NULL) {
+		NET_DBG("[%p] Resource %.*s not found", client, (int)path_len,
+			client->url);
+		return send_error(client, HTTP_404_NOT_FOUND);
+	}
+
+	detail = res->detail;
+
+	/* The bitmask of supported methods only covers the first 32 methods. */
+	if (method >= 32) {
+		return send_error(client, HTTP_405_METHOD_NOT_ALLOWED);
+	}
+
+	/* HEAD is served like GET, but without the body. */
+	if (method == HTTP_HEAD) {
+		method_bit = HTTP_METHOD_BIT(HTTP_GET) | HTTP_METHOD_BIT(HTTP_HEAD);
+		send_body = false;
+	} else {
+		method_bit = HTTP_METHOD_BIT(method);
+	}
+
+	if ((detail->bitmask_of_supported_http_methods & method_bit) == 0) {
+		return send_error(client, HTTP_405_METHOD_NOT_ALLOWED);
+	}
+
+	switch (detail->type) {
+	case HTTP_RESOURCE_TYPE_STATIC: {
+		const struct http_resource_detail_static *static_detail =
+			CONTAINER_OF(detail, struct http_resource_detail_static, common);
+
+		return send_response(client, HTTP_200_OK, detail,
+				     static_detail->static_data,
+				     static_detail->static_data_len, send_body);
+	}
+
+	case HTTP_RESOURCE_TYPE_DYNAMIC: {
+		const struct http_resource_detail_dynamic *dynamic_detail =
+			CONTAINER_OF(detail, struct http_resource_detail_dynamic, common);
+		struct http_server_request req = {
+			.method = method,
+			.url = client->url,
+			.url_len = client->url_len,
+			.body = client->body,
+			.body_len = client->body_len,
+		};
+
+		ret = dynamic_detail->cb(&req, client->rsp_buf, sizeof(client->rsp_buf),
+					 dynamic_detail->user_data);
+		if (ret < 0 || (size_t)ret > sizeof(client->rsp_buf)) {
+			return send_error(client, HTTP_500_INTERNAL_SERVER_ERROR);
+		}
+
+		return send_response(client, HTTP_200_OK, detail, client->rsp_buf,
+				     ret, send_body);
+	}
+
+	default:
+		break;
+	}
+
+	return send_error(client, HTTP_500_INTERNAL_SERVER_ERROR);
+}
+
+static int on_message_begin(struct http_parser *parser)
+{
+	struct http_client_ctx *client = parser->data;
+
+	client->url_len = 0;
+	client->body_len = 0;
+	client->url_overflow = 0U;
+	client->body_overflow = 0U;
+
+	return 0;
+}
+
+static int on_url(struct http_parser *parser, const char *at, size_t length)
+{
+	struct http_client_ctx *client = parser->data;
+
+	if (length > sizeof(client->url) - client->url_len) {
+		client->url_overflow = 1U;
+		return 0;
+	}
+
+	memcpy(&client->url[client->url_len], at, length);
+	client->url_len += length;
+
+	return 0;
+}
+
+static int on_body(struct http_parser *parser, const char *at, size_t length)
+{
+	struct http_client_ctx *client = parser->data;
+
+	if (length > sizeof(client->body) - client->body_len) {
+		client->body_overflow = 1U;
+		return 0;
+	}
+
+	memcpy(&client->body[client->body_len], at, length);
+	client->body_len += length;
+
+	return 0;
+}
+
+static int on_message_complete(struct http_parser *parser)
+{
+	struct http_client_ctx *client = parser->data;
+	int ret;
+
+	/* Pipelined requests are answered in order as the parser reaches the
+	 * end of each of them.
+	 */
+	ret = handle_request(client);
+	if (ret < 0) {
+		NET_DBG("[%p] Cannot send response (%d)", client, ret);
+		client->close = 1U;
+	}
+
+	if (client->close) {
+		/* Stop parsing, anything after this request is discarded. */
+		return 1;
+	}
+
+	if (client_tx_pending(client)) {
+		/* The next request is parsed once this response is sent. */
+		http_parser_pause(parser, 1);
+	}
+
+	return 0;
+}
+
+static const struct http_parser_settings parser_settings = {
+	.on_message_begin = on_message_begin,
+	.on_url = on_url,
+	.on_body = on_body,
+	.on_message_complete = on_message_complete,
+};
+
+static void client_close(struct http_client_ctx *client)
+{
+	NET_DBG("[%p] Closing connection %d", client, client->fd);
+
+	(void)zsock_close(client->fd);
+	client->fd = -1;
+	client->service = NULL;
+}
+
+static void client_recv(struct http_client_ctx *client)
+{
+	size_t parsed;
+	bool paused;
+	int ret;
+
+	/* Data is only peeked at first, so that what follows a request whose
+	 * response cannot be sent yet stays queued in the socket.
+	 */
+	ret = zsock_recv(client->fd, server.rx_buf, sizeof(server.rx_buf),
+			 ZSOCK_MSG_PEEK | ZSOCK_MSG_DONTWAIT);
+	if (ret < 0) {
+		if (errno == EAGAIN) {
+			return;
+		}
+
+		ret = -errno;
+	}
+
+	if (ret <= 0) {
+		/* Connection closed by peer or error. */
+		client_close(client);
+		return;
+	}
+
+	client->expiry = k_uptime_get() + INACTIVITY_TIMEOUT_MS;
+
+	parsed = http_parser_execute(&client->parser, &parser_settings,
+				     server.rx_buf, ret);
+
+	paused = (HTTP_PARSER_ERRNO(&client->parser) == HPE_PAUSED);
+	if (paused) {
+		http_parser_pause(&client->parser, 0);
+	}
+
+	if (parsed > 0) {
+		/* Consume what the parser went through. */
+		(void)zsock_recv(client->fd, server.rx_buf, parsed,
+				 ZSOCK_MSG_DONTWAIT);
+	}
+
+	if (client->close) {
+		if (!client_tx_pending(client)) {
+			client_close(client);
+		}
+
+		return;
+	}
+
+	if (paused) {
+		return;
+	}
+
+	if (parsed < (size_t)ret || client->parser.upgrade) {
+		NET_DBG("[%p] Invalid request (%s)", client,
+			http_errno_name(HTTP_PARSER_ERRNO(&client->parser)));
+
+		/* The connection is closed once the response is sent, from
+		 * the event loop if the socket does not take it all now.
+		 */
+		client->close = 1U;
+		ret = send_error(client, HTTP_400_BAD_REQUEST);
+		if (ret < 0 || !client_tx_pending(client)) {
+			client_close(client);
+		}
+	}
+}
+
+static void client_send_pending(struct http_client_ctx *client)
+{
+	int ret;
+
+	ret = client_send(client);
+	if (ret < 0) {
+		NET_DBG("[%p] Cannot send response (%d)", client, ret);
+		client_close(client);
+		return;
+	}
+
+	if (!client_tx_pending(client) && client->close) {
+		client_close(client);
+	}
+}
+
+static size_t service_client_count(const struct http_service_desc *svc)
+{
+	size_t count = 0;
+
+	for (size_t i = 0; i < ARRAY_SIZE(server.clients); i++) {
+		if (server.clients[i].fd >= 0 && server.clients[i].service == svc) {
+			count++;
+		}
+	}
+
+	return count;
+}
+
+static void client_accept(size_t svc_idx)
+{
+	const struct http_service_desc *svc = server.services[svc_idx];
+	struct http_client_ctx *client = NULL;
+	struct sockaddr addr;
+	socklen_t addrlen = sizeof(addr);
+	int fd;
+
+	fd = zsock_accept(server.listen_fds[svc_idx], &addr, &addrlen);
+	if (fd < 0) {
+		NET_DBG("accept failed (%d)", -errno);
+		return;
+	}
+
+	if (service_client_count(svc) < svc->concurrent) {
+		for (size_t i = 0; i < ARRAY_SIZE(server.clients); i++) {
+			if (server.clients[i].fd < 0) {
+				client = &server.clients[i];
+				break;
+			}
+		}
+	}
+
+	if (client == NULL) {
+		NET_DBG("No free client slot for service %s", svc->host);
+		(void)zsock_close(fd);
+		return;
+	}
+
+	memset(client, 0, sizeof(*client));
+	client->fd = fd;
+	client->service = svc;
+	client->expiry = k_uptime_get() + INACTIVITY_TIMEOUT_MS;
+
+	http_parser_init(&client->parser, HTTP_REQUEST);
+	client->parser.data = client;
+
+	NET_DBG("[%p] New connection %d to service %s", client, fd, svc->host);
+}
+
+static int listener_open(const struct http_service_desc *svc)
+{
+	struct sockaddr_storage addr_storage = { 0 };
+	struct sockaddr *addr = (struct sockaddr *)&addr_storage;
+	socklen_t addrlen;
+	int fd, ret;
+
+	if (IS_ENABLED(CONFIG_NET_IPV6) &&
+	    zsock_inet_pton(AF_INET6, svc->host, &net_sin6(addr)->sin6_addr) == 1) {
+		addr->sa_family = AF_INET6;
+	} else if (IS_ENABLED(CONFIG_NET_IPV4) &&
+		   zsock_inet_pton(AF_INET, svc->host, &net_sin(addr)->sin_addr) == 1) {
+		addr->sa_family = AF_INET;
+	} else {
+		/* Host name or virtual host, listen on any address. */
+		memset(&addr_storage, 0, sizeof(addr_storage));
+		addr->sa_family = IS_ENABLED(CONFIG_NET_IPV6) ? AF_INET6 : AF_INET;
+	}
+
+	if (IS_ENABLED(CONFIG_NET_IPV6) && addr->sa_family == AF_INET6) {
+		net_sin6(addr)->sin6_port = htons(*svc->port);
+		addrlen = sizeof(struct sockaddr_in6);
+	} else {
+		net_sin(addr)->sin_port = htons(*svc->port);
+		addrlen = sizeof(struct sockaddr_in);
+	}
+
+	fd = zsock_socket(addr->sa_family, SOCK_STREAM, IPPROTO_TCP);
+	if (fd < 0) {
+		return -errno;
+	}
+
+	ret = zsock_bind(fd, addr, addrlen);
+	if (ret < 0) {
+		goto fail;
+	}
+
+	ret = zsock_listen(fd, svc->backlog);
+	if (ret < 0) {
+		goto fail;
+	}
+
+	if (*svc->port == 0) {
+		/* Write back the ephemeral port that was assigned. */
+		ret = zsock_getsockname(fd, addr, &addrlen);
+		if (ret < 0) {
+			goto fail;
+		}
+
+		*svc->port = ntohs((IS_ENABLED(CONFIG_NET_IPV6) &&
+				    addr->sa_family == AF_INET6) ?
+				   net_sin6(addr)->sin6_port :
+				   net_sin(addr)->sin_port);
+	}
+
+	NET_DBG("Service %s listening on port %d", svc->host, *svc->port);
+
+	return fd;
+
+fail:
+	ret = -errno;
+	(void)zsock_close(fd);
+
+	return ret;
+}
+
+static void server_close_all(void)
+{
+	for (size_t i = 0; i < ARRAY_SIZE(server.clients); i++) {
+		if (server.clients[i].fd >= 0) {
+			client_close(&server.clients[i]);
+		}
+	}
+
+	for (size_t i = 0; i < server.num_services; i++) {
+		(void)zsock_close(server.listen_fds[i]);
+	}
+
+	server.num_services = 0;
+
+	for (size_t i = 0; i < ARRAY_SIZE(server.control_fds); i++) {
+		if (server.control_fds[i] >= 0) {
+			(void)zsock_close(server.control_fds[i]);
+			server.control_fds[i] = -1;
+		}
+	}
+}
+
+static int server_open(void)
+{
+	int ret;
+
+	server.num_services = 0;
+	server.control_fds[0] = -1;
+	server.control_fds[1] = -1;
+
+	for (size_t i = 0; i < ARRAY_SIZE(server.clients); i++) {
+		server.clients[i].fd = -1;
+	}
+
+	ret = zsock_socketpair(AF_UNIX, SOCK_STREAM, 0, server.control_fds);
+	if (ret < 0) {
+		server.control_fds[0] = -1;
+		server.control_fds[1] = -1;
+		return -errno;
+	}
+
+	HTTP_SERVICE_FOREACH(svc) {
+		if (server.num_services >= MAX_SERVICES) {
+			NET_ERR("Too many services, increase %s",
+				"CONFIG_HTTP_SERVER_MAX_SERVICES");
+			ret = -ENOMEM;
+			goto fail;
+		}
+
+		ret = listener_open(svc);
+		if (ret < 0) {
+			NET_ERR("Cannot listen for service %s (%d)", svc->host, ret);
+			goto fail;
+		}
+
+		server.listen_fds[server.num_services] = ret;
+		server.services[server.num_services] = svc;
+		server.num_services++;
+	}
+
+	return 0;
+
+fail:
+	server_close_all();
+
+	return ret;
+}
+
+/* Close connections that have been idle for too long and return the time
+ * until the next one expires.
+ */
+static int client_expire(void)
+{
+	int64_t now = k_uptime_get();
+	int64_t timeout = -1;
+
+	for (size_t i = 0; i < ARRAY_SIZE(server.clients); i++) {
+		struct http_client_ctx *client = &server.clients[i];
+
+		if (client->fd < 0) {
+			continue;
+		}
+
+		if (client->expiry <= now) {
+			NET_DBG("[%p] Inactivity timeout", client);
+			client_close(client);
+			continue;
+		}
+
+		if (timeout < 0 || client->expiry - now < timeout) {
+			timeout = client->expiry - now;
+		}
+	}
+
+	return (int)timeout;
+}
+
+static void http_server_thread(void *p1, void *p2, void *p3)
+{
+	struct http_client_ctx *polled[MAX_CLIENTS];
+	int nfds, nclients, timeout, ret;
+
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	while (true) {
+		timeout = client_expire();
+
+		nfds = 0;
+		nclients = 0;
+
+		server.fds[nfds].fd = server.control_fds[0];
+		server.fds[nfds++].events = ZSOCK_POLLIN;
+
+		for (size_t i = 0; i < server.num_services; i++) {
+			server.fds[nfds].fd = server.listen_fds[i];
+			server.fds[nfds++].events = ZSOCK_POLLIN;
+		}
+
+		for (size_t i = 0; i < ARRAY_SIZE(server.clients); i++) {
+			if (server.clients[i].fd < 0) {
+				continue;
+			}
+
+			/* Requests are not read while a response is pending. */
+			polled[nclients++] = &server.clients[i];
+			server.fds[nfds].fd = server.clients[i].fd;
+			server.fds[nfds++].events = client_tx_pending(&server.clients[i]) ?
+						    ZSOCK_POLLOUT : ZSOCK_POLLIN;
+		}
+
+		ret = zsock_poll(server.fds, nfds, timeout);
+		if (ret < 0) {
+			NET_ERR("poll failed (%d)", -errno);
+			break;
+		}
+
+		if (server.fds[0].revents) {
+			/* Stop requested */
+			break;
+		}
+
+		for (size_t i = 0; i < server.num_services; i++) {
+			if (server.fds[1 + i].revents & ZSOCK_POLLIN) {
+				client_accept(i);
+			}
+		}
+
+		for (int i = 0; i < nclients; i++) {
+			short revents = server.fds[1 + server.num_services + i].revents;
+
+			if (revents & ZSOCK_POLLOUT) {
+				client_send_pending(polled[i]);
+			} else if (revents & ZSOCK_POLLIN) {
+				client_recv(polled[i]);
+			} else if (revents & (ZSOCK_POLLERR | ZSOCK_POLLHUP |
+					      ZSOCK_POLLNVAL)) {
+				client_close(polled[i]);
+			}
+		}
+	}
+
+	server_close_all();
+	atomic_set(&server.running, 0);
+}
+
+int http_server_start(void)
+{
+	int ret;
+
+	if (!atomic_cas(&server.running, 0, 1)) {
+		return -EALREADY;
+	}
+
+	ret = server_open();
+	if (ret < 0) {
+		atomic_set(&server.running, 0);
+		return ret;
+	}
+
+	k_thread_create(&server.thread, http_server_stack,
+			K_THREAD_STACK_SIZEOF(http_server_stack),
+			http_server_thread, NULL, NULL, NULL,
+			THREAD_PRIORITY, 0, K_NO_WAIT);
+	k_thread_name_set(&server.thread, "http_server");
+
+	return 0;
+}
+
+int http_server_stop(void)
+{
+	char c = 0;
+
+	if (!atomic_get(&server.running)) {
+		return -EALREADY;
+	}
+
+	if (zsock_send(server.control_fds[1], &c, sizeof(c), 0) < 0) {
+		return -errno;
+	}
+
+	return k_thread_join(&server.thread, K_FOREVER);
+}
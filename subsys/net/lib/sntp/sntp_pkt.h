@@ -25,6 +25,13 @@
 #define SNTP_SET_VN(x, v)   (x = x | (v << SNTP_VN_SHIFT))
 #define SNTP_SET_MODE(x, v) (x = x | (v << SNTP_MODE_SHIFT))
 
+#define SNTP_LI_MAX 3
+#define SNTP_VERSION_NUMBER 3
+#define SNTP_MODE_CLIENT 3
+#define SNTP_MODE_SERVER 4
+#define SNTP_STRATUM_KOD 0 /* kiss-o'-death */
+#define OFFSET_1970_JAN_1 2208988800
+
 struct sntp_pkt {
 	uint8_t lvm;		/* li, vn, and mode in big endian fashion */
 	uint8_t stratum;
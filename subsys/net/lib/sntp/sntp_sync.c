@@ -0,0 +1,581 @@
+/*
+ * Copyright The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Clock synchronization against several SNTP servers, loosely following
+ * the NTP algorithms of RFC 5905:
+ *
+ * - every poll, each server is queried a burst of times in parallel and
+ *   the sample with the lowest round trip delay is kept (clock filter),
+ * - servers whose correctness intervals do not intersect with those of
+ *   the majority are discarded (Marzullo's algorithm),
+ * - the offsets of the remaining servers are combined, weighted by their
+ *   root distance, and CLOCK_REALTIME is slewed with adjtime(). It is only
+ *   stepped when the offset is too large to be slewed in reasonable time,
+ * - the poll interval grows while the clock stays within the measurement
+ *   noise and shrinks when it does not.
+ */
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(net_sntp, CONFIG_SNTP_LOG_LEVEL);
+
+#include <stdlib.h>
+#include <zephyr/kernel.h>
+#include <zephyr/net/sntp.h>
+#include <zephyr/posix/time.h>
+#include <zephyr/posix/sys/time.h>
+
+#include "sntp_pkt.h"
+
+#define STEP_THRESHOLD_NS ((int64_t)CONFIG_SNTP_SYNC_STEP_THRESHOLD_MS * NSEC_PER_MSEC)
+
+/* Offsets below this are considered to be in sync even if the measured
+ * jitter is lower, there is no point in polling more often for them.
+ */
+#define MIN_SYNC_THRESHOLD_NS (1 * NSEC_PER_MSEC)
+
+struct sntp_sync_server {
+	struct sockaddr addr;
+	int sock;
+
+	/* Transmit timestamp of the pending request, the server returns it
+	 * as the originate timestamp.
+	 */
+	uint32_t orig_tm_s;
+	uint32_t orig_tm_f;
+
+	/* Local time at which the pending request was sent */
+	int64_t t1;
+
+	/* Samples of the current burst */
+	int64_t offset[CONFIG_SNTP_SYNC_BURST];
+	int64_t delay[CONFIG_SNTP_SYNC_BURST];
+	uint8_t samples;
+
+	/* Result of the clock filter */
+	int64_t best_offset;
+	int64_t best_delay;
+	int64_t jitter;
+
+	/* The server agrees with the majority */
+	bool selected;
+};
+
+static struct {
+	struct sntp_sync_server servers[CONFIG_SNTP_SYNC_MAX_SERVERS];
+	struct zsock_pollfd fds[CONFIG_SNTP_SYNC_MAX_SERVERS];
+	size_t count;
+
+	struct sntp_sync_status status;
+	uint8_t poll_exp;
+	bool running;
+} sync;
+
+static K_MUTEX_DEFINE(sync_lock);
+static K_SEM_DEFINE(sync_stop, 0, 1);
+static K_THREAD_STACK_DEFINE(sync_stack, CONFIG_SNTP_SYNC_STACK_SIZE);
+static struct k_thread sync_thread;
+
+static int64_t realtime_ns(void)
+{
+	struct timespec ts;
+
+	(void)clock_gettime(CLOCK_REALTIME, &ts);
+
+	return (int64_t)ts.tv_sec * NSEC_PER_SEC + ts.tv_nsec;
+}
+
+static void ns_to_ntp(int64_t ns, uint32_t *s, uint32_t *f)
+{
+	*s = (uint32_t)(ns / NSEC_PER_SEC + OFFSET_1970_JAN_1);
+	*f = (uint32_t)(((uint64_t)(ns % NSEC_PER_SEC) << 32) / NSEC_PER_SEC);
+}
+
+static int64_t ntp_to_ns(uint32_t s, uint32_t f)
+{
+	uint64_t seconds;
+
+	/* See parse_response() in sntp.c for the era handling */
+	if (s & 0x80000000) {
+		seconds = s - OFFSET_1970_JAN_1;
+	} else {
+		seconds = s + 0x100000000ULL - OFFSET_1970_JAN_1;
+	}
+
+	return (int64_t)(seconds * NSEC_PER_SEC +
+			 (((uint64_t)f * NSEC_PER_SEC) >> 32));
+}
+
+static int send_request(struct sntp_sync_server *srv)
+{
+	struct sntp_pkt pkt = { 0 };
+	int ret;
+
+	SNTP_SET_LI(pkt.lvm, 0);
+	SNTP_SET_VN(pkt.lvm, SNTP_VERSION_NUMBER);
+	SNTP_SET_MODE(pkt.lvm, SNTP_MODE_CLIENT);
+
+	srv->t1 = realtime_ns();
+	ns_to_ntp(srv->t1, &srv->orig_tm_s, &srv->orig_tm_f);
+
+	pkt.tx_tm_s = htonl(srv->orig_tm_s);
+	pkt.tx_tm_f = htonl(srv->orig_tm_f);
+
+	ret = zsock_send(srv->sock, &pkt, sizeof(pkt), 0);
+	if (ret < 0) {
+		NET_DBG("Failed to send to server %d (%d)",
+			(int)(srv - sync.servers), errno);
+		return -errno;
+	}
+
+	return 0;
+}
+
+/* Returns true if the response to the pending request was received */
+static bool recv_response(struct sntp_sync_server *srv)
+{
+	struct sntp_pkt pkt;
+	int64_t t2, t3, t4;
+	int rcvd;
+
+	rcvd = zsock_recv(srv->sock, &pkt, sizeof(pkt), ZSOCK_MSG_DONTWAIT);
+	t4 = realtime_ns();
+
+	if (rcvd != sizeof(pkt)) {
+		return false;
+	}
+
+	/* Late responses to the previous requests of the burst do not match
+	 * and are dropped here.
+	 */
+	if (ntohl(pkt.orig_tm_s) != srv->orig_tm_s ||
+	    ntohl(pkt.orig_tm_f) != srv->orig_tm_f) {
+		return false;
+	}
+
+	if (SNTP_GET_MODE(pkt.lvm) != SNTP_MODE_SERVER ||
+	    SNTP_GET_LI(pkt.lvm) == SNTP_LI_MAX ||
+	    pkt.stratum == SNTP_STRATUM_KOD ||
+	    (pkt.tx_tm_s == 0 && pkt.tx_tm_f == 0) ||
+	    (ntohl(pkt.tx_tm_s) & 0x80000000 &&
+	     ntohl(pkt.tx_tm_s) < OFFSET_1970_JAN_1)) {
+		NET_DBG("Server %d is not synchronized",
+			(int)(srv - sync.servers));
+		srv->orig_tm_s = 0;
+		return true;
+	}
+
+	/* Make sure a duplicate is not taken into account */
+	srv->orig_tm_s = 0;
+
+	t2 = ntp_to_ns(ntohl(pkt.rx_tm_s), ntohl(pkt.rx_tm_f));
+	t3 = ntp_to_ns(ntohl(pkt.tx_tm_s), ntohl(pkt.tx_tm_f));
+
+	srv->offset[srv->samples] = ((t2 - srv->t1) + (t3 - t4)) / 2;
+	srv->delay[srv->samples] = MAX((t4 - srv->t1) - (t3 - t2), 0);
+	srv->samples++;
+
+	return true;
+}
+
+/* Query all the servers once and wait for the responses */
+static void query_servers(uint32_t timeout)
+{
+	int64_t deadline = k_uptime_get() + timeout;
+	size_t pending = 0;
+	int64_t remaining;
+	int ret;
+
+	for (size_t i = 0; i < sync.count; i++) {
+		if (send_request(&sync.servers[i]) == 0) {
+			sync.fds[i].fd = sync.servers[i].sock;
+			pending++;
+		} else {
+			/* Negative descriptors are ignored by poll */
+			sync.fds[i].fd = -1;
+		}
+	}
+
+	while (pending > 0) {
+		remaining = deadline - k_uptime_get();
+		if (remaining <= 0) {
+			break;
+		}
+
+		ret = zsock_poll(sync.fds, sync.count, remaining);
+		if (ret <= 0) {
+			break;
+		}
+
+		for (size_t i = 0; i < sync.count; i++) {
+			if (!(sync.fds[i].revents & ZSOCK_POLLIN)) {
+				continue;
+			}
+
+			if (recv_response(&sync.servers[i])) {
+				sync.fds[i].fd = -1;
+				pending--;
+			}
+		}
+	}
+}
+
+/* Keep the sample with the lowest delay, it is the least affected by
+ * queueing in the network.
+ */
+static void clock_filter(struct sntp_sync_server *srv)
+{
+	int64_t sum = 0;
+	uint8_t best = 0;
+
+	for (uint8_t i = 1; i < srv->samples; i++) {
+		if (srv->delay[i] < srv->delay[best]) {
+			best = i;
+		}
+	}
+
+	for (uint8_t i = 0; i < srv->samples; i++) {
+		sum += llabs(srv->offset[i] - srv->offset[best]);
+	}
+
+	srv->best_offset = srv->offset[best];
+	srv->best_delay = srv->delay[best];
+	srv->jitter = sum / srv->samples;
+}
+
+static int64_t root_distance(const struct sntp_sync_server *srv)
+{
+	/* Never zero, it is used as a weight divisor */
+	return srv->best_delay / 2 + srv->jitter + NSEC_PER_USEC;
+}
+
+/* Marzullo's algorithm, find the smallest interval that is consistent with
+ * the largest number of servers. Returns that number of servers.
+ */
+static int select_interval(int64_t *low, int64_t *high)
+{
+	struct {
+		int64_t value;
+		int type;
+	} edges[2 * CONFIG_SNTP_SYNC_MAX_SERVERS], tmp;
+	size_t n = 0;
+	int best = 0;
+	int count = 0;
+
+	for (size_t i = 0; i < sync.count; i++) {
+		struct sntp_sync_server *srv = &sync.servers[i];
+
+		if (srv->samples == 0) {
+			continue;
+		}
+
+		edges[n].value = srv->best_offset - root_distance(srv);
+		edges[n++].type = -1;
+		edges[n].value = srv->best_offset + root_distance(srv);
+		edges[n++].type = 1;
+	}
+
+	/* Few entries, insertion sort. Lower edges go first on ties so that
+	 * touching intervals intersect.
+	 */
+	for (size_t i = 1; i < n; i++) {
+		size_t j = i;
+
+		tmp = edges[i];
+		while (j > 0 && (edges[j - 1].value > tmp.value ||
+				 (edges[j - 1].value == tmp.value &&
+				  edges[j - 1].type > tmp.type))) {
+			edges[j] = edges[j - 1];
+			j--;
+		}
+		edges[j] = tmp;
+	}
+
+	for (size_t i = 0; i < n; i++) {
+		count -= edges[i].type;
+
+		if (count > best) {
+			best = count;
+			*low = edges[i].value;
+			*high = edges[i + 1].value;
+		}
+	}
+
+	return best;
+}
+
+static void update_clock(int64_t offset, bool *stepped)
+{
+	struct timespec ts;
+	struct timeval tv;
+	int64_t now;
+
+	if (llabs(offset) >= STEP_THRESHOLD_NS) {
+		now = realtime_ns() + offset;
+
+		ts.tv_sec = now / NSEC_PER_SEC;
+		ts.tv_nsec = now % NSEC_PER_SEC;
+		(void)clock_settime(CLOCK_REALTIME, &ts);
+
+		NET_INFO("Clock stepped by %lld ms",
+			 (long long)(offset / NSEC_PER_MSEC));
+
+		*stepped = true;
+		return;
+	}
+
+	/* The measured offset already includes what is left of the previous
+	 * adjustment, so it replaces it.
+	 */
+	tv.tv_sec = offset / NSEC_PER_SEC;
+	tv.tv_usec = (offset % NSEC_PER_SEC) / NSEC_PER_USEC;
+	(void)adjtime(&tv, NULL);
+
+	*stepped = false;
+}
+
+static int sync_poll(uint32_t timeout)
+{
+	struct sntp_sync_status *status = &sync.status;
+	double weight_sum = 0.0;
+	double offset_sum = 0.0;
+	int64_t low = 0, high = 0;
+	int64_t jitter = 0;
+	size_t responding = 0;
+	size_t selected = 0;
+	int64_t offset;
+
+	for (size_t i = 0; i < sync.count; i++) {
+		sync.servers[i].samples = 0;
+	}
+
+	for (int i = 0; i < CONFIG_SNTP_SYNC_BURST; i++) {
+		query_servers(timeout);
+	}
+
+	for (size_t i = 0; i < sync.count; i++) {
+		if (sync.servers[i].samples > 0) {
+			clock_filter(&sync.servers[i]);
+			responding++;
+		}
+	}
+
+	status->responding = responding;
+	status->selected = 0;
+
+	if (responding == 0) {
+		NET_DBG("No server responded");
+		return -ETIMEDOUT;
+	}
+
+	/* A majority of the servers must agree on the time */
+	if (select_interval(&low, &high) <= (int)(responding / 2)) {
+		NET_DBG("No majority among %zu servers", responding);
+		return -EAGAIN;
+	}
+
+	/* Combine the truechimers, weighted by their root distance */
+	for (size_t i = 0; i < sync.count; i++) {
+		struct sntp_sync_server *srv = &sync.servers[i];
+		double weight;
+
+		srv->selected = srv->samples > 0 &&
+				srv->best_offset + root_distance(srv) >= low &&
+				srv->best_offset - root_distance(srv) <= high;
+		if (!srv->selected) {
+			continue;
+		}
+
+		weight = 1.0 / (double)root_distance(srv);
+		offset_sum += weight * (double)srv->best_offset;
+		weight_sum += weight;
+		selected++;
+	}
+
+	offset = (int64_t)(offset_sum / weight_sum);
+
+	for (size_t i = 0; i < sync.count; i++) {
+		struct sntp_sync_server *srv = &sync.servers[i];
+
+		if (srv->selected) {
+			jitter += srv->jitter + llabs(srv->best_offset - offset);
+		}
+	}
+
+	jitter /= selected;
+
+	status->selected = selected;
+	status->offset_us = offset / NSEC_PER_USEC;
+	status->jitter_us = (uint32_t)(jitter / NSEC_PER_USEC);
+
+	update_clock(offset, &status->stepped);
+
+	/* Poll less often while the offset stays within the noise */
+	if (!status->stepped &&
+	    llabs(offset) < MAX(4 * jitter, MIN_SYNC_THRESHOLD_NS)) {
+		if (sync.poll_exp < CONFIG_SNTP_SYNC_MAX_POLL) {
+			sync.poll_exp++;
+		}
+	} else if (sync.poll_exp > CONFIG_SNTP_SYNC_MIN_POLL) {
+		sync.poll_exp--;
+	}
+
+	status->poll_interval = BIT(sync.poll_exp);
+
+	NET_DBG("Offset %lld us, jitter %u us, %zu/%zu servers, poll %u s",
+		(long long)status->offset_us, status->jitter_us, selected,
+		responding, status->poll_interval);
+
+	return 0;
+}
+
+static void close_servers(void)
+{
+	for (size_t i = 0; i < sync.count; i++) {
+		(void)zsock_close(sync.servers[i].sock);
+	}
+
+	sync.count = 0;
+}
+
+int sntp_sync_init(const struct sockaddr *servers, size_t count)
+{
+	socklen_t addrlen;
+	int ret = 0;
+
+	if (servers == NULL || count == 0 ||
+	    count > CONFIG_SNTP_SYNC_MAX_SERVERS) {
+		return -EINVAL;
+	}
+
+	k_mutex_lock(&sync_lock, K_FOREVER);
+
+	close_servers();
+
+	for (size_t i = 0; i < count; i++) {
+		struct sntp_sync_server *srv = &sync.servers[i];
+
+		memset(srv, 0, sizeof(*srv));
+		memcpy(&srv->addr, &servers[i], sizeof(srv->addr));
+
+		addrlen = (servers[i].sa_family == AF_INET6) ?
+			  sizeof(struct sockaddr_in6) : sizeof(struct sockaddr_in);
+
+		srv->sock = zsock_socket(servers[i].sa_family, SOCK_DGRAM,
+					 IPPROTO_UDP);
+		if (srv->sock < 0) {
+			NET_ERR("Failed to create UDP socket %d", errno);
+			ret = -errno;
+			break;
+		}
+
+		sync.count++;
+
+		if (zsock_connect(srv->sock, &srv->addr, addrlen) < 0) {
+			NET_ERR("Cannot connect to UDP remote : %d", errno);
+			ret = -errno;
+			break;
+		}
+
+		sync.fds[i].events = ZSOCK_POLLIN;
+	}
+
+	if (ret < 0) {
+		close_servers();
+	}
+
+	sync.poll_exp = CONFIG_SNTP_SYNC_MIN_POLL;
+	memset(&sync.status, 0, sizeof(sync.status));
+	sync.status.poll_interval = BIT(sync.poll_exp);
+
+	k_mutex_unlock(&sync_lock);
+
+	return ret;
+}
+
+int sntp_sync_poll(uint32_t timeout, struct sntp_sync_status *status)
+{
+	int ret;
+
+	k_mutex_lock(&sync_lock, K_FOREVER);
+
+	if (sync.count == 0) {
+		ret = -ENOTCONN;
+	} else {
+		ret = sync_poll(timeout);
+	}
+
+	if (status != NULL) {
+		*status = sync.status;
+	}
+
+	k_mutex_unlock(&sync_lock);
+
+	return ret;
+}
+
+void sntp_sync_get_status(struct sntp_sync_status *status)
+{
+	k_mutex_lock(&sync_lock, K_FOREVER);
+	*status = sync.status;
+	k_mutex_unlock(&sync_lock);
+}
+
+static void sntp_sync_handler(void *p1, void *p2, void *p3)
+{
+	uint32_t interval;
+
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	while (true) {
+		(void)sntp_sync_poll(CONFIG_SNTP_SYNC_QUERY_TIMEOUT, NULL);
+
+		k_mutex_lock(&sync_lock, K_FOREVER);
+		interval = sync.status.poll_interval;
+		k_mutex_unlock(&sync_lock);
+
+		if (k_sem_take(&sync_stop, K_SECONDS(interval)) == 0) {
+			break;
+		}
+	}
+}
+
+int sntp_sync_start(void)
+{
+	if (sync.running) {
+		return -EALREADY;
+	}
+
+	if (sync.count == 0) {
+		return -ENOTCONN;
+	}
+
+	k_sem_reset(&sync_stop);
+	sync.running = true;
+
+	k_thread_create(&sync_thread, sync_stack,
+			K_THREAD_STACK_SIZEOF(sync_stack),
+			sntp_sync_handler, NULL, NULL, NULL,
+			K_LOWEST_APPLICATION_THREAD_PRIO, 0, K_NO_WAIT);
+	k_thread_name_set(&sync_thread, "sntp_sync");
+
+	return 0;
+}
+
+void sntp_sync_stop(void)
+{
+	if (sync.running) {
+		k_sem_give(&sync_stop);
+		(void)k_thread_join(&sync_thread, K_FOREVER);
+		sync.running = false;
+	}
+
+	k_mutex_lock(&sync_lock, K_FOREVER);
+	close_servers();
+	k_mutex_unlock(&sync_lock);
+}
@@ -40,26 +40,24 @@ LOG_MODULE_REGISTER(net_sock, CONFIG_NET_SOCKETS_LOG_LEVEL);
 #define VTABLE_CALL(fn, sock, ...)			     \
 	do {						     \
 		const struct socket_op_vtable *vtable;	     \
-		struct k_mutex *lock;			     \
 		void *obj;				     \
 		int ret;				     \
 							     \
-		obj = get_sock_vtable(sock, &vtable, &lock); \
+		obj = lock_sock_vtable(sock, &vtable);	     \
 		if (obj == NULL) {			     \
 			errno = EBADF;			     \
 			return -1;			     \
 		}					     \
 							     \
 		if (vtable->fn == NULL) {		     \
+			z_unlock_fd(sock);		     \
 			errno = EOPNOTSUPP;		     \
 			return -1;			     \
 		}					     \
 							     \
-		(void)k_mutex_lock(lock, K_FOREVER);         \
-							     \
 		ret = vtable->fn(obj, __VA_ARGS__);	     \
 							     \
-		k_mutex_unlock(lock);                        \
+		z_unlock_fd(sock);			     \
 							     \
 		return ret;				     \
 	} while (0)
@@ -96,6 +94,40 @@ static inline void *get_sock_vtable(int sock,
 	return ctx;
 }
 
+/* Same as get_sock_vtable(), but with the descriptor locked and held until
+ * z_unlock_fd(). This is the lookup done by every socket call, it doesn't
+ * involve the fdtable lock and a concurrent close can't release the
+ * descriptor under the caller.
+ */
+static inline void *lock_sock_vtable(int sock,
+				     const struct socket_op_vtable **vtable)
+{
+	void *ctx;
+
+	if (z_lock_fd(sock, &ctx, (const struct fd_op_vtable **)vtable,
+		      NULL) < 0) {
+		ctx = NULL;
+	} else if (ctx == NULL) {
+		z_unlock_fd(sock);
+	}
+
+#ifdef CONFIG_USERSPACE
+	if (ctx != NULL && z_is_in_user_syscall()) {
+		if (!k_object_is_valid(ctx, K_OBJ_NET_SOCKET)) {
+			z_unlock_fd(sock);
+			ctx = NULL;
+		}
+	}
+#endif /* CONFIG_USERSPACE */
+
+	if (ctx == NULL) {
+		NET_ERR("invalid access on sock %d by thread %p", sock,
+			_current);
+	}
+
+	return ctx;
+}
+
 void *z_impl_zsock_get_context_object(int sock)
 {
 	const struct socket_op_vtable *ignored;
@@ -272,26 +304,26 @@ int zsock_close_ctx(struct net_context *ctx)
 int z_impl_zsock_close(int sock)
 {
 	const struct socket_op_vtable *vtable;
-	struct k_mutex *lock;
 	void *ctx;
 	int ret;
 
-	ctx = get_sock_vtable(sock, &vtable, &lock);
+	ctx = lock_sock_vtable(sock, &vtable);
 	if (ctx == NULL) {
 		errno = EBADF;
 		return -1;
 	}
 
-	(void)k_mutex_lock(lock, K_FOREVER);
-
 	NET_DBG("close: ctx=%p, fd=%d", ctx, sock);
 
 	ret = vtable->fd_vtable.close(ctx);
 
-	k_mutex_unlock(lock);
-
+	/* Detach the socket while still locked, calls waiting for the lock
+	 * will then fail with EBADF instead of using the closed socket.
+	 */
 	z_free_fd(sock);
 
+	z_unlock_fd(sock);
+
 	return ret;
 }
 
@@ -306,28 +338,26 @@ static inline int z_vrfy_zsock_close(int sock)
 int z_impl_zsock_shutdown(int sock, int how)
 {
 	const struct socket_op_vtable *vtable;
-	struct k_mutex *lock;
 	void *ctx;
 	int ret;
 
-	ctx = get_sock_vtable(sock, &vtable, &lock);
+	ctx = lock_sock_vtable(sock, &vtable);
 	if (ctx == NULL) {
 		errno = EBADF;
 		return -1;
 	}
 
 	if (!vtable->shutdown) {
+		z_unlock_fd(sock);
 		errno = ENOTSUP;
 		return -1;
 	}
 
-	(void)k_mutex_lock(lock, K_FOREVER);
-
 	NET_DBG("shutdown: ctx=%p, fd=%d, how=%d", ctx, sock, how);
 
 	ret = vtable->shutdown(ctx, how);
 
-	k_mutex_unlock(lock);
+	z_unlock_fd(sock);
 
 	return ret;
 }
@@ -1512,22 +1542,19 @@ ssize_t z_vrfy_zsock_recvfrom(int sock, void *buf, size_t max_len, int flags,
 int z_impl_zsock_fcntl(int sock, int cmd, int flags)
 {
 	const struct socket_op_vtable *vtable;
-	struct k_mutex *lock;
 	void *obj;
 	int ret;
 
-	obj = get_sock_vtable(sock, &vtable, &lock);
+	obj = lock_sock_vtable(sock, &vtable);
 	if (obj == NULL) {
 		errno = EBADF;
 		return -1;
 	}
 
-	(void)k_mutex_lock(lock, K_FOREVER);
-
 	ret = z_fdtable_call_ioctl((const struct fd_op_vtable *)vtable,
 				   obj, cmd, flags);
 
-	k_mutex_unlock(lock);
+	z_unlock_fd(sock);
 
 	return ret;
 }
@@ -1543,23 +1570,20 @@ static inline int z_vrfy_zsock_fcntl(int sock, int cmd, int flags)
 int z_impl_zsock_ioctl(int sock, unsigned long request, va_list args)
 {
 	const struct socket_op_vtable *vtable;
-	struct k_mutex *lock;
 	void *ctx;
 	int ret;
 
-	ctx = get_sock_vtable(sock, &vtable, &lock);
+	ctx = lock_sock_vtable(sock, &vtable);
 	if (ctx == NULL) {
 		errno = EBADF;
 		return -1;
 	}
 
-	(void)k_mutex_lock(lock, K_FOREVER);
-
 	NET_DBG("ioctl: ctx=%p, fd=%d, request=%lu", ctx, sock, request);
 
 	ret = vtable->fd_vtable.ioctl(ctx, request, args);
 
-	k_mutex_unlock(lock);
+	z_unlock_fd(sock);
 
 	return ret;
 
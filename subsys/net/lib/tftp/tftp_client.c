@@ -8,49 +8,168 @@
 LOG_MODULE_REGISTER(tftp_client, CONFIG_TFTP_LOG_LEVEL);
 
 #include <stddef.h>
+#include <stdlib.h>
+#include <strings.h>
 #include <zephyr/net/tftp.h>
 #include "tftp_client.h"
 
+#if defined(CONFIG_STREAM_FLASH)
+#include <zephyr/storage/stream_flash.h>
+#endif
+
 #define ADDRLEN(sa) \
 	(sa.sa_family == AF_INET ? \
 		sizeof(struct sockaddr_in) : sizeof(struct sockaddr_in6))
 
+/* Options negotiated with the server, RFC2347 */
+struct tftp_options {
+	uint16_t blksize;
+	uint16_t windowsize;
+	uint32_t tsize;
+};
+
+static char *append_option(char *ptr, const char *name, uint32_t value)
+{
+	size_t len = strlen(name) + 1;
+
+	memcpy(ptr, name, len);
+	ptr += len;
+
+	/* The value is at most 10 digits */
+	ptr += snprintk(ptr, 11, "%u", value) + 1;
+
+	return ptr;
+}
+
 /*
- * Prepare a request as required by RFC1350. This packet can be sent
- * out directly to the TFTP server.
+ * Prepare a request as required by RFC1350, with the options from RFC2348,
+ * RFC2349 and RFC7440. This packet can be sent out directly to the TFTP
+ * server. Returns the size of the request, or -EINVAL if the filename and
+ * the mode do not fit into it.
  */
-static size_t make_request(uint8_t *buf, int request,
-			   const char *remote_file, const char *mode)
+static int make_request(uint8_t *buf, int request,
+			const char *remote_file, const char *mode,
+			uint32_t tsize)
 {
-	char *ptr = (char *)buf;
+	char options[TFTP_MAX_OPTIONS_SIZE];
+	char *opt = options;
 	const char def_mode[] = "octet";
+	size_t file_len, mode_len, opt_len;
+	uint8_t *ptr = buf;
+
+	/* Default to "Octet" if mode not specified. */
+	if (mode == NULL) {
+		mode = def_mode;
+	}
+
+	/* Only ask for options that differ from the RFC1350 behavior. The
+	 * transfer size comes along, for a read request the server fills it.
+	 */
+	if (TFTPC_MAX_BLOCK_SIZE != TFTP_BLOCK_SIZE ||
+	    (request == READ_REQUEST && CONFIG_TFTPC_WINDOW_SIZE > 1)) {
+		if (TFTPC_MAX_BLOCK_SIZE != TFTP_BLOCK_SIZE) {
+			opt = append_option(opt, "blksize", TFTPC_MAX_BLOCK_SIZE);
+		}
+
+		/* Windowed transfers are only supported for read requests */
+		if (request == READ_REQUEST && CONFIG_TFTPC_WINDOW_SIZE > 1) {
+			opt = append_option(opt, "windowsize",
+					    CONFIG_TFTPC_WINDOW_SIZE);
+		}
+
+		opt = append_option(opt, "tsize", tsize);
+	}
+
+	file_len = strlen(remote_file) + 1;
+	mode_len = strlen(mode) + 1;
+	opt_len = opt - options;
+
+	if (mode_len > TFTP_MAX_MODE_SIZE + 1 ||
+	    2 + file_len + mode_len + opt_len > TFTP_MAX_REQUEST_SIZE) {
+		LOG_ERR("Request for %s does not fit into a packet", remote_file);
+		return -EINVAL;
+	}
 
 	/* Fill in the Request Type. */
 	sys_put_be16(request, ptr);
 	ptr += 2;
 
-	/* Copy the name of the remote file. */
-	strncpy(ptr, remote_file, TFTP_MAX_FILENAME_SIZE);
-	ptr += strlen(remote_file);
-	*ptr++ = '\0';
+	/* Copy the name of the remote file and the mode of operation. */
+	memcpy(ptr, remote_file, file_len);
+	ptr += file_len;
 
-	/* Default to "Octet" if mode not specified. */
-	if (mode == NULL) {
-		mode = def_mode;
-	}
+	memcpy(ptr, mode, mode_len);
+	ptr += mode_len;
 
-	/* Copy the mode of operation. */
-	strncpy(ptr, mode, TFTP_MAX_MODE_SIZE);
-	ptr += strlen(mode);
-	*ptr++ = '\0';
+	memcpy(ptr, options, opt_len);
+	ptr += opt_len;
 
-	return ptr - (char *)buf;
+	return ptr - buf;
+}
+
+/*
+ * Parse an Option Acknowledgment from the server. The server may only
+ * acknowledge options we asked for, with values no larger than requested.
+ */
+static int parse_oack(const uint8_t *buf, size_t len, int request,
+		      struct tftp_options *opts)
+{
+	const char *ptr = (const char *)buf + 2;
+	const char *end = (const char *)buf + len;
+
+	while (ptr < end) {
+		const char *name = ptr;
+		const char *value;
+		char *value_end;
+		unsigned long val;
+
+		ptr += strnlen(ptr, end - ptr);
+		if (ptr >= end) {
+			return -EINVAL;
+		}
+
+		value = ++ptr;
+		ptr += strnlen(ptr, end - ptr);
+		if (ptr >= end || ptr == value) {
+			return -EINVAL;
+		}
+
+		ptr++;
+
+		val = strtoul(value, &value_end, 10);
+		if (*value_end != '\0') {
+			return -EINVAL;
+		}
+
+		if (strncasecmp(name, "blksize", sizeof("blksize")) == 0) {
+			if (val < 8 || val > TFTPC_MAX_BLOCK_SIZE) {
+				return -EINVAL;
+			}
+
+			opts->blksize = val;
+		} else if (strncasecmp(name, "windowsize", sizeof("windowsize")) == 0) {
+			if (request != READ_REQUEST || val < 1 ||
+			    val > CONFIG_TFTPC_WINDOW_SIZE) {
+				return -EINVAL;
+			}
+
+			opts->windowsize = val;
+		} else if (strncasecmp(name, "tsize", sizeof("tsize")) == 0) {
+			opts->tsize = val;
+		} else {
+			return -EINVAL;
+		}
+
+		LOG_DBG("Server accepted option %s %lu", name, val);
+	}
+
+	return 0;
 }
 
 /*
  * Send Data message to the TFTP Server and receive ACK message from it.
  */
-static int send_data(int sock, struct tftpc *client, uint32_t block_no, const uint8_t *data_buffer,
+static int send_data(int sock, struct tftpc *client, uint16_t block_no, const uint8_t *data_buffer,
 		     size_t data_size)
 {
 	int ret;
@@ -174,14 +293,19 @@ static inline int send_ack(int sock, struct tftphdr_ack *ackhdr)
 }
 
 static int send_request(int sock, struct tftpc *client,
-			int request, const char *remote_file, const char *mode)
+			int request, const char *remote_file, const char *mode,
+			uint32_t tsize)
 {
 	int tx_count = 0;
-	size_t req_size;
+	int req_size;
 	int ret;
 
 	/* Create TFTP Request. */
-	req_size = make_request(client->tftp_buf, request, remote_file, mode);
+	req_size = make_request(client->tftp_buf, request, remote_file, mode,
+				tsize);
+	if (req_size < 0) {
+		return req_size;
+	}
 
 	do {
 		tx_count++;
@@ -217,7 +341,7 @@ static int send_request(int sock, struct tftpc *client,
 				&from_addr, &from_addr_len);
 		if (ret < TFTP_HEADER_SIZE) {
 			req_size = make_request(client->tftp_buf, request,
-						remote_file, mode);
+						remote_file, mode, tsize);
 			continue;
 		}
 
@@ -231,16 +355,92 @@ static int send_request(int sock, struct tftpc *client,
 	return ret;
 }
 
+/*
+ * Pass received data to the data sink or to the application callback.
+ */
+static int deliver_data(int sock, struct tftpc *client, const uint8_t *data,
+			size_t data_size, bool last)
+{
+	int ret;
+
+	if (client->sink != NULL) {
+		ret = client->sink(client->sink_user_data, data, data_size, last);
+		if (ret < 0) {
+			LOG_ERR("Data sink failed (%d)", ret);
+			send_err(sock, client, TFTP_ERROR_DISK_FULL, NULL);
+			return TFTPC_SINK_FAILURE;
+		}
+
+		return 0;
+	}
+
+	if (client->callback == NULL) {
+		LOG_ERR("No callback defined.");
+		send_err(sock, client, TFTP_ERROR_DISK_FULL, NULL);
+		return TFTPC_BUFFER_OVERFLOW;
+	}
+
+	/* Send received data to client */
+	struct tftp_evt evt = {
+		.type = TFTP_EVT_DATA
+	};
+
+	evt.param.data.data_ptr = (uint8_t *)data;
+	evt.param.data.len      = data_size;
+	client->callback(&evt);
+
+	return 0;
+}
+
+/*
+ * Wait for the next packet from the server, re-sending our last ACK each
+ * time the server does not answer in time.
+ */
+static int wait_data(int sock, struct tftpc *client, struct tftphdr_ack *ackhdr,
+		     int *tx_count)
+{
+	struct pollfd fds = {
+		.fd     = sock,
+		.events = ZSOCK_POLLIN,
+	};
+	int ret;
+
+	while ((ret = poll(&fds, 1, CONFIG_TFTPC_REQUEST_TIMEOUT)) == 0) {
+		if (*tx_count > TFTP_REQ_RETX) {
+			LOG_ERR("No more retransmits. Exiting");
+			return TFTPC_RETRIES_EXHAUSTED;
+		}
+
+		(void)send_ack(sock, ackhdr);
+		(*tx_count)++;
+	}
+
+	if (ret < 0) {
+		LOG_ERR("poll() error: %d", -errno);
+		return -errno;
+	}
+
+	/* Receive data from the TFTP Server. */
+	return recv(sock, client->tftp_buf, TFTPC_MAX_BUF_SIZE, 0);
+}
+
 int tftp_get(struct tftpc *client, const char *remote_file, const char *mode)
 {
-	int sock;
-	uint32_t tftpc_block_no = 1;
-	uint32_t tftpc_index = 0;
-	int tx_count = 0;
+	struct tftp_options opts = {
+		.blksize = TFTP_BLOCK_SIZE,
+		.windowsize = 1,
+	};
 	struct tftphdr_ack ackhdr = {
 		.opcode = htons(ACK_OPCODE),
-		.block = htons(1)
+		.block = htons(0)
 	};
+	uint16_t tftpc_block_no = 1;
+	uint32_t tftpc_index = 0;
+	uint16_t window_count = 0;
+	uint16_t dup_count = 0;
+	int tx_count = 0;
+	int prev_tx_count;
+	int sock;
 	int rcv_size;
 	int ret;
 
@@ -248,6 +448,8 @@ int tftp_get(struct tftpc *client, const char *remote_file, const char *mode)
 		return -EINVAL;
 	}
 
+	client->tsize = 0;
+
 	sock = socket(client->server.sa_family, SOCK_DGRAM, IPPROTO_UDP);
 	if (sock < 0) {
 		LOG_ERR("Failed to create UDP socket: %d", errno);
@@ -255,10 +457,44 @@ int tftp_get(struct tftpc *client, const char *remote_file, const char *mode)
 	}
 
 	/* Send out the READ request to the TFTP Server. */
-	ret = send_request(sock, client, READ_REQUEST, remote_file, mode);
+	ret = send_request(sock, client, READ_REQUEST, remote_file, mode, 0);
+	if (ret == -EINVAL) {
+		goto get_end;
+	}
+
 	rcv_size = ret;
 
-	while (rcv_size >= TFTP_HEADER_SIZE && rcv_size <= TFTPC_MAX_BUF_SIZE) {
+	/* A server supporting options answers with an OACK, which we
+	 * acknowledge with block 0 before the data starts. Otherwise the
+	 * data starts right away with the RFC1350 defaults.
+	 */
+	if (rcv_size >= TFTP_HEADER_SIZE &&
+	    sys_get_be16(client->tftp_buf) == OACK_OPCODE) {
+		if (parse_oack(client->tftp_buf, rcv_size, READ_REQUEST, &opts) < 0) {
+			LOG_ERR("Server responded with invalid options.");
+			send_err(sock, client, TFTP_ERROR_OPTION, NULL);
+			ret = TFTPC_REMOTE_ERROR;
+			goto get_end;
+		}
+
+		LOG_DBG("Block size %u, window size %u, transfer size %u",
+			opts.blksize, opts.windowsize, opts.tsize);
+
+		client->tsize = opts.tsize;
+
+		(void)send_ack(sock, &ackhdr);
+
+		ret = wait_data(sock, client, &ackhdr, &tx_count);
+		if (ret < 0) {
+			goto get_end;
+		}
+
+		rcv_size = ret;
+	}
+
+	while (rcv_size >= TFTP_HEADER_SIZE && rcv_size <= opts.blksize + TFTP_HEADER_SIZE) {
+		bool ack_now;
+
 		/* Process server response. */
 		uint16_t opcode = sys_get_be16(client->tftp_buf);
 		uint16_t block_no = sys_get_be16(client->tftp_buf + 2);
@@ -278,42 +514,35 @@ int tftp_get(struct tftpc *client, const char *remote_file, const char *mode)
 			}
 			ret = TFTPC_REMOTE_ERROR;
 			break;
+		} else if (opcode == OACK_OPCODE && tftpc_block_no == 1) {
+			/* The server did not get our ACK of the options */
+			ack_now = true;
 		} else if (opcode != DATA_OPCODE) {
 			LOG_ERR("Server responded with invalid opcode.");
 			ret = TFTPC_REMOTE_ERROR;
 			break;
-		}
-
-		if (block_no == tftpc_block_no) {
+		} else if (block_no == tftpc_block_no) {
 			uint32_t data_size = rcv_size - TFTP_HEADER_SIZE;
+			/* Per RFC1350, the end of a transfer is marked
+			 * by a block smaller than the block size.
+			 */
+			bool last = data_size < opts.blksize;
 
-			tftpc_block_no++;
-			ackhdr.block = htons(block_no);
-			tx_count = 0;
-
-			if (client->callback == NULL) {
-				LOG_ERR("No callback defined.");
-				send_err(sock, client, TFTP_ERROR_DISK_FULL, NULL);
-				ret = TFTPC_BUFFER_OVERFLOW;
+			ret = deliver_data(sock, client, client->tftp_buf + TFTP_HEADER_SIZE,
+					   data_size, last);
+			if (ret < 0) {
 				goto get_end;
 			}
 
-			/* Send received data to client */
-			struct tftp_evt evt = {
-				.type = TFTP_EVT_DATA
-			};
-
-			evt.param.data.data_ptr = client->tftp_buf + TFTP_HEADER_SIZE;
-			evt.param.data.len      = data_size;
-			client->callback(&evt);
+			tftpc_block_no++;
+			ackhdr.block = htons(block_no);
+			tx_count = 0;
+			dup_count = 0;
 
 			/* Update the index. */
 			tftpc_index += data_size;
 
-			/* Per RFC1350, the end of a transfer is marked
-			 * by datagram size < TFTPC_MAX_BUF_SIZE.
-			 */
-			if (rcv_size < TFTPC_MAX_BUF_SIZE) {
+			if (last) {
 				(void)send_ack(sock, &ackhdr);
 				ret = tftpc_index;
 				LOG_DBG("%d bytes received.", tftpc_index);
@@ -322,32 +551,50 @@ int tftp_get(struct tftpc *client, const char *remote_file, const char *mode)
 				 */
 				break;
 			}
-		}
 
-		/* Poll for the response */
-		struct pollfd fds = {
-			.fd     = sock,
-			.events = ZSOCK_POLLIN,
-		};
+			/* RFC7440: only the last block of a window is acked */
+			ack_now = ++window_count >= opts.windowsize;
+		} else {
+			/* A block of the window was lost, or the server did not
+			 * get our last ACK and sends the window again. Ack the
+			 * last block received in order so that the server
+			 * restarts from there. Only the first out of order block
+			 * of a window is acked, the following ones are out of
+			 * order as well, but once a window worth of them has
+			 * passed the server is sending the next one. With a
+			 * window of one block, every duplicate is acked.
+			 */
+			ack_now = dup_count == 0;
 
-		do {
-			if (tx_count > TFTP_REQ_RETX) {
-				LOG_ERR("No more retransmits. Exiting");
-				ret = TFTPC_RETRIES_EXHAUSTED;
-				goto get_end;
+			if (++dup_count >= opts.windowsize) {
+				dup_count = 0;
 			}
+		}
 
-			/* Send ACK to the TFTP Server */
+		if (ack_now) {
 			(void)send_ack(sock, &ackhdr);
-			tx_count++;
-		} while (poll(&fds, 1, CONFIG_TFTPC_REQUEST_TIMEOUT) <= 0);
+			window_count = 0;
+		}
+
+		prev_tx_count = tx_count;
+
+		ret = wait_data(sock, client, &ackhdr, &tx_count);
+		if (ret < 0) {
+			goto get_end;
+		}
+
+		if (tx_count != prev_tx_count) {
+			/* The ACK was sent again on timeout, the server starts
+			 * a new window from it.
+			 */
+			window_count = 0;
+			dup_count = 0;
+		}
 
-		/* Receive data from the TFTP Server. */
-		ret = recv(sock, client->tftp_buf, TFTPC_MAX_BUF_SIZE, 0);
 		rcv_size = ret;
 	}
 
-	if (!(rcv_size >= TFTP_HEADER_SIZE && rcv_size <= TFTPC_MAX_BUF_SIZE)) {
+	if (!(rcv_size >= TFTP_HEADER_SIZE && rcv_size <= opts.blksize + TFTP_HEADER_SIZE)) {
 		ret = TFTPC_REMOTE_ERROR;
 	}
 
@@ -359,8 +606,12 @@ get_end:
 int tftp_put(struct tftpc *client, const char *remote_file, const char *mode,
 	     const uint8_t *user_buf, uint32_t user_buf_size)
 {
+	struct tftp_options opts = {
+		.blksize = TFTP_BLOCK_SIZE,
+		.windowsize = 1,
+	};
 	int sock;
-	uint32_t tftpc_block_no = 1;
+	uint16_t tftpc_block_no = 1;
 	uint32_t tftpc_index = 0;
 	uint32_t send_size;
 	uint8_t *send_buffer;
@@ -377,7 +628,11 @@ int tftp_put(struct tftpc *client, const char *remote_file, const char *mode,
 	}
 
 	/* Send out the WRITE request to the TFTP Server. */
-	ret = send_request(sock, client, WRITE_REQUEST, remote_file, mode);
+	ret = send_request(sock, client, WRITE_REQUEST, remote_file, mode,
+			   user_buf_size);
+	if (ret == -EINVAL) {
+		goto put_end;
+	}
 
 	/* Check connection initiation result */
 	if (ret >= TFTP_HEADER_SIZE) {
@@ -399,6 +654,16 @@ int tftp_put(struct tftpc *client, const char *remote_file, const char *mode,
 			LOG_ERR("Server responded with service reject.");
 			ret = TFTPC_REMOTE_ERROR;
 			goto put_end;
+		} else if (opcode == OACK_OPCODE) {
+			/* The OACK stands for the ACK of block 0 */
+			if (parse_oack(client->tftp_buf, ret, WRITE_REQUEST, &opts) < 0) {
+				LOG_ERR("Server responded with invalid options.");
+				send_err(sock, client, TFTP_ERROR_OPTION, NULL);
+				ret = TFTPC_REMOTE_ERROR;
+				goto put_end;
+			}
+
+			LOG_DBG("Block size %u", opts.blksize);
 		} else if (opcode != ACK_OPCODE || block_no != 0) {
 			LOG_ERR("Server responded with invalid opcode or block number.");
 			ret = TFTPC_REMOTE_ERROR;
@@ -412,8 +677,8 @@ int tftp_put(struct tftpc *client, const char *remote_file, const char *mode,
 	/* Send out data by chunks */
 	do {
 		send_size = user_buf_size - tftpc_index;
-		if (send_size > TFTP_BLOCK_SIZE) {
-			send_size = TFTP_BLOCK_SIZE;
+		if (send_size > opts.blksize) {
+			send_size = opts.blksize;
 		}
 		send_buffer = (uint8_t *)(user_buf + tftpc_index);
 
@@ -426,9 +691,9 @@ int tftp_put(struct tftpc *client, const char *remote_file, const char *mode,
 		}
 
 		/* Per RFC1350, the end of a transfer is marked
-		 * by datagram size < TFTPC_MAX_BUF_SIZE.
+		 * by a block smaller than the block size.
 		 */
-		if (send_size < TFTP_BLOCK_SIZE) {
+		if (send_size < opts.blksize) {
 			LOG_DBG("%d bytes sent.", tftpc_index);
 			ret = tftpc_index;
 			break;
@@ -439,3 +704,13 @@ put_end:
 	close(sock);
 	return ret;
 }
+
+#if defined(CONFIG_STREAM_FLASH)
+int tftp_stream_flash_sink(void *user_data, const uint8_t *data, size_t len,
+			   bool last)
+{
+	struct stream_flash_ctx *ctx = user_data;
+
+	return stream_flash_buffered_write(ctx, data, len, last);
+}
+#endif
@@ -12,17 +12,19 @@
 
 /* Defines for creating static arrays for TFTP communication. */
 #define TFTP_MAX_MODE_SIZE       8
+/* Space for the "blksize", "windowsize" and "tsize" options, each with a
+ * value of at most 10 digits.
+ */
+#define TFTP_MAX_OPTIONS_SIZE    (sizeof("blksize") + sizeof("windowsize") + \
+				  sizeof("tsize") + 3 * 11)
 #define TFTP_REQ_RETX            CONFIG_TFTPC_REQUEST_RETRANSMITS
 
-/* Maximum filename size allowed by the TFTP Client. This is used as
- * an upper bound in the "make_request" function to ensure that there
- * are no buffer overflows. The complete "tftpc_buffer" has the size of
- * "TFTPC_MAX_BUF_SIZE" which is used when creating a request. From this
- * total size, we need 2 bytes for request info, 2 dummy NULL bytes and
- * "TFTP_MAX_MODE_SIZE" for mode info. Everything else can be used for
- * filename.
+/* Maximum size of a request. A request must fit in a default sized packet,
+ * whatever block size is negotiated afterwards. The filename can use
+ * whatever the opcode, the mode and the options that are actually sent
+ * leave of it.
  */
-#define TFTP_MAX_FILENAME_SIZE   (TFTPC_MAX_BUF_SIZE - TFTP_MAX_MODE_SIZE - 4)
+#define TFTP_MAX_REQUEST_SIZE    (TFTP_BLOCK_SIZE + TFTP_HEADER_SIZE)
 
 /* TFTP Opcodes. */
 #define READ_REQUEST             0x1
@@ -30,6 +32,7 @@
 #define DATA_OPCODE              0x3
 #define ACK_OPCODE               0x4
 #define ERROR_OPCODE             0x5
+#define OACK_OPCODE              0x6
 
 /* Error Codes */
 
@@ -49,6 +52,8 @@
 #define TFTP_ERROR_FILE_EXISTS         6
 /** No such user. */
 #define TFTP_ERROR_NO_USER             7
+/** Option negotiation failed (RFC2347). */
+#define TFTP_ERROR_OPTION              8
 
 struct tftphdr_ack {
 	uint16_t opcode;
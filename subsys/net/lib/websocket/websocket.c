@@ -274,6 +274,7 @@ int websocket_connect(int sock, struct websocket_request *wreq,
 	}
 
 	ctx->real_sock = sock;
+	ctx->tx_aborted = 0U;
 	ctx->recv_buf.buf = wreq->tmp_buf;
 	ctx->recv_buf.size = wreq->tmp_buf_len;
 	ctx->sec_accept_key = sec_accept_key;
@@ -419,10 +420,15 @@ static int websocket_interal_disconnect(struct websocket_context *ctx)
 
 	NET_DBG("[%p] Disconnecting", ctx);
 
-	ret = websocket_send_msg(ctx->sock, NULL, 0, WEBSOCKET_OPCODE_CLOSE,
-				 true, true, SYS_FOREVER_MS);
-	if (ret < 0) {
-		NET_ERR("[%p] Failed to send close message (err %d).", ctx, ret);
+	if (ctx->tx_aborted) {
+		/* A close frame would only add to the partial frame */
+		ret = 0;
+	} else {
+		ret = websocket_send_msg(ctx->sock, NULL, 0, WEBSOCKET_OPCODE_CLOSE,
+					 true, true, SYS_FOREVER_MS);
+		if (ret < 0) {
+			NET_ERR("[%p] Failed to send close message (err %d).", ctx, ret);
+		}
 	}
 
 	websocket_context_unref(ctx);
@@ -618,13 +624,91 @@ static int websocket_prepare_and_send(struct websocket_context *ctx,
 #endif /* CONFIG_NET_TEST */
 }
 
+/* Apply the masking key to len bytes of src and store the result in dst.
+ * The offset is the position of src[0] within the frame payload so that
+ * the key stays in phase when a payload is processed in several pieces.
+ * The bulk of the data is handled one machine word at a time, src and dst
+ * may point to the same buffer.
+ */
+static void websocket_mask_payload(uint8_t *dst, const uint8_t *src,
+				   size_t len, uint32_t masking_value,
+				   uint64_t offset)
+{
+	uint8_t key[sizeof(uintptr_t)];
+	uint8_t mask[4];
+	uintptr_t key_word, word;
+	size_t i;
+
+	sys_put_be32(masking_value, mask);
+
+	for (i = 0; i < sizeof(key); i++) {
+		key[i] = mask[(offset + i) % 4];
+	}
+
+	memcpy(&key_word, key, sizeof(key_word));
+
+	for (i = 0; i + sizeof(word) <= len; i += sizeof(word)) {
+		memcpy(&word, &src[i], sizeof(word));
+		word ^= key_word;
+		memcpy(&dst[i], &word, sizeof(word));
+	}
+
+	for (; i < len; i++) {
+		dst[i] = src[i] ^ key[i % 4];
+	}
+}
+
+/* Mask the payload into the context TX buffer and send it in chunks, this
+ * way there is no need to allocate a copy of the whole payload.
+ */
+static int websocket_send_masked(struct websocket_context *ctx,
+				 uint8_t *header, size_t header_len,
+				 const uint8_t *payload, size_t payload_len,
+				 int32_t timeout)
+{
+	size_t offset = 0;
+	int total = 0;
+	int ret;
+
+	while (offset < payload_len) {
+		size_t chunk_len = MIN(payload_len - offset, sizeof(ctx->tx_buf));
+
+		websocket_mask_payload(ctx->tx_buf, &payload[offset], chunk_len,
+				       ctx->masking_value, offset);
+
+		ret = websocket_prepare_and_send(ctx, header, header_len,
+						 ctx->tx_buf, chunk_len,
+						 timeout);
+		if (ret < 0 && offset > 0) {
+			/* Part of the frame is already sent, the peer can't
+			 * make sense of anything sent after it.
+			 */
+			NET_DBG("[%p] Frame cut at %zu/%zu (%d)", ctx, offset,
+				payload_len, ret);
+			ctx->tx_aborted = 1U;
+			return -ECONNABORTED;
+		}
+
+		if (ret < 0) {
+			return ret;
+		}
+
+		total += ret;
+		offset += chunk_len;
+
+		/* Only the first chunk carries the frame header */
+		header_len = 0;
+	}
+
+	return total;
+}
+
 int websocket_send_msg(int ws_sock, const uint8_t *payload, size_t payload_len,
 		       enum websocket_opcode opcode, bool mask, bool final,
 		       int32_t timeout)
 {
 	struct websocket_context *ctx;
 	uint8_t header[MAX_HEADER_LEN], hdr_len = 2;
-	uint8_t *data_to_send = (uint8_t *)payload;
 	int ret;
 
 	if (opcode != WEBSOCKET_OPCODE_DATA_TEXT &&
@@ -651,6 +735,10 @@ int websocket_send_msg(int ws_sock, const uint8_t *payload, size_t payload_len,
 	}
 #endif /* !defined(CONFIG_NET_TEST) */
 
+	if (ctx->tx_aborted) {
+		return -ENOTCONN;
+	}
+
 	NET_DBG("[%p] Len %zd %s/%d/%s", ctx, payload_len, opcode2str(opcode),
 		mask, final ? "final" : "more");
 
@@ -687,39 +775,25 @@ int websocket_send_msg(int ws_sock, const uint8_t *payload, size_t payload_len,
 
 	/* Add masking value if needed */
 	if (mask) {
-		int i;
-
 		ctx->masking_value = sys_rand32_get();
 
 		header[hdr_len++] |= ctx->masking_value >> 24;
 		header[hdr_len++] |= ctx->masking_value >> 16;
 		header[hdr_len++] |= ctx->masking_value >> 8;
 		header[hdr_len++] |= ctx->masking_value;
+	}
 
-		if ((payload != NULL) && (payload_len > 0)) {
-			data_to_send = k_malloc(payload_len);
-			if (!data_to_send) {
-				return -ENOMEM;
-			}
-
-			memcpy(data_to_send, payload, payload_len);
-
-			for (i = 0; i < payload_len; i++) {
-				data_to_send[i] ^= ctx->masking_value >> (8 * (3 - i % 4));
-			}
-		}
+	if (mask && (payload != NULL) && (payload_len > 0)) {
+		ret = websocket_send_masked(ctx, header, hdr_len,
+					    payload, payload_len, timeout);
+	} else {
+		ret = websocket_prepare_and_send(ctx, header, hdr_len,
+						 (uint8_t *)payload, payload_len,
+						 timeout);
 	}
 
-	ret = websocket_prepare_and_send(ctx, header, hdr_len,
-					 data_to_send, payload_len, timeout);
 	if (ret < 0) {
 		NET_DBG("Cannot send ws msg (%d)", -errno);
-		goto quit;
-	}
-
-quit:
-	if (data_to_send != payload) {
-		k_free(data_to_send);
 	}
 
 	/* Do no math with 0 and error codes */
@@ -941,16 +1015,34 @@ int websocket_recv_msg(int ws_sock, uint8_t *buf, size_t buf_len,
 	}
 #endif /* CONFIG_NET_TEST */
 
+	if (ctx->tx_aborted) {
+		return -ENOTCONN;
+	}
+
 	do {
-		size_t parsed_count;
+		size_t parsed_count = 0;
+		bool direct = false;
 
 		if (ctx->recv_buf.count == 0) {
+			uint8_t *rx_buf = ctx->recv_buf.buf;
+			size_t rx_len = ctx->recv_buf.size;
+
+			/* Nothing is buffered in front of the payload, so it can
+			 * be received straight into the caller buffer.
+			 */
+			if (ctx->parser_state == WEBSOCKET_PARSER_STATE_PAYLOAD) {
+				rx_buf = &payload.buf[payload.count];
+				rx_len = MIN(payload.size - payload.count,
+					     ctx->parser_remaining);
+				direct = true;
+			}
+
 #if defined(CONFIG_NET_TEST)
-			size_t input_len = MIN(ctx->recv_buf.size,
+			size_t input_len = MIN(rx_len,
 					       test_data->input_len - test_data->input_pos);
 
 			if (input_len > 0) {
-				memcpy(ctx->recv_buf.buf,
+				memcpy(rx_buf,
 				       &test_data->input_buf[test_data->input_pos], input_len);
 				test_data->input_pos += input_len;
 				ret = input_len;
@@ -963,8 +1055,8 @@ int websocket_recv_msg(int ws_sock, uint8_t *buf, size_t buf_len,
 
 			ret = wait_rx(ctx->real_sock, timeout_to_ms(&tout));
 			if (ret == 0) {
-				ret = recv(ctx->real_sock, ctx->recv_buf.buf,
-					   ctx->recv_buf.size, MSG_DONTWAIT);
+				ret = recv(ctx->real_sock, rx_buf, rx_len,
+					   MSG_DONTWAIT);
 				if (ret < 0) {
 					ret = -errno;
 				}
@@ -984,16 +1076,27 @@ int websocket_recv_msg(int ws_sock, uint8_t *buf, size_t buf_len,
 				return -ENOTCONN;
 			}
 
-			ctx->recv_buf.count = ret;
+			NET_DBG("[%p] Received %d bytes%s", ctx, ret,
+				direct ? " of payload" : "");
 
-			NET_DBG("[%p] Received %d bytes", ctx, ret);
+			if (direct) {
+				payload.count += ret;
+				ctx->parser_remaining -= ret;
+				if (ctx->parser_remaining == 0) {
+					ctx->parser_state = WEBSOCKET_PARSER_STATE_OPCODE;
+				}
+			} else {
+				ctx->recv_buf.count = ret;
+			}
 		}
 
-		ret = websocket_parse(ctx, &payload);
-		if (ret < 0) {
-			return ret;
+		if (!direct) {
+			ret = websocket_parse(ctx, &payload);
+			if (ret < 0) {
+				return ret;
+			}
+			parsed_count = ret;
 		}
-		parsed_count = ret;
 
 		if ((ctx->parser_state == WEBSOCKET_PARSER_STATE_OPCODE) ||
 		    (payload.count >= payload.size)) {
@@ -1019,15 +1122,11 @@ int websocket_recv_msg(int ws_sock, uint8_t *buf, size_t buf_len,
 
 	/* Unmask the data */
 	if (ctx->masked) {
-		uint8_t *mask_as_bytes = (uint8_t *)&ctx->masking_value;
-		size_t data_buf_offset = ctx->message_len - ctx->parser_remaining - payload.count;
-
-		for (size_t i = 0; i < payload.count; i++) {
-			size_t m = data_buf_offset % 4;
+		uint64_t data_buf_offset = ctx->message_len - ctx->parser_remaining -
+					   payload.count;
 
-			payload.buf[i] ^= mask_as_bytes[3 - m];
-			data_buf_offset++;
-		}
+		websocket_mask_payload(payload.buf, payload.buf, payload.count,
+				       ctx->masking_value, data_buf_offset);
 	}
 
 	return payload.count;
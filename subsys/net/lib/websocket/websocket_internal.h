@@ -96,6 +96,9 @@ __net_socket struct websocket_context {
 	/** Websocket connection masking value */
 	uint32_t masking_value;
 
+	/** Buffer where masked payload is prepared before sending. */
+	uint8_t tx_buf[CONFIG_WEBSOCKET_TX_BUF_SIZE];
+
 	/** Message length */
 	uint64_t message_len;
 
@@ -119,6 +122,9 @@ __net_socket struct websocket_context {
 
 	/** Did we receive all from peer during HTTP handshake */
 	uint8_t all_received : 1;
+
+	/** Sending failed in the middle of a frame, the connection is lost */
+	uint8_t tx_aborted : 1;
 };
 
 #if defined(CONFIG_NET_TEST)
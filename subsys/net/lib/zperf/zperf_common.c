@@ -41,9 +41,6 @@ struct sockaddr_in *zperf_get_sin(void)
 	return &in4_addr_my;
 }
 
-#define ZPERF_WORK_Q_THREAD_PRIORITY                                                               \
-	CLAMP(CONFIG_ZPERF_WORK_Q_THREAD_PRIORITY, K_HIGHEST_APPLICATION_THREAD_PRIO,              \
-	      K_LOWEST_APPLICATION_THREAD_PRIO)
 K_THREAD_STACK_DEFINE(zperf_work_q_stack, CONFIG_ZPERF_WORK_Q_STACK_SIZE);
 
 static struct k_work_q zperf_work_q;
@@ -227,6 +224,20 @@ uint32_t zperf_packet_duration(uint32_t packet_size, uint32_t rate_in_kbps)
 			  (rate_in_kbps * 1024U));
 }
 
+/* Non-idle cycles spent by the whole system so far */
+uint64_t zperf_cpu_cycles(void)
+{
+#if defined(CONFIG_SCHED_THREAD_USAGE_ALL)
+	k_thread_runtime_stats_t stats;
+
+	if (k_thread_runtime_stats_all_get(&stats) == 0) {
+		return stats.total_cycles;
+	}
+#endif
+
+	return 0;
+}
+
 void zperf_async_work_submit(struct k_work *work)
 {
 	k_work_submit_to_queue(&zperf_work_q, work);
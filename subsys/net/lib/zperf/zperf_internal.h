@@ -39,12 +39,25 @@
 
 #define PACKET_SIZE_MAX CONFIG_NET_ZPERF_MAX_PACKET_SIZE
 
+#define ZPERF_WORK_Q_THREAD_PRIORITY                                                               \
+	CLAMP(CONFIG_ZPERF_WORK_Q_THREAD_PRIORITY, K_HIGHEST_APPLICATION_THREAD_PRIO,              \
+	      K_LOWEST_APPLICATION_THREAD_PRIO)
+
 #define MY_SRC_PORT 50000
 #define DEF_PORT 5001
 #define DEF_PORT_STR STRINGIFY(DEF_PORT)
 
 #define ZPERF_VERSION "1.1"
 
+/* iPerf client header flags */
+#define ZPERF_FLAGS_VERSION1 0x80000000
+#define ZPERF_FLAGS_RUN_NOW 0x00000001
+
+/* Size of the buffer a UDP upload stream builds its packets in */
+#define ZPERF_UDP_PACKET_BUF_SIZE (sizeof(struct zperf_udp_datagram) +		\
+				   sizeof(struct zperf_client_hdr_v1) +		\
+				   PACKET_SIZE_MAX)
+
 struct zperf_udp_datagram {
 	int32_t id;
 	uint32_t tv_sec;
@@ -87,6 +100,14 @@ static inline uint32_t time_delta(uint32_t ts, uint32_t t)
 	return (t >= ts) ? (t - ts) : (ULONG_MAX - ts + t);
 }
 
+/* Histogram bucket of a duration in microseconds, see struct zperf_results */
+static inline void zperf_hist_add(uint32_t *hist, uint32_t us)
+{
+	int bucket = (us == 0U) ? 0 : 32 - __builtin_clz(us);
+
+	hist[MIN(bucket, ZPERF_HIST_BUCKETS - 1)]++;
+}
+
 int zperf_get_ipv6_addr(char *host, char *prefix_str, struct in6_addr *addr);
 struct sockaddr_in6 *zperf_get_sin6(void);
 
@@ -103,6 +124,16 @@ int zperf_prepare_upload_sock(const struct sockaddr *peer_addr, int tos,
 
 uint32_t zperf_packet_duration(uint32_t packet_size, uint32_t rate_in_kbps);
 
+uint64_t zperf_cpu_cycles(void);
+
+int zperf_udp_upload_stream(const struct zperf_upload_params *param,
+			    uint8_t *packet, struct zperf_results *result);
+int zperf_tcp_upload_stream(const struct zperf_upload_params *param,
+			    struct zperf_results *result);
+int zperf_upload_streams(const struct zperf_upload_params *param, int proto,
+			 struct zperf_results *stream_results,
+			 struct zperf_results *total);
+
 void zperf_async_work_submit(struct k_work *work);
 void zperf_udp_uploader_init(void);
 void zperf_tcp_uploader_init(void);
@@ -100,6 +100,8 @@ void zperf_reset_session_stats(struct session *session)
 	session->error = 0U;
 	session->jitter = 0;
 	session->last_transit_time = 0;
+	memset(session->latency_hist, 0, sizeof(session->latency_hist));
+	memset(session->jitter_hist, 0, sizeof(session->jitter_hist));
 }
 
 void zperf_session_init(void)
@@ -49,6 +49,8 @@ struct session {
 	uint32_t last_time;
 	int32_t jitter;
 	int32_t last_transit_time;
+	uint32_t latency_hist[ZPERF_HIST_BUCKETS];
+	uint32_t jitter_hist[ZPERF_HIST_BUCKETS];
 
 	/* Stats packet*/
 	struct zperf_server_hdr stat;
@@ -289,6 +289,59 @@ static int cmd_setip(const struct shell *sh, size_t argc, char *argv[])
 	return 0;
 }
 
+static void print_histogram(const struct shell *sh, const char *name,
+			    const uint32_t *hist)
+{
+	bool empty = true;
+
+	for (int i = 0; i < ZPERF_HIST_BUCKETS; i++) {
+		if (hist[i] != 0U) {
+			empty = false;
+			break;
+		}
+	}
+
+	if (empty) {
+		return;
+	}
+
+	shell_fprintf(sh, SHELL_NORMAL, " %s histogram:\n", name);
+
+	for (int i = 0; i < ZPERF_HIST_BUCKETS; i++) {
+		if (hist[i] == 0U) {
+			continue;
+		}
+
+		if (i == 0) {
+			shell_fprintf(sh, SHELL_NORMAL, "  < 1 us\t\t%u\n", hist[i]);
+		} else if (i == ZPERF_HIST_BUCKETS - 1) {
+			shell_fprintf(sh, SHELL_NORMAL, "  >= %u us\t%u\n",
+				      1U << (i - 1), hist[i]);
+		} else {
+			shell_fprintf(sh, SHELL_NORMAL, "  %u - %u us\t%u\n",
+				      1U << (i - 1), (1U << i) - 1U, hist[i]);
+		}
+	}
+}
+
+static void print_cpu_usage(const struct shell *sh,
+			    const struct zperf_results *results,
+			    uint64_t bytes)
+{
+	uint64_t per_byte_x100;
+
+	if (results->cpu_cycles == 0U || bytes == 0U) {
+		return;
+	}
+
+	per_byte_x100 = results->cpu_cycles * 100U / bytes;
+
+	shell_fprintf(sh, SHELL_NORMAL, "CPU cycles:\t\t%llu (%u.%02u per byte)\n",
+		      (unsigned long long)results->cpu_cycles,
+		      (unsigned int)(per_byte_x100 / 100U),
+		      (unsigned int)(per_byte_x100 % 100U));
+}
+
 static void udp_session_cb(enum zperf_status status,
 			   struct zperf_results *result,
 			   void *user_data)
@@ -334,6 +387,9 @@ static void udp_session_cb(enum zperf_status status,
 		print_number(sh, rate_in_kbps, KBPS, KBPS_UNIT);
 		shell_fprintf(sh, SHELL_NORMAL, "\n");
 
+		print_histogram(sh, "latency", result->latency_hist);
+		print_histogram(sh, "jitter", result->jitter_hist);
+
 		break;
 	}
 
@@ -458,6 +514,9 @@ static void shell_udp_upload_print_stats(const struct shell *sh,
 		shell_fprintf(sh, SHELL_NORMAL, "\t(");
 		print_number(sh, client_rate_in_kbps, KBPS, KBPS_UNIT);
 		shell_fprintf(sh, SHELL_NORMAL, ")\n");
+
+		print_cpu_usage(sh, results, (uint64_t)results->nb_packets_sent *
+					     results->packet_size);
 	}
 }
 
@@ -491,6 +550,75 @@ static void shell_tcp_upload_print_stats(const struct shell *sh,
 		shell_fprintf(sh, SHELL_NORMAL, "Rate:\t\t");
 		print_number(sh, client_rate_in_kbps, KBPS, KBPS_UNIT);
 		shell_fprintf(sh, SHELL_NORMAL, "\n");
+
+		print_cpu_usage(sh, results, (uint64_t)results->nb_packets_sent *
+					     results->packet_size);
+	}
+}
+
+static void shell_print_results_json(const struct shell *sh,
+				     const struct zperf_results *results)
+{
+	shell_fprintf(sh, SHELL_NORMAL,
+		      "{\"packets_sent\":%u,\"packets_received\":%u,"
+		      "\"packets_lost\":%u,\"packets_outorder\":%u,"
+		      "\"errors\":%u,\"packet_size\":%u,"
+		      "\"bytes_sent\":%llu,\"bytes_received\":%u,"
+		      "\"client_time_us\":%u,\"server_time_us\":%u,"
+		      "\"jitter_us\":%u,\"cpu_cycles\":%llu}",
+		      results->nb_packets_sent, results->nb_packets_rcvd,
+		      results->nb_packets_lost, results->nb_packets_outorder,
+		      results->nb_packets_errors, results->packet_size,
+		      (unsigned long long)results->nb_packets_sent *
+		      results->packet_size,
+		      results->total_len,
+		      results->client_time_in_us, results->time_in_us,
+		      results->jitter_in_us,
+		      (unsigned long long)results->cpu_cycles);
+}
+
+/* Machine readable summary of a test, printed on a single line */
+static void shell_upload_print_json(const struct shell *sh, bool is_udp,
+				    const struct zperf_results *stream_results,
+				    int num_streams,
+				    const struct zperf_results *total)
+{
+	shell_fprintf(sh, SHELL_NORMAL, "{\"protocol\":\"%s\",\"streams\":[",
+		      is_udp ? "udp" : "tcp");
+
+	for (int i = 0; i < num_streams; i++) {
+		if (i > 0) {
+			shell_fprintf(sh, SHELL_NORMAL, ",");
+		}
+
+		shell_print_results_json(sh, &stream_results[i]);
+	}
+
+	shell_fprintf(sh, SHELL_NORMAL, "],\"total\":");
+	shell_print_results_json(sh, total);
+	shell_fprintf(sh, SHELL_NORMAL, "}\n");
+}
+
+static void shell_upload_print_streams(const struct shell *sh,
+				       const struct zperf_results *stream_results,
+				       int num_streams)
+{
+	for (int i = 0; i < num_streams; i++) {
+		const struct zperf_results *results = &stream_results[i];
+		unsigned int client_rate_in_kbps = 0U;
+
+		if (results->client_time_in_us != 0U) {
+			client_rate_in_kbps = (uint32_t)
+				(((uint64_t)results->nb_packets_sent *
+				  (uint64_t)results->packet_size * (uint64_t)8 *
+				  (uint64_t)USEC_PER_SEC) /
+				 ((uint64_t)results->client_time_in_us * 1024U));
+		}
+
+		shell_fprintf(sh, SHELL_NORMAL, "Stream %d:\t\t%u packets\t", i,
+			      results->nb_packets_sent);
+		print_number(sh, client_rate_in_kbps, KBPS, KBPS_UNIT);
+		shell_fprintf(sh, SHELL_NORMAL, "\n");
 	}
 }
 
@@ -587,13 +715,69 @@ static void send_ping(const struct shell *sh,
 	(void)net_icmp_cleanup_ctx(&ctx);
 }
 
+static int execute_upload_streams(const struct shell *sh,
+				  const struct zperf_upload_params *param,
+				  bool is_udp, bool json)
+{
+	static struct zperf_results stream_results[CONFIG_NET_ZPERF_MAX_STREAMS];
+	struct zperf_results total = { 0 };
+	int num_streams = MAX(param->num_streams, 1);
+	int ret;
+
+	if (is_udp) {
+		ret = zperf_udp_upload_streams(param, stream_results, &total);
+	} else {
+		ret = zperf_tcp_upload_streams(param, stream_results, &total);
+	}
+
+	if (ret < 0) {
+		shell_fprintf(sh, SHELL_ERROR, "%s upload failed (%d)\n",
+			      is_udp ? "UDP" : "TCP", ret);
+		return ret;
+	}
+
+	if (json) {
+		shell_upload_print_json(sh, is_udp, stream_results, num_streams,
+					&total);
+		return 0;
+	}
+
+	shell_upload_print_streams(sh, stream_results, num_streams);
+
+	if (is_udp) {
+		shell_udp_upload_print_stats(sh, &total);
+	} else {
+		shell_tcp_upload_print_stats(sh, &total);
+	}
+
+	return 0;
+}
+
 static int execute_upload(const struct shell *sh,
 			  const struct zperf_upload_params *param,
-			  bool is_udp, bool async)
+			  bool is_udp, bool async, bool json)
 {
 	struct zperf_results results = { 0 };
 	int ret;
 
+	if (async && json) {
+		shell_fprintf(sh, SHELL_WARNING,
+			      "JSON output is not available for asynchronous uploads\n");
+		return -EINVAL;
+	}
+
+	if (param->num_streams > CONFIG_NET_ZPERF_MAX_STREAMS) {
+		shell_fprintf(sh, SHELL_WARNING, "At most %d streams are supported\n",
+			      CONFIG_NET_ZPERF_MAX_STREAMS);
+		return -EINVAL;
+	}
+
+	if (!is_udp && param->bidirectional) {
+		shell_fprintf(sh, SHELL_WARNING,
+			      "Bidirectional test is only supported with UDP\n");
+		return -EINVAL;
+	}
+
 	shell_fprintf(sh, SHELL_NORMAL, "Duration:\t");
 	print_number(sh, param->duration_ms * USEC_PER_MSEC, TIME_US,
 		     TIME_US_UNIT);
@@ -602,6 +786,10 @@ static int execute_upload(const struct shell *sh,
 		      param->packet_size);
 	shell_fprintf(sh, SHELL_NORMAL, "Rate:\t\t%u kbps\n",
 		      param->rate_kbps);
+	if (param->num_streams > 1) {
+		shell_fprintf(sh, SHELL_NORMAL, "Streams:\t%u\n",
+			      param->num_streams);
+	}
 	shell_fprintf(sh, SHELL_NORMAL, "Starting...\n");
 
 	if (IS_ENABLED(CONFIG_NET_IPV6) && param->peer_addr.sa_family == AF_INET6) {
@@ -638,6 +826,8 @@ static int execute_upload(const struct shell *sh,
 					"Failed to start UDP async upload (%d)\n", ret);
 				return ret;
 			}
+		} else if (param->num_streams > 1 || json) {
+			return execute_upload_streams(sh, param, is_udp, json);
 		} else {
 			ret = zperf_udp_upload(param, &results);
 			if (ret < 0) {
@@ -664,6 +854,8 @@ static int execute_upload(const struct shell *sh,
 					"Failed to start TCP async upload (%d)\n", ret);
 				return ret;
 			}
+		} else if (param->num_streams > 1 || json) {
+			return execute_upload_streams(sh, param, is_udp, json);
 		} else {
 			ret = zperf_tcp_upload(param, &results);
 			if (ret < 0) {
@@ -721,6 +913,7 @@ static int shell_cmd_upload(const struct shell *sh, size_t argc,
 	struct sockaddr_in ipv4 = { .sin_family = AF_INET };
 	char *port_str;
 	bool async = false;
+	bool json = false;
 	bool is_udp;
 	int start = 0;
 	size_t opt_cnt = 0;
@@ -754,6 +947,35 @@ static int shell_cmd_upload(const struct shell *sh, size_t argc,
 			opt_cnt += 1;
 			break;
 
+		case 'P': {
+			int streams = parse_arg(&i, argc, argv);
+
+			if (streams < 1 || streams > UINT8_MAX) {
+				shell_fprintf(sh, SHELL_WARNING,
+					      "Parse error: %s\n", argv[i]);
+				return -ENOEXEC;
+			}
+
+			param.num_streams = streams;
+			opt_cnt += 2;
+			break;
+		}
+
+		case 'd':
+			if (!is_udp) {
+				shell_fprintf(sh, SHELL_WARNING,
+					      "TCP does not support -d option\n");
+				return -ENOEXEC;
+			}
+			param.bidirectional = true;
+			opt_cnt += 1;
+			break;
+
+		case 'j':
+			json = true;
+			opt_cnt += 1;
+			break;
+
 		case 'n':
 			if (is_udp) {
 				shell_fprintf(sh, SHELL_WARNING,
@@ -889,7 +1111,7 @@ static int shell_cmd_upload(const struct shell *sh, size_t argc,
 		param.rate_kbps = 10U;
 	}
 
-	return execute_upload(sh, &param, is_udp, async);
+	return execute_upload(sh, &param, is_udp, async, json);
 }
 
 static int cmd_tcp_upload(const struct shell *sh, size_t argc, char *argv[])
@@ -909,6 +1131,7 @@ static int shell_cmd_upload2(const struct shell *sh, size_t argc,
 	sa_family_t family;
 	uint8_t is_udp;
 	bool async = false;
+	bool json = false;
 	int start = 0;
 	size_t opt_cnt = 0;
 
@@ -940,6 +1163,35 @@ static int shell_cmd_upload2(const struct shell *sh, size_t argc,
 			opt_cnt += 1;
 			break;
 
+		case 'P': {
+			int streams = parse_arg(&i, argc, argv);
+
+			if (streams < 1 || streams > UINT8_MAX) {
+				shell_fprintf(sh, SHELL_WARNING,
+					      "Parse error: %s\n", argv[i]);
+				return -ENOEXEC;
+			}
+
+			param.num_streams = streams;
+			opt_cnt += 2;
+			break;
+		}
+
+		case 'd':
+			if (!is_udp) {
+				shell_fprintf(sh, SHELL_WARNING,
+					      "TCP does not support -d option\n");
+				return -ENOEXEC;
+			}
+			param.bidirectional = true;
+			opt_cnt += 1;
+			break;
+
+		case 'j':
+			json = true;
+			opt_cnt += 1;
+			break;
+
 		case 'n':
 			if (is_udp) {
 				shell_fprintf(sh, SHELL_WARNING,
@@ -1040,7 +1292,7 @@ static int shell_cmd_upload2(const struct shell *sh, size_t argc,
 		param.rate_kbps = 10U;
 	}
 
-	return execute_upload(sh, &param, is_udp, async);
+	return execute_upload(sh, &param, is_udp, async, json);
 }
 
 static int cmd_tcp_upload2(const struct shell *sh, size_t argc,
@@ -1248,7 +1500,7 @@ SHELL_STATIC_SUBCMD_SET_CREATE(zperf_cmd_tcp_download,
 SHELL_STATIC_SUBCMD_SET_CREATE(zperf_cmd_tcp,
 	SHELL_CMD(upload, NULL,
 		  "[<options>] <dest ip> <dest port> <duration> <packet size>[K]\n"
-		  "<options>     command options (optional): [-S tos -a]\n"
+		  "<options>     command options (optional): [-S tos -a -P num -j]\n"
 		  "<dest ip>     IP destination\n"
 		  "<dest port>   port destination\n"
 		  "<duration>    of the test in seconds\n"
@@ -1257,6 +1509,8 @@ SHELL_STATIC_SUBCMD_SET_CREATE(zperf_cmd_tcp,
 		  "Available options:\n"
 		  "-S tos: Specify IPv4/6 type of service\n"
 		  "-a: Asynchronous call (shell will not block for the upload)\n"
+		  "-P num: Number of parallel streams\n"
+		  "-j: Print a JSON summary of the results\n"
 		  "-n: Disable Nagle's algorithm\n"
 #ifdef CONFIG_NET_CONTEXT_PRIORITY
 		  "-p: Specify custom packet priority\n"
@@ -1266,7 +1520,7 @@ SHELL_STATIC_SUBCMD_SET_CREATE(zperf_cmd_tcp,
 		  cmd_tcp_upload),
 	SHELL_CMD(upload2, NULL,
 		  "[<options>] v6|v4 <duration> <packet size>[K] <baud rate>[K|M]\n"
-		  "<options>     command options (optional): [-S tos -a]\n"
+		  "<options>     command options (optional): [-S tos -a -P num -j]\n"
 		  "<v6|v4>:      Use either IPv6 or IPv4\n"
 		  "<duration>    Duration of the test in seconds\n"
 		  "<packet size> Size of the packet in byte or kilobyte "
@@ -1274,6 +1528,8 @@ SHELL_STATIC_SUBCMD_SET_CREATE(zperf_cmd_tcp,
 		  "Available options:\n"
 		  "-S tos: Specify IPv4/6 type of service\n"
 		  "-a: Asynchronous call (shell will not block for the upload)\n"
+		  "-P num: Number of parallel streams\n"
+		  "-j: Print a JSON summary of the results\n"
 #ifdef CONFIG_NET_CONTEXT_PRIORITY
 		  "-p: Specify custom packet priority\n"
 #endif /* CONFIG_NET_CONTEXT_PRIORITY */
@@ -1307,7 +1563,7 @@ SHELL_STATIC_SUBCMD_SET_CREATE(zperf_cmd_udp,
 	SHELL_CMD(upload, NULL,
 		  "[<options>] <dest ip> [<dest port> <duration> <packet size>[K] "
 							"<baud rate>[K|M]]\n"
-		  "<options>     command options (optional): [-S tos -a]\n"
+		  "<options>     command options (optional): [-S tos -a -P num -j]\n"
 		  "<dest ip>     IP destination\n"
 		  "<dest port>   port destination\n"
 		  "<duration>    of the test in seconds\n"
@@ -1317,6 +1573,9 @@ SHELL_STATIC_SUBCMD_SET_CREATE(zperf_cmd_udp,
 		  "Available options:\n"
 		  "-S tos: Specify IPv4/6 type of service\n"
 		  "-a: Asynchronous call (shell will not block for the upload)\n"
+		  "-P num: Number of parallel streams\n"
+		  "-d: Bidirectional test, the peer sends back to the sending port\n"
+		  "-j: Print a JSON summary of the results\n"
 #ifdef CONFIG_NET_CONTEXT_PRIORITY
 		  "-p: Specify custom packet priority\n"
 #endif /* CONFIG_NET_CONTEXT_PRIORITY */
@@ -1325,7 +1584,7 @@ SHELL_STATIC_SUBCMD_SET_CREATE(zperf_cmd_udp,
 		  cmd_udp_upload),
 	SHELL_CMD(upload2, NULL,
 		  "[<options>] v6|v4 [<duration> <packet size>[K] <baud rate>[K|M]]\n"
-		  "<options>     command options (optional): [-S tos -a]\n"
+		  "<options>     command options (optional): [-S tos -a -P num -j]\n"
 		  "<v6|v4>:      Use either IPv6 or IPv4\n"
 		  "<duration>    Duration of the test in seconds\n"
 		  "<packet size> Size of the packet in byte or kilobyte "
@@ -1334,6 +1593,9 @@ SHELL_STATIC_SUBCMD_SET_CREATE(zperf_cmd_udp,
 		  "Available options:\n"
 		  "-S tos: Specify IPv4/6 type of service\n"
 		  "-a: Asynchronous call (shell will not block for the upload)\n"
+		  "-P num: Number of parallel streams\n"
+		  "-d: Bidirectional test, the peer sends back to the sending port\n"
+		  "-j: Print a JSON summary of the results\n"
 #ifdef CONFIG_NET_CONTEXT_PRIORITY
 		  "-p: Specify custom packet priority\n"
 #endif /* CONFIG_NET_CONTEXT_PRIORITY */
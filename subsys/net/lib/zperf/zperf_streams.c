@@ -0,0 +1,176 @@
+/*
+ * Copyright The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(net_zperf, CONFIG_NET_ZPERF_LOG_LEVEL);
+
+#include <zephyr/kernel.h>
+
+#include <errno.h>
+
+#include <zephyr/net/socket.h>
+#include <zephyr/net/zperf.h>
+
+#include "zperf_internal.h"
+
+/* Parallel upload streams. Each stream runs from its own thread and uses
+ * its own socket, so the streams are handled independently by the stack
+ * and by the peer (iPerf uses a session per source port).
+ */
+struct zperf_stream {
+	struct k_thread thread;
+	struct zperf_upload_params param;
+	struct zperf_results results;
+	int proto;
+	int ret;
+
+	/* UDP packet buffer, the headers differ between streams */
+	uint8_t packet[ZPERF_UDP_PACKET_BUF_SIZE];
+};
+
+static K_THREAD_STACK_ARRAY_DEFINE(stream_stacks, CONFIG_NET_ZPERF_MAX_STREAMS,
+				   CONFIG_NET_ZPERF_STREAM_STACK_SIZE);
+static struct zperf_stream streams[CONFIG_NET_ZPERF_MAX_STREAMS];
+static K_MUTEX_DEFINE(streams_lock);
+
+static uint64_t thread_cpu_cycles(void)
+{
+#if defined(CONFIG_SCHED_THREAD_USAGE)
+	k_thread_runtime_stats_t stats;
+
+	if (k_thread_runtime_stats_get(k_current_get(), &stats) == 0) {
+		return stats.execution_cycles;
+	}
+#endif
+
+	return 0;
+}
+
+static void stream_thread(void *p1, void *p2, void *p3)
+{
+	struct zperf_stream *stream = p1;
+
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	if (stream->proto == IPPROTO_UDP) {
+		stream->ret = zperf_udp_upload_stream(&stream->param,
+						      stream->packet,
+						      &stream->results);
+	} else {
+		stream->ret = zperf_tcp_upload_stream(&stream->param,
+						      &stream->results);
+	}
+
+	/* The thread is created for this run, so its whole usage belongs
+	 * to the stream.
+	 */
+	stream->results.cpu_cycles = thread_cpu_cycles();
+}
+
+static void results_add(struct zperf_results *total,
+			const struct zperf_results *results)
+{
+	total->nb_packets_sent += results->nb_packets_sent;
+	total->nb_packets_rcvd += results->nb_packets_rcvd;
+	total->nb_packets_lost += results->nb_packets_lost;
+	total->nb_packets_outorder += results->nb_packets_outorder;
+	total->nb_packets_errors += results->nb_packets_errors;
+	total->total_len += results->total_len;
+
+	/* The streams run in parallel, so the test lasts as long as the
+	 * slowest one, and the jitter is the worst one.
+	 */
+	total->time_in_us = MAX(total->time_in_us, results->time_in_us);
+	total->client_time_in_us = MAX(total->client_time_in_us,
+				       results->client_time_in_us);
+	total->jitter_in_us = MAX(total->jitter_in_us, results->jitter_in_us);
+	total->packet_size = results->packet_size;
+
+	for (int i = 0; i < ZPERF_HIST_BUCKETS; i++) {
+		total->latency_hist[i] += results->latency_hist[i];
+		total->jitter_hist[i] += results->jitter_hist[i];
+	}
+}
+
+int zperf_upload_streams(const struct zperf_upload_params *param, int proto,
+			 struct zperf_results *stream_results,
+			 struct zperf_results *total)
+{
+	int num_streams = MAX(param->num_streams, 1);
+	uint64_t cycles;
+	int ret = 0;
+
+	if (num_streams > CONFIG_NET_ZPERF_MAX_STREAMS) {
+		NET_ERR("Too many streams %d, maximum is %d", num_streams,
+			CONFIG_NET_ZPERF_MAX_STREAMS);
+		return -EINVAL;
+	}
+
+	if (proto == IPPROTO_TCP && param->bidirectional) {
+		NET_ERR("Bidirectional test is only supported with UDP");
+		return -ENOTSUP;
+	}
+
+	if (k_mutex_lock(&streams_lock, K_NO_WAIT) != 0) {
+		return -EBUSY;
+	}
+
+	for (int i = 0; i < num_streams; i++) {
+		struct zperf_stream *stream = &streams[i];
+
+		memcpy(&stream->param, param, sizeof(*param));
+		memset(&stream->results, 0, sizeof(stream->results));
+		stream->proto = proto;
+		stream->ret = 0;
+
+		/* The peer runs a single test back to us */
+		stream->param.bidirectional = param->bidirectional && i == 0;
+
+		k_thread_create(&stream->thread, stream_stacks[i],
+				K_THREAD_STACK_SIZEOF(stream_stacks[i]),
+				stream_thread, stream, NULL, NULL,
+				ZPERF_WORK_Q_THREAD_PRIORITY, 0, K_FOREVER);
+		k_thread_name_set(&stream->thread, "zperf_stream");
+	}
+
+	cycles = zperf_cpu_cycles();
+
+	/* Start all the streams together once they are set up */
+	for (int i = 0; i < num_streams; i++) {
+		k_thread_start(&streams[i].thread);
+	}
+
+	for (int i = 0; i < num_streams; i++) {
+		(void)k_thread_join(&streams[i].thread, K_FOREVER);
+	}
+
+	memset(total, 0, sizeof(*total));
+	total->cpu_cycles = zperf_cpu_cycles() - cycles;
+
+	for (int i = 0; i < num_streams; i++) {
+		struct zperf_stream *stream = &streams[i];
+
+		if (stream->ret < 0) {
+			NET_ERR("Stream %d failed (%d)", i, stream->ret);
+
+			if (ret == 0) {
+				ret = stream->ret;
+			}
+		} else {
+			results_add(total, &stream->results);
+		}
+
+		if (stream_results != NULL) {
+			memcpy(&stream_results[i], &stream->results,
+			       sizeof(stream->results));
+		}
+	}
+
+	k_mutex_unlock(&streams_lock);
+
+	return ret;
+}
@@ -40,14 +40,6 @@ static int tcp_upload(int sock,
 	/* Start the loop */
 	start_time = k_uptime_ticks();
 
-	(void)memset(sample_packet, 'z', sizeof(sample_packet));
-
-	/* Set the "flags" field in start of the packet to be 0.
-	 * As the protocol is not properly described anywhere, it is
-	 * not certain if this is a proper thing to do.
-	 */
-	(void)memset(sample_packet, 0, sizeof(uint32_t));
-
 	do {
 		/* Send the packet */
 		ret = zsock_send(sock, sample_packet, packet_size, 0);
@@ -106,14 +98,15 @@ static int tcp_upload(int sock,
 	return 0;
 }
 
-int zperf_tcp_upload(const struct zperf_upload_params *param,
-		     struct zperf_results *result)
+int zperf_tcp_upload_stream(const struct zperf_upload_params *param,
+			    struct zperf_results *result)
 {
 	int sock;
 	int ret;
 
-	if (param == NULL || result == NULL) {
-		return -EINVAL;
+	if (param->bidirectional) {
+		NET_ERR("Bidirectional test is only supported with UDP");
+		return -ENOTSUP;
 	}
 
 	sock = zperf_prepare_upload_sock(&param->peer_addr, param->options.tos,
@@ -127,6 +120,7 @@ int zperf_tcp_upload(const struct zperf_upload_params *param,
 			     &param->options.tcp_nodelay,
 			     sizeof(param->options.tcp_nodelay)) != 0) {
 		NET_WARN("Failed to set IPPROTO_TCP - TCP_NODELAY socket option.");
+		zsock_close(sock);
 		return -EINVAL;
 	}
 
@@ -137,6 +131,40 @@ int zperf_tcp_upload(const struct zperf_upload_params *param,
 	return ret;
 }
 
+int zperf_tcp_upload(const struct zperf_upload_params *param,
+		     struct zperf_results *result)
+{
+	uint64_t cycles;
+	int ret;
+
+	if (param == NULL || result == NULL) {
+		return -EINVAL;
+	}
+
+	if (param->num_streams > 1) {
+		return zperf_upload_streams(param, IPPROTO_TCP, NULL, result);
+	}
+
+	cycles = zperf_cpu_cycles();
+
+	ret = zperf_tcp_upload_stream(param, result);
+
+	result->cpu_cycles = zperf_cpu_cycles() - cycles;
+
+	return ret;
+}
+
+int zperf_tcp_upload_streams(const struct zperf_upload_params *param,
+			     struct zperf_results *stream_results,
+			     struct zperf_results *total)
+{
+	if (param == NULL || total == NULL) {
+		return -EINVAL;
+	}
+
+	return zperf_upload_streams(param, IPPROTO_TCP, stream_results, total);
+}
+
 static void tcp_upload_async_work(struct k_work *work)
 {
 	struct zperf_async_upload_context *upload_ctx =
@@ -179,5 +207,16 @@ int zperf_tcp_upload_async(const struct zperf_upload_params *param,
 
 void zperf_tcp_uploader_init(void)
 {
+	/* The payload is shared by all the upload streams, so it is only
+	 * written once.
+	 */
+	(void)memset(sample_packet, 'z', sizeof(sample_packet));
+
+	/* Set the "flags" field in start of the packet to be 0.
+	 * As the protocol is not properly described anywhere, it is
+	 * not certain if this is a proper thing to do.
+	 */
+	(void)memset(sample_packet, 0, sizeof(uint32_t));
+
 	k_work_init(&tcp_async_upload_ctx.work, tcp_upload_async_work);
 }
@@ -99,6 +99,74 @@ static int zperf_receiver_send_stat(int sock, const struct sockaddr *addr,
 	return ret;
 }
 
+#if defined(CONFIG_NET_ZPERF_UDP_REVERSE)
+static void reverse_upload_cb(enum zperf_status status,
+			      struct zperf_results *result,
+			      void *user_data)
+{
+	ARG_UNUSED(user_data);
+
+	switch (status) {
+	case ZPERF_SESSION_STARTED:
+		NET_INFO("Reverse test started");
+		break;
+	case ZPERF_SESSION_FINISHED:
+		NET_INFO("Reverse test finished, %u packets sent",
+			 result->nb_packets_sent);
+		break;
+	case ZPERF_SESSION_ERROR:
+		NET_WARN("Reverse test failed");
+		break;
+	}
+}
+
+/* iPerf dual test: the client asks us to run the same test back to it
+ * while it is sending. The test only goes back to where the request came
+ * from and within the configured limits, so the header cannot turn the
+ * server into a traffic generator towards other hosts or ports.
+ */
+static void udp_start_reverse(const struct sockaddr *addr,
+			      const struct zperf_client_hdr_v1 *client_hdr)
+{
+	struct zperf_upload_params param = { 0 };
+	uint32_t flags = ntohl(UNALIGNED_GET(&client_hdr->flags));
+	uint32_t packet_size;
+	uint32_t rate_kbps;
+	int32_t amount;
+	int ret;
+
+	if (!(flags & ZPERF_FLAGS_VERSION1) || !(flags & ZPERF_FLAGS_RUN_NOW)) {
+		return;
+	}
+
+	amount = ntohl(UNALIGNED_GET(&client_hdr->num_of_bytes));
+	if (amount >= 0) {
+		NET_WARN("Only time based reverse tests are supported");
+		return;
+	}
+
+	memcpy(&param.peer_addr, addr, sizeof(param.peer_addr));
+
+	/* The amount is the duration in hundredths of a second */
+	param.duration_ms = MIN(-(int64_t)amount,
+				CONFIG_NET_ZPERF_UDP_REVERSE_MAX_DURATION * 100) * 10;
+
+	packet_size = ntohl(UNALIGNED_GET(&client_hdr->buffer_len));
+	param.packet_size = CLAMP(packet_size, sizeof(struct zperf_udp_datagram),
+				  CONFIG_NET_ZPERF_MAX_PACKET_SIZE);
+
+	rate_kbps = ntohl(UNALIGNED_GET(&client_hdr->bandwidth)) / 1024U;
+	param.rate_kbps = CLAMP(rate_kbps, 1U, CONFIG_NET_ZPERF_UDP_REVERSE_MAX_RATE);
+
+	param.options.priority = -1;
+
+	ret = zperf_udp_upload_async(&param, reverse_upload_cb, NULL);
+	if (ret < 0) {
+		NET_WARN("Cannot start the reverse test (%d)", ret);
+	}
+}
+#endif /* CONFIG_NET_ZPERF_UDP_REVERSE */
+
 static void udp_received(int sock, const struct sockaddr *addr, uint8_t *data,
 			 size_t datalen)
 {
@@ -140,6 +208,14 @@ static void udp_received(int sock, const struct sockaddr *addr, uint8_t *data,
 			session->state = STATE_ONGOING;
 			session->start_time = time;
 
+#if defined(CONFIG_NET_ZPERF_UDP_REVERSE)
+			if (datalen >= sizeof(struct zperf_udp_datagram) +
+				       sizeof(struct zperf_client_hdr_v1)) {
+				udp_start_reverse(addr,
+					(struct zperf_client_hdr_v1 *)(data + sizeof(*hdr)));
+			}
+#endif /* CONFIG_NET_ZPERF_UDP_REVERSE */
+
 			/* Start a new session! */
 			if (udp_session_cb != NULL) {
 				udp_session_cb(ZPERF_SESSION_STARTED, NULL,
@@ -183,21 +259,32 @@ static void udp_received(int sock, const struct sockaddr *addr, uint8_t *data,
 			results.time_in_us = duration;
 			results.jitter_in_us = session->jitter;
 			results.packet_size = session->length / session->counter;
+			memcpy(results.latency_hist, session->latency_hist,
+			       sizeof(results.latency_hist));
+			memcpy(results.jitter_hist, session->jitter_hist,
+			       sizeof(results.jitter_hist));
 
 			if (udp_session_cb != NULL) {
 				udp_session_cb(ZPERF_SESSION_FINISHED, &results,
 					       udp_user_data);
 			}
 		} else {
+			uint32_t sent_us = ntohl(hdr->tv_sec) * USEC_PER_SEC +
+					   ntohl(hdr->tv_usec);
+			int32_t latency = k_ticks_to_us_ceil32(time) - sent_us;
+
 			/* Update counter */
 			session->counter++;
 			session->length += datalen;
 
+			/* Latency is only meaningful if both ends share the
+			 * clock, clamp the obviously wrong values.
+			 */
+			zperf_hist_add(session->latency_hist, MAX(latency, 0));
+
 			/* Compute jitter */
 			transit_time = time_delta(
-				k_ticks_to_us_ceil32(time),
-				ntohl(hdr->tv_sec) * USEC_PER_SEC +
-				ntohl(hdr->tv_usec));
+				k_ticks_to_us_ceil32(time), sent_us);
 			if (session->last_transit_time != 0) {
 				int32_t delta_transit = transit_time -
 					session->last_transit_time;
@@ -208,6 +295,9 @@ static void udp_received(int sock, const struct sockaddr *addr, uint8_t *data,
 
 				session->jitter +=
 					(delta_transit - session->jitter) / 16;
+
+				zperf_hist_add(session->jitter_hist,
+					       delta_transit);
 			}
 
 			session->last_transit_time = transit_time;
@@ -14,9 +14,7 @@ LOG_MODULE_DECLARE(net_zperf, CONFIG_NET_ZPERF_LOG_LEVEL);
 
 #include "zperf_internal.h"
 
-static uint8_t sample_packet[sizeof(struct zperf_udp_datagram) +
-			     sizeof(struct zperf_client_hdr_v1) +
-			     PACKET_SIZE_MAX];
+static uint8_t sample_packet[ZPERF_UDP_PACKET_BUF_SIZE];
 
 static struct zperf_async_upload_context udp_async_upload_ctx;
 
@@ -45,7 +43,7 @@ static inline void zperf_upload_decode_stat(const uint8_t *data,
 		ntohl(UNALIGNED_GET(&stat->jitter1)) * USEC_PER_SEC;
 }
 
-static inline int zperf_upload_fin(int sock,
+static inline int zperf_upload_fin(int sock, uint8_t *packet,
 				   uint32_t nb_packets,
 				   uint64_t end_time,
 				   uint32_t packet_size,
@@ -65,14 +63,14 @@ static inline int zperf_upload_fin(int sock,
 	};
 
 	while (ret <= 0 && loop-- > 0) {
-		datagram = (struct zperf_udp_datagram *)sample_packet;
+		datagram = (struct zperf_udp_datagram *)packet;
 
 		/* Fill the packet header */
 		datagram->id = htonl(-nb_packets);
 		datagram->tv_sec = htonl(secs);
 		datagram->tv_usec = htonl(usecs);
 
-		hdr = (struct zperf_client_hdr_v1 *)(sample_packet +
+		hdr = (struct zperf_client_hdr_v1 *)(packet +
 						     sizeof(*datagram));
 
 		/* According to iperf documentation (in include/Settings.hpp),
@@ -83,13 +81,13 @@ static inline int zperf_upload_fin(int sock,
 		hdr->flags = 0;
 		hdr->num_of_threads = htonl(1);
 		hdr->port = 0;
-		hdr->buffer_len = sizeof(sample_packet) -
+		hdr->buffer_len = ZPERF_UDP_PACKET_BUF_SIZE -
 			sizeof(*datagram) - sizeof(*hdr);
 		hdr->bandwidth = 0;
 		hdr->num_of_bytes = htonl(packet_size);
 
 		/* Send the packet */
-		ret = zsock_send(sock, sample_packet, packet_size, 0);
+		ret = zsock_send(sock, packet, packet_size, 0);
 		if (ret < 0) {
 			NET_ERR("Failed to send the packet (%d)", errno);
 			continue;
@@ -131,10 +129,11 @@ static inline int zperf_upload_fin(int sock,
 	return 0;
 }
 
-static int udp_upload(int sock, int port,
+static int udp_upload(int sock, int port, uint8_t *packet,
 		      unsigned int duration_in_ms,
 		      unsigned int packet_size,
 		      unsigned int rate_in_kbps,
+		      bool dual,
 		      struct zperf_results *results)
 {
 	uint32_t packet_duration_us = zperf_packet_duration(packet_size, rate_in_kbps);
@@ -165,7 +164,7 @@ static int udp_upload(int sock, int port,
 	print_period = k_ms_to_ticks_ceil32(MSEC_PER_SEC);
 	print_time = start_time + print_period;
 
-	(void)memset(sample_packet, 'z', sizeof(sample_packet));
+	(void)memset(packet, 'z', ZPERF_UDP_PACKET_BUF_SIZE);
 
 	do {
 		struct zperf_udp_datagram *datagram;
@@ -201,24 +200,38 @@ static int udp_upload(int sock, int port,
 		usecs = usecs64 - (uint64_t)secs * USEC_PER_SEC;
 
 		/* Fill the packet header */
-		datagram = (struct zperf_udp_datagram *)sample_packet;
+		datagram = (struct zperf_udp_datagram *)packet;
 
 		datagram->id = htonl(nb_packets);
 		datagram->tv_sec = htonl(secs);
 		datagram->tv_usec = htonl(usecs);
 
-		hdr = (struct zperf_client_hdr_v1 *)(sample_packet +
+		hdr = (struct zperf_client_hdr_v1 *)(packet +
 						     sizeof(*datagram));
-		hdr->flags = 0;
 		hdr->num_of_threads = htonl(1);
 		hdr->port = htonl(port);
-		hdr->buffer_len = sizeof(sample_packet) -
-			sizeof(*datagram) - sizeof(*hdr);
-		hdr->bandwidth = htonl(rate_in_kbps);
-		hdr->num_of_bytes = htonl(packet_size);
+
+		if (dual) {
+			/* Ask the server to run a test back to us, with the
+			 * same parameters. As in iPerf, the bandwidth is in
+			 * bits per second and a negative amount is the test
+			 * duration in hundredths of a second.
+			 */
+			hdr->flags = htonl(ZPERF_FLAGS_VERSION1 |
+					   ZPERF_FLAGS_RUN_NOW);
+			hdr->buffer_len = htonl(packet_size);
+			hdr->bandwidth = htonl(rate_in_kbps * 1024U);
+			hdr->num_of_bytes = htonl(-(int32_t)(duration_in_ms / 10U));
+		} else {
+			hdr->flags = 0;
+			hdr->buffer_len = ZPERF_UDP_PACKET_BUF_SIZE -
+				sizeof(*datagram) - sizeof(*hdr);
+			hdr->bandwidth = htonl(rate_in_kbps);
+			hdr->num_of_bytes = htonl(packet_size);
+		}
 
 		/* Send the packet */
-		ret = zsock_send(sock, sample_packet, packet_size, 0);
+		ret = zsock_send(sock, packet, packet_size, 0);
 		if (ret < 0) {
 			NET_ERR("Failed to send the packet (%d)", errno);
 			return -errno;
@@ -247,7 +260,7 @@ static int udp_upload(int sock, int port,
 
 	end_time = k_uptime_ticks();
 
-	ret = zperf_upload_fin(sock, nb_packets, end_time, packet_size,
+	ret = zperf_upload_fin(sock, packet, nb_packets, end_time, packet_size,
 			       results);
 	if (ret < 0) {
 		return ret;
@@ -262,17 +275,13 @@ static int udp_upload(int sock, int port,
 	return 0;
 }
 
-int zperf_udp_upload(const struct zperf_upload_params *param,
-		     struct zperf_results *result)
+int zperf_udp_upload_stream(const struct zperf_upload_params *param,
+			    uint8_t *packet, struct zperf_results *result)
 {
 	int port = 0;
 	int sock;
 	int ret;
 
-	if (param == NULL || result == NULL) {
-		return -EINVAL;
-	}
-
 	if (param->peer_addr.sa_family == AF_INET) {
 		port = ntohs(net_sin(&param->peer_addr)->sin_port);
 	} else if (param->peer_addr.sa_family == AF_INET6) {
@@ -289,14 +298,53 @@ int zperf_udp_upload(const struct zperf_upload_params *param,
 		return sock;
 	}
 
-	ret = udp_upload(sock, port, param->duration_ms, param->packet_size,
-			 param->rate_kbps, result);
+	ret = udp_upload(sock, port, packet, param->duration_ms,
+			 param->packet_size, param->rate_kbps,
+			 param->bidirectional, result);
 
 	zsock_close(sock);
 
 	return ret;
 }
 
+int zperf_udp_upload(const struct zperf_upload_params *param,
+		     struct zperf_results *result)
+{
+	uint64_t cycles;
+	int ret;
+
+	if (param == NULL || result == NULL) {
+		return -EINVAL;
+	}
+
+	/* A bidirectional test also runs through the stream threads, as the
+	 * reverse test started by a local server (e.g. over loopback) would
+	 * use the shared packet buffer.
+	 */
+	if (param->num_streams > 1 || param->bidirectional) {
+		return zperf_upload_streams(param, IPPROTO_UDP, NULL, result);
+	}
+
+	cycles = zperf_cpu_cycles();
+
+	ret = zperf_udp_upload_stream(param, sample_packet, result);
+
+	result->cpu_cycles = zperf_cpu_cycles() - cycles;
+
+	return ret;
+}
+
+int zperf_udp_upload_streams(const struct zperf_upload_params *param,
+			     struct zperf_results *stream_results,
+			     struct zperf_results *total)
+{
+	if (param == NULL || total == NULL) {
+		return -EINVAL;
+	}
+
+	return zperf_upload_streams(param, IPPROTO_UDP, stream_results, total);
+}
+
 static void udp_upload_async_work(struct k_work *work)
 {
 	struct zperf_async_upload_context *upload_ctx =
@@ -0,0 +1,171 @@
+/*
+ * Copyright The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/types.h>
+#include <zephyr/ztest.h>
+
+/* The cycle counter does not run in unit tests, give mayfly a clock the
+ * tests control.
+ */
+static uint32_t cycles;
+
+static uint32_t cycles_get(void)
+{
+	return cycles;
+}
+
+#define k_cycle_get_32 cycles_get
+
+#include "util/mayfly.c"
+
+#define CALLER  MAYFLY_CALL_ID_0
+#define CALLEE  MAYFLY_CALL_ID_1
+#define BURST   8U
+
+#if defined(CONFIG_BT_MAYFLY_YIELD_AFTER_CALL)
+#define CALLS_PER_RUN CONFIG_BT_MAYFLY_YIELD_AFTER_CALL_COUNT
+#else
+#define CALLS_PER_RUN BURST
+#endif
+
+static memq_link_t links[BURST];
+static struct mayfly mfy[BURST];
+static uint32_t called;
+
+/* The callee is pended for execution */
+static bool pended;
+
+void mayfly_enable_cb(uint8_t caller_id, uint8_t callee_id, uint8_t enable)
+{
+	ARG_UNUSED(caller_id);
+	ARG_UNUSED(callee_id);
+	ARG_UNUSED(enable);
+}
+
+uint32_t mayfly_is_enabled(uint8_t caller_id, uint8_t callee_id)
+{
+	ARG_UNUSED(caller_id);
+	ARG_UNUSED(callee_id);
+
+	return 1U;
+}
+
+uint32_t mayfly_prio_is_equal(uint8_t caller_id, uint8_t callee_id)
+{
+	return caller_id == callee_id;
+}
+
+void mayfly_pend(uint8_t caller_id, uint8_t callee_id)
+{
+	ARG_UNUSED(caller_id);
+
+	if (callee_id == CALLEE) {
+		pended = true;
+	}
+}
+
+uint32_t mayfly_is_running(void)
+{
+	return 0U;
+}
+
+static void mfy_fp(void *param)
+{
+	ARG_UNUSED(param);
+
+	called++;
+}
+
+/* Run the callee for as long as it pends itself, return the number of
+ * runs it took.
+ */
+static uint32_t run_callee(void)
+{
+	uint32_t runs = 0U;
+
+	while (pended) {
+		pended = false;
+		mayfly_run(CALLEE);
+		runs++;
+	}
+
+	return runs;
+}
+
+static void mayfly_setup(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	mayfly_init();
+	mayfly_latency_reset(CALLEE);
+
+	for (uint8_t i = 0U; i < BURST; i++) {
+		mfy[i] = (struct mayfly){ 0, 0, &links[i], NULL, mfy_fp };
+	}
+
+	called = 0U;
+	pended = false;
+	cycles = 0U;
+}
+
+ZTEST(mayfly, test_burst)
+{
+	for (uint8_t i = 0U; i < BURST; i++) {
+		zassert_equal(mayfly_enqueue(CALLER, CALLEE, 0U, &mfy[i]), 0U);
+	}
+
+	zassert_equal(called, 0U, "mayfly called inline");
+
+	/* Each run calls up to the configured number of mayflies before
+	 * yielding and pending the callee again.
+	 */
+	zassert_equal(run_callee(), DIV_ROUND_UP(BURST, CALLS_PER_RUN));
+	zassert_equal(called, BURST);
+}
+
+ZTEST(mayfly, test_latency)
+{
+	struct mayfly_latency latency;
+
+	cycles = 100U;
+	zassert_equal(mayfly_enqueue(CALLER, CALLEE, 0U, &mfy[0]), 0U);
+	cycles = 150U;
+	zassert_equal(mayfly_enqueue(CALLER, CALLEE, 0U, &mfy[1]), 0U);
+
+	cycles = 400U;
+	(void)run_callee();
+	zassert_equal(called, 2U);
+
+	mayfly_latency_get(CALLEE, &latency);
+	zassert_equal(latency.count, 2U);
+	zassert_equal(latency.last, 250U);
+	zassert_equal(latency.max, 300U);
+
+	/* Latency of a mayfly queued again after it was called */
+	cycles = 1000U;
+	zassert_equal(mayfly_enqueue(CALLER, CALLEE, 0U, &mfy[0]), 0U);
+	cycles = 1010U;
+	(void)run_callee();
+
+	mayfly_latency_get(CALLEE, &latency);
+	zassert_equal(latency.count, 3U);
+	zassert_equal(latency.last, 10U);
+	zassert_equal(latency.max, 300U);
+
+	/* Mayflies called inline do not wait */
+	zassert_equal(mayfly_enqueue(CALLEE, CALLEE, 0U, &mfy[2]), 0U);
+	zassert_equal(called, 4U);
+
+	mayfly_latency_get(CALLEE, &latency);
+	zassert_equal(latency.count, 3U);
+
+	mayfly_latency_reset(CALLEE);
+	mayfly_latency_get(CALLEE, &latency);
+	zassert_equal(latency.count, 0U);
+	zassert_equal(latency.max, 0U);
+}
+
+ZTEST_SUITE(mayfly, NULL, NULL, mayfly_setup, NULL, NULL);
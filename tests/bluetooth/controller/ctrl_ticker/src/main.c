@@ -0,0 +1,318 @@
+/*
+ * Copyright The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#if defined(ENQUEUE_COST_BENCHMARK)
+#include <time.h>
+#endif
+
+#include <zephyr/types.h>
+#include <zephyr/ztest.h>
+
+/* The mock vendor HAL has no debug pins */
+#define DEBUG_TICKER_ISR(flag)
+#define DEBUG_TICKER_TASK(flag)
+#define DEBUG_TICKER_JOB(flag)
+
+/* The list operations under test are static, build them in */
+#include "ticker/ticker.c"
+
+#define NODES     64U
+#define ROUNDS    20000U
+
+static struct ticker_node nodes[NODES];
+static struct ticker_user users[1];
+static bool queued[NODES];
+static uint32_t seed;
+
+uint32_t cntr_start(void)
+{
+	return 0;
+}
+
+uint32_t cntr_stop(void)
+{
+	return 0;
+}
+
+uint32_t cntr_cnt_get(void)
+{
+	return 0;
+}
+
+void cntr_cmp_set(uint8_t cmp, uint32_t value)
+{
+	ARG_UNUSED(cmp);
+	ARG_UNUSED(value);
+}
+
+static uint32_t rand_get(uint32_t max)
+{
+	seed = seed * 1103515245U + 12345U;
+
+	return (seed >> 8) % max;
+}
+
+/* The tail must be the last node in the list and hold the total of the
+ * relative expiries of all the nodes.
+ */
+static void tail_check(struct ticker_instance *instance)
+{
+	uint8_t last = TICKER_NULL;
+	uint32_t total = 0U;
+	uint8_t id;
+
+	for (id = instance->ticker_id_head; id != TICKER_NULL; id = nodes[id].next) {
+		total += nodes[id].ticks_to_expire;
+		last = id;
+	}
+
+	if (last == TICKER_NULL) {
+		zassert_equal(instance->ticker_id_tail, TICKER_NULL, "tail on empty list");
+		return;
+	}
+
+	if (instance->ticker_id_tail != TICKER_NULL) {
+		zassert_equal(instance->ticker_id_tail, last, "tail not last node");
+		zassert_equal(instance->ticks_to_expire_tail, total, "tail ticks %u != %u",
+			      instance->ticks_to_expire_tail, total);
+	}
+}
+
+/* Enqueue with the tail invalidated so the whole list is walked, this is
+ * the list the tail shortcut has to produce.
+ */
+static uint8_t enqueue_walk(struct ticker_instance *instance, uint8_t id,
+			    struct ticker_node *ref, uint8_t *ref_head)
+{
+	struct ticker_node save[NODES];
+	uint32_t ticks_tail;
+	uint8_t tail;
+	uint8_t head;
+	uint8_t ret;
+
+	memcpy(save, nodes, sizeof(nodes));
+	head = instance->ticker_id_head;
+	tail = instance->ticker_id_tail;
+	ticks_tail = instance->ticks_to_expire_tail;
+
+	instance->ticker_id_tail = TICKER_NULL;
+	ret = ticker_enqueue(instance, id);
+
+	memcpy(ref, nodes, sizeof(nodes));
+	*ref_head = instance->ticker_id_head;
+
+	memcpy(nodes, save, sizeof(nodes));
+	instance->ticker_id_head = head;
+	instance->ticker_id_tail = tail;
+	instance->ticks_to_expire_tail = ticks_tail;
+
+	return ret;
+}
+
+static void enqueue(struct ticker_instance *instance, uint8_t id)
+{
+	struct ticker_node ref[NODES];
+	uint8_t ref_head;
+	uint8_t ret_ref;
+	uint8_t ret;
+
+	nodes[id].ticks_to_expire = rand_get(200U);
+	nodes[id].lazy_current = rand_get(3U);
+	nodes[id].ticks_slot = rand_get(3U) ? 0U : rand_get(20U);
+	nodes[id].next = TICKER_NULL;
+
+	ret_ref = enqueue_walk(instance, id, ref, &ref_head);
+	ret = ticker_enqueue(instance, id);
+
+	zassert_equal(ret, ret_ref, "enqueue of %u returned %u, walk %u", id, ret, ret_ref);
+	zassert_equal(instance->ticker_id_head, ref_head, "head differs");
+
+	for (uint8_t i = 0U; i < NODES; i++) {
+		if (!queued[i] && (i != id)) {
+			continue;
+		}
+
+		zassert_equal(nodes[i].next, ref[i].next, "next of %u differs", i);
+		zassert_equal(nodes[i].ticks_to_expire, ref[i].ticks_to_expire,
+			      "ticks_to_expire of %u differs", i);
+	}
+
+	queued[id] = (ret == id);
+}
+
+/* Expire the nodes at the head of the list the way ticker_worker does */
+static void expire(struct ticker_instance *instance, uint32_t ticks_elapsed)
+{
+	while (instance->ticker_id_head != TICKER_NULL) {
+		struct ticker_node *ticker = &nodes[instance->ticker_id_head];
+
+		if (ticks_elapsed < ticker->ticks_to_expire) {
+			ticker->ticks_to_expire -= ticks_elapsed;
+			instance->ticks_to_expire_tail -= ticks_elapsed;
+			break;
+		}
+
+		ticks_elapsed -= ticker->ticks_to_expire;
+		instance->ticks_to_expire_tail -= ticker->ticks_to_expire;
+		ticker->ticks_to_expire = 0U;
+
+		queued[instance->ticker_id_head] = false;
+		instance->ticker_id_head = ticker->next;
+		if (instance->ticker_id_head == TICKER_NULL) {
+			instance->ticker_id_tail = TICKER_NULL;
+			instance->ticks_to_expire_tail = 0U;
+		}
+	}
+}
+
+static void ticker_setup(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	memset(nodes, 0, sizeof(nodes));
+	memset(users, 0, sizeof(users));
+	memset(queued, 0, sizeof(queued));
+	seed = 1U;
+
+	zassert_equal(ticker_init(0, NODES, nodes, ARRAY_SIZE(users), users, 0, NULL,
+				  NULL, NULL, NULL),
+		      TICKER_STATUS_SUCCESS);
+}
+
+ZTEST(ticker, test_enqueue_matches_walk)
+{
+	struct ticker_instance *instance = &_instance[0];
+
+	for (uint32_t round = 0U; round < ROUNDS; round++) {
+		uint8_t id = rand_get(NODES);
+
+		if (queued[id]) {
+			(void)ticker_dequeue(instance, id);
+			queued[id] = false;
+		} else {
+			enqueue(instance, id);
+		}
+
+		tail_check(instance);
+	}
+}
+
+ZTEST(ticker, test_enqueue_after_expiry)
+{
+	struct ticker_instance *instance = &_instance[0];
+
+	for (uint32_t round = 0U; round < ROUNDS; round++) {
+		uint8_t id = rand_get(NODES);
+		uint32_t op = rand_get(10U);
+
+		if (op < 5U && !queued[id]) {
+			enqueue(instance, id);
+		} else if (op < 8U && queued[id]) {
+			(void)ticker_dequeue(instance, id);
+			queued[id] = false;
+		} else if (op == 9U) {
+			expire(instance, rand_get(60U));
+		}
+
+		tail_check(instance);
+	}
+}
+
+ZTEST(ticker, test_dequeue_tail)
+{
+	struct ticker_instance *instance = &_instance[0];
+
+	for (uint8_t id = 0U; id < 4U; id++) {
+		nodes[id].ticks_to_expire = 100U * (id + 1U);
+		zassert_equal(ticker_enqueue(instance, id), id);
+		queued[id] = true;
+	}
+
+	zassert_equal(instance->ticker_id_tail, 3U);
+	zassert_equal(instance->ticks_to_expire_tail, 400U);
+
+	/* Removing the last node makes the previous one the tail */
+	zassert_equal(ticker_dequeue(instance, 3U), 400U);
+	zassert_equal(instance->ticker_id_tail, 2U);
+	zassert_equal(instance->ticks_to_expire_tail, 300U);
+
+	/* Removing a node in the middle keeps the tail */
+	zassert_equal(ticker_dequeue(instance, 1U), 200U);
+	zassert_equal(instance->ticker_id_tail, 2U);
+	zassert_equal(instance->ticks_to_expire_tail, 300U);
+
+	zassert_equal(ticker_dequeue(instance, 2U), 300U);
+	zassert_equal(ticker_dequeue(instance, 0U), 100U);
+	zassert_equal(instance->ticker_id_head, TICKER_NULL);
+	zassert_equal(instance->ticker_id_tail, TICKER_NULL);
+}
+
+#if defined(ENQUEUE_COST_BENCHMARK)
+#define APPEND_ROUNDS 200000U
+
+static uint64_t ns_get(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (uint64_t)ts.tv_sec * 1000000000U + ts.tv_nsec;
+}
+
+/* Nanoseconds per append of a node expiring after count - 1 queued nodes,
+ * with the tail shortcut or with the tail invalidated so the whole list is
+ * walked like before the shortcut existed.
+ */
+static uint64_t append_cost(struct ticker_instance *instance, uint8_t count, bool walk)
+{
+	uint8_t last = count - 1U;
+	uint64_t total = 0U;
+
+	ticker_setup(NULL);
+
+	for (uint8_t id = 0U; id < last; id++) {
+		nodes[id].ticks_to_expire = 10U * (id + 1U);
+		zassert_equal(ticker_enqueue(instance, id), id);
+	}
+
+	for (uint32_t round = 0U; round < APPEND_ROUNDS; round++) {
+		uint64_t start;
+
+		nodes[last].ticks_to_expire = 10U * count;
+		nodes[last].next = TICKER_NULL;
+
+		if (walk) {
+			instance->ticker_id_tail = TICKER_NULL;
+		}
+
+		start = ns_get();
+		(void)ticker_enqueue(instance, last);
+		total += ns_get() - start;
+
+		zassert_equal(instance->ticker_id_tail, last, "%u not appended", last);
+		zassert_equal(ticker_dequeue(instance, last), 10U * count);
+	}
+
+	return total / APPEND_ROUNDS;
+}
+
+ZTEST(ticker, test_append_cost)
+{
+	struct ticker_instance *instance = &_instance[0];
+
+	TC_PRINT("nodes  tail ns  walk ns\n");
+
+	for (uint8_t count = 8U; count <= NODES; count *= 2U) {
+		uint64_t tail = append_cost(instance, count, false);
+		uint64_t walk = append_cost(instance, count, true);
+
+		TC_PRINT("%5u  %7u  %7u\n", count, (uint32_t)tail, (uint32_t)walk);
+	}
+}
+#endif /* ENQUEUE_COST_BENCHMARK */
+
+ZTEST_SUITE(ticker, NULL, NULL, ticker_setup, NULL, NULL);
@@ -9,6 +9,7 @@
 #include <zephyr/kernel.h>
 #include <stddef.h>
 #include <zephyr/ztest.h>
+#include <zephyr/sys/byteorder.h>
 
 #include <zephyr/bluetooth/buf.h>
 #include <zephyr/bluetooth/bluetooth.h>
@@ -274,3 +275,222 @@ ZTEST(test_gatt, test_gatt_write)
 	zassert_mem_equal(value, test_value, ret,
 			  "Attribute write value don't match");
 }
+
+#if defined(CONFIG_BT_GATT_CACHING)
+#include <tinycrypt/constants.h>
+#include <tinycrypt/cmac_mode.h>
+
+static struct bt_uuid_128 hash_uuid = BT_UUID_INIT_128(
+	0xf6, 0xde, 0xbc, 0x9a, 0x78, 0x56, 0x34, 0x12,
+	0x78, 0x56, 0x34, 0x12, 0x78, 0x56, 0x34, 0x12);
+static struct bt_uuid_128 hash_chrc_uuid = BT_UUID_INIT_128(
+	0xf7, 0xde, 0xbc, 0x9a, 0x78, 0x56, 0x34, 0x12,
+	0x78, 0x56, 0x34, 0x12, 0x78, 0x56, 0x34, 0x12);
+
+static struct bt_gatt_attr hash_attrs[] = {
+	BT_GATT_PRIMARY_SERVICE(&hash_uuid),
+
+	BT_GATT_CHARACTERISTIC(&hash_chrc_uuid.uuid, BT_GATT_CHRC_READ,
+			       BT_GATT_PERM_READ, read_test, NULL, test_value),
+};
+
+static struct bt_gatt_service hash_svc = BT_GATT_SERVICE(hash_attrs);
+
+/* Hash input of an attribute, Core Spec 5.1 Vol 3, Part G, 7.3 */
+static uint8_t hash_attr(const struct bt_gatt_attr *attr, uint16_t handle,
+			 void *user_data)
+{
+	struct tc_cmac_struct *cmac = user_data;
+	uint8_t data[BT_UUID_SIZE_128 + 3];
+	ssize_t len = 0;
+	uint16_t value;
+
+	if (attr->uuid->type != BT_UUID_TYPE_16) {
+		return BT_GATT_ITER_CONTINUE;
+	}
+
+	switch (BT_UUID_16(attr->uuid)->val) {
+	case BT_UUID_GATT_PRIMARY_VAL:
+	case BT_UUID_GATT_SECONDARY_VAL:
+	case BT_UUID_GATT_INCLUDE_VAL:
+	case BT_UUID_GATT_CHRC_VAL:
+	case BT_UUID_GATT_CEP_VAL:
+		len = attr->read(NULL, attr, data, sizeof(data), 0);
+		zassert_true(len >= 0, "Attribute 0x%04x read failed", handle);
+		__fallthrough;
+	case BT_UUID_GATT_CUD_VAL:
+	case BT_UUID_GATT_CCC_VAL:
+	case BT_UUID_GATT_SCC_VAL:
+	case BT_UUID_GATT_CPF_VAL:
+	case BT_UUID_GATT_CAF_VAL:
+		value = sys_cpu_to_le16(handle);
+		tc_cmac_update(cmac, (uint8_t *)&value, sizeof(value));
+		value = sys_cpu_to_le16(BT_UUID_16(attr->uuid)->val);
+		tc_cmac_update(cmac, (uint8_t *)&value, sizeof(value));
+		tc_cmac_update(cmac, data, len);
+		break;
+	default:
+		break;
+	}
+
+	return BT_GATT_ITER_CONTINUE;
+}
+
+/* Compare the Database Hash the stack reports with one generated from
+ * scratch over the whole database.
+ */
+static void db_hash_check(void)
+{
+	const struct bt_gatt_attr *attr = NULL;
+	struct tc_aes_key_sched_struct sched;
+	struct tc_cmac_struct cmac;
+	uint8_t key[16] = {};
+	uint8_t expected[16];
+	uint8_t hash[16];
+
+	zassert_equal(tc_cmac_setup(&cmac, key, &sched), TC_CRYPTO_SUCCESS);
+	bt_gatt_foreach_attr(0x0001, 0xffff, hash_attr, &cmac);
+	zassert_equal(tc_cmac_final(expected, &cmac), TC_CRYPTO_SUCCESS);
+	sys_mem_swap(expected, sizeof(expected));
+
+	bt_gatt_foreach_attr_type(0x0001, 0xffff, BT_UUID_GATT_DB_HASH, NULL,
+				  1, find_attr, &attr);
+	zassert_not_null(attr, "Database Hash not found");
+
+	zassert_equal(attr->read(NULL, attr, hash, sizeof(hash), 0),
+		      sizeof(hash), "Database Hash read failed");
+	zassert_mem_equal(hash, expected, sizeof(hash),
+			  "Database Hash doesn't match the database");
+}
+
+ZTEST(test_gatt, test_gatt_db_hash)
+{
+	struct bt_gatt_chrc *chrc = hash_attrs[1].user_data;
+
+	bt_gatt_service_unregister(&test_svc);
+	bt_gatt_service_unregister(&test1_svc);
+
+	zassert_false(bt_gatt_service_register(&test_svc),
+		      "Test service registration failed");
+	zassert_false(bt_gatt_service_register(&hash_svc),
+		      "Hash service registration failed");
+	db_hash_check();
+
+	/* The service is registered again with the same attributes at the
+	 * same handles but its content changed.
+	 */
+	zassert_false(bt_gatt_service_unregister(&hash_svc),
+		      "Hash service unregister failed");
+	chrc->properties |= BT_GATT_CHRC_WRITE;
+	zassert_false(bt_gatt_service_register(&hash_svc),
+		      "Hash service re-registration failed");
+	db_hash_check();
+
+	/* A service before it is replaced */
+	zassert_false(bt_gatt_service_unregister(&test_svc),
+		      "Test service unregister failed");
+	db_hash_check();
+	zassert_false(bt_gatt_service_register(&test1_svc),
+		      "Test service1 registration failed");
+	db_hash_check();
+
+	/* Back to the original content */
+	zassert_false(bt_gatt_service_unregister(&hash_svc),
+		      "Hash service unregister failed");
+	chrc->properties &= ~BT_GATT_CHRC_WRITE;
+	zassert_false(bt_gatt_service_register(&hash_svc),
+		      "Hash service re-registration failed");
+	db_hash_check();
+
+	zassert_false(bt_gatt_service_unregister(&hash_svc),
+		      "Hash service unregister failed");
+	zassert_false(bt_gatt_service_unregister(&test1_svc),
+		      "Test service1 unregister failed");
+	db_hash_check();
+}
+#endif /* CONFIG_BT_GATT_CACHING */
+
+#if defined(DISCOVERY_COST_BENCHMARK)
+#define BENCH_SVC_COUNT 20
+#define BENCH_CHRC_UUID(i) BT_UUID_DECLARE_16(0xff00 + (i))
+
+#define BENCH_SVC_ATTRS(i, _)							\
+	static struct bt_gatt_attr bench_attrs_##i[] = {			\
+		BT_GATT_PRIMARY_SERVICE(BT_UUID_DECLARE_16(0xfe00 + (i))),	\
+		BT_GATT_CHARACTERISTIC(BENCH_CHRC_UUID(i), BT_GATT_CHRC_READ,	\
+				       BT_GATT_PERM_READ, read_test, NULL,	\
+				       test_value),				\
+	};
+
+#define BENCH_SVC(i, _) BT_GATT_SERVICE(bench_attrs_##i)
+
+LISTIFY(BENCH_SVC_COUNT, BENCH_SVC_ATTRS, ())
+
+static struct bt_gatt_service bench_svcs[] = {
+	LISTIFY(BENCH_SVC_COUNT, BENCH_SVC, (,))
+};
+
+/* Only built in the discovery_cost variants, reports the cost of the
+ * lookups done by a peer discovering the database, for comparison between
+ * configurations.
+ */
+ZTEST(test_gatt, test_gatt_discovery_cost)
+{
+	const struct bt_gatt_attr *attr;
+	uint32_t start, primary, chrc, by_uuid, by_handle;
+	uint16_t last_handle;
+	uint16_t num;
+
+	for (int i = 0; i < BENCH_SVC_COUNT; i++) {
+		zassert_false(bt_gatt_service_register(&bench_svcs[i]),
+			      "Bench service %d registration failed", i);
+	}
+
+	last_handle = bench_svcs[BENCH_SVC_COUNT - 1].attrs[2].handle;
+
+	/* Discover All Primary Services */
+	num = 0;
+	start = k_cycle_get_32();
+	bt_gatt_foreach_attr_type(0x0001, 0xffff, BT_UUID_GATT_PRIMARY, NULL,
+				  0, count_attr, &num);
+	primary = k_cycle_get_32() - start;
+	zassert_true(num >= BENCH_SVC_COUNT, "Services missing");
+
+	/* Discover All Characteristics */
+	num = 0;
+	start = k_cycle_get_32();
+	bt_gatt_foreach_attr_type(0x0001, 0xffff, BT_UUID_GATT_CHRC, NULL,
+				  0, count_attr, &num);
+	chrc = k_cycle_get_32() - start;
+	zassert_true(num >= BENCH_SVC_COUNT, "Characteristics missing");
+
+	/* Read Using Characteristic UUID, one per service */
+	start = k_cycle_get_32();
+	for (int i = 0; i < BENCH_SVC_COUNT; i++) {
+		attr = NULL;
+		bt_gatt_foreach_attr_type(0x0001, 0xffff, BENCH_CHRC_UUID(i),
+					  NULL, 1, find_attr, &attr);
+		zassert_equal_ptr(attr, &bench_svcs[i].attrs[2],
+				  "Attribute don't match");
+	}
+	by_uuid = k_cycle_get_32() - start;
+
+	/* Lookup of every handle */
+	start = k_cycle_get_32();
+	for (uint16_t handle = 1; handle <= last_handle; handle++) {
+		num = 0;
+		bt_gatt_foreach_attr(handle, handle, count_attr, &num);
+		zassert_true(num <= 1, "Duplicate handle 0x%04x", handle);
+	}
+	by_handle = k_cycle_get_32() - start;
+
+	TC_PRINT("%u attributes: primary %u, chrc %u, by uuid %u, "
+		 "by handle %u cycles\n", last_handle, primary, chrc, by_uuid,
+		 by_handle);
+
+	for (int i = 0; i < BENCH_SVC_COUNT; i++) {
+		zassert_false(bt_gatt_service_unregister(&bench_svcs[i]),
+			      "Bench service %d unregister failed", i);
+	}
+}
+#endif /* DISCOVERY_COST_BENCHMARK */
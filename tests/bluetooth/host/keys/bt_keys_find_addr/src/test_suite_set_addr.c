@@ -0,0 +1,87 @@
+/*
+ * Copyright The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "mocks/keys_help_utils.h"
+#include "testing_common_defs.h"
+
+#include <zephyr/bluetooth/bluetooth.h>
+#include <zephyr/kernel.h>
+
+#include <host/keys.h>
+
+static const struct id_addr_pair testing_id_addr_pair_lut[] = {
+	{BT_ADDR_ID_1, BT_RPA_ADDR_LE_1},
+	{BT_ADDR_ID_1, BT_RPA_ADDR_LE_2},
+	{BT_ADDR_ID_2, BT_RPA_ADDR_LE_1},
+};
+
+static struct bt_keys *returned_keys_refs[ARRAY_SIZE(testing_id_addr_pair_lut)];
+
+static void set_addr_ts_before(void *f)
+{
+	clear_key_pool();
+	int rv = fill_key_pool_by_id_addr(testing_id_addr_pair_lut,
+					  ARRAY_SIZE(testing_id_addr_pair_lut), returned_keys_refs);
+
+	zassert_true(rv == 0, "Failed to fill keys pool list, error code %d", -rv);
+}
+
+ZTEST_SUITE(bt_keys_find_addr_set_addr, NULL, NULL, set_addr_ts_before, NULL, NULL);
+
+/*
+ *  Find a key reference by the address it was changed to
+ *
+ *  Constraints:
+ *   - The address of an existing key is changed with bt_keys_set_addr()
+ *
+ *  Expected behaviour:
+ *   - The key reference is found by its new address only
+ *   - Other key references are still found
+ */
+ZTEST(bt_keys_find_addr_set_addr, test_find_key_by_new_address)
+{
+	bt_keys_set_addr(returned_keys_refs[0], BT_ADDR_LE_1);
+
+	zassert_equal_ptr(bt_keys_find_addr(BT_ADDR_ID_1, BT_ADDR_LE_1), returned_keys_refs[0],
+			  "bt_keys_find_addr() returned unexpected reference");
+	zassert_is_null(bt_keys_find_addr(BT_ADDR_ID_1, BT_RPA_ADDR_LE_1),
+			"bt_keys_find_addr() returned a reference for the old address");
+
+	for (size_t i = 1; i < ARRAY_SIZE(testing_id_addr_pair_lut); i++) {
+		zassert_equal_ptr(bt_keys_find_addr(testing_id_addr_pair_lut[i].id,
+						    testing_id_addr_pair_lut[i].addr),
+				  returned_keys_refs[i],
+				  "bt_keys_find_addr() returned unexpected reference");
+	}
+}
+
+/*
+ *  Refill the keys pool many times without clearing keys through the API
+ *
+ *  Constraints:
+ *   - The keys pool is reset behind the keys module's back
+ *
+ *  Expected behaviour:
+ *   - All key references are found after each refill
+ */
+ZTEST(bt_keys_find_addr_set_addr, test_find_keys_after_pool_reset)
+{
+	for (int round = 0; round < 2 * CONFIG_BT_MAX_PAIRED; round++) {
+		clear_key_pool();
+		int rv = fill_key_pool_by_id_addr(testing_id_addr_pair_lut,
+						  ARRAY_SIZE(testing_id_addr_pair_lut),
+						  returned_keys_refs);
+
+		zassert_true(rv == 0, "Failed to fill keys pool list, error code %d", -rv);
+
+		for (size_t i = 0; i < ARRAY_SIZE(testing_id_addr_pair_lut); i++) {
+			zassert_equal_ptr(bt_keys_find_addr(testing_id_addr_pair_lut[i].id,
+							    testing_id_addr_pair_lut[i].addr),
+					  returned_keys_refs[i],
+					  "bt_keys_find_addr() returned unexpected reference");
+		}
+	}
+}
@@ -0,0 +1,118 @@
+/*
+ * Copyright The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "mocks/kernel.h"
+#include "mocks/keys_help_utils.h"
+#include "mocks/rpa.h"
+#include "testing_common_defs.h"
+
+#include <zephyr/bluetooth/bluetooth.h>
+#include <zephyr/fff.h>
+#include <zephyr/kernel.h>
+
+#include <host/keys.h>
+
+#if CONFIG_BT_KEYS_RPA_CACHE_SIZE > 0
+
+/* Keys with an IRK, none of them resolving the testing address */
+static const struct id_addr_type testing_id_addr_type_lut[] = {
+	{BT_ADDR_ID_1, BT_ADDR_LE_1, BT_KEYS_IRK},
+	{BT_ADDR_ID_1, BT_ADDR_LE_2, BT_KEYS_IRK},
+	{BT_ADDR_ID_2, BT_ADDR_LE_3, BT_KEYS_IRK},
+};
+
+static struct bt_keys *returned_keys_refs[ARRAY_SIZE(testing_id_addr_type_lut)];
+
+static void rpa_miss_cache_ts_before(void *f)
+{
+	clear_key_pool();
+	int rv = fill_key_pool_by_id_addr_type(
+		testing_id_addr_type_lut, ARRAY_SIZE(testing_id_addr_type_lut), returned_keys_refs);
+
+	zassert_true(rv == 0, "Failed to fill keys pool list, error code %d", -rv);
+
+	RPA_FFF_FAKES_LIST(RESET_FAKE);
+	KERNEL_FFF_FAKES_LIST(RESET_FAKE);
+
+	bt_rpa_irk_matches_fake.return_val = false;
+}
+
+ZTEST_SUITE(bt_keys_find_irk_rpa_miss_cache, NULL, NULL, rpa_miss_cache_ts_before, NULL, NULL);
+
+/*
+ *  Resolve the same unknown RPA twice
+ *
+ *  Constraints:
+ *   - No IRK matches the address
+ *
+ *  Expected behaviour:
+ *   - A NULL value is returned both times
+ *   - IRKs are only tried the first time
+ */
+ZTEST(bt_keys_find_irk_rpa_miss_cache, test_unresolved_rpa_is_not_resolved_again)
+{
+	zassert_is_null(bt_keys_find_irk(BT_ADDR_ID_1, BT_RPA_ADDR_LE_1));
+	zassert_equal(bt_rpa_irk_matches_fake.call_count, 2,
+		      "Unexpected number of calls to bt_rpa_irk_matches()");
+
+	zassert_is_null(bt_keys_find_irk(BT_ADDR_ID_1, BT_RPA_ADDR_LE_1));
+	zassert_equal(bt_rpa_irk_matches_fake.call_count, 2,
+		      "bt_rpa_irk_matches() was called for a cached address");
+
+	/* The address is remembered for its identity only */
+	zassert_is_null(bt_keys_find_irk(BT_ADDR_ID_2, BT_RPA_ADDR_LE_1));
+	zassert_equal(bt_rpa_irk_matches_fake.call_count, 3,
+		      "Unexpected number of calls to bt_rpa_irk_matches()");
+}
+
+/*
+ *  Resolve an unknown RPA again once the cache timeout has elapsed
+ *
+ *  Constraints:
+ *   - No IRK matches the address
+ *
+ *  Expected behaviour:
+ *   - IRKs are tried again
+ */
+ZTEST(bt_keys_find_irk_rpa_miss_cache, test_unresolved_rpa_expires)
+{
+	zassert_is_null(bt_keys_find_irk(BT_ADDR_ID_1, BT_RPA_ADDR_LE_1));
+	zassert_equal(bt_rpa_irk_matches_fake.call_count, 2,
+		      "Unexpected number of calls to bt_rpa_irk_matches()");
+
+	k_uptime_ticks_fake.return_val =
+		k_ms_to_ticks_ceil64(CONFIG_BT_KEYS_RPA_CACHE_TIMEOUT * MSEC_PER_SEC);
+
+	zassert_is_null(bt_keys_find_irk(BT_ADDR_ID_1, BT_RPA_ADDR_LE_1));
+	zassert_equal(bt_rpa_irk_matches_fake.call_count, 4,
+		      "bt_rpa_irk_matches() wasn't called for an expired address");
+}
+
+/*
+ *  Resolve an unknown RPA again once a new IRK has been added
+ *
+ *  Constraints:
+ *   - The address didn't match the IRKs stored so far
+ *
+ *  Expected behaviour:
+ *   - The keys with the new IRK are returned
+ */
+ZTEST(bt_keys_find_irk_rpa_miss_cache, test_new_irk_resolves_cached_rpa)
+{
+	struct bt_keys *keys;
+
+	zassert_is_null(bt_keys_find_irk(BT_ADDR_ID_1, BT_RPA_ADDR_LE_1));
+
+	keys = bt_keys_get_type(BT_KEYS_IRK, BT_ADDR_ID_1, BT_ADDR_LE_4);
+	zassert_not_null(keys, "Failed to add keys");
+
+	bt_rpa_irk_matches_fake.return_val = true;
+
+	zassert_equal_ptr(bt_keys_find_irk(BT_ADDR_ID_1, BT_RPA_ADDR_LE_1), returned_keys_refs[0],
+			  "bt_keys_find_irk() returned unexpected reference");
+}
+
+#endif /* CONFIG_BT_KEYS_RPA_CACHE_SIZE > 0 */
@@ -0,0 +1,443 @@
+/* main.c - Host advertising data updates */
+
+/*
+ * Copyright The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+
+#include <errno.h>
+#include <zephyr/tc_util.h>
+
+#include <zephyr/bluetooth/hci.h>
+#include <zephyr/bluetooth/buf.h>
+#include <zephyr/bluetooth/bluetooth.h>
+#include <zephyr/drivers/bluetooth/hci_driver.h>
+#include <zephyr/sys/byteorder.h>
+
+#define LOG_LEVEL CONFIG_BT_LOG_LEVEL
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(host_test_app);
+
+/* Command handler structure for cmd_handle(). */
+struct cmd_handler {
+	uint16_t opcode; /* HCI command opcode */
+	uint8_t len; /* HCI command response length */
+	void (*handler)(struct net_buf *buf, struct net_buf **evt, uint8_t len, uint16_t opcode);
+};
+
+/* Add event to net_buf. */
+static void evt_create(struct net_buf *buf, uint8_t evt, uint8_t len)
+{
+	struct bt_hci_evt_hdr *hdr;
+
+	hdr = net_buf_add(buf, sizeof(*hdr));
+	hdr->evt = evt;
+	hdr->len = len;
+}
+
+/* Create a command complete event. */
+static void *cmd_complete(struct net_buf **buf, uint8_t plen, uint16_t opcode)
+{
+	struct bt_hci_evt_cmd_complete *cc;
+
+	*buf = bt_buf_get_evt(BT_HCI_EVT_CMD_COMPLETE, false, K_FOREVER);
+	evt_create(*buf, BT_HCI_EVT_CMD_COMPLETE, sizeof(*cc) + plen);
+	cc = net_buf_add(*buf, sizeof(*cc));
+	cc->ncmd = 1U;
+	cc->opcode = sys_cpu_to_le16(opcode);
+
+	return net_buf_add(*buf, plen);
+}
+
+/* Loop over handlers to try to handle the command given by opcode. */
+static int cmd_handle_helper(uint16_t opcode, struct net_buf *cmd, struct net_buf **evt,
+			     const struct cmd_handler *handlers, size_t num_handlers)
+{
+	for (size_t i = 0; i < num_handlers; i++) {
+		const struct cmd_handler *handler = &handlers[i];
+
+		if (handler->opcode != opcode) {
+			continue;
+		}
+
+		if (handler->handler) {
+			handler->handler(cmd, evt, handler->len, opcode);
+
+			return 0;
+		}
+	}
+
+	zassert_unreachable("opcode %X failed", opcode);
+
+	return -EINVAL;
+}
+
+/* Lookup the command opcode and invoke handler. */
+static int cmd_handle(struct net_buf *cmd, const struct cmd_handler *handlers, size_t num_handlers)
+{
+	struct net_buf *evt = NULL;
+	struct bt_hci_evt_cc_status *ccst;
+	struct bt_hci_cmd_hdr *chdr;
+	uint16_t opcode;
+	int err;
+
+	chdr = net_buf_pull_mem(cmd, sizeof(*chdr));
+	opcode = sys_le16_to_cpu(chdr->opcode);
+
+	err = cmd_handle_helper(opcode, cmd, &evt, handlers, num_handlers);
+
+	if (err == -EINVAL) {
+		ccst = cmd_complete(&evt, sizeof(*ccst), opcode);
+		ccst->status = BT_HCI_ERR_UNKNOWN_CMD;
+	}
+
+	if (evt) {
+		bt_recv_prio(evt);
+	}
+
+	return err;
+}
+
+/* Generic command complete with success status. */
+static void generic_success(struct net_buf *buf, struct net_buf **evt, uint8_t len, uint16_t opcode)
+{
+	struct bt_hci_evt_cc_status *ccst;
+
+	ccst = cmd_complete(evt, len, opcode);
+
+	/* Fill any event parameters with zero */
+	(void)memset(ccst, 0, len);
+
+	ccst->status = BT_HCI_ERR_SUCCESS;
+}
+
+/* Bogus handler for BT_HCI_OP_READ_LOCAL_FEATURES. */
+static void read_local_features(struct net_buf *buf, struct net_buf **evt, uint8_t len,
+				uint16_t opcode)
+{
+	struct bt_hci_rp_read_local_features *rp;
+
+	rp = cmd_complete(evt, sizeof(*rp), opcode);
+	rp->status = 0x00;
+	(void)memset(rp->features, 0xFF, sizeof(rp->features));
+}
+
+/* Bogus handler for BT_HCI_OP_READ_SUPPORTED_COMMANDS. */
+static void read_supported_commands(struct net_buf *buf, struct net_buf **evt, uint8_t len,
+				    uint16_t opcode)
+{
+	struct bt_hci_rp_read_supported_commands *rp;
+
+	rp = cmd_complete(evt, sizeof(*rp), opcode);
+	(void)memset(rp->commands, 0xFF, sizeof(rp->commands));
+	rp->status = 0x00;
+}
+
+/* Bogus handler for BT_HCI_OP_LE_READ_LOCAL_FEATURES. */
+static void le_read_local_features(struct net_buf *buf, struct net_buf **evt, uint8_t len,
+				   uint16_t opcode)
+{
+	struct bt_hci_rp_le_read_local_features *rp;
+
+	rp = cmd_complete(evt, sizeof(*rp), opcode);
+	rp->status = 0x00;
+	(void)memset(rp->features, 0xFF, sizeof(rp->features));
+}
+
+/* Bogus handler for BT_HCI_OP_LE_READ_SUPP_STATES. */
+static void le_read_supp_states(struct net_buf *buf, struct net_buf **evt, uint8_t len,
+				uint16_t opcode)
+{
+	struct bt_hci_rp_le_read_supp_states *rp;
+
+	rp = cmd_complete(evt, sizeof(*rp), opcode);
+	rp->status = 0x00;
+	(void)memset(&rp->le_states, 0xFF, sizeof(rp->le_states));
+}
+
+/* Data commands received by the controller, and the operation of the last
+ * one.
+ */
+static struct {
+	uint32_t count;
+	uint8_t op;
+} ad_cmds, sd_cmds, per_cmds;
+
+static void set_ext_adv_data(struct net_buf *buf, struct net_buf **evt, uint8_t len,
+			     uint16_t opcode)
+{
+	const struct bt_hci_cp_le_set_ext_adv_data *cp = (void *)buf->data;
+
+	if (opcode == BT_HCI_OP_LE_SET_EXT_ADV_DATA) {
+		ad_cmds.count++;
+		ad_cmds.op = cp->op;
+	} else {
+		sd_cmds.count++;
+		sd_cmds.op = cp->op;
+	}
+
+	generic_success(buf, evt, len, opcode);
+}
+
+static void set_per_adv_data(struct net_buf *buf, struct net_buf **evt, uint8_t len,
+			     uint16_t opcode)
+{
+	const struct bt_hci_cp_le_set_per_adv_data *cp = (void *)buf->data;
+
+	per_cmds.count++;
+	per_cmds.op = cp->op;
+
+	generic_success(buf, evt, len, opcode);
+}
+
+/* Bogus handler for BT_HCI_OP_LE_READ_NUM_ADV_SETS. */
+static void le_read_num_adv_sets(struct net_buf *buf, struct net_buf **evt, uint8_t len,
+				 uint16_t opcode)
+{
+	struct bt_hci_rp_le_read_num_adv_sets *rp;
+
+	rp = cmd_complete(evt, sizeof(*rp), opcode);
+	rp->status = 0x00;
+	rp->num_sets = CONFIG_BT_EXT_ADV_MAX_ADV_SET;
+}
+
+/* Bogus handler for BT_HCI_OP_LE_READ_MAX_ADV_DATA_LEN. */
+static void le_read_max_adv_data_len(struct net_buf *buf, struct net_buf **evt, uint8_t len,
+				     uint16_t opcode)
+{
+	struct bt_hci_rp_le_read_max_adv_data_len *rp;
+
+	rp = cmd_complete(evt, sizeof(*rp), opcode);
+	rp->status = 0x00;
+	rp->max_adv_data_len = sys_cpu_to_le16(BT_GAP_ADV_MAX_EXT_ADV_DATA_LEN);
+}
+
+/* Setup handlers needed for bt_enable and advertising to function. */
+static const struct cmd_handler cmds[] = {
+	{ BT_HCI_OP_READ_LOCAL_VERSION_INFO, sizeof(struct bt_hci_rp_read_local_version_info),
+	  generic_success },
+	{ BT_HCI_OP_READ_SUPPORTED_COMMANDS, sizeof(struct bt_hci_rp_read_supported_commands),
+	  read_supported_commands },
+	{ BT_HCI_OP_READ_LOCAL_FEATURES, sizeof(struct bt_hci_rp_read_local_features),
+	  read_local_features },
+	{ BT_HCI_OP_READ_BD_ADDR, sizeof(struct bt_hci_rp_read_bd_addr), generic_success },
+	{ BT_HCI_OP_SET_EVENT_MASK, sizeof(struct bt_hci_evt_cc_status), generic_success },
+	{ BT_HCI_OP_LE_SET_EVENT_MASK, sizeof(struct bt_hci_evt_cc_status), generic_success },
+	{ BT_HCI_OP_LE_READ_LOCAL_FEATURES, sizeof(struct bt_hci_rp_le_read_local_features),
+	  le_read_local_features },
+	{ BT_HCI_OP_LE_READ_SUPP_STATES, sizeof(struct bt_hci_rp_le_read_supp_states),
+	  le_read_supp_states },
+	{ BT_HCI_OP_LE_RAND, sizeof(struct bt_hci_rp_le_rand), generic_success },
+	{ BT_HCI_OP_LE_SET_RANDOM_ADDRESS, sizeof(struct bt_hci_cp_le_set_random_address),
+	  generic_success },
+	{ BT_HCI_OP_LE_READ_NUM_ADV_SETS, sizeof(struct bt_hci_rp_le_read_num_adv_sets),
+	  le_read_num_adv_sets },
+	{ BT_HCI_OP_LE_READ_MAX_ADV_DATA_LEN, sizeof(struct bt_hci_rp_le_read_max_adv_data_len),
+	  le_read_max_adv_data_len },
+	{ BT_HCI_OP_LE_SET_ADV_SET_RANDOM_ADDR, sizeof(struct bt_hci_evt_cc_status),
+	  generic_success },
+	{ BT_HCI_OP_LE_SET_EXT_ADV_PARAM, sizeof(struct bt_hci_rp_le_set_ext_adv_param),
+	  generic_success },
+	{ BT_HCI_OP_LE_SET_EXT_ADV_DATA, sizeof(struct bt_hci_evt_cc_status),
+	  set_ext_adv_data },
+	{ BT_HCI_OP_LE_SET_EXT_SCAN_RSP_DATA, sizeof(struct bt_hci_evt_cc_status),
+	  set_ext_adv_data },
+	{ BT_HCI_OP_LE_SET_EXT_ADV_ENABLE, sizeof(struct bt_hci_evt_cc_status),
+	  generic_success },
+	{ BT_HCI_OP_LE_SET_PER_ADV_PARAM, sizeof(struct bt_hci_evt_cc_status),
+	  generic_success },
+	{ BT_HCI_OP_LE_SET_PER_ADV_DATA, sizeof(struct bt_hci_evt_cc_status),
+	  set_per_adv_data },
+	{ BT_HCI_OP_RESET, 0, generic_success },
+};
+
+/* HCI driver open. */
+static int driver_open(void)
+{
+	return 0;
+}
+
+/*  HCI driver send.  */
+static int driver_send(struct net_buf *buf)
+{
+	zassert_true(cmd_handle(buf, cmds, ARRAY_SIZE(cmds)) == 0, "Unknown HCI command");
+
+	net_buf_unref(buf);
+
+	return 0;
+}
+
+/* HCI driver structure. */
+static const struct bt_hci_driver drv = {
+	.name = "test",
+	.bus = BT_HCI_DRIVER_BUS_VIRTUAL,
+	.open = driver_open,
+	.send = driver_send,
+	.quirks = 0,
+};
+
+static const uint8_t mfg_data[] = { 0x59, 0x00, 0x01, 0x02, 0x03 };
+static const uint8_t mfg_data_changed[] = { 0x59, 0x00, 0x01, 0x02, 0x04 };
+
+static const struct bt_data ad[] = {
+	BT_DATA_BYTES(BT_DATA_FLAGS, BT_LE_AD_NO_BREDR),
+	BT_DATA(BT_DATA_MANUFACTURER_DATA, mfg_data, sizeof(mfg_data)),
+};
+
+/* Same length, one byte differs */
+static const struct bt_data ad_changed[] = {
+	BT_DATA_BYTES(BT_DATA_FLAGS, BT_LE_AD_NO_BREDR),
+	BT_DATA(BT_DATA_MANUFACTURER_DATA, mfg_data_changed, sizeof(mfg_data_changed)),
+};
+
+/* Same leading bytes, only the length of the last element changes */
+static const struct bt_data ad_shorter[] = {
+	BT_DATA_BYTES(BT_DATA_FLAGS, BT_LE_AD_NO_BREDR),
+	BT_DATA(BT_DATA_MANUFACTURER_DATA, mfg_data, sizeof(mfg_data) - 1),
+};
+
+static const struct bt_data sd[] = {
+	BT_DATA(BT_DATA_MANUFACTURER_DATA, mfg_data, sizeof(mfg_data)),
+};
+
+static const struct bt_le_adv_param nconn_param =
+	BT_LE_ADV_PARAM_INIT(BT_LE_ADV_OPT_EXT_ADV | BT_LE_ADV_OPT_USE_IDENTITY,
+			     BT_GAP_ADV_FAST_INT_MIN_2, BT_GAP_ADV_FAST_INT_MAX_2, NULL);
+
+static const struct bt_le_adv_param scan_param =
+	BT_LE_ADV_PARAM_INIT(BT_LE_ADV_OPT_SCANNABLE | BT_LE_ADV_OPT_USE_IDENTITY,
+			     BT_GAP_ADV_FAST_INT_MIN_2, BT_GAP_ADV_FAST_INT_MAX_2, NULL);
+
+static const struct bt_le_per_adv_param per_param = {
+	.interval_min = BT_GAP_PER_ADV_FAST_INT_MIN_2,
+	.interval_max = BT_GAP_PER_ADV_FAST_INT_MAX_2,
+};
+
+/* Extended non-connectable set, and legacy scannable set */
+static struct bt_le_ext_adv *ext_adv;
+static struct bt_le_ext_adv *scan_adv;
+
+static void *adv_data_setup(void)
+{
+	/* Register the test HCI driver */
+	bt_hci_driver_register(&drv);
+
+	zassert_true((bt_enable(NULL) == 0), "bt_enable failed");
+
+	zassert_ok(bt_le_ext_adv_create(&nconn_param, NULL, &ext_adv));
+	zassert_ok(bt_le_ext_adv_create(&scan_param, NULL, &scan_adv));
+
+	return NULL;
+}
+
+static void adv_data_before(void *f)
+{
+	/* Setting the parameters forgets the data the controller holds */
+	zassert_ok(bt_le_ext_adv_update_param(ext_adv, &nconn_param));
+	zassert_ok(bt_le_ext_adv_update_param(scan_adv, &scan_param));
+
+	(void)memset(&ad_cmds, 0, sizeof(ad_cmds));
+	(void)memset(&sd_cmds, 0, sizeof(sd_cmds));
+	(void)memset(&per_cmds, 0, sizeof(per_cmds));
+}
+
+static void adv_data_after(void *f)
+{
+	(void)bt_le_ext_adv_stop(ext_adv);
+}
+
+ZTEST_SUITE(adv_data_tests, NULL, adv_data_setup, adv_data_before, adv_data_after, NULL);
+
+ZTEST(adv_data_tests, test_unchanged_skipped)
+{
+	zassert_ok(bt_le_ext_adv_set_data(ext_adv, ad, ARRAY_SIZE(ad), NULL, 0));
+	zassert_equal(ad_cmds.count, 1);
+	zassert_equal(ad_cmds.op, BT_HCI_LE_EXT_ADV_OP_COMPLETE_DATA);
+
+	/* The controller already holds this data */
+	zassert_ok(bt_le_ext_adv_set_data(ext_adv, ad, ARRAY_SIZE(ad), NULL, 0));
+	zassert_equal(ad_cmds.count, 1, "Unchanged data sent again");
+}
+
+ZTEST(adv_data_tests, test_changed_sent)
+{
+	zassert_ok(bt_le_ext_adv_set_data(ext_adv, ad, ARRAY_SIZE(ad), NULL, 0));
+	zassert_ok(bt_le_ext_adv_set_data(ext_adv, ad_changed, ARRAY_SIZE(ad_changed),
+					  NULL, 0));
+	zassert_equal(ad_cmds.count, 2, "Changed data not sent");
+
+	zassert_ok(bt_le_ext_adv_set_data(ext_adv, ad, ARRAY_SIZE(ad), NULL, 0));
+	zassert_equal(ad_cmds.count, 3, "Changed data not sent");
+}
+
+ZTEST(adv_data_tests, test_length_change_sent)
+{
+	zassert_ok(bt_le_ext_adv_set_data(ext_adv, ad, ARRAY_SIZE(ad), NULL, 0));
+	zassert_ok(bt_le_ext_adv_set_data(ext_adv, ad_shorter, ARRAY_SIZE(ad_shorter),
+					  NULL, 0));
+	zassert_equal(ad_cmds.count, 2, "Shorter data not sent");
+
+	/* Same elements, the last one dropped */
+	zassert_ok(bt_le_ext_adv_set_data(ext_adv, ad, 1, NULL, 0));
+	zassert_equal(ad_cmds.count, 3, "Shorter data not sent");
+
+	zassert_ok(bt_le_ext_adv_set_data(ext_adv, ad, ARRAY_SIZE(ad), NULL, 0));
+	zassert_equal(ad_cmds.count, 4, "Longer data not sent");
+}
+
+ZTEST(adv_data_tests, test_unchanged_running)
+{
+	zassert_ok(bt_le_ext_adv_set_data(ext_adv, ad, ARRAY_SIZE(ad), NULL, 0));
+	zassert_ok(bt_le_ext_adv_start(ext_adv, BT_LE_EXT_ADV_START_DEFAULT));
+	zassert_equal(ad_cmds.count, 1);
+
+	/* Only the Advertising DID is updated */
+	zassert_ok(bt_le_ext_adv_set_data(ext_adv, ad, ARRAY_SIZE(ad), NULL, 0));
+	zassert_equal(ad_cmds.count, 2);
+	zassert_equal(ad_cmds.op, BT_HCI_LE_EXT_ADV_OP_UNCHANGED_DATA);
+
+	zassert_ok(bt_le_ext_adv_set_data(ext_adv, ad_changed, ARRAY_SIZE(ad_changed),
+					  NULL, 0));
+	zassert_equal(ad_cmds.count, 3);
+	zassert_equal(ad_cmds.op, BT_HCI_LE_EXT_ADV_OP_COMPLETE_DATA);
+}
+
+ZTEST(adv_data_tests, test_scan_rsp_unchanged_skipped)
+{
+	zassert_ok(bt_le_ext_adv_set_data(scan_adv, NULL, 0, sd, ARRAY_SIZE(sd)));
+	zassert_equal(sd_cmds.count, 1);
+
+	zassert_ok(bt_le_ext_adv_set_data(scan_adv, NULL, 0, sd, ARRAY_SIZE(sd)));
+	zassert_equal(sd_cmds.count, 1, "Unchanged scan response sent again");
+}
+
+ZTEST(adv_data_tests, test_params_forget_data)
+{
+	zassert_ok(bt_le_ext_adv_set_data(ext_adv, ad, ARRAY_SIZE(ad), NULL, 0));
+	zassert_ok(bt_le_ext_adv_update_param(ext_adv, &nconn_param));
+	zassert_ok(bt_le_ext_adv_set_data(ext_adv, ad, ARRAY_SIZE(ad), NULL, 0));
+	zassert_equal(ad_cmds.count, 2, "Data not sent after the parameters");
+}
+
+ZTEST(adv_data_tests, test_per_adv_data)
+{
+	zassert_ok(bt_le_per_adv_set_param(ext_adv, &per_param));
+
+	zassert_ok(bt_le_per_adv_set_data(ext_adv, ad, ARRAY_SIZE(ad)));
+	zassert_equal(per_cmds.count, 1);
+
+	zassert_ok(bt_le_per_adv_set_data(ext_adv, ad, ARRAY_SIZE(ad)));
+	zassert_equal(per_cmds.count, 1, "Unchanged periodic data sent again");
+
+	zassert_ok(bt_le_per_adv_set_data(ext_adv, ad_shorter, ARRAY_SIZE(ad_shorter)));
+	zassert_equal(per_cmds.count, 2, "Changed periodic data not sent");
+
+	/* Setting the parameters forgets the data the controller holds */
+	zassert_ok(bt_le_per_adv_set_param(ext_adv, &per_param));
+	zassert_ok(bt_le_per_adv_set_data(ext_adv, ad_shorter, ARRAY_SIZE(ad_shorter)));
+	zassert_equal(per_cmds.count, 3, "Data not sent after the parameters");
+}
@@ -0,0 +1,563 @@
+/* main.c - Host scan report filtering */
+
+/*
+ * Copyright The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+
+#include <errno.h>
+#include <zephyr/tc_util.h>
+
+#include <zephyr/bluetooth/hci.h>
+#include <zephyr/bluetooth/buf.h>
+#include <zephyr/bluetooth/bluetooth.h>
+#include <zephyr/bluetooth/uuid.h>
+#include <zephyr/drivers/bluetooth/hci_driver.h>
+#include <zephyr/sys/byteorder.h>
+
+#define LOG_LEVEL CONFIG_BT_LOG_LEVEL
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(host_test_app);
+
+#define NUM_ADVERTISERS 8
+#define NUM_REPEATS 20
+#define NUM_REPORTS (NUM_ADVERTISERS * NUM_REPEATS)
+
+#define COMPANY_ID_A 0x0059
+#define COMPANY_ID_B 0x004c
+#define SERVICE_UUID 0x180f
+
+#define COMPLETE BT_HCI_LE_ADV_EVT_TYPE_DATA_STATUS_COMPLETE << 5
+
+struct test_adv_report {
+	uint8_t data[BT_GAP_ADV_MAX_ADV_DATA_LEN];
+	uint8_t length;
+	int8_t rssi;
+	bt_addr_le_t addr;
+	/* Event type properties of a legacy PDU, non-connectable if 0 */
+	uint16_t evt_type;
+};
+
+/* Command handler structure for cmd_handle(). */
+struct cmd_handler {
+	uint16_t opcode; /* HCI command opcode */
+	uint8_t len; /* HCI command response length */
+	void (*handler)(struct net_buf *buf, struct net_buf **evt, uint8_t len, uint16_t opcode);
+};
+
+/* Add event to net_buf. */
+static void evt_create(struct net_buf *buf, uint8_t evt, uint8_t len)
+{
+	struct bt_hci_evt_hdr *hdr;
+
+	hdr = net_buf_add(buf, sizeof(*hdr));
+	hdr->evt = evt;
+	hdr->len = len;
+}
+
+/* Create a command complete event. */
+static void *cmd_complete(struct net_buf **buf, uint8_t plen, uint16_t opcode)
+{
+	struct bt_hci_evt_cmd_complete *cc;
+
+	*buf = bt_buf_get_evt(BT_HCI_EVT_CMD_COMPLETE, false, K_FOREVER);
+	evt_create(*buf, BT_HCI_EVT_CMD_COMPLETE, sizeof(*cc) + plen);
+	cc = net_buf_add(*buf, sizeof(*cc));
+	cc->ncmd = 1U;
+	cc->opcode = sys_cpu_to_le16(opcode);
+
+	return net_buf_add(*buf, plen);
+}
+
+/* Loop over handlers to try to handle the command given by opcode. */
+static int cmd_handle_helper(uint16_t opcode, struct net_buf *cmd, struct net_buf **evt,
+			     const struct cmd_handler *handlers, size_t num_handlers)
+{
+	for (size_t i = 0; i < num_handlers; i++) {
+		const struct cmd_handler *handler = &handlers[i];
+
+		if (handler->opcode != opcode) {
+			continue;
+		}
+
+		if (handler->handler) {
+			handler->handler(cmd, evt, handler->len, opcode);
+
+			return 0;
+		}
+	}
+
+	zassert_unreachable("opcode %X failed", opcode);
+
+	return -EINVAL;
+}
+
+/* Lookup the command opcode and invoke handler. */
+static int cmd_handle(struct net_buf *cmd, const struct cmd_handler *handlers, size_t num_handlers)
+{
+	struct net_buf *evt = NULL;
+	struct bt_hci_evt_cc_status *ccst;
+	struct bt_hci_cmd_hdr *chdr;
+	uint16_t opcode;
+	int err;
+
+	chdr = net_buf_pull_mem(cmd, sizeof(*chdr));
+	opcode = sys_le16_to_cpu(chdr->opcode);
+
+	err = cmd_handle_helper(opcode, cmd, &evt, handlers, num_handlers);
+
+	if (err == -EINVAL) {
+		ccst = cmd_complete(&evt, sizeof(*ccst), opcode);
+		ccst->status = BT_HCI_ERR_UNKNOWN_CMD;
+	}
+
+	if (evt) {
+		bt_recv_prio(evt);
+	}
+
+	return err;
+}
+
+/* Generic command complete with success status. */
+static void generic_success(struct net_buf *buf, struct net_buf **evt, uint8_t len, uint16_t opcode)
+{
+	struct bt_hci_evt_cc_status *ccst;
+
+	ccst = cmd_complete(evt, len, opcode);
+
+	/* Fill any event parameters with zero */
+	(void)memset(ccst, 0, len);
+
+	ccst->status = BT_HCI_ERR_SUCCESS;
+}
+
+/* Bogus handler for BT_HCI_OP_READ_LOCAL_FEATURES. */
+static void read_local_features(struct net_buf *buf, struct net_buf **evt, uint8_t len,
+				uint16_t opcode)
+{
+	struct bt_hci_rp_read_local_features *rp;
+
+	rp = cmd_complete(evt, sizeof(*rp), opcode);
+	rp->status = 0x00;
+	(void)memset(rp->features, 0xFF, sizeof(rp->features));
+}
+
+/* Bogus handler for BT_HCI_OP_READ_SUPPORTED_COMMANDS. */
+static void read_supported_commands(struct net_buf *buf, struct net_buf **evt, uint8_t len,
+				    uint16_t opcode)
+{
+	struct bt_hci_rp_read_supported_commands *rp;
+
+	rp = cmd_complete(evt, sizeof(*rp), opcode);
+	(void)memset(rp->commands, 0xFF, sizeof(rp->commands));
+	rp->status = 0x00;
+}
+
+/* Bogus handler for BT_HCI_OP_LE_READ_LOCAL_FEATURES. */
+static void le_read_local_features(struct net_buf *buf, struct net_buf **evt, uint8_t len,
+				   uint16_t opcode)
+{
+	struct bt_hci_rp_le_read_local_features *rp;
+
+	rp = cmd_complete(evt, sizeof(*rp), opcode);
+	rp->status = 0x00;
+	(void)memset(rp->features, 0xFF, sizeof(rp->features));
+}
+
+/* Bogus handler for BT_HCI_OP_LE_READ_SUPP_STATES. */
+static void le_read_supp_states(struct net_buf *buf, struct net_buf **evt, uint8_t len,
+				uint16_t opcode)
+{
+	struct bt_hci_rp_le_read_supp_states *rp;
+
+	rp = cmd_complete(evt, sizeof(*rp), opcode);
+	rp->status = 0x00;
+	(void)memset(&rp->le_states, 0xFF, sizeof(rp->le_states));
+}
+
+/* Setup handlers needed for bt_enable and scanning to function. */
+static const struct cmd_handler cmds[] = {
+	{ BT_HCI_OP_READ_LOCAL_VERSION_INFO, sizeof(struct bt_hci_rp_read_local_version_info),
+	  generic_success },
+	{ BT_HCI_OP_READ_SUPPORTED_COMMANDS, sizeof(struct bt_hci_rp_read_supported_commands),
+	  read_supported_commands },
+	{ BT_HCI_OP_READ_LOCAL_FEATURES, sizeof(struct bt_hci_rp_read_local_features),
+	  read_local_features },
+	{ BT_HCI_OP_READ_BD_ADDR, sizeof(struct bt_hci_rp_read_bd_addr), generic_success },
+	{ BT_HCI_OP_SET_EVENT_MASK, sizeof(struct bt_hci_evt_cc_status), generic_success },
+	{ BT_HCI_OP_LE_SET_EVENT_MASK, sizeof(struct bt_hci_evt_cc_status), generic_success },
+	{ BT_HCI_OP_LE_READ_LOCAL_FEATURES, sizeof(struct bt_hci_rp_le_read_local_features),
+	  le_read_local_features },
+	{ BT_HCI_OP_LE_READ_SUPP_STATES, sizeof(struct bt_hci_rp_le_read_supp_states),
+	  le_read_supp_states },
+	{ BT_HCI_OP_LE_RAND, sizeof(struct bt_hci_rp_le_rand), generic_success },
+	{ BT_HCI_OP_LE_SET_RANDOM_ADDRESS, sizeof(struct bt_hci_cp_le_set_random_address),
+	  generic_success },
+	{ BT_HCI_OP_LE_SET_EXT_SCAN_PARAM, sizeof(struct bt_hci_evt_cc_status),
+	  generic_success },
+	{ BT_HCI_OP_LE_SET_EXT_SCAN_ENABLE, sizeof(struct bt_hci_evt_cc_status),
+	  generic_success },
+	{ BT_HCI_OP_RESET, 0, generic_success },
+};
+
+/* HCI driver open. */
+static int driver_open(void)
+{
+	return 0;
+}
+
+/*  HCI driver send.  */
+static int driver_send(struct net_buf *buf)
+{
+	zassert_true(cmd_handle(buf, cmds, ARRAY_SIZE(cmds)) == 0, "Unknown HCI command");
+
+	net_buf_unref(buf);
+
+	return 0;
+}
+
+/* HCI driver structure. */
+static const struct bt_hci_driver drv = {
+	.name = "test",
+	.bus = BT_HCI_DRIVER_BUS_VIRTUAL,
+	.open = driver_open,
+	.send = driver_send,
+	.quirks = 0,
+};
+
+struct bt_recv_job_data {
+	struct k_work work; /* Work item */
+	struct k_sem *sync; /* Semaphore to synchronize with */
+	struct net_buf *buf; /* Net buffer to be passed to bt_recv() */
+} job_data[CONFIG_BT_BUF_EVT_RX_COUNT];
+
+#define job(buf) (&job_data[net_buf_id(buf)])
+
+/* Work item handler for bt_recv() jobs. */
+static void bt_recv_job_cb(struct k_work *item)
+{
+	struct bt_recv_job_data *data = CONTAINER_OF(item, struct bt_recv_job_data, work);
+
+	/* Send net buffer to host */
+	bt_recv(data->buf);
+
+	/* Wake up bt_recv_job_submit */
+	k_sem_give(job(data->buf)->sync);
+}
+
+/* Prepare a job to call bt_recv() to be submitted to the system workqueue. */
+static void bt_recv_job_submit(struct net_buf *buf)
+{
+	struct k_sem sync_sem;
+
+	/* Store the net buffer to be passed to bt_recv */
+	job(buf)->buf = buf;
+
+	/* Initialize job work item/semaphore */
+	k_work_init(&job(buf)->work, bt_recv_job_cb);
+	k_sem_init(&sync_sem, 0, 1);
+	job(buf)->sync = &sync_sem;
+
+	/* Make sure the buffer stays around until the command completes */
+	buf = net_buf_ref(buf);
+
+	/* Submit the work item */
+	k_work_submit(&job(buf)->work);
+
+	/* Wait for bt_recv_job_cb to be done */
+	k_sem_take(&sync_sem, K_FOREVER);
+
+	net_buf_unref(buf);
+}
+
+/* Send an extended advertising report with the given data. */
+static void send_adv_report(const struct test_adv_report *report)
+{
+	struct bt_hci_evt_le_meta_event *meta_evt;
+	struct bt_hci_evt_le_ext_advertising_info *evt;
+	struct net_buf *buf;
+
+	buf = bt_buf_get_rx(BT_BUF_EVT, K_FOREVER);
+
+	evt_create(buf, BT_HCI_EVT_LE_META_EVENT,
+		   sizeof(*meta_evt) + sizeof(*evt) + report->length + 1);
+	meta_evt = net_buf_add(buf, sizeof(*meta_evt));
+	meta_evt->subevent = BT_HCI_EVT_LE_EXT_ADVERTISING_REPORT;
+	net_buf_add_u8(buf, 1); /* Number of reports */
+
+	evt = net_buf_add(buf, sizeof(*evt));
+	(void)memset(evt, 0, sizeof(*evt));
+	evt->evt_type = sys_cpu_to_le16(COMPLETE | BT_HCI_LE_ADV_EVT_TYPE_LEGACY |
+					report->evt_type);
+	bt_addr_le_copy(&evt->addr, &report->addr);
+	bt_addr_le_copy(&evt->direct_addr, BT_ADDR_LE_NONE);
+	evt->sid = BT_GAP_SID_INVALID;
+	evt->tx_power = BT_GAP_TX_POWER_INVALID;
+	evt->rssi = report->rssi;
+	evt->length = report->length;
+
+	net_buf_add_mem(buf, report->data, report->length);
+
+	bt_recv_job_submit(buf);
+}
+
+/* Recorded report stream: each advertiser repeats its report, interleaved
+ * with the other advertisers. Even advertisers use COMPANY_ID_A and odd ones
+ * COMPANY_ID_B. Advertisers 0 and 4 list SERVICE_UUID, advertisers 1 and 5
+ * have Service Data for it. The RSSI drops by 5 dBm per advertiser, from
+ * -40 dBm. Advertiser 0 changes its data halfway.
+ */
+static struct test_adv_report stream[NUM_REPORTS];
+
+static void stream_create(void)
+{
+	for (int r = 0; r < NUM_REPEATS; r++) {
+		for (int i = 0; i < NUM_ADVERTISERS; i++) {
+			struct test_adv_report *report = &stream[r * NUM_ADVERTISERS + i];
+			uint8_t *data = report->data;
+
+			/* Fixed static addresses, so that the reports are stored
+			 * in the same duplicate filter entries on every run.
+			 */
+			report->addr.type = BT_ADDR_LE_RANDOM;
+			report->addr.a = (bt_addr_t){ { i + 1, 0x00, 0x00, 0x00, 0x00, 0xc0 } };
+			report->rssi = -40 - 5 * i;
+
+			*data++ = 2;
+			*data++ = BT_DATA_FLAGS;
+			*data++ = BT_LE_AD_GENERAL | BT_LE_AD_NO_BREDR;
+
+			*data++ = 5;
+			*data++ = BT_DATA_MANUFACTURER_DATA;
+			sys_put_le16(i % 2 ? COMPANY_ID_B : COMPANY_ID_A, data);
+			data += 2;
+			*data++ = i;
+			*data++ = (i == 0 && r >= NUM_REPEATS / 2) ? 1 : 0;
+
+			if (i % 4 == 0) {
+				*data++ = 3;
+				*data++ = BT_DATA_UUID16_ALL;
+				sys_put_le16(SERVICE_UUID, data);
+				data += 2;
+			} else if (i % 4 == 1) {
+				*data++ = 4;
+				*data++ = BT_DATA_SVC_DATA16;
+				sys_put_le16(SERVICE_UUID, data);
+				data += 2;
+				*data++ = 100;
+			}
+
+			report->length = data - report->data;
+		}
+	}
+}
+
+static uint32_t recv_count;
+
+static void scan_recv_cb(const struct bt_le_scan_recv_info *info, struct net_buf_simple *buf)
+{
+	ARG_UNUSED(info);
+	ARG_UNUSED(buf);
+
+	recv_count++;
+}
+
+static struct bt_le_scan_cb scan_callbacks = {
+	.recv = scan_recv_cb,
+};
+
+/* Replay the stream, returning the number of reports delivered */
+static uint32_t stream_replay(void)
+{
+	uint32_t start;
+	uint32_t us;
+
+	recv_count = 0U;
+	start = k_cycle_get_32();
+
+	for (int i = 0; i < ARRAY_SIZE(stream); i++) {
+		send_adv_report(&stream[i]);
+	}
+
+	us = k_cyc_to_us_floor32(k_cycle_get_32() - start);
+	TC_PRINT("%u reports in %u us, %u delivered\n", NUM_REPORTS, us, recv_count);
+
+	return recv_count;
+}
+
+static void scan_start(uint32_t options)
+{
+	struct bt_le_scan_param param = {
+		.type = BT_LE_SCAN_TYPE_PASSIVE,
+		.options = options,
+		.interval = BT_GAP_SCAN_FAST_INTERVAL,
+		.window = BT_GAP_SCAN_FAST_WINDOW,
+	};
+
+	zassert_ok(bt_le_scan_start(&param, NULL), "Failed to start scanning");
+}
+
+static void *scan_filter_setup(void)
+{
+	/* Register the test HCI driver */
+	bt_hci_driver_register(&drv);
+
+	zassert_true((bt_enable(NULL) == 0), "bt_enable failed");
+
+	bt_le_scan_cb_register(&scan_callbacks);
+
+	stream_create();
+
+	return NULL;
+}
+
+static void scan_filter_after(void *f)
+{
+	(void)bt_le_scan_stop();
+	zassert_ok(bt_le_scan_filter_set(NULL));
+}
+
+ZTEST_SUITE(scan_filter_tests, NULL, scan_filter_setup, NULL, scan_filter_after, NULL);
+
+ZTEST(scan_filter_tests, test_no_filter)
+{
+	scan_start(BT_LE_SCAN_OPT_NONE);
+
+	zassert_equal(stream_replay(), NUM_REPORTS);
+}
+
+ZTEST(scan_filter_tests, test_dedup)
+{
+	scan_start(BT_LE_SCAN_OPT_FILTER_DUPLICATE);
+
+	/* One report per advertiser, and the changed data of advertiser 0 */
+	zassert_equal(stream_replay(), NUM_ADVERTISERS + 1);
+
+	/* Duplicates are dropped until the timeout */
+	zassert_equal(stream_replay(), 0);
+
+	k_sleep(K_MSEC(CONFIG_BT_SCAN_DEDUP_TIMEOUT));
+
+	zassert_equal(stream_replay(), NUM_ADVERTISERS + 1);
+}
+
+ZTEST(scan_filter_tests, test_dedup_restart)
+{
+	scan_start(BT_LE_SCAN_OPT_FILTER_DUPLICATE);
+	zassert_equal(stream_replay(), NUM_ADVERTISERS + 1);
+	zassert_ok(bt_le_scan_stop());
+
+	/* Restarting the scanner forgets the delivered reports */
+	scan_start(BT_LE_SCAN_OPT_FILTER_DUPLICATE);
+	zassert_equal(stream_replay(), NUM_ADVERTISERS + 1);
+}
+
+ZTEST(scan_filter_tests, test_filter_company_id)
+{
+	struct bt_le_scan_filter filter = {
+		.options = BT_LE_SCAN_FILTER_COMPANY_ID,
+		.company_id = COMPANY_ID_A,
+	};
+
+	zassert_ok(bt_le_scan_filter_set(&filter));
+	scan_start(BT_LE_SCAN_OPT_NONE);
+
+	zassert_equal(stream_replay(), NUM_REPORTS / 2);
+}
+
+ZTEST(scan_filter_tests, test_filter_uuid)
+{
+	struct bt_le_scan_filter filter = {
+		.options = BT_LE_SCAN_FILTER_UUID,
+		.uuid = BT_UUID_DECLARE_16(SERVICE_UUID),
+	};
+
+	zassert_ok(bt_le_scan_filter_set(&filter));
+	scan_start(BT_LE_SCAN_OPT_NONE);
+
+	/* Listed by advertisers 0 and 4, Service Data of advertisers 1 and 5 */
+	zassert_equal(stream_replay(), 4 * NUM_REPEATS);
+}
+
+ZTEST(scan_filter_tests, test_filter_rssi)
+{
+	struct bt_le_scan_filter filter = {
+		.options = BT_LE_SCAN_FILTER_RSSI,
+		.rssi = -55,
+	};
+
+	zassert_ok(bt_le_scan_filter_set(&filter));
+	scan_start(BT_LE_SCAN_OPT_NONE);
+
+	zassert_equal(stream_replay(), 4 * NUM_REPEATS);
+}
+
+ZTEST(scan_filter_tests, test_filter_combined)
+{
+	struct bt_le_scan_filter filter = {
+		.options = BT_LE_SCAN_FILTER_COMPANY_ID | BT_LE_SCAN_FILTER_UUID,
+		.company_id = COMPANY_ID_A,
+		.uuid = BT_UUID_DECLARE_16(SERVICE_UUID),
+	};
+
+	zassert_ok(bt_le_scan_filter_set(&filter));
+	scan_start(BT_LE_SCAN_OPT_FILTER_DUPLICATE);
+
+	/* Advertisers 0 and 4, and the changed data of advertiser 0 */
+	zassert_equal(stream_replay(), 3);
+}
+
+ZTEST(scan_filter_tests, test_filter_scan_rsp)
+{
+	struct bt_le_scan_filter filter = {
+		.options = BT_LE_SCAN_FILTER_UUID,
+		.uuid = BT_UUID_DECLARE_16(SERVICE_UUID),
+	};
+	struct test_adv_report rsp = {
+		.data = { 5, BT_DATA_NAME_COMPLETE, 't', 'e', 's', 't' },
+		.length = 6,
+		.rssi = -40,
+		.evt_type = BT_HCI_LE_ADV_EVT_TYPE_CONN | BT_HCI_LE_ADV_EVT_TYPE_SCAN |
+			    BT_HCI_LE_ADV_EVT_TYPE_SCAN_RSP,
+	};
+	struct test_adv_report adv;
+
+	zassert_ok(bt_le_scan_filter_set(&filter));
+	scan_start(BT_LE_SCAN_OPT_NONE);
+
+	/* ADV_IND listing the UUID, the scan response only has the name */
+	adv = stream[0];
+	adv.evt_type = BT_HCI_LE_ADV_EVT_TYPE_CONN | BT_HCI_LE_ADV_EVT_TYPE_SCAN;
+	rsp.addr = adv.addr;
+
+	recv_count = 0U;
+	send_adv_report(&adv);
+	send_adv_report(&rsp);
+	zassert_equal(recv_count, 2, "Scan response of a matching advertiser dropped");
+
+	/* Advertiser 2 doesn't match, neither does its scan response */
+	adv = stream[2];
+	adv.evt_type = BT_HCI_LE_ADV_EVT_TYPE_CONN | BT_HCI_LE_ADV_EVT_TYPE_SCAN;
+	rsp.addr = adv.addr;
+
+	recv_count = 0U;
+	send_adv_report(&adv);
+	send_adv_report(&rsp);
+	zassert_equal(recv_count, 0, "Scan response of another advertiser delivered");
+}
+
+ZTEST(scan_filter_tests, test_filter_set_invalid)
+{
+	struct bt_le_scan_filter filter = {
+		.options = BT_LE_SCAN_FILTER_UUID,
+	};
+
+	zassert_equal(bt_le_scan_filter_set(&filter), -EINVAL);
+
+	scan_start(BT_LE_SCAN_OPT_NONE);
+	zassert_equal(bt_le_scan_filter_set(NULL), -EBUSY);
+}
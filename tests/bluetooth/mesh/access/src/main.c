@@ -0,0 +1,265 @@
+/*
+ * Copyright The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/ztest.h>
+#include <zephyr/bluetooth/mesh.h>
+
+#include "access.h"
+#include "foundation.h"
+
+#define ADDR    0x0001
+#define APP_IDX 0x000
+
+#define CID_1   0x0001
+#define CID_2   0x0002
+
+#define OP_SHARED  BT_MESH_MODEL_OP_2(0x82, 0x01)
+#define OP_A       BT_MESH_MODEL_OP_2(0x82, 0x02)
+#define OP_B       BT_MESH_MODEL_OP_2(0x82, 0x03)
+#define OP_SHORT   BT_MESH_MODEL_OP_1(0x10)
+#define OP_UNKNOWN BT_MESH_MODEL_OP_2(0x82, 0x7f)
+#define OP_IN_VND  BT_MESH_MODEL_OP_2(0x82, 0x10)
+#define VOP_OWN    BT_MESH_MODEL_OP_3(0x01, CID_1)
+#define VOP_CID_2  BT_MESH_MODEL_OP_3(0x02, CID_2)
+
+/* Model and handler the last message was dispatched to */
+static struct {
+	struct bt_mesh_model *model;
+	const void *handler;
+} rx;
+
+#define HANDLER(_name)                                                         \
+	static int _name(struct bt_mesh_model *model, struct bt_mesh_msg_ctx *ctx, \
+			 struct net_buf_simple *buf)                           \
+	{                                                                      \
+		rx.model = model;                                              \
+		rx.handler = _name;                                            \
+		return 0;                                                      \
+	}
+
+HANDLER(a_shared)
+HANDLER(a_op_a)
+HANDLER(b_shared)
+HANDLER(b_op_b)
+HANDLER(b_short)
+HANDLER(c_shared)
+HANDLER(c_op_a)
+HANDLER(v1_own)
+HANDLER(v2_cid_2)
+#if !defined(CONFIG_BT_MESH_MODEL_VND_MSG_CID_FORCE)
+HANDLER(v1_cid_2)
+HANDLER(v1_sig)
+#endif
+
+static const struct bt_mesh_model_op model_a_op[] = {
+	{ OP_SHARED, 0, a_shared },
+	{ OP_A, 0, a_op_a },
+	BT_MESH_MODEL_OP_END,
+};
+
+static const struct bt_mesh_model_op model_b_op[] = {
+	{ OP_B, 0, b_op_b },
+	{ OP_SHARED, 0, b_shared },
+	{ OP_SHORT, 0, b_short },
+	BT_MESH_MODEL_OP_END,
+};
+
+static const struct bt_mesh_model_op model_c_op[] = {
+	{ OP_A, 0, c_op_a },
+	{ OP_SHARED, 0, c_shared },
+	BT_MESH_MODEL_OP_END,
+};
+
+static const struct bt_mesh_model_op model_v1_op[] = {
+#if !defined(CONFIG_BT_MESH_MODEL_VND_MSG_CID_FORCE)
+	/* OpCodes that are not of the model's company are only accepted
+	 * without CID_FORCE.
+	 */
+	{ VOP_CID_2, 0, v1_cid_2 },
+	{ OP_IN_VND, 0, v1_sig },
+#endif
+	{ VOP_OWN, 0, v1_own },
+	BT_MESH_MODEL_OP_END,
+};
+
+static const struct bt_mesh_model_op model_v2_op[] = {
+	{ VOP_CID_2, 0, v2_cid_2 },
+	BT_MESH_MODEL_OP_END,
+};
+
+static struct bt_mesh_model models_0[] = {
+	BT_MESH_MODEL(0x1000, model_a_op, NULL, NULL),
+	BT_MESH_MODEL(0x1001, model_b_op, NULL, NULL),
+};
+
+static struct bt_mesh_model vnd_models_0[] = {
+	BT_MESH_MODEL_VND(CID_1, 0x0001, model_v1_op, NULL, NULL),
+	BT_MESH_MODEL_VND(CID_2, 0x0002, model_v2_op, NULL, NULL),
+};
+
+static struct bt_mesh_model models_1[] = {
+	BT_MESH_MODEL(0x1000, model_c_op, NULL, NULL),
+};
+
+#if defined(RECV_COST_BENCHMARK)
+#define BENCH_MODELS   120
+#define BENCH_ROUNDS   100
+#define BENCH_OP(i)    BT_MESH_MODEL_OP_2(0x83, (i))
+
+HANDLER(bench)
+
+#define BENCH_MODEL_OP(i, _) { { BENCH_OP(i), 0, bench }, BT_MESH_MODEL_OP_END }
+
+static const struct bt_mesh_model_op bench_op[BENCH_MODELS][2] = {
+	LISTIFY(BENCH_MODELS, BENCH_MODEL_OP, (,))
+};
+
+/* BT_MESH_MODEL() uses LISTIFY() itself, so the models are spelled out ten
+ * at a time instead.
+ */
+#define BENCH_MODEL(i) BT_MESH_MODEL(0x2000 + (i), bench_op[i], NULL, NULL)
+#define BENCH_MODEL_10(n)                                                      \
+	BENCH_MODEL(n##0), BENCH_MODEL(n##1), BENCH_MODEL(n##2),               \
+	BENCH_MODEL(n##3), BENCH_MODEL(n##4), BENCH_MODEL(n##5),               \
+	BENCH_MODEL(n##6), BENCH_MODEL(n##7), BENCH_MODEL(n##8),               \
+	BENCH_MODEL(n##9)
+
+static struct bt_mesh_model bench_models[BENCH_MODELS] = {
+	BENCH_MODEL_10(), BENCH_MODEL_10(1), BENCH_MODEL_10(2),
+	BENCH_MODEL_10(3), BENCH_MODEL_10(4), BENCH_MODEL_10(5),
+	BENCH_MODEL_10(6), BENCH_MODEL_10(7), BENCH_MODEL_10(8),
+	BENCH_MODEL_10(9), BENCH_MODEL_10(10), BENCH_MODEL_10(11),
+};
+#endif /* RECV_COST_BENCHMARK */
+
+static struct bt_mesh_elem elems[] = {
+	BT_MESH_ELEM(0, models_0, vnd_models_0),
+	BT_MESH_ELEM(1, models_1, BT_MESH_MODEL_NONE),
+#if defined(RECV_COST_BENCHMARK)
+	BT_MESH_ELEM(2, bench_models, BT_MESH_MODEL_NONE),
+#endif
+};
+
+static const struct bt_mesh_comp comp = {
+	.cid = CID_1,
+	.elem = elems,
+	.elem_count = ARRAY_SIZE(elems),
+};
+
+static void bind(struct bt_mesh_model *mod, struct bt_mesh_elem *elem,
+		 bool vnd, bool primary, void *user_data)
+{
+	mod->keys[0] = APP_IDX;
+}
+
+static int recv(uint16_t dst, uint32_t opcode)
+{
+	struct bt_mesh_msg_ctx ctx = {
+		.app_idx = APP_IDX,
+		.addr = 0x0100,
+		.recv_dst = dst,
+	};
+
+	NET_BUF_SIMPLE_DEFINE(buf, BT_MESH_MODEL_OP_LEN(opcode));
+
+	bt_mesh_model_msg_init(&buf, opcode);
+
+	rx.model = NULL;
+	rx.handler = NULL;
+
+	return bt_mesh_model_recv(&ctx, &buf);
+}
+
+static void expect_rx(uint16_t dst, uint32_t opcode, struct bt_mesh_model *model,
+		      const void *handler)
+{
+	zassert_equal(recv(dst, opcode), ACCESS_STATUS_SUCCESS,
+		      "OpCode 0x%06x to 0x%04x not handled", opcode, dst);
+	zassert_equal_ptr(rx.model, model, "OpCode 0x%06x to wrong model", opcode);
+	zassert_equal_ptr(rx.handler, handler, "OpCode 0x%06x to wrong handler", opcode);
+}
+
+static void expect_no_rx(uint16_t dst, uint32_t opcode)
+{
+	zassert_equal(recv(dst, opcode), ACCESS_STATUS_WRONG_OPCODE,
+		      "OpCode 0x%06x to 0x%04x handled", opcode, dst);
+	zassert_is_null(rx.model);
+}
+
+static void *setup(void)
+{
+	zassert_ok(bt_mesh_comp_register(&comp));
+	bt_mesh_comp_provision(ADDR);
+	bt_mesh_model_foreach(bind, NULL);
+
+	return NULL;
+}
+
+ZTEST(bt_mesh_access, test_sig)
+{
+	/* The first model of the element with the OpCode gets it */
+	expect_rx(ADDR, OP_SHARED, &models_0[0], a_shared);
+	expect_rx(ADDR, OP_A, &models_0[0], a_op_a);
+	expect_rx(ADDR, OP_B, &models_0[1], b_op_b);
+	expect_rx(ADDR, OP_SHORT, &models_0[1], b_short);
+
+	/* Other elements only look at their own models */
+	expect_rx(ADDR + 1, OP_SHARED, &models_1[0], c_shared);
+	expect_rx(ADDR + 1, OP_A, &models_1[0], c_op_a);
+	expect_no_rx(ADDR + 1, OP_B);
+
+	expect_no_rx(ADDR, OP_UNKNOWN);
+
+	/* SIG OpCodes are only looked up in SIG models */
+	expect_no_rx(ADDR, OP_IN_VND);
+}
+
+ZTEST(bt_mesh_access, test_vnd)
+{
+	expect_rx(ADDR, VOP_OWN, &vnd_models_0[0], v1_own);
+
+	/* With CID_FORCE, vendor OpCodes only reach the models of the
+	 * company in the OpCode, otherwise the first model with the OpCode
+	 * gets it.
+	 */
+#if defined(CONFIG_BT_MESH_MODEL_VND_MSG_CID_FORCE)
+	expect_rx(ADDR, VOP_CID_2, &vnd_models_0[1], v2_cid_2);
+#else
+	expect_rx(ADDR, VOP_CID_2, &vnd_models_0[0], v1_cid_2);
+#endif
+
+	expect_no_rx(ADDR + 1, VOP_OWN);
+}
+
+#if defined(RECV_COST_BENCHMARK)
+/* Only built in the recv_cost variants, reports the cost of dispatching a
+ * message to each model of an element with BENCH_MODELS models, for
+ * comparison between the OpCode table and the linear lookup.
+ */
+ZTEST(bt_mesh_access, test_recv_cost)
+{
+	uint32_t start, cycles;
+
+	start = k_cycle_get_32();
+	for (int round = 0; round < BENCH_ROUNDS; round++) {
+		for (int i = 0; i < BENCH_MODELS; i++) {
+			expect_rx(ADDR + 2, BENCH_OP(i), &bench_models[i], bench);
+		}
+	}
+	cycles = k_cycle_get_32() - start;
+
+	/* The POSIX architecture's cycle counter only advances while idle */
+	if (IS_ENABLED(CONFIG_ARCH_POSIX)) {
+		ztest_test_skip();
+	}
+
+	TC_PRINT("%u models, table size %u: %u cycles for %u messages\n",
+		 BENCH_MODELS, CONFIG_BT_MESH_ACCESS_OP_TABLE_SIZE, cycles,
+		 BENCH_MODELS * BENCH_ROUNDS);
+}
+#endif /* RECV_COST_BENCHMARK */
+
+ZTEST_SUITE(bt_mesh_access, NULL, setup, NULL, NULL, NULL);
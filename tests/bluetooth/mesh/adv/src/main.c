@@ -0,0 +1,148 @@
+/*
+ * Copyright The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/ztest.h>
+#include <zephyr/bluetooth/mesh.h>
+
+#include "adv.h"
+
+#define XMIT(count) BT_MESH_TRANSMIT(count, 20)
+
+/* The test thread is cooperative, so the advertising sets don't get to take
+ * the queued messages before the test does.
+ */
+BUILD_ASSERT(CONFIG_ZTEST_THREAD_PRIORITY < 0);
+
+static struct net_buf *relay_bufs[CONFIG_BT_MESH_RELAY_BUF_COUNT];
+
+static struct net_buf *adv_create(enum bt_mesh_adv_tag tag, uint8_t xmit)
+{
+	struct net_buf *buf;
+
+	buf = bt_mesh_adv_create(BT_MESH_ADV_DATA, tag, xmit, K_NO_WAIT);
+	zassert_not_null(buf, "Out of buffers for tag %u", tag);
+
+	return buf;
+}
+
+static void adv_send(enum bt_mesh_adv_tag tag)
+{
+	struct net_buf *buf = adv_create(tag, XMIT(0));
+
+	net_buf_add_u8(buf, tag);
+	bt_mesh_adv_send(buf, NULL, NULL);
+	net_buf_unref(buf);
+}
+
+/* Take the next message the main advertising set would send */
+static void expect_buf_get(enum bt_mesh_adv_tag tag)
+{
+	struct net_buf *buf = bt_mesh_adv_buf_get(K_NO_WAIT);
+
+	zassert_not_null(buf, "No message for tag %u", tag);
+	zassert_equal(BT_MESH_ADV(buf)->tag, tag, "Got tag %u instead of %u",
+		      BT_MESH_ADV(buf)->tag, tag);
+	net_buf_unref(buf);
+}
+
+static void expect_count(uint8_t count, uint8_t expected)
+{
+	uint8_t xmit = bt_mesh_adv_relay_xmit_adapt(XMIT(count));
+
+	zassert_equal(BT_MESH_TRANSMIT_COUNT(xmit), expected, "Count %u adapted to %u, not %u",
+		      count, BT_MESH_TRANSMIT_COUNT(xmit), expected);
+	zassert_equal(BT_MESH_TRANSMIT_INT(xmit), 20, "Interval changed");
+}
+
+static void cleanup(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	for (int i = 0; i < ARRAY_SIZE(relay_bufs); i++) {
+		if (relay_bufs[i]) {
+			net_buf_unref(relay_bufs[i]);
+			relay_bufs[i] = NULL;
+		}
+	}
+
+	while (bt_mesh_adv_buf_get(K_NO_WAIT)) {
+	}
+}
+
+ZTEST(bt_mesh_adv, test_relay_xmit_adapt)
+{
+	/* The count drops with the relay buffers in use, rounded up */
+	static const uint8_t counts[][CONFIG_BT_MESH_RELAY_BUF_COUNT] = {
+		{ 4, 3, 2, 1, 0 },
+		{ 2, 2, 1, 1, 0 },
+		{ 7, 6, 4, 2, 0 },
+		{ 0, 0, 0, 0, 0 },
+	};
+
+	for (int i = 0; i < ARRAY_SIZE(relay_bufs); i++) {
+		for (int j = 0; j < ARRAY_SIZE(counts); j++) {
+			expect_count(counts[j][0], counts[j][i]);
+		}
+
+		/* Creating the relay buffer does not change the count, only
+		 * the Relay Retransmit state is adapted.
+		 */
+		relay_bufs[i] = adv_create(BT_MESH_RELAY_ADV, XMIT(4));
+		zassert_equal(BT_MESH_ADV(relay_bufs[i])->xmit, XMIT(4));
+	}
+
+	/* Freed relay buffers restore the count */
+	for (int i = 0; i < 2; i++) {
+		net_buf_unref(relay_bufs[i]);
+		relay_bufs[i] = NULL;
+	}
+
+	expect_count(4, 1);
+
+	for (int i = 2; i < ARRAY_SIZE(relay_bufs); i++) {
+		net_buf_unref(relay_bufs[i]);
+		relay_bufs[i] = NULL;
+	}
+
+	expect_count(4, 4);
+}
+
+ZTEST(bt_mesh_adv, test_main_set_alternation)
+{
+	/* After a local message, the relay queue is checked first */
+	adv_send(BT_MESH_LOCAL_ADV);
+	expect_buf_get(BT_MESH_LOCAL_ADV);
+
+	adv_send(BT_MESH_LOCAL_ADV);
+	adv_send(BT_MESH_LOCAL_ADV);
+	adv_send(BT_MESH_LOCAL_ADV);
+	adv_send(BT_MESH_RELAY_ADV);
+	adv_send(BT_MESH_RELAY_ADV);
+
+	/* The two queues take turns */
+	expect_buf_get(BT_MESH_RELAY_ADV);
+	expect_buf_get(BT_MESH_LOCAL_ADV);
+	expect_buf_get(BT_MESH_RELAY_ADV);
+	expect_buf_get(BT_MESH_LOCAL_ADV);
+
+	/* An empty queue does not hold back the other one */
+	expect_buf_get(BT_MESH_LOCAL_ADV);
+
+	adv_send(BT_MESH_RELAY_ADV);
+	adv_send(BT_MESH_RELAY_ADV);
+	expect_buf_get(BT_MESH_RELAY_ADV);
+	expect_buf_get(BT_MESH_RELAY_ADV);
+
+	/* After a relayed message, the local queue is checked first */
+	adv_send(BT_MESH_RELAY_ADV);
+	adv_send(BT_MESH_LOCAL_ADV);
+	expect_buf_get(BT_MESH_LOCAL_ADV);
+	expect_buf_get(BT_MESH_RELAY_ADV);
+
+	zassert_is_null(bt_mesh_adv_buf_get(K_NO_WAIT));
+}
+
+ZTEST_SUITE(bt_mesh_adv, NULL, NULL, NULL, cleanup, NULL);
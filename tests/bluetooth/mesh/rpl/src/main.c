@@ -469,3 +469,43 @@ ZTEST(bt_mesh_rpl_reset, test_rpl_check_on_save_new_entry)
 	zassert_true(bt_mesh_rpl_check(&msg, NULL));
 	check_empty_entries(EMPTY_ENTRIES_CNT - 1);
 }
+
+/** Test that entries are found by source address when the RPL is full. */
+ZTEST(bt_mesh_rpl_reset, test_rpl_check_full)
+{
+	struct bt_mesh_net_rx msg = {
+		.local_match = true,
+		.old_iv = false,
+	};
+
+	/* Fill RPL with scattered source addresses. */
+	for (int i = 0; i < CONFIG_BT_MESH_CRPL; i++) {
+		msg.ctx.addr = 0x0100 + i * 0x2b;
+		msg.seq = 100 + i;
+
+		ztest_expect_value(bt_mesh_settings_store_schedule, flag,
+				   BT_MESH_SETTINGS_RPL_PENDING);
+		zassert_false(bt_mesh_rpl_check(&msg, NULL));
+	}
+
+	for (int i = CONFIG_BT_MESH_CRPL - 1; i >= 0; i--) {
+		msg.ctx.addr = 0x0100 + i * 0x2b;
+
+		/* Replayed and older messages are rejected. */
+		msg.seq = 100 + i;
+		zassert_true(bt_mesh_rpl_check(&msg, NULL));
+		msg.seq = 99 + i;
+		zassert_true(bt_mesh_rpl_check(&msg, NULL));
+
+		/* Newer messages are accepted. */
+		msg.seq = 101 + i;
+		ztest_expect_value(bt_mesh_settings_store_schedule, flag,
+				   BT_MESH_SETTINGS_RPL_PENDING);
+		zassert_false(bt_mesh_rpl_check(&msg, NULL));
+	}
+
+	/* No room for a new source address. */
+	msg.ctx.addr = 0x0042;
+	msg.seq = 1;
+	zassert_true(bt_mesh_rpl_check(&msg, NULL));
+}
@@ -0,0 +1,107 @@
+/*
+ * Copyright The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/ztest.h>
+#include <zephyr/bluetooth/mesh.h>
+
+#include "keys.h"
+#include "net.h"
+#include "subnet.h"
+#include "foundation.h"
+
+#define NET_IDX 0x123
+
+static const uint8_t net_key[16] = {
+	0x7d, 0xd7, 0x36, 0x4c, 0xd8, 0x42, 0xad, 0x18,
+	0xc1, 0x7c, 0x2b, 0x82, 0x0c, 0x84, 0xc3, 0xd6,
+};
+
+static const uint8_t net_key_new[16] = {
+	0xf7, 0xa2, 0xa4, 0x4f, 0x8e, 0x8a, 0x80, 0x21,
+	0x06, 0x4f, 0x17, 0x3d, 0xdc, 0x1a, 0x9b, 0x0a,
+};
+
+static uint8_t nid_get(int idx)
+{
+	struct bt_mesh_subnet *sub = bt_mesh_subnet_get(NET_IDX);
+
+	zassert_not_null(sub, "subnet not found");
+	zassert_true(sub->keys[idx].valid, "key %d not valid", idx);
+
+	return sub->keys[idx].msg.nid;
+}
+
+static void subnet_cleanup(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	bt_mesh_net_keys_reset();
+}
+
+ZTEST(bt_mesh_subnet, test_nid_add_del)
+{
+	uint8_t nid;
+
+	/* Build the map before the subnet exists */
+	for (int i = 0; i < 0x80; i++) {
+		zassert_false(bt_mesh_net_cred_nid_known(i), "NID 0x%02x known", i);
+	}
+
+	zassert_equal(bt_mesh_subnet_add(NET_IDX, net_key), STATUS_SUCCESS);
+
+	nid = nid_get(0);
+	zassert_true(bt_mesh_net_cred_nid_known(nid), "NID of new subnet unknown");
+
+	/* Only the NID of the subnet is known */
+	for (int i = 0; i < 0x80; i++) {
+		zassert_equal(bt_mesh_net_cred_nid_known(i), i == nid, "NID 0x%02x", i);
+	}
+
+	zassert_equal(bt_mesh_subnet_del(NET_IDX), STATUS_SUCCESS);
+	zassert_false(bt_mesh_net_cred_nid_known(nid), "NID of deleted subnet known");
+}
+
+ZTEST(bt_mesh_subnet, test_nid_key_refresh)
+{
+	uint8_t phase = BT_MESH_KR_PHASE_3;
+	uint8_t nid_old;
+	uint8_t nid_new;
+
+	zassert_equal(bt_mesh_subnet_add(NET_IDX, net_key), STATUS_SUCCESS);
+	nid_old = nid_get(0);
+	zassert_true(bt_mesh_net_cred_nid_known(nid_old));
+
+	/* Both keys are in use during the key refresh */
+	zassert_equal(bt_mesh_subnet_update(NET_IDX, net_key_new), STATUS_SUCCESS);
+	nid_new = nid_get(1);
+	zassert_not_equal(nid_old, nid_new, "test keys have the same NID");
+	zassert_true(bt_mesh_net_cred_nid_known(nid_old), "old NID unknown");
+	zassert_true(bt_mesh_net_cred_nid_known(nid_new), "new NID unknown");
+
+	/* Revoking the old key forgets its NID */
+	zassert_equal(bt_mesh_subnet_kr_phase_set(NET_IDX, &phase), STATUS_SUCCESS);
+	zassert_equal(phase, BT_MESH_KR_NORMAL);
+	zassert_equal(nid_get(0), nid_new);
+	zassert_false(bt_mesh_net_cred_nid_known(nid_old), "revoked NID known");
+	zassert_true(bt_mesh_net_cred_nid_known(nid_new), "new NID unknown");
+}
+
+ZTEST(bt_mesh_subnet, test_nid_set)
+{
+	struct bt_mesh_key key;
+	uint8_t nid;
+
+	zassert_false(bt_mesh_net_cred_nid_known(0));
+
+	/* Subnets restored from the settings */
+	zassert_ok(bt_mesh_key_import(BT_MESH_KEY_TYPE_NET, net_key, &key));
+	zassert_ok(bt_mesh_subnet_set(NET_IDX, BT_MESH_KR_NORMAL, &key, NULL));
+
+	nid = nid_get(0);
+	zassert_true(bt_mesh_net_cred_nid_known(nid), "NID of restored subnet unknown");
+}
+
+ZTEST_SUITE(bt_mesh_subnet, NULL, NULL, NULL, subnet_cleanup, NULL);
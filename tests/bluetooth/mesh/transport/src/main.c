@@ -0,0 +1,190 @@
+/*
+ * Copyright The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+
+#include <zephyr/ztest.h>
+#include <zephyr/bluetooth/mesh.h>
+
+#include "net.h"
+#include "rpl.h"
+#include "subnet.h"
+#include "transport.h"
+#include "foundation.h"
+
+#define NET_IDX   0x000
+#define GROUP     0xc000
+#define SRC_A     0x0100
+#define SRC_B     0x0200
+
+/* A control OpCode nobody handles. A segmented message with it is handed to
+ * the control layer once complete, which rejects it.
+ */
+#define CTL_OP    0x3f
+
+#if defined(CONFIG_BT_MESH_V1d1)
+#define CTL_OP_UNHANDLED -EBADMSG
+#else
+#define CTL_OP_UNHANDLED -ENOENT
+#endif
+
+static const uint8_t net_key[16] = {
+	0x7d, 0xd7, 0x36, 0x4c, 0xd8, 0x42, 0xad, 0x18,
+	0xc1, 0x7c, 0x2b, 0x82, 0x0c, 0x84, 0xc3, 0xd6,
+};
+
+/* Segmented control message from a peer, sent to a group so that no
+ * Segment Acknowledgments are sent for it.
+ */
+struct seg_msg {
+	uint16_t src;
+	uint32_t seq_zero;
+	uint8_t seg_n;
+};
+
+static uint32_t seq = 1;
+
+static void seg_msg_init(struct seg_msg *msg, uint16_t src, uint8_t seg_n)
+{
+	msg->src = src;
+	msg->seq_zero = seq;
+	msg->seg_n = seg_n;
+
+	seq += seg_n + 1;
+}
+
+/* Receive segment seg_o of the message the way the network layer passes it */
+static int seg_recv(const struct seg_msg *msg, uint8_t seg_o)
+{
+	struct bt_mesh_net_rx rx = {
+		.sub = bt_mesh_subnet_get(NET_IDX),
+		.ctx = {
+			.net_idx = NET_IDX,
+			.app_idx = BT_MESH_KEY_UNUSED,
+			.addr = msg->src,
+			.recv_dst = GROUP,
+		},
+		.seq = msg->seq_zero + seg_o,
+		.ctl = 1,
+		.net_if = BT_MESH_NET_IF_ADV,
+		.local_match = 1,
+	};
+
+	NET_BUF_SIMPLE_DEFINE(buf, BT_MESH_NET_MAX_PDU_LEN);
+
+	/* Network header, removed by the transport layer */
+	memset(net_buf_simple_add(&buf, BT_MESH_NET_HDR_LEN), 0, BT_MESH_NET_HDR_LEN);
+
+	net_buf_simple_add_u8(&buf, TRANS_CTL_HDR(CTL_OP, 1));
+	net_buf_simple_add_be16(&buf, ((msg->seq_zero & TRANS_SEQ_ZERO_MASK) << 2) |
+				      (seg_o >> 3));
+	net_buf_simple_add_u8(&buf, ((seg_o & 0x07) << 5) | msg->seg_n);
+	memset(net_buf_simple_add(&buf, BT_MESH_CTL_SEG_SDU_MAX), seg_o,
+	       BT_MESH_CTL_SEG_SDU_MAX);
+
+	return bt_mesh_trans_recv(&buf, &rx);
+}
+
+static void seg_recv_partial(const struct seg_msg *msg, uint8_t seg_o)
+{
+	zassert_ok(seg_recv(msg, seg_o), "Seg %u from 0x%04x not received", seg_o, msg->src);
+}
+
+static void seg_recv_complete(const struct seg_msg *msg, uint8_t seg_o)
+{
+	zassert_equal(seg_recv(msg, seg_o), CTL_OP_UNHANDLED, "SDU from 0x%04x not complete",
+		      msg->src);
+}
+
+static void *setup(void)
+{
+	bt_mesh_trans_init();
+	zassert_equal(bt_mesh_subnet_add(NET_IDX, net_key), STATUS_SUCCESS);
+
+	return NULL;
+}
+
+static void cleanup(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	bt_mesh_rx_reset();
+}
+
+ZTEST(bt_mesh_transport, test_parallel_rx)
+{
+	struct seg_msg a, b;
+
+	/* 2 x 3 segments fit in the pool of 6 */
+	seg_msg_init(&a, SRC_A, 2);
+	seg_msg_init(&b, SRC_B, 2);
+
+	seg_recv_partial(&a, 0);
+	seg_recv_partial(&b, 2);
+	seg_recv_partial(&a, 1);
+	seg_recv_partial(&b, 0);
+	seg_recv_complete(&a, 2);
+	seg_recv_complete(&b, 1);
+
+	/* The segments of both are back in the pool */
+	seg_msg_init(&a, SRC_A, 2);
+	seg_msg_init(&b, SRC_B, 2);
+
+	seg_recv_partial(&b, 0);
+	seg_recv_partial(&a, 0);
+	seg_recv_partial(&b, 1);
+	seg_recv_partial(&a, 1);
+	seg_recv_complete(&b, 2);
+	seg_recv_complete(&a, 2);
+}
+
+ZTEST(bt_mesh_transport, test_rx_no_room)
+{
+	struct seg_msg a, b;
+
+	seg_msg_init(&a, SRC_A, 3);
+	seg_recv_partial(&a, 0);
+
+	/* 5 blocks are free, but 3 of them are needed to complete the first
+	 * session, so a message of 4 segments is not accepted even though
+	 * there is an RX context for it.
+	 */
+	seg_msg_init(&b, SRC_B, 3);
+	zassert_equal(seg_recv(&b, 0), -ENOMEM, "Session without room accepted");
+	zassert_equal(seg_recv(&b, 1), -ENOMEM, "Session without room accepted");
+
+	/* The first session is not starved by the rejected one */
+	seg_recv_partial(&a, 1);
+	seg_recv_partial(&a, 2);
+	seg_recv_complete(&a, 3);
+
+	/* The sender retransmits once there is room */
+	seg_recv_partial(&b, 0);
+	seg_recv_partial(&b, 1);
+	seg_recv_partial(&b, 2);
+	seg_recv_complete(&b, 3);
+}
+
+ZTEST(bt_mesh_transport, test_rx_exact_fit)
+{
+	struct seg_msg a, b;
+
+	seg_msg_init(&a, SRC_A, 3);
+	seg_recv_partial(&a, 0);
+
+	/* 3 segments still missing for the first session leave room for
+	 * exactly 2 more.
+	 */
+	seg_msg_init(&b, SRC_B, 1);
+	seg_recv_partial(&b, 1);
+
+	seg_recv_partial(&a, 3);
+	seg_recv_partial(&a, 2);
+	seg_recv_complete(&b, 0);
+	seg_recv_complete(&a, 1);
+}
+
+ZTEST_SUITE(bt_mesh_transport, NULL, setup, NULL, cleanup, NULL);
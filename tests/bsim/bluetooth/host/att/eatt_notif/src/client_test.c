@@ -161,6 +161,30 @@ static void gatt_discover(void)
 	}
 }
 
+#if defined(CONFIG_BT_ATT_TX_STATS)
+static void check_tx_stats(void)
+{
+	struct bt_att_tx_stats stats;
+	int err;
+
+	for (int i = 0; i < BT_ATT_TX_CLASS_NUM; i++) {
+		err = bt_att_tx_stats_get(g_conn, i, &stats);
+		if (err != 0) {
+			FAIL("Failed to get ATT TX stats (err %d)\n", err);
+			return;
+		}
+
+		printk("ATT TX class %d: sent %u, queued max %u, latency avg %u ms max %u ms\n",
+		       i, stats.sent, stats.queued_max, stats.latency_avg_ms,
+		       stats.latency_max_ms);
+
+		if (stats.sent == 0) {
+			FAIL("No PDU sent in ATT TX class %d\n", i);
+		}
+	}
+}
+#endif /* CONFIG_BT_ATT_TX_STATS */
+
 BT_GATT_SERVICE_DEFINE(g_svc,
 	BT_GATT_PRIMARY_SERVICE(TEST_SERVICE_UUID),
 	BT_GATT_CHARACTERISTIC(TEST_CHRC_UUID, BT_GATT_CHRC_NOTIFY,
@@ -242,6 +266,10 @@ static void test_main(void)
 		send_notification();
 	}
 
+#if defined(CONFIG_BT_ATT_TX_STATS)
+	check_tx_stats();
+#endif /* CONFIG_BT_ATT_TX_STATS */
+
 	printk("Sending final sync\n");
 	device_sync_send();
 
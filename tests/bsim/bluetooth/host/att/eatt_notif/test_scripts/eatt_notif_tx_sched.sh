@@ -0,0 +1,25 @@
+#!/usr/bin/env bash
+# Copyright The Zephyr Project Contributors
+# SPDX-License-Identifier: Apache-2.0
+
+# EATT notification reliability test, with the ATT TX scheduler and its
+# statistics
+
+source ${ZEPHYR_BASE}/tests/bsim/sh_common.source
+
+simulation_id="eatt_notif_tx_sched"
+verbosity_level=2
+EXECUTE_TIMEOUT=120
+
+cd ${BSIM_OUT_PATH}/bin
+
+Execute ./bs_${BOARD}_tests_bsim_bluetooth_host_att_eatt_notif_prj_conf_overlay_tx_sched_conf \
+  -v=${verbosity_level} -s=${simulation_id} -d=0 -testid=client
+
+Execute ./bs_${BOARD}_tests_bsim_bluetooth_host_att_eatt_notif_prj_conf_overlay_tx_sched_conf \
+  -v=${verbosity_level} -s=${simulation_id} -d=1 -testid=server
+
+Execute ./bs_2G4_phy_v1 -v=${verbosity_level} -s=${simulation_id} \
+  -D=2 -sim_length=60e6 $@
+
+wait_for_background_jobs
@@ -32,6 +32,7 @@ app=tests/bsim/bluetooth/host/att/eatt conf_file=prj_collision.conf compile
 app=tests/bsim/bluetooth/host/att/eatt conf_file=prj_multiple_conn.conf compile
 app=tests/bsim/bluetooth/host/att/eatt conf_file=prj_autoconnect.conf compile
 app=tests/bsim/bluetooth/host/att/eatt_notif conf_file=prj.conf compile
+app=tests/bsim/bluetooth/host/att/eatt_notif conf_overlay=overlay_tx_sched.conf compile
 app=tests/bsim/bluetooth/host/att/mtu_update compile
 app=tests/bsim/bluetooth/host/att/read_fill_buf/client compile
 app=tests/bsim/bluetooth/host/att/read_fill_buf/server compile
@@ -42,6 +43,7 @@ app=tests/bsim/bluetooth/host/gatt/caching compile
 app=tests/bsim/bluetooth/host/gatt/general compile
 app=tests/bsim/bluetooth/host/gatt/notify compile
 app=tests/bsim/bluetooth/host/gatt/notify_multiple compile
+app=tests/bsim/bluetooth/host/gatt/notify_multiple conf_overlay=overlay_multi_peer.conf compile
 app=tests/bsim/bluetooth/host/gatt/settings compile
 app=tests/bsim/bluetooth/host/gatt/settings conf_file=prj_2.conf compile
 app=tests/bsim/bluetooth/host/gatt/ccc_store compile
@@ -53,6 +55,7 @@ app=tests/bsim/bluetooth/host/iso/cis compile
 app=tests/bsim/bluetooth/host/l2cap/general compile
 app=tests/bsim/bluetooth/host/l2cap/userdata compile
 app=tests/bsim/bluetooth/host/l2cap/stress compile
+app=tests/bsim/bluetooth/host/l2cap/stress conf_overlay=overlay_tx_batch.conf compile
 app=tests/bsim/bluetooth/host/l2cap/split/dut compile
 app=tests/bsim/bluetooth/host/l2cap/split/tester compile
 app=tests/bsim/bluetooth/host/l2cap/credits compile
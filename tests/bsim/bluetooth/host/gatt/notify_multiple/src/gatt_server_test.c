@@ -13,6 +13,7 @@ CREATE_FLAG(flag_short_subscribe);
 CREATE_FLAG(flag_long_subscribe);
 
 static struct bt_conn *g_conn;
+static atomic_t num_connected;
 
 #define ARRAY_ITEM(i, _) i
 const uint8_t chrc_data[] = { LISTIFY(CHRC_SIZE, ARRAY_ITEM, (,)) }; /* 1, 2, 3 ... */
@@ -32,6 +33,7 @@ static void connected(struct bt_conn *conn, uint8_t err)
 	printk("Connected to %s\n", addr);
 
 	g_conn = bt_conn_ref(conn);
+	atomic_inc(&num_connected);
 	SET_FLAG(flag_is_connected);
 }
 
@@ -93,6 +95,10 @@ BT_GATT_SERVICE_DEFINE(test_svc, BT_GATT_PRIMARY_SERVICE(TEST_SERVICE_UUID),
 
 static volatile size_t num_notifications_sent;
 
+/* Peers of the gatt_server_all_peers test */
+#define NUM_PEERS 2
+static size_t num_subscribed;
+
 static void notification_sent(struct bt_conn *conn, void *user_data)
 {
 	printk("Sent notification #%u\n", num_notifications_sent++);
@@ -179,6 +185,117 @@ static void test_main(void)
 	PASS("GATT server passed\n");
 }
 
+/* Notify all the subscribed peers at once. A failure with one peer does
+ * not keep the others from being notified, so the call is not retried:
+ * the peers that were notified would get the values twice. Waiting for the
+ * values to be sent before the next call keeps the buffers available.
+ */
+static void notify_all(const struct bt_gatt_attr *attrs[2], size_t expected_sent)
+{
+	int err;
+	static struct bt_gatt_notify_params params[] = {
+		{
+			.data = long_chrc_data,
+			.len = LONG_CHRC_SIZE,
+			.func = notification_sent,
+			.uuid = NULL,
+		},
+		{
+			.data = chrc_data,
+			.len = CHRC_SIZE,
+			.func = notification_sent,
+			.uuid = NULL,
+		},
+	};
+	params[0].attr = attrs[0];
+	params[1].attr = attrs[1];
+
+	err = bt_gatt_notify_multiple(NULL, ARRAY_SIZE(params), params);
+	if (err) {
+		FAIL("multiple notify to all peers failed (err %d)\n", err);
+		return;
+	}
+
+	while (num_notifications_sent < expected_sent) {
+		k_sleep(K_MSEC(10));
+	}
+}
+
+static void count_subscribed(struct bt_conn *conn, void *user_data)
+{
+	const struct bt_gatt_attr **attrs = user_data;
+	struct bt_conn_info info;
+
+	if (bt_conn_get_info(conn, &info) != 0 || info.state != BT_CONN_STATE_CONNECTED) {
+		return;
+	}
+
+	if (bt_gatt_is_subscribed(conn, attrs[0], BT_GATT_CCC_NOTIFY) &&
+	    bt_gatt_is_subscribed(conn, attrs[1], BT_GATT_CCC_NOTIFY)) {
+		num_subscribed++;
+	}
+}
+
+static void test_main_all_peers(void)
+{
+	int err;
+	const struct bt_gatt_attr *attrs[2];
+	const struct bt_data ad[] = {
+		BT_DATA_BYTES(BT_DATA_FLAGS, (BT_LE_AD_GENERAL | BT_LE_AD_NO_BREDR)),
+	};
+
+	err = bt_enable(NULL);
+	if (err != 0) {
+		FAIL("Bluetooth init failed (err %d)\n", err);
+		return;
+	}
+
+	printk("Bluetooth initialized\n");
+
+	/* Advertising stops on each connection */
+	while (atomic_get(&num_connected) < NUM_PEERS) {
+		atomic_val_t prev = atomic_get(&num_connected);
+
+		err = bt_le_adv_start(BT_LE_ADV_CONN_NAME, ad, ARRAY_SIZE(ad), NULL, 0);
+		if (err != 0) {
+			FAIL("Advertising failed to start (err %d)\n", err);
+			return;
+		}
+
+		printk("Advertising successfully started\n");
+
+		while (atomic_get(&num_connected) == prev) {
+			k_sleep(K_MSEC(1));
+		}
+	}
+
+	/* Long characteristic [attr=value] */
+	attrs[0] = bt_gatt_find_by_uuid(NULL, 0, TEST_LONG_CHRC_UUID);
+	/* Short characteristic [attr=descriptor] */
+	attrs[1] = &attr_test_svc[1];
+
+	do {
+		k_sleep(K_MSEC(10));
+		num_subscribed = 0;
+		bt_conn_foreach(BT_CONN_TYPE_LE, count_subscribed, attrs);
+	} while (num_subscribed < NUM_PEERS);
+
+	printk("All peers subscribed\n");
+
+	/* Each peer gets both values of each call */
+	for (int i = 0; i < NOTIFICATION_COUNT / 2; i++) {
+		notify_all(attrs, (i + 1) * 2 * NUM_PEERS);
+	}
+
+	k_sleep(K_MSEC(1000));
+
+	if (num_notifications_sent != NOTIFICATION_COUNT * NUM_PEERS) {
+		FAIL("Unexpected notification callback value\n");
+	}
+
+	PASS("GATT server passed\n");
+}
+
 static const struct bst_test_instance test_gatt_server[] = {
 	{
 		.test_id = "gatt_server",
@@ -186,6 +303,14 @@ static const struct bst_test_instance test_gatt_server[] = {
 		.test_tick_f = test_tick,
 		.test_main_f = test_main,
 	},
+	{
+		.test_id = "gatt_server_all_peers",
+		.test_descr = "Notify all the subscribed peers at once. Needs "
+			      "overlay_multi_peer.conf and two gatt_client devices",
+		.test_post_init_f = test_init,
+		.test_tick_f = test_tick,
+		.test_main_f = test_main_all_peers,
+	},
 	BSTEST_END_MARKER,
 };
 
@@ -0,0 +1,27 @@
+#!/usr/bin/env bash
+# Copyright The Zephyr Project Contributors
+# SPDX-License-Identifier: Apache-2.0
+set -eu
+
+source ${ZEPHYR_BASE}/tests/bsim/sh_common.source
+
+# Multiple notifications sent to all the subscribed peers at once
+simulation_id="notify_multiple_all_peers"
+verbosity_level=2
+EXECUTE_TIMEOUT=120
+
+cd ${BSIM_OUT_PATH}/bin
+
+bsim_exe=./bs_${BOARD}_tests_bsim_bluetooth_host_gatt_notify_multiple_prj_conf_overlay_multi_peer_conf
+
+Execute "${bsim_exe}" -v=${verbosity_level} -s=${simulation_id} -d=0 -testid=gatt_client -rs=1
+
+Execute "${bsim_exe}" -v=${verbosity_level} -s=${simulation_id} -d=1 -testid=gatt_client -rs=2
+
+Execute "${bsim_exe}" -v=${verbosity_level} -s=${simulation_id} -d=2 -testid=gatt_server_all_peers \
+  -rs=3
+
+Execute ./bs_2G4_phy_v1 -v=${verbosity_level} -s=${simulation_id} \
+  -D=3 -sim_length=60e6 $@
+
+wait_for_background_jobs
@@ -435,6 +435,8 @@ static void test_central_main(void)
 	bt_conn_foreach(BT_CONN_TYPE_LE, connect_l2cap_channel, NULL);
 
 	/* Send SDU_NUM SDUs to each peripheral */
+	int64_t start = k_uptime_get();
+
 	for (int i = 0; i < NUM_PERIPHERALS; i++) {
 		contexts[i].tx_left = SDU_NUM;
 		l2cap_chan_send(&contexts[i].le_chan.chan, tx_data, sizeof(tx_data));
@@ -452,6 +454,12 @@ static void test_central_main(void)
 		}
 	} while (remaining_tx_total);
 
+	int64_t elapsed = MAX(k_uptime_get() - start, 1);
+
+	LOG_INF("Sent %d bytes in %lld ms (%lld bytes/s)",
+		NUM_PERIPHERALS * SDU_NUM * SDU_LEN, elapsed,
+		(int64_t)NUM_PERIPHERALS * SDU_NUM * SDU_LEN * MSEC_PER_SEC / elapsed);
+
 	LOG_DBG("Waiting until all peripherals are disconnected..");
 	while (disconnect_counter < NUM_PERIPHERALS) {
 		k_msleep(100);
@@ -29,6 +29,7 @@ app=tests/bsim/bluetooth/mesh \
 app=tests/bsim/bluetooth/mesh \
   conf_file=prj_mesh1d1.conf conf_overlay=overlay_low_lat.conf compile
 app=tests/bsim/bluetooth/mesh conf_file=prj_mesh1d1.conf conf_overlay=overlay_psa.conf compile
+app=tests/bsim/bluetooth/mesh conf_file=prj_mesh1d1.conf conf_overlay=overlay_rx_seg.conf compile
 app=tests/bsim/bluetooth/mesh \
   conf_file=prj_mesh1d1.conf conf_overlay="overlay_pst.conf;overlay_psa.conf" compile
 app=tests/bsim/bluetooth/mesh \
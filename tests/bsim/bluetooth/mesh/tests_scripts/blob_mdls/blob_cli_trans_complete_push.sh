@@ -15,3 +15,11 @@ overlay=overlay_psa_conf
 RunTest blob_success_push_psa blob_cli_trans_complete \
 	blob_srv_trans_complete blob_srv_trans_complete \
 	blob_srv_trans_complete blob_srv_trans_complete
+
+# Test that the transfer completes when the Target nodes answer the Initiator
+# in parallel with more segmented messages than it has RX contexts for
+conf=prj_mesh1d1_conf
+overlay=overlay_rx_seg_conf
+RunTest blob_success_push_rx_seg blob_cli_trans_complete \
+	blob_srv_trans_complete blob_srv_trans_complete \
+	blob_srv_trans_complete blob_srv_trans_complete
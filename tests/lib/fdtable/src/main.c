@@ -175,4 +175,67 @@ ZTEST(fdtable, test_z_fd_multiple_access)
 	zassert_equal(errno, EBADF, "fd was found");
 }
 
+ZTEST(fdtable, test_z_lock_fd)
+{
+	const struct fd_op_vtable *vtable;
+	struct k_mutex *lock;
+	void *obj;
+
+	int fd = z_reserve_fd();
+	zassert_true(fd >= 0, "fd < 0");
+
+	/* Reserved but not finalized yet */
+	zassert_equal(z_lock_fd(fd, &obj, &vtable, NULL), -1);
+	zassert_equal(errno, EBADF, "fd was found");
+
+	z_finalize_fd(fd, VTABLE_INIT, VTABLE_INIT);
+
+	/* function being tested */
+	zassert_equal(z_lock_fd(fd, &obj, &vtable, &lock), 0);
+	zassert_equal_ptr(obj, VTABLE_INIT, "wrong object");
+	zassert_equal_ptr(vtable, VTABLE_INIT, "wrong vtable");
+	zassert_equal_ptr(lock->owner, k_current_get(), "lock not taken");
+
+	z_unlock_fd(fd); /* function being tested */
+	zassert_is_null(lock->owner, "lock still taken");
+
+	z_free_fd(fd);
+
+	zassert_equal(z_lock_fd(fd, &obj, &vtable, NULL), -1);
+	zassert_equal(errno, EBADF, "fd was found");
+	zassert_equal(z_lock_fd(-1, &obj, &vtable, NULL), -1);
+	zassert_equal(errno, EBADF, "fd was found");
+}
+
+ZTEST(fdtable, test_z_free_fd_while_locked)
+{
+	const struct fd_op_vtable *vtable;
+	void *obj;
+	int fd2;
+
+	int fd = z_alloc_fd(VTABLE_INIT, VTABLE_INIT);
+	zassert_true(fd >= 0, "fd < 0");
+
+	zassert_equal(z_lock_fd(fd, &obj, &vtable, NULL), 0);
+
+	/* Closing detaches the object right away... */
+	z_free_fd(fd);
+
+	obj = z_get_fd_obj_and_vtable(fd, &vtable, NULL);
+	zassert_is_null(obj, "obj is still there");
+
+	/* ...but the entry is not reused while still locked */
+	fd2 = z_reserve_fd();
+	zassert_true(fd2 >= 0, "fd < 0");
+	zassert_not_equal(fd2, fd, "locked fd was reused");
+	z_free_fd(fd2);
+
+	z_unlock_fd(fd);
+
+	/* Now it is free */
+	fd2 = z_reserve_fd();
+	zassert_equal(fd2, fd, "fd was not released");
+	z_free_fd(fd2);
+}
+
 ZTEST_SUITE(fdtable, NULL, NULL, NULL, NULL, NULL);
@@ -0,0 +1,149 @@
+/*
+ * Copyright The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdlib.h>
+
+#include <zephyr/ztest.h>
+#include <zephyr/random/random.h>
+
+#include "gptp_servo.h"
+
+#define SYNC_INTERVAL_NS (NSEC_PER_SEC / 8)
+#define STEP_THRESHOLD_NS 5000
+
+/* Simulated local PTP clock driven by the servo, the master clock is
+ * perfect and the local oscillator has a constant frequency error.
+ */
+struct sim_clock {
+	double master;
+	double local;
+	double rate;
+	double freq_err;
+};
+
+static struct gptp_servo servo;
+
+static void sim_tick(struct sim_clock *clk)
+{
+	clk->master += SYNC_INTERVAL_NS;
+	clk->local += SYNC_INTERVAL_NS * (1.0 + clk->freq_err) * clk->rate;
+}
+
+/* Feed one sample to the servo the same way the gPTP stack does, step
+ * the clock if the offset is too large.
+ */
+static void sim_sync(struct sim_clock *clk, int64_t noise)
+{
+	int64_t offset = (int64_t)(clk->master - clk->local) + noise;
+
+	if (llabs(offset) > STEP_THRESHOLD_NS) {
+		clk->rate *= gptp_servo_step(&servo, offset, (uint64_t)clk->local);
+		clk->local = clk->master;
+		return;
+	}
+
+	clk->rate *= gptp_servo_sample(&servo, offset, (uint64_t)clk->local);
+}
+
+static int64_t sim_noise(int64_t range)
+{
+	return (int64_t)(sys_rand32_get() % (2 * range + 1)) - range;
+}
+
+static void before(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	gptp_servo_reset(&servo);
+}
+
+ZTEST(gptp_servo, test_frequency_lock)
+{
+	struct sim_clock clk = {
+		.local = 1000,
+		.rate = 1.0,
+		.freq_err = 30e-6,
+	};
+	struct gptp_servo_stats *stats = &servo.stats;
+
+	for (int i = 0; i < 200; i++) {
+		sim_tick(&clk);
+		sim_sync(&clk, sim_noise(20));
+	}
+
+	/* The servo has learned the 30 ppm oscillator error, apart from the
+	 * proportional correction of the measurement noise.
+	 */
+	zassert_within(stats->freq_adj, -30000, 500, "freq_adj %d", stats->freq_adj);
+
+	for (int i = 0; i < 100; i++) {
+		sim_tick(&clk);
+		sim_sync(&clk, sim_noise(20));
+
+		zassert_within(clk.master, clk.local, 200.0,
+			       "offset %d ns", (int)(clk.master - clk.local));
+	}
+
+	zassert_true(stats->steps > 0, "clock was never stepped");
+	zassert_equal(stats->outliers, 0);
+}
+
+ZTEST(gptp_servo, test_delayed_samples_rejected)
+{
+	struct sim_clock clk = {
+		.rate = 1.0,
+		.freq_err = -5e-6,
+	};
+	struct gptp_servo_stats *stats = &servo.stats;
+	int32_t freq_adj;
+
+	for (int i = 0; i < 200; i++) {
+		sim_tick(&clk);
+		sim_sync(&clk, sim_noise(20));
+	}
+
+	freq_adj = stats->freq_adj;
+
+	/* A single sample delayed by receive queueing must not disturb the
+	 * clock.
+	 */
+	sim_tick(&clk);
+	sim_sync(&clk, 4000);
+
+	zassert_equal(stats->outliers, 1);
+	zassert_equal(stats->freq_adj, freq_adj);
+
+	for (int i = 0; i < 20; i++) {
+		sim_tick(&clk);
+		sim_sync(&clk, sim_noise(20));
+
+		zassert_within(clk.master, clk.local, 200.0,
+			       "offset %d ns", (int)(clk.master - clk.local));
+	}
+}
+
+ZTEST(gptp_servo, test_histogram)
+{
+	uint32_t total = 0;
+
+	zassert_equal(gptp_servo_sample(&servo, 0, 1000), 1.0);
+	gptp_servo_sample(&servo, 2, 1000 + SYNC_INTERVAL_NS);
+	gptp_servo_sample(&servo, -1000000000, 1000 + 2 * SYNC_INTERVAL_NS);
+
+	zassert_equal(servo.stats.samples, 3);
+	zassert_equal(servo.stats.offset_hist[0], 1, "0 ns not in bucket 0");
+	zassert_equal(servo.stats.offset_hist[1], 1, "2 ns not in bucket 1");
+	zassert_equal(servo.stats.offset_hist[GPTP_SERVO_HIST_BUCKETS - 1], 1,
+		      "1 s not in the last bucket");
+
+	for (int i = 0; i < GPTP_SERVO_HIST_BUCKETS; i++) {
+		total += servo.stats.jitter_hist[i];
+	}
+
+	zassert_equal(total, 2, "first sample has no jitter");
+}
+
+ZTEST_SUITE(gptp_servo, NULL, NULL, before, NULL, NULL);
@@ -587,6 +587,59 @@ ZTEST(dns_packet, test_mdns_response)
 		      " at line %d", -rc);
 }
 
+/* mDNS query for _http._tcp.local PTR records, with a known answer for
+ * the "Zephyr" instance. Both names of the answer are compressed.
+ */
+static uint8_t query_known_answer[] = {
+	/* DNS msg header (12 bytes), 1 question, 1 answer */
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x01,
+	0x00, 0x00, 0x00, 0x00,
+
+	/* Question: _http._tcp.local PTR IN */
+	0x05, 0x5f, 0x68, 0x74, 0x74, 0x70, 0x04, 0x5f,
+	0x74, 0x63, 0x70, 0x05, 0x6c, 0x6f, 0x63, 0x61,
+	0x6c, 0x00, 0x00, 0x0c, 0x00, 0x01,
+
+	/* Answer: pointer to the question name, PTR IN, TTL 4500 */
+	0xc0, 0x0c, 0x00, 0x0c, 0x00, 0x01, 0x00, 0x00,
+	0x11, 0x94, 0x00, 0x09,
+
+	/* Zephyr + pointer to the question name */
+	0x06, 0x5a, 0x65, 0x70, 0x68, 0x79, 0x72, 0xc0,
+	0x0c,
+};
+
+ZTEST(dns_packet, test_mdns_known_answer)
+{
+	static const char * const service[] = { "_http", "_tcp", "local" };
+	static const char * const instance[] = { "zephyr", "_HTTP", "_tcp", "local" };
+	static const char * const other[] = { "zephyr", "_http", "_udp", "local" };
+	struct dns_msg_t dns_msg = DNS_MSG_INIT(query_known_answer,
+						sizeof(query_known_answer));
+	struct dns_rr_info rr;
+	int pos;
+
+	pos = dns_skip_question(&dns_msg, DNS_MSG_HEADER_SIZE);
+	zassert_equal(pos, 34, "Invalid question size (%d)", pos);
+
+	zassert_equal(dns_unpack_rr(&dns_msg, pos, &rr), sizeof(query_known_answer));
+	zassert_equal(rr.type, DNS_RR_TYPE_PTR);
+	zassert_equal(rr.class_, DNS_CLASS_IN);
+	zassert_equal(rr.ttl, 4500);
+	zassert_equal(rr.rdlength, 9);
+	zassert_equal(rr.rdata_pos, 46);
+
+	zassert_true(dns_name_equal(&dns_msg, rr.name_pos, service, ARRAY_SIZE(service)));
+	zassert_true(dns_name_equal(&dns_msg, rr.rdata_pos, instance, ARRAY_SIZE(instance)),
+		     "Names differing in case only must be equal");
+	zassert_false(dns_name_equal(&dns_msg, rr.rdata_pos, other, ARRAY_SIZE(other)));
+	zassert_false(dns_name_equal(&dns_msg, rr.rdata_pos, instance, 3));
+
+	/* Record data past the end of the message */
+	dns_msg.msg_size = sizeof(query_known_answer) - 1;
+	zassert_equal(dns_unpack_rr(&dns_msg, pos, &rr), -EINVAL);
+}
+
 static uint8_t resp_truncated_response_ipv4_1[] = {
 	/* DNS msg header (12 bytes) */
 	0xb0, 0x41, 0x81, 0x80, 0x00, 0x01, 0x00, 0x01,
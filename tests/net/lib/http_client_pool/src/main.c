@@ -0,0 +1,389 @@
+/*
+ * Copyright The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+
+#include <zephyr/ztest.h>
+#include <zephyr/net/socket.h>
+#include <zephyr/net/http/client.h>
+
+#define NUM_SERVERS 3
+#define MAX_CONNS 6
+#define TIMEOUT_MS 2000
+
+#define SERVER_STACK_SIZE 2048
+#define SERVER_PRIORITY K_PRIO_PREEMPT(8)
+
+#define RESPONSE "HTTP/1.1 200 OK\r\nContent-Length: 2\r\n\r\nok"
+#define BAD_RESPONSE "HTTP/1.1 200 OK\r\nContent-Length: x\r\n\r\nok"
+
+/* Minimal HTTP server answering every request with RESPONSE. The tests
+ * steer it to close connections at the points where the pool has to cope
+ * with it.
+ */
+static struct test_server {
+	int listen_fds[NUM_SERVERS];
+	uint16_t ports[NUM_SERVERS];
+	int conn_fds[MAX_CONNS];
+
+	/** Connections accepted per server */
+	atomic_t accepted[NUM_SERVERS];
+
+	/** Close the connection the next request arrives on, unanswered */
+	atomic_t drop_next;
+
+	/** Answer the next request with a response that cannot be parsed */
+	atomic_t bad_next;
+
+	/** Close all the open connections */
+	atomic_t close_idle;
+} server;
+
+static K_THREAD_STACK_DEFINE(server_stack, SERVER_STACK_SIZE);
+static struct k_thread server_thread;
+
+static struct {
+	int calls;
+	uint16_t status;
+	bool complete;
+} rsp;
+
+static uint8_t recv_buf[128];
+
+static void server_close_conns(void)
+{
+	for (int i = 0; i < MAX_CONNS; i++) {
+		if (server.conn_fds[i] >= 0) {
+			(void)zsock_close(server.conn_fds[i]);
+			server.conn_fds[i] = -1;
+		}
+	}
+}
+
+static void server_accept(int idx)
+{
+	int fd;
+
+	fd = zsock_accept(server.listen_fds[idx], NULL, NULL);
+	if (fd < 0) {
+		return;
+	}
+
+	atomic_inc(&server.accepted[idx]);
+
+	for (int i = 0; i < MAX_CONNS; i++) {
+		if (server.conn_fds[i] < 0) {
+			server.conn_fds[i] = fd;
+			return;
+		}
+	}
+
+	(void)zsock_close(fd);
+}
+
+static void server_recv(int i)
+{
+	static char buf[256];
+	int ret;
+
+	ret = zsock_recv(server.conn_fds[i], buf, sizeof(buf) - 1, 0);
+	if (ret <= 0) {
+		(void)zsock_close(server.conn_fds[i]);
+		server.conn_fds[i] = -1;
+		return;
+	}
+
+	buf[ret] = '\0';
+	if (strstr(buf, "\r\n\r\n") == NULL) {
+		return;
+	}
+
+	if (atomic_cas(&server.drop_next, 1, 0)) {
+		(void)zsock_close(server.conn_fds[i]);
+		server.conn_fds[i] = -1;
+		return;
+	}
+
+	if (atomic_cas(&server.bad_next, 1, 0)) {
+		(void)zsock_send(server.conn_fds[i], BAD_RESPONSE,
+				 sizeof(BAD_RESPONSE) - 1, 0);
+		return;
+	}
+
+	(void)zsock_send(server.conn_fds[i], RESPONSE, sizeof(RESPONSE) - 1, 0);
+}
+
+static void server_fn(void *p1, void *p2, void *p3)
+{
+	struct zsock_pollfd fds[NUM_SERVERS + MAX_CONNS];
+	int conn_idx[MAX_CONNS];
+	int nfds, nconns;
+
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	while (true) {
+		if (atomic_cas(&server.close_idle, 1, 0)) {
+			server_close_conns();
+		}
+
+		nfds = 0;
+		nconns = 0;
+
+		for (int i = 0; i < NUM_SERVERS; i++) {
+			fds[nfds].fd = server.listen_fds[i];
+			fds[nfds++].events = ZSOCK_POLLIN;
+		}
+
+		for (int i = 0; i < MAX_CONNS; i++) {
+			if (server.conn_fds[i] >= 0) {
+				conn_idx[nconns++] = i;
+				fds[nfds].fd = server.conn_fds[i];
+				fds[nfds++].events = ZSOCK_POLLIN;
+			}
+		}
+
+		if (zsock_poll(fds, nfds, 10) <= 0) {
+			continue;
+		}
+
+		for (int i = 0; i < NUM_SERVERS; i++) {
+			if (fds[i].revents & ZSOCK_POLLIN) {
+				server_accept(i);
+			}
+		}
+
+		for (int i = 0; i < nconns; i++) {
+			if (fds[NUM_SERVERS + i].revents) {
+				server_recv(conn_idx[i]);
+			}
+		}
+	}
+}
+
+static void response_cb(struct http_response *r, enum http_final_call final_data,
+			void *user_data)
+{
+	ARG_UNUSED(user_data);
+
+	if (final_data == HTTP_DATA_FINAL) {
+		rsp.calls++;
+		rsp.status = r->http_status_code;
+		rsp.complete = r->message_complete;
+	}
+}
+
+static void host_init(struct http_client_pool_host *host, int idx)
+{
+	memset(host, 0, sizeof(*host));
+
+	net_sin(&host->addr)->sin_family = AF_INET;
+	net_sin(&host->addr)->sin_port = htons(server.ports[idx]);
+	zassert_equal(zsock_inet_pton(AF_INET, "127.0.0.1",
+				      &net_sin(&host->addr)->sin_addr), 1);
+	host->addrlen = sizeof(struct sockaddr_in);
+	host->proto = IPPROTO_TCP;
+}
+
+static int pool_req(const struct http_client_pool_host *host,
+		    enum http_method method)
+{
+	struct http_request req = {
+		.method = method,
+		.url = "/",
+		.host = "127.0.0.1",
+		.protocol = "HTTP/1.1",
+		.response = response_cb,
+		.recv_buf = recv_buf,
+		.recv_buf_len = sizeof(recv_buf),
+	};
+
+	memset(&rsp, 0, sizeof(rsp));
+
+	return http_client_pool_req(host, &req, TIMEOUT_MS, NULL);
+}
+
+static void expect_ok(const struct http_client_pool_host *host)
+{
+	zassert_true(pool_req(host, HTTP_GET) > 0, "request failed");
+	zassert_equal(rsp.calls, 1, "response reported %d times", rsp.calls);
+	zassert_equal(rsp.status, 200, "unexpected status %d", rsp.status);
+	zassert_true(rsp.complete, "response not complete");
+
+	/* Make the last use times of the connections distinct. */
+	k_msleep(2);
+}
+
+static void *setup(void)
+{
+	struct sockaddr_in addr = {
+		.sin_family = AF_INET,
+	};
+	socklen_t addrlen;
+
+	zassert_equal(zsock_inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr), 1);
+
+	for (int i = 0; i < MAX_CONNS; i++) {
+		server.conn_fds[i] = -1;
+	}
+
+	for (int i = 0; i < NUM_SERVERS; i++) {
+		int fd = zsock_socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+
+		zassert_true(fd >= 0, "socket failed (%d)", errno);
+		zassert_ok(zsock_bind(fd, (struct sockaddr *)&addr, sizeof(addr)));
+		zassert_ok(zsock_listen(fd, 2));
+
+		addrlen = sizeof(addr);
+		zassert_ok(zsock_getsockname(fd, (struct sockaddr *)&addr, &addrlen));
+
+		server.listen_fds[i] = fd;
+		server.ports[i] = ntohs(addr.sin_port);
+		addr.sin_port = 0;
+	}
+
+	k_thread_create(&server_thread, server_stack,
+			K_THREAD_STACK_SIZEOF(server_stack), server_fn,
+			NULL, NULL, NULL, SERVER_PRIORITY, 0, K_NO_WAIT);
+
+	return NULL;
+}
+
+static void before(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	http_client_pool_close_all();
+	atomic_set(&server.close_idle, 1);
+	atomic_set(&server.drop_next, 0);
+	atomic_set(&server.bad_next, 0);
+	k_msleep(50);
+
+	for (int i = 0; i < NUM_SERVERS; i++) {
+		atomic_set(&server.accepted[i], 0);
+	}
+}
+
+ZTEST(http_client_pool, test_reuse)
+{
+	struct http_client_pool_host host;
+
+	host_init(&host, 0);
+
+	expect_ok(&host);
+	expect_ok(&host);
+	expect_ok(&host);
+
+	zassert_equal(atomic_get(&server.accepted[0]), 1,
+		      "connection not reused");
+}
+
+ZTEST(http_client_pool, test_stale)
+{
+	struct http_client_pool_host host;
+
+	host_init(&host, 0);
+
+	expect_ok(&host);
+
+	/* The server closes the idle connection, the pool notices it before
+	 * sending the next request.
+	 */
+	atomic_set(&server.close_idle, 1);
+	k_msleep(50);
+
+	expect_ok(&host);
+
+	zassert_equal(atomic_get(&server.accepted[0]), 2);
+}
+
+ZTEST(http_client_pool, test_retry_idempotent)
+{
+	struct http_client_pool_host host;
+
+	host_init(&host, 0);
+
+	expect_ok(&host);
+
+	/* The connection looks fine but the server closes it when the
+	 * request arrives. GET is sent again over a new connection and the
+	 * failed attempt is not reported.
+	 */
+	atomic_set(&server.drop_next, 1);
+
+	expect_ok(&host);
+
+	zassert_equal(atomic_get(&server.drop_next), 0);
+	zassert_equal(atomic_get(&server.accepted[0]), 2);
+}
+
+ZTEST(http_client_pool, test_no_retry_post)
+{
+	struct http_client_pool_host host;
+
+	host_init(&host, 0);
+
+	expect_ok(&host);
+
+	/* POST is not idempotent, it must not be sent twice. */
+	atomic_set(&server.drop_next, 1);
+
+	(void)pool_req(&host, HTTP_POST);
+
+	zassert_equal(atomic_get(&server.drop_next), 0);
+	zassert_not_equal(rsp.status, 200, "POST was sent again");
+	zassert_equal(atomic_get(&server.accepted[0]), 1, "POST was sent again");
+}
+
+ZTEST(http_client_pool, test_parse_error)
+{
+	struct http_client_pool_host host;
+	int ret;
+
+	host_init(&host, 0);
+
+	/* The error is returned and the callback gets the final data once,
+	 * without the response being complete.
+	 */
+	atomic_set(&server.bad_next, 1);
+
+	ret = pool_req(&host, HTTP_GET);
+	zassert_equal(ret, -EBADMSG, "parse error not returned (%d)", ret);
+	zassert_equal(rsp.calls, 1, "response reported %d times", rsp.calls);
+	zassert_false(rsp.complete, "failed response reported complete");
+
+	/* The connection is not reused after the error. */
+	expect_ok(&host);
+	zassert_equal(atomic_get(&server.accepted[0]), 2);
+}
+
+ZTEST(http_client_pool, test_eviction)
+{
+	struct http_client_pool_host hosts[NUM_SERVERS];
+
+	for (int i = 0; i < NUM_SERVERS; i++) {
+		host_init(&hosts[i], i);
+	}
+
+	/* The pool holds two connections, the third host evicts the least
+	 * recently used one.
+	 */
+	expect_ok(&hosts[0]);
+	expect_ok(&hosts[1]);
+	expect_ok(&hosts[2]);
+
+	expect_ok(&hosts[1]);
+	zassert_equal(atomic_get(&server.accepted[1]), 1, "connection not reused");
+
+	expect_ok(&hosts[0]);
+	zassert_equal(atomic_get(&server.accepted[0]), 2, "connection not evicted");
+
+	expect_ok(&hosts[2]);
+	zassert_equal(atomic_get(&server.accepted[2]), 2, "connection not evicted");
+}
+
+ZTEST_SUITE(http_client_pool, NULL, setup, before, NULL, NULL);
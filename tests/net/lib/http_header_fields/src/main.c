@@ -641,6 +641,52 @@ ZTEST(http_header_fields_fn, test_header_nread_value)
 			"http_parser error");
 }
 
+static size_t header_value_len;
+
+static int on_header_value_len(struct http_parser *parser, const char *at,
+			       size_t length)
+{
+	header_value_len += length;
+
+	return 0;
+}
+
+ZTEST(http_header_fields_fn, test_header_value_split)
+{
+	static const struct http_parser_settings settings_value = {
+		.on_header_value = on_header_value_len,
+	};
+	struct http_parser parser = { 0 };
+	const char *buf;
+	size_t buflen, split, parsed;
+
+	/* Long header values are scanned a word at a time, feed them in all
+	 * possible splits so that every alignment of the line end is hit.
+	 */
+	buf = "GET / HTTP/1.1\r\n"
+	      "X-Long: 0123456789abcdefghijklmnopqrstuvwxyz\r\n"
+	      "X-Lf: 0123456789abcdefghijklmnopqrstuvwxyz\n"
+	      "Content-Length: 3\r\n\r\nabc";
+	buflen = strlen(buf);
+
+	for (split = 1; split < buflen; split++) {
+		http_parser_init(&parser, HTTP_REQUEST);
+		header_value_len = 0;
+
+		parsed = http_parser_execute(&parser, &settings_value, buf, split);
+		zassert_equal(parsed, split, "http_parser error at split %zu", split);
+
+		parsed = http_parser_execute(&parser, &settings_value, buf + split,
+					     buflen - split);
+		zassert_equal(parsed, buflen - split, "http_parser error at split %zu",
+			      split);
+
+		zassert_equal(header_value_len, 36 + 36 + 1,
+			      "invalid header value length %zu at split %zu",
+			      header_value_len, split);
+	}
+}
+
 int test_invalid_header_content(int req, const char *str)
 {
 	struct http_parser parser = { 0 };
@@ -0,0 +1,294 @@
+/*
+ * Copyright The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+
+#include <zephyr/ztest.h>
+#include <zephyr/net/socket.h>
+#include <zephyr/net/http/server.h>
+
+#define RECV_TIMEOUT_MS 2000
+
+static const char index_html[] = "<html><body>Hello</body></html>";
+
+static struct http_resource_detail_static index_detail = {
+	.common = {
+		.bitmask_of_supported_http_methods = HTTP_METHOD_BIT(HTTP_GET),
+		.type = HTTP_RESOURCE_TYPE_STATIC,
+		.content_type = "text/html",
+	},
+	.static_data = index_html,
+	.static_data_len = sizeof(index_html) - 1,
+};
+
+#define BIG_DATA_LEN 4096
+
+static uint8_t big_data[BIG_DATA_LEN];
+
+static struct http_resource_detail_static big_detail = {
+	.common = {
+		.bitmask_of_supported_http_methods = HTTP_METHOD_BIT(HTTP_GET),
+		.type = HTTP_RESOURCE_TYPE_STATIC,
+		.content_type = "text/plain",
+	},
+	.static_data = big_data,
+	.static_data_len = sizeof(big_data),
+};
+
+static int echo_cb(const struct http_server_request *req, uint8_t *rsp_buf,
+		   size_t rsp_buf_len, void *user_data)
+{
+	ARG_UNUSED(user_data);
+
+	if (req->body_len > rsp_buf_len) {
+		return -ENOMEM;
+	}
+
+	memcpy(rsp_buf, req->body, req->body_len);
+
+	return req->body_len;
+}
+
+static struct http_resource_detail_dynamic echo_detail = {
+	.common = {
+		.bitmask_of_supported_http_methods = HTTP_METHOD_BIT(HTTP_POST),
+		.type = HTTP_RESOURCE_TYPE_DYNAMIC,
+		.content_type = "text/plain",
+	},
+	.cb = echo_cb,
+};
+
+static uint16_t test_http_service_port;
+HTTP_SERVICE_DEFINE(test_http_service, "127.0.0.1", &test_http_service_port, 2, 2, NULL);
+HTTP_RESOURCE_DEFINE(index_resource, test_http_service, "/index.html", &index_detail);
+HTTP_RESOURCE_DEFINE(echo_resource, test_http_service, "/echo", &echo_detail);
+HTTP_RESOURCE_DEFINE(big_resource, test_http_service, "/big", &big_detail);
+
+#define INDEX_RESPONSE                                                                             \
+	"HTTP/1.1 200 OK\r\n"                                                                      \
+	"Content-Length: 31\r\n"                                                                   \
+	"Content-Type: text/html\r\n"                                                              \
+	"\r\n"                                                                                     \
+	"<html><body>Hello</body></html>"
+
+static int client_connect(void)
+{
+	struct sockaddr_in addr = {
+		.sin_family = AF_INET,
+		.sin_port = htons(test_http_service_port),
+	};
+	int fd;
+
+	zassert_equal(zsock_inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr), 1);
+
+	fd = zsock_socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+	zassert_true(fd >= 0, "socket failed (%d)", errno);
+
+	zassert_ok(zsock_connect(fd, (struct sockaddr *)&addr, sizeof(addr)),
+		   "connect failed (%d)", errno);
+
+	return fd;
+}
+
+static void client_send(int fd, const char *req)
+{
+	size_t len = strlen(req);
+
+	zassert_equal(zsock_send(fd, req, len, 0), len, "send failed (%d)", errno);
+}
+
+/* Receive exactly the expected response, in as many segments as needed. */
+static void client_expect(int fd, const char *expected)
+{
+	static char buf[512];
+	size_t expected_len = strlen(expected);
+	size_t len = 0;
+	int ret;
+
+	zassert_true(expected_len < sizeof(buf));
+
+	while (len < expected_len) {
+		struct zsock_pollfd pfd = {
+			.fd = fd,
+			.events = ZSOCK_POLLIN,
+		};
+
+		ret = zsock_poll(&pfd, 1, RECV_TIMEOUT_MS);
+		zassert_equal(ret, 1, "response timed out after %zu bytes", len);
+
+		ret = zsock_recv(fd, &buf[len], expected_len - len, 0);
+		zassert_true(ret > 0, "recv failed (%d, %d)", ret, errno);
+
+		len += ret;
+	}
+
+	buf[len] = '\0';
+	zassert_mem_equal(buf, expected, expected_len, "unexpected response: %s", buf);
+}
+
+static void *setup(void)
+{
+	memset(big_data, 'x', sizeof(big_data));
+
+	zassert_ok(http_server_start());
+	zassert_not_equal(test_http_service_port, 0, "ephemeral port not assigned");
+
+	return NULL;
+}
+
+static void teardown(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	zassert_ok(http_server_stop());
+}
+
+ZTEST(http_server_core, test_static_resource_keep_alive)
+{
+	int fd = client_connect();
+
+	client_send(fd, "GET /index.html HTTP/1.1\r\nHost: 127.0.0.1\r\n\r\n");
+	client_expect(fd, INDEX_RESPONSE);
+
+	/* The connection is persistent, the same socket is used again. */
+	client_send(fd, "GET /index.html?foo=bar HTTP/1.1\r\nHost: 127.0.0.1\r\n\r\n");
+	client_expect(fd, INDEX_RESPONSE);
+
+	zsock_close(fd);
+}
+
+ZTEST(http_server_core, test_pipelined_requests)
+{
+	int fd = client_connect();
+
+	client_send(fd,
+		    "GET /index.html HTTP/1.1\r\nHost: 127.0.0.1\r\n\r\n"
+		    "POST /echo HTTP/1.1\r\nHost: 127.0.0.1\r\nContent-Length: 4\r\n\r\nping"
+		    "GET /missing HTTP/1.1\r\nHost: 127.0.0.1\r\n\r\n");
+
+	client_expect(fd, INDEX_RESPONSE
+		      "HTTP/1.1 200 OK\r\n"
+		      "Content-Length: 4\r\n"
+		      "Content-Type: text/plain\r\n"
+		      "\r\n"
+		      "ping"
+		      "HTTP/1.1 404 Not Found\r\n"
+		      "Content-Length: 0\r\n"
+		      "\r\n");
+
+	zsock_close(fd);
+}
+
+ZTEST(http_server_core, test_method_not_allowed)
+{
+	int fd = client_connect();
+
+	client_send(fd, "GET /echo HTTP/1.1\r\nHost: 127.0.0.1\r\n\r\n");
+	client_expect(fd, "HTTP/1.1 405 Method Not Allowed\r\n"
+			  "Content-Length: 0\r\n"
+			  "\r\n");
+
+	zsock_close(fd);
+}
+
+ZTEST(http_server_core, test_connection_close)
+{
+	char c;
+	int fd = client_connect();
+
+	client_send(fd, "HEAD /index.html HTTP/1.1\r\nConnection: close\r\n\r\n");
+	client_expect(fd, "HTTP/1.1 200 OK\r\n"
+			  "Content-Length: 31\r\n"
+			  "Content-Type: text/html\r\n"
+			  "Connection: close\r\n"
+			  "\r\n");
+
+	/* Server closes the connection after the response. */
+	zassert_equal(zsock_recv(fd, &c, sizeof(c), 0), 0, "connection not closed");
+
+	zsock_close(fd);
+}
+
+ZTEST(http_server_core, test_bad_request)
+{
+	char c;
+	int fd = client_connect();
+
+	client_send(fd, "GET /index.html HTTP/1.1\r\nBad header\r\n\r\n");
+	client_expect(fd, "HTTP/1.1 400 Bad Request\r\n"
+			  "Content-Length: 0\r\n"
+			  "Connection: close\r\n"
+			  "\r\n");
+
+	/* The connection is closed only after the complete response. */
+	zassert_equal(zsock_recv(fd, &c, sizeof(c), 0), 0, "connection not closed");
+
+	zsock_close(fd);
+}
+
+ZTEST(http_server_core, test_method_out_of_bitmask)
+{
+	int fd = client_connect();
+
+	/* UNLINK is past the 32 methods covered by the bitmask. */
+	client_send(fd, "UNLINK /index.html HTTP/1.1\r\nHost: 127.0.0.1\r\n\r\n");
+	client_expect(fd, "HTTP/1.1 405 Method Not Allowed\r\n"
+			  "Content-Length: 0\r\n"
+			  "\r\n");
+
+	zsock_close(fd);
+}
+
+ZTEST(http_server_core, test_slow_reader)
+{
+	static const char big_hdr[] = "HTTP/1.1 200 OK\r\n"
+				      "Content-Length: 4096\r\n"
+				      "Content-Type: text/plain\r\n"
+				      "\r\n";
+	size_t expected_len = sizeof(big_hdr) - 1 + BIG_DATA_LEN;
+	size_t len = 0;
+	char buf[256];
+	int fd_slow, fd;
+	int ret;
+
+	/* The response is larger than the receive window, so the server
+	 * cannot send it all before the client reads.
+	 */
+	fd_slow = client_connect();
+	client_send(fd_slow, "GET /big HTTP/1.1\r\nHost: 127.0.0.1\r\n\r\n");
+	k_msleep(100);
+
+	/* Other clients are served meanwhile. */
+	fd = client_connect();
+	client_send(fd, "GET /index.html HTTP/1.1\r\nHost: 127.0.0.1\r\n\r\n");
+	client_expect(fd, INDEX_RESPONSE);
+	zsock_close(fd);
+
+	/* The slow client still gets its complete response. */
+	while (len < expected_len) {
+		struct zsock_pollfd pfd = {
+			.fd = fd_slow,
+			.events = ZSOCK_POLLIN,
+		};
+
+		ret = zsock_poll(&pfd, 1, RECV_TIMEOUT_MS);
+		zassert_equal(ret, 1, "response timed out after %zu bytes", len);
+
+		ret = zsock_recv(fd_slow, buf, MIN(sizeof(buf), expected_len - len), 0);
+		zassert_true(ret > 0, "recv failed (%d, %d)", ret, errno);
+
+		if (len < sizeof(big_hdr) - 1) {
+			zassert_mem_equal(buf, &big_hdr[len],
+					  MIN((size_t)ret, sizeof(big_hdr) - 1 - len));
+		}
+
+		len += ret;
+	}
+
+	zsock_close(fd_slow);
+}
+
+ZTEST_SUITE(http_server_core, NULL, setup, NULL, NULL, teardown);
@@ -0,0 +1,238 @@
+/*
+ * Copyright The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+
+#include <zephyr/ztest.h>
+#include <zephyr/net/net_if.h>
+#include <zephyr/net/net_pkt.h>
+#include <zephyr/net/dummy.h>
+#include <zephyr/net/udp.h>
+
+#include "ipv4.h"
+#include "udp_internal.h"
+
+#define MDNS_PORT 5353
+#define RATE_LIMIT CONFIG_MDNS_RESPONDER_RATE_LIMIT
+
+/* Time for the stack to process a query and send the answer */
+#define PROCESS_TIME_MS 50
+
+static const struct in_addr my_addr[] = {
+	{ { { 192, 0, 2, 1 } } },
+	{ { { 198, 51, 100, 1 } } },
+};
+
+static const struct in_addr peer_addr[] = {
+	{ { { 192, 0, 2, 2 } } },
+	{ { { 198, 51, 100, 2 } } },
+};
+
+static const struct in_addr mdns_addr = { { { 224, 0, 0, 251 } } };
+
+static struct net_if *ifaces[2];
+
+/* mDNS messages sent by the responder */
+static atomic_t answers;
+
+struct test_dev_context {
+	uint8_t mac_addr[6];
+};
+
+static struct test_dev_context test_dev_ctx[2];
+
+static void test_iface_init(struct net_if *iface)
+{
+	struct test_dev_context *ctx = net_if_get_device(iface)->data;
+
+	ctx->mac_addr[0] = 0x00;
+	ctx->mac_addr[1] = 0x00;
+	ctx->mac_addr[2] = 0x5E;
+	ctx->mac_addr[3] = 0x00;
+	ctx->mac_addr[4] = 0x53;
+	ctx->mac_addr[5] = ctx == &test_dev_ctx[0] ? 0x01 : 0x02;
+
+	net_if_set_link_addr(iface, ctx->mac_addr, sizeof(ctx->mac_addr),
+			     NET_LINK_ETHERNET);
+}
+
+static int test_send(const struct device *dev, struct net_pkt *pkt)
+{
+	ARG_UNUSED(dev);
+
+	/* Skip the IGMP reports */
+	if (NET_IPV4_HDR(pkt)->proto == IPPROTO_UDP) {
+		atomic_inc(&answers);
+	}
+
+	return 0;
+}
+
+static struct dummy_api test_if_api = {
+	.iface_api.init = test_iface_init,
+	.send = test_send,
+};
+
+#define _L2_LAYER DUMMY_L2
+#define _L2_CTX_TYPE NET_L2_GET_CTX_TYPE(DUMMY_L2)
+
+NET_DEVICE_INIT_INSTANCE(mdns_test_0, "mdns_test_0", 0, NULL, NULL,
+			 &test_dev_ctx[0], NULL, CONFIG_KERNEL_INIT_PRIORITY_DEFAULT,
+			 &test_if_api, _L2_LAYER, _L2_CTX_TYPE, 127);
+
+NET_DEVICE_INIT_INSTANCE(mdns_test_1, "mdns_test_1", 1, NULL, NULL,
+			 &test_dev_ctx[1], NULL, CONFIG_KERNEL_INIT_PRIORITY_DEFAULT,
+			 &test_if_api, _L2_LAYER, _L2_CTX_TYPE, 127);
+
+/* Query for the A record of our hostname, optionally with the querier's
+ * known answer for it.
+ */
+static size_t build_query(uint8_t *buf, const struct in_addr *known_addr,
+			  uint32_t known_ttl)
+{
+	static const uint8_t header[] = {
+		0x00, 0x00, /* ID */
+		0x00, 0x00, /* Flags: standard query */
+		0x00, 0x01, /* QDCOUNT */
+		0x00, 0x00, /* ANCOUNT */
+		0x00, 0x00, /* NSCOUNT */
+		0x00, 0x00, /* ARCOUNT */
+	};
+	static const uint8_t question[] = {
+		6, 'z', 'e', 'p', 'h', 'y', 'r', 5, 'l', 'o', 'c', 'a', 'l', 0,
+		0x00, 0x01, /* A */
+		0x00, 0x01, /* IN */
+	};
+	size_t len = 0;
+
+	memcpy(buf, header, sizeof(header));
+	len += sizeof(header);
+	memcpy(buf + len, question, sizeof(question));
+	len += sizeof(question);
+
+	if (known_addr == NULL) {
+		return len;
+	}
+
+	buf[7] = 1; /* ANCOUNT */
+
+	buf[len++] = 0xc0; /* Name: pointer to the question */
+	buf[len++] = 12;
+	buf[len++] = 0x00; /* A */
+	buf[len++] = 0x01;
+	buf[len++] = 0x00; /* IN */
+	buf[len++] = 0x01;
+	sys_put_be32(known_ttl, buf + len);
+	len += sizeof(uint32_t);
+	buf[len++] = 0x00; /* RDLENGTH */
+	buf[len++] = sizeof(struct in_addr);
+	memcpy(buf + len, known_addr, sizeof(struct in_addr));
+	len += sizeof(struct in_addr);
+
+	return len;
+}
+
+/* Feed a query into the stack as if received on the interface and return
+ * the number of answers the responder sent for it.
+ */
+static int query(int idx, const struct in_addr *known_addr, uint32_t known_ttl)
+{
+	uint8_t buf[64];
+	struct net_pkt *pkt;
+	size_t len;
+
+	len = build_query(buf, known_addr, known_ttl);
+
+	pkt = net_pkt_alloc_with_buffer(ifaces[idx], len, AF_INET, IPPROTO_UDP,
+					K_NO_WAIT);
+	zassert_not_null(pkt, "cannot allocate packet");
+
+	net_pkt_set_ipv4_ttl(pkt, 255);
+
+	zassert_ok(net_ipv4_create(pkt, &peer_addr[idx], &mdns_addr));
+	zassert_ok(net_udp_create(pkt, htons(MDNS_PORT), htons(MDNS_PORT)));
+	zassert_ok(net_pkt_write(pkt, buf, len));
+
+	net_pkt_cursor_init(pkt);
+	zassert_ok(net_ipv4_finalize(pkt, IPPROTO_UDP));
+	net_pkt_cursor_init(pkt);
+
+	atomic_set(&answers, 0);
+
+	if (net_recv_data(ifaces[idx], pkt) < 0) {
+		net_pkt_unref(pkt);
+		zassert_unreachable("cannot receive packet");
+	}
+
+	k_msleep(PROCESS_TIME_MS);
+
+	return atomic_get(&answers);
+}
+
+static void *setup(void)
+{
+	for (int i = 0; i < ARRAY_SIZE(ifaces); i++) {
+		ifaces[i] = net_if_get_by_index(i + 1);
+		zassert_not_null(ifaces[i], "interface %d not found", i + 1);
+
+		zassert_not_null(net_if_ipv4_addr_add(ifaces[i],
+						      (struct in_addr *)&my_addr[i],
+						      NET_ADDR_MANUAL, 0));
+		net_if_ipv4_set_netmask(ifaces[i],
+					&(struct in_addr){ { { 255, 255, 255, 0 } } });
+	}
+
+	return NULL;
+}
+
+static void before(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	/* Let the answers of the previous test expire from the rate limit */
+	k_msleep(RATE_LIMIT + PROCESS_TIME_MS);
+}
+
+ZTEST(mdns_responder, test_rate_limit)
+{
+	zassert_equal(query(0, NULL, 0), 1, "query not answered");
+
+	/* The same answer was just multicast on this link */
+	zassert_equal(query(0, NULL, 0), 0, "answer not rate limited");
+
+	/* but not on the other one */
+	zassert_equal(query(1, NULL, 0), 1, "answer limited on other link");
+	zassert_equal(query(1, NULL, 0), 0, "answer not rate limited");
+
+	k_msleep(RATE_LIMIT);
+
+	zassert_equal(query(0, NULL, 0), 1, "answer limited after interval");
+	zassert_equal(query(1, NULL, 0), 1, "answer limited after interval");
+}
+
+ZTEST(mdns_responder, test_known_answer)
+{
+	/* The querier knows our answer with its full TTL */
+	zassert_equal(query(0, &my_addr[0], CONFIG_MDNS_RESPONDER_TTL), 0,
+		      "known answer sent");
+
+	/* Less than half of the TTL remains */
+	zassert_equal(query(0, &my_addr[0], CONFIG_MDNS_RESPONDER_TTL / 2 - 1), 1,
+		      "expiring known answer not refreshed");
+
+	k_msleep(RATE_LIMIT);
+
+	/* The known answer holds another address */
+	zassert_equal(query(0, &my_addr[1], CONFIG_MDNS_RESPONDER_TTL), 1,
+		      "answer with other address suppressed");
+
+	/* A suppressed answer does not count as sent */
+	zassert_equal(query(1, &my_addr[1], CONFIG_MDNS_RESPONDER_TTL), 0,
+		      "known answer sent");
+	zassert_equal(query(1, NULL, 0), 1, "query not answered");
+}
+
+ZTEST_SUITE(mdns_responder, NULL, setup, before, NULL, NULL);
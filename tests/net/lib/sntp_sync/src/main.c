@@ -0,0 +1,234 @@
+/*
+ * Copyright The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdlib.h>
+
+#include <zephyr/ztest.h>
+#include <zephyr/net/socket.h>
+#include <zephyr/net/sntp.h>
+#include <zephyr/posix/time.h>
+#include <zephyr/posix/sys/time.h>
+#include <zephyr/random/random.h>
+
+#include "sntp_pkt.h"
+
+#define NUM_SERVERS 3
+#define SERVER_PORT 12300
+#define QUERY_TIMEOUT_MS 200
+
+/* Stand-in NTP servers. Their time is derived from the uptime so that it
+ * is not affected by the changes the client does to CLOCK_REALTIME.
+ */
+struct test_server {
+	int64_t offset;
+	int64_t jitter;
+	int sock;
+};
+
+static struct test_server servers[NUM_SERVERS];
+static struct sockaddr server_addrs[NUM_SERVERS];
+static int64_t server_base;
+
+static K_THREAD_STACK_DEFINE(server_stack, 1024);
+static struct k_thread server_thread;
+
+static int64_t uptime_ns(void)
+{
+	return (int64_t)k_ticks_to_ns_floor64(k_uptime_ticks());
+}
+
+static int64_t realtime_ns(void)
+{
+	struct timespec ts;
+
+	zassert_ok(clock_gettime(CLOCK_REALTIME, &ts));
+
+	return (int64_t)ts.tv_sec * NSEC_PER_SEC + ts.tv_nsec;
+}
+
+static void ns_to_ntp(int64_t ns, uint32_t *s, uint32_t *f)
+{
+	*s = htonl((uint32_t)(ns / NSEC_PER_SEC + OFFSET_1970_JAN_1));
+	*f = htonl((uint32_t)(((uint64_t)(ns % NSEC_PER_SEC) << 32) / NSEC_PER_SEC));
+}
+
+static void server_respond(struct test_server *srv)
+{
+	struct sockaddr addr;
+	socklen_t addrlen = sizeof(addr);
+	struct sntp_pkt pkt;
+	uint32_t tm_s, tm_f;
+	int64_t now;
+	int ret;
+
+	ret = zsock_recvfrom(srv->sock, &pkt, sizeof(pkt), 0, &addr, &addrlen);
+	if (ret != sizeof(pkt)) {
+		return;
+	}
+
+	now = server_base + uptime_ns() + srv->offset;
+	if (srv->jitter > 0) {
+		now += (int64_t)(sys_rand32_get() % (2 * srv->jitter)) - srv->jitter;
+	}
+
+	pkt.orig_tm_s = pkt.tx_tm_s;
+	pkt.orig_tm_f = pkt.tx_tm_f;
+	pkt.lvm = 0;
+	SNTP_SET_VN(pkt.lvm, SNTP_VERSION_NUMBER);
+	SNTP_SET_MODE(pkt.lvm, SNTP_MODE_SERVER);
+	pkt.stratum = 1;
+	ns_to_ntp(now, &tm_s, &tm_f);
+	pkt.rx_tm_s = tm_s;
+	pkt.rx_tm_f = tm_f;
+	pkt.tx_tm_s = tm_s;
+	pkt.tx_tm_f = tm_f;
+
+	(void)zsock_sendto(srv->sock, &pkt, sizeof(pkt), 0, &addr, addrlen);
+}
+
+static void server_handler(void *p1, void *p2, void *p3)
+{
+	struct zsock_pollfd fds[NUM_SERVERS];
+
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	for (int i = 0; i < NUM_SERVERS; i++) {
+		fds[i].fd = servers[i].sock;
+		fds[i].events = ZSOCK_POLLIN;
+	}
+
+	while (zsock_poll(fds, NUM_SERVERS, -1) > 0) {
+		for (int i = 0; i < NUM_SERVERS; i++) {
+			if (fds[i].revents & ZSOCK_POLLIN) {
+				server_respond(&servers[i]);
+			}
+		}
+	}
+}
+
+static void set_server_offsets(int64_t o0, int64_t o1, int64_t o2)
+{
+	servers[0].offset = o0;
+	servers[1].offset = o1;
+	servers[2].offset = o2;
+}
+
+static void *setup(void)
+{
+	struct sockaddr *addrs = server_addrs;
+
+	for (int i = 0; i < NUM_SERVERS; i++) {
+		struct sockaddr_in *addr = (struct sockaddr_in *)&addrs[i];
+
+		memset(addr, 0, sizeof(addrs[i]));
+		addr->sin_family = AF_INET;
+		addr->sin_port = htons(SERVER_PORT + i);
+		zassert_equal(zsock_inet_pton(AF_INET, "127.0.0.1", &addr->sin_addr), 1);
+
+		servers[i].sock = zsock_socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+		zassert_true(servers[i].sock >= 0, "socket failed (%d)", errno);
+		zassert_ok(zsock_bind(servers[i].sock, &addrs[i], sizeof(*addr)),
+			   "bind failed (%d)", errno);
+	}
+
+	server_base = realtime_ns() - uptime_ns();
+
+	k_thread_create(&server_thread, server_stack,
+			K_THREAD_STACK_SIZEOF(server_stack),
+			server_handler, NULL, NULL, NULL,
+			K_PRIO_PREEMPT(1), 0, K_NO_WAIT);
+
+	return NULL;
+}
+
+static void before(void *fixture)
+{
+	struct timespec ts;
+	int64_t now = server_base + uptime_ns();
+
+	ARG_UNUSED(fixture);
+
+	/* Start each test in sync with the servers, no adjustment pending */
+	ts.tv_sec = now / NSEC_PER_SEC;
+	ts.tv_nsec = now % NSEC_PER_SEC;
+	zassert_ok(clock_settime(CLOCK_REALTIME, &ts));
+
+	for (int i = 0; i < NUM_SERVERS; i++) {
+		servers[i].jitter = 200 * NSEC_PER_USEC;
+	}
+
+	/* Also resets the poll interval */
+	zassert_ok(sntp_sync_init(server_addrs, NUM_SERVERS));
+}
+
+ZTEST(sntp_sync, test_falseticker_rejected)
+{
+	struct sntp_sync_status status;
+	struct timeval old;
+
+	set_server_offsets(50 * NSEC_PER_MSEC, 50 * NSEC_PER_MSEC, 5 * NSEC_PER_SEC);
+
+	zassert_ok(sntp_sync_poll(QUERY_TIMEOUT_MS, &status));
+
+	zassert_equal(status.responding, 3);
+	zassert_equal(status.selected, 2, "falseticker was not rejected");
+	zassert_false(status.stepped, "clock should be slewed");
+	zassert_within(status.offset_us, 50 * USEC_PER_MSEC, 2 * USEC_PER_MSEC,
+		       "offset %lld us", (long long)status.offset_us);
+
+	/* The clock is being slewed towards the servers */
+	zassert_ok(adjtime(NULL, &old));
+	zassert_equal(old.tv_sec, 0);
+	zassert_within(old.tv_usec, 50 * USEC_PER_MSEC, 2 * USEC_PER_MSEC,
+		       "remaining adjustment %ld us", (long)old.tv_usec);
+}
+
+ZTEST(sntp_sync, test_large_offset_stepped)
+{
+	struct sntp_sync_status status;
+	int64_t diff;
+
+	set_server_offsets(10 * NSEC_PER_SEC, 10 * NSEC_PER_SEC, 10 * NSEC_PER_SEC);
+
+	zassert_ok(sntp_sync_poll(QUERY_TIMEOUT_MS, &status));
+
+	zassert_equal(status.selected, 3);
+	zassert_true(status.stepped, "clock should be stepped");
+	zassert_equal(status.poll_interval, BIT(CONFIG_SNTP_SYNC_MIN_POLL));
+
+	/* The local clock now matches the servers */
+	diff = realtime_ns() - (server_base + uptime_ns() + 10 * NSEC_PER_SEC);
+	zassert_true(llabs(diff) < 5 * NSEC_PER_MSEC, "clock off by %lld us",
+		     (long long)(diff / NSEC_PER_USEC));
+}
+
+ZTEST(sntp_sync, test_no_majority)
+{
+	struct sntp_sync_status status;
+
+	set_server_offsets(0, NSEC_PER_SEC, 2 * NSEC_PER_SEC);
+
+	zassert_equal(sntp_sync_poll(QUERY_TIMEOUT_MS, &status), -EAGAIN);
+	zassert_equal(status.responding, 3);
+	zassert_equal(status.selected, 0);
+}
+
+ZTEST(sntp_sync, test_poll_interval_backoff)
+{
+	struct sntp_sync_status status;
+
+	set_server_offsets(0, 0, 0);
+
+	zassert_ok(sntp_sync_poll(QUERY_TIMEOUT_MS, &status));
+	zassert_equal(status.poll_interval, BIT(CONFIG_SNTP_SYNC_MIN_POLL + 1));
+
+	zassert_ok(sntp_sync_poll(QUERY_TIMEOUT_MS, &status));
+	zassert_equal(status.poll_interval, BIT(CONFIG_SNTP_SYNC_MIN_POLL + 2));
+}
+
+ZTEST_SUITE(sntp_sync, NULL, setup, before, NULL, NULL);
@@ -0,0 +1,538 @@
+/*
+ * Copyright The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <zephyr/ztest.h>
+#include <zephyr/net/socket.h>
+#include <zephyr/net/tftp.h>
+
+#include "tftp_client.h"
+
+#define SERVER_PORT 6969
+#define SERVER_TIMEOUT_MS 100
+#define SERVER_RETRIES 10
+
+#define FILE_SIZE 10000
+
+/* Stand-in TFTP server, serving a single file from memory */
+struct test_server {
+	int sock;
+
+	/* Answer the options, otherwise behave as a RFC1350 server */
+	bool options;
+
+	/* Largest window size granted to the client */
+	uint16_t max_window;
+
+	/* Block not sent the first time, 0 for none */
+	uint16_t drop_block;
+
+	/* Block sent three times the first time, 0 for none */
+	uint16_t dup_block;
+
+	/* ACKs received for dup_block */
+	int dup_acks;
+
+	/* Block size used by the last transfer */
+	uint16_t blksize;
+
+	/* Data received by the last WRQ */
+	size_t put_len;
+
+	/* ACKs waited for during the last RRQ, each one is a round trip */
+	int acks;
+};
+
+static struct test_server server;
+static K_SEM_DEFINE(server_done, 0, 1);
+static uint8_t file_data[FILE_SIZE];
+static uint8_t put_data[FILE_SIZE];
+static uint8_t pkt_buf[TFTPC_MAX_BUF_SIZE + 64];
+
+static K_THREAD_STACK_DEFINE(server_stack, 2048);
+static struct k_thread server_thread;
+
+static struct tftpc client;
+static uint8_t recv_data[FILE_SIZE];
+static size_t recv_len;
+static int sink_last_count;
+
+static int ram_sink(void *user_data, const uint8_t *data, size_t len, bool last)
+{
+	ARG_UNUSED(user_data);
+
+	if (recv_len + len > sizeof(recv_data)) {
+		return -ENOMEM;
+	}
+
+	memcpy(&recv_data[recv_len], data, len);
+	recv_len += len;
+
+	if (last) {
+		sink_last_count++;
+	}
+
+	return 0;
+}
+
+static void data_callback(const struct tftp_evt *evt)
+{
+	if (evt->type != TFTP_EVT_DATA ||
+	    recv_len + evt->param.data.len > sizeof(recv_data)) {
+		return;
+	}
+
+	memcpy(&recv_data[recv_len], evt->param.data.data_ptr, evt->param.data.len);
+	recv_len += evt->param.data.len;
+}
+
+static int server_recv(struct sockaddr *addr, socklen_t *addrlen, int timeout)
+{
+	struct zsock_pollfd pfd = {
+		.fd = server.sock,
+		.events = ZSOCK_POLLIN,
+	};
+
+	if (zsock_poll(&pfd, 1, timeout) <= 0) {
+		return -EAGAIN;
+	}
+
+	*addrlen = sizeof(*addr);
+
+	return zsock_recvfrom(server.sock, pkt_buf, sizeof(pkt_buf) - 1, 0, addr, addrlen);
+}
+
+static void server_send(const void *buf, size_t len, const struct sockaddr *addr,
+			socklen_t addrlen)
+{
+	(void)zsock_sendto(server.sock, buf, len, 0, addr, addrlen);
+}
+
+/* Wait for an ACK, returns its block number or a negative error */
+static int server_wait_ack(struct sockaddr *addr, socklen_t *addrlen)
+{
+	int ret;
+
+	ret = server_recv(addr, addrlen, SERVER_TIMEOUT_MS);
+	if (ret < 0) {
+		return ret;
+	}
+
+	if (ret != TFTP_HEADER_SIZE || sys_get_be16(pkt_buf) != ACK_OPCODE) {
+		return -EPROTO;
+	}
+
+	server.acks++;
+
+	if (server.dup_block != 0 && sys_get_be16(pkt_buf + 2) == server.dup_block) {
+		server.dup_acks++;
+	}
+
+	return sys_get_be16(pkt_buf + 2);
+}
+
+static size_t server_oack(char *buf, uint16_t blksize, uint16_t window, uint32_t tsize)
+{
+	size_t len = 2;
+
+	sys_put_be16(OACK_OPCODE, buf);
+
+	if (blksize != TFTP_BLOCK_SIZE) {
+		len += sprintf(&buf[len], "blksize") + 1;
+		len += sprintf(&buf[len], "%u", blksize) + 1;
+	}
+
+	if (window > 1) {
+		len += sprintf(&buf[len], "windowsize") + 1;
+		len += sprintf(&buf[len], "%u", window) + 1;
+	}
+
+	len += sprintf(&buf[len], "tsize") + 1;
+	len += sprintf(&buf[len], "%u", tsize) + 1;
+
+	return len;
+}
+
+static void server_send_block(uint16_t block, uint16_t blksize, struct sockaddr *addr,
+			      socklen_t addrlen)
+{
+	static uint8_t data[TFTPC_MAX_BUF_SIZE];
+	size_t offset = (size_t)(block - 1) * blksize;
+	size_t len = MIN(blksize, FILE_SIZE - offset);
+
+	if (block == server.drop_block) {
+		server.drop_block = 0;
+		return;
+	}
+
+	sys_put_be16(DATA_OPCODE, data);
+	sys_put_be16(block, data + 2);
+	memcpy(data + TFTP_HEADER_SIZE, &file_data[offset], len);
+
+	server_send(data, len + TFTP_HEADER_SIZE, addr, addrlen);
+
+	if (block == server.dup_block && server.dup_acks == 0) {
+		server_send(data, len + TFTP_HEADER_SIZE, addr, addrlen);
+		server_send(data, len + TFTP_HEADER_SIZE, addr, addrlen);
+	}
+}
+
+static void server_read(uint16_t blksize, uint16_t window, bool oack,
+			struct sockaddr *addr, socklen_t addrlen)
+{
+	uint16_t last_block = FILE_SIZE / blksize + 1;
+	uint16_t base = 1;
+	int retries = 0;
+	int ret;
+
+	server.acks = 0;
+
+	if (oack) {
+		static char buf[64];
+		size_t len = server_oack(buf, blksize, window, FILE_SIZE);
+
+		do {
+			server_send(buf, len, addr, addrlen);
+			ret = server_wait_ack(addr, &addrlen);
+		} while (ret == -EAGAIN && ++retries < SERVER_RETRIES);
+
+		if (ret != 0) {
+			return;
+		}
+	}
+
+	retries = 0;
+
+	while (base <= last_block && retries < SERVER_RETRIES) {
+		uint16_t end = MIN(base + window - 1, last_block);
+
+		for (uint16_t block = base; block <= end; block++) {
+			server_send_block(block, blksize, addr, addrlen);
+		}
+
+		ret = server_wait_ack(addr, &addrlen);
+		if (ret == -EAGAIN) {
+			retries++;
+			continue;
+		} else if (ret < 0) {
+			return;
+		}
+
+		/* The client acks the last block received in order */
+		if (ret >= base - 1 && ret <= end) {
+			base = ret + 1;
+			retries = 0;
+		}
+	}
+}
+
+static void server_write(uint16_t blksize, bool oack, struct sockaddr *addr,
+			 socklen_t addrlen)
+{
+	uint8_t ack[TFTP_HEADER_SIZE];
+	uint16_t expected = 1;
+	int ret;
+
+	server.put_len = 0;
+
+	if (oack) {
+		static char buf[64];
+		size_t len = server_oack(buf, blksize, 1, FILE_SIZE);
+
+		server_send(buf, len, addr, addrlen);
+	} else {
+		sys_put_be16(ACK_OPCODE, ack);
+		sys_put_be16(0, ack + 2);
+		server_send(ack, sizeof(ack), addr, addrlen);
+	}
+
+	while ((ret = server_recv(addr, &addrlen, SERVER_TIMEOUT_MS)) >= TFTP_HEADER_SIZE) {
+		size_t len = ret - TFTP_HEADER_SIZE;
+		uint16_t block = sys_get_be16(pkt_buf + 2);
+
+		if (sys_get_be16(pkt_buf) != DATA_OPCODE || len > blksize) {
+			return;
+		}
+
+		if (block == expected && server.put_len + len <= sizeof(put_data)) {
+			memcpy(&put_data[server.put_len], pkt_buf + TFTP_HEADER_SIZE, len);
+			server.put_len += len;
+			expected++;
+		}
+
+		sys_put_be16(ACK_OPCODE, ack);
+		sys_put_be16(block, ack + 2);
+		server_send(ack, sizeof(ack), addr, addrlen);
+
+		if (len < blksize) {
+			return;
+		}
+	}
+}
+
+static void server_handle_request(int len, struct sockaddr *addr, socklen_t addrlen)
+{
+	const char *ptr = (const char *)pkt_buf + 2;
+	const char *end = (const char *)pkt_buf + len;
+	uint16_t opcode = sys_get_be16(pkt_buf);
+	uint16_t blksize = TFTP_BLOCK_SIZE;
+	uint16_t window = 1;
+	bool oack = false;
+
+	/* Skip the file name and the mode */
+	ptr += strlen(ptr) + 1;
+	ptr += strlen(ptr) + 1;
+
+	while (server.options && ptr < end) {
+		const char *name = ptr;
+		const char *value = name + strlen(name) + 1;
+
+		ptr = value + strlen(value) + 1;
+		oack = true;
+
+		if (strcmp(name, "blksize") == 0) {
+			blksize = atoi(value);
+		} else if (strcmp(name, "windowsize") == 0) {
+			window = MIN(atoi(value), server.max_window);
+		}
+	}
+
+	server.blksize = blksize;
+
+	if (opcode == READ_REQUEST) {
+		server_read(blksize, window, oack, addr, addrlen);
+	} else if (opcode == WRITE_REQUEST) {
+		server_write(blksize, oack, addr, addrlen);
+	}
+
+	k_sem_give(&server_done);
+}
+
+static void server_handler(void *p1, void *p2, void *p3)
+{
+	struct sockaddr addr;
+	socklen_t addrlen;
+	int ret;
+
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	while (true) {
+		ret = server_recv(&addr, &addrlen, SYS_FOREVER_MS);
+		if (ret > 2) {
+			pkt_buf[ret] = '\0';
+			server_handle_request(ret, &addr, addrlen);
+		}
+	}
+}
+
+/* The client is done once it has sent the last ACK, the server once it
+ * has received it.
+ */
+static void wait_server(void)
+{
+	zassert_ok(k_sem_take(&server_done, K_SECONDS(2)), "server did not finish");
+}
+
+static void get_file(void)
+{
+	zassert_equal(tftp_get(&client, "file.bin", "octet"), FILE_SIZE);
+	wait_server();
+}
+
+static void check_file(void)
+{
+	zassert_equal(recv_len, FILE_SIZE);
+	zassert_mem_equal(recv_data, file_data, FILE_SIZE);
+}
+
+static void *setup(void)
+{
+	struct sockaddr_in *addr = (struct sockaddr_in *)&client.server;
+
+	for (int i = 0; i < FILE_SIZE; i++) {
+		file_data[i] = (uint8_t)(i * 7);
+	}
+
+	addr->sin_family = AF_INET;
+	addr->sin_port = htons(SERVER_PORT);
+	zassert_equal(zsock_inet_pton(AF_INET, "127.0.0.1", &addr->sin_addr), 1);
+
+	server.sock = zsock_socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+	zassert_true(server.sock >= 0, "socket failed (%d)", errno);
+	zassert_ok(zsock_bind(server.sock, &client.server, sizeof(*addr)),
+		   "bind failed (%d)", errno);
+
+	k_thread_create(&server_thread, server_stack,
+			K_THREAD_STACK_SIZEOF(server_stack),
+			server_handler, NULL, NULL, NULL,
+			K_PRIO_PREEMPT(1), 0, K_NO_WAIT);
+
+	return NULL;
+}
+
+static void before(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	server.options = true;
+	server.max_window = UINT16_MAX;
+	server.drop_block = 0;
+	server.dup_block = 0;
+	server.dup_acks = 0;
+
+	client.callback = NULL;
+	client.sink = ram_sink;
+	client.sink_user_data = NULL;
+
+	memset(recv_data, 0, sizeof(recv_data));
+	recv_len = 0;
+	sink_last_count = 0;
+
+	k_sem_reset(&server_done);
+}
+
+ZTEST(tftp_client, test_get_windowed)
+{
+	get_file();
+
+	check_file();
+	zassert_equal(sink_last_count, 1, "last data not signaled once");
+	zassert_equal(client.tsize, FILE_SIZE, "transfer size not reported");
+	zassert_equal(server.blksize, CONFIG_TFTPC_MAX_BLOCK_SIZE);
+}
+
+ZTEST(tftp_client, test_get_no_options)
+{
+	server.options = false;
+
+	get_file();
+
+	check_file();
+	zassert_equal(client.tsize, 0);
+}
+
+ZTEST(tftp_client, test_get_callback)
+{
+	client.sink = NULL;
+	client.callback = data_callback;
+
+	get_file();
+
+	check_file();
+}
+
+ZTEST(tftp_client, test_get_lost_block)
+{
+	server.drop_block = 3;
+
+	get_file();
+
+	check_file();
+	zassert_equal(server.drop_block, 0, "no block was dropped");
+}
+
+ZTEST(tftp_client, test_get_duplicate_block)
+{
+	/* Without a window, every duplicate is acked again as in RFC1350 */
+	server.max_window = 1;
+	server.dup_block = 3;
+
+	get_file();
+
+	check_file();
+	zassert_equal(server.dup_acks, 3, "block acked %d times", server.dup_acks);
+}
+
+ZTEST(tftp_client, test_window_speedup)
+{
+	int blocks = FILE_SIZE / CONFIG_TFTPC_MAX_BLOCK_SIZE + 1;
+	int stop_and_wait;
+
+	/* Each ACK the server waits for costs a round trip, a window of
+	 * blocks is acked at once. The OACK is acked separately.
+	 */
+	server.max_window = 1;
+	get_file();
+	stop_and_wait = server.acks;
+
+	zassert_equal(stop_and_wait, blocks + 1);
+
+	recv_len = 0;
+	server.max_window = UINT16_MAX;
+	get_file();
+
+	check_file();
+
+	TC_PRINT("Round trips: stop-and-wait %d, window of %d blocks %d\n",
+		 stop_and_wait, CONFIG_TFTPC_WINDOW_SIZE, server.acks);
+
+	zassert_equal(server.acks, DIV_ROUND_UP(blocks, CONFIG_TFTPC_WINDOW_SIZE) + 1);
+}
+
+/* Longest file name for which a read request with the options of this
+ * configuration still fits into a default sized packet.
+ */
+static size_t max_filename_len(void)
+{
+	char options[64];
+	size_t options_len;
+
+	options_len = snprintf(options, sizeof(options), "blksize%c%d%cwindowsize%c%d%ctsize%c0",
+			       0, CONFIG_TFTPC_MAX_BLOCK_SIZE, 0, 0,
+			       CONFIG_TFTPC_WINDOW_SIZE, 0, 0) + 1;
+
+	return TFTP_BLOCK_SIZE + TFTP_HEADER_SIZE - 2 - sizeof("octet") -
+	       options_len - 1;
+}
+
+ZTEST(tftp_client, test_long_filename)
+{
+	static char name[TFTP_BLOCK_SIZE];
+	size_t len = max_filename_len();
+
+	/* The file name can use all the space the options leave */
+	memset(name, 'a', len);
+	name[len] = '\0';
+
+	zassert_equal(tftp_get(&client, name, "octet"), FILE_SIZE);
+	wait_server();
+	check_file();
+
+	/* One more character and the request does not fit */
+	name[len] = 'a';
+	name[len + 1] = '\0';
+
+	zassert_equal(tftp_get(&client, name, "octet"), -EINVAL);
+}
+
+ZTEST(tftp_client, test_put)
+{
+	zassert_equal(tftp_put(&client, "file.bin", "octet", file_data, FILE_SIZE),
+		      FILE_SIZE);
+	wait_server();
+
+	zassert_equal(server.blksize, CONFIG_TFTPC_MAX_BLOCK_SIZE);
+	zassert_equal(server.put_len, FILE_SIZE);
+	zassert_mem_equal(put_data, file_data, FILE_SIZE);
+}
+
+ZTEST(tftp_client, test_put_no_options)
+{
+	server.options = false;
+
+	zassert_equal(tftp_put(&client, "file.bin", "octet", file_data, FILE_SIZE),
+		      FILE_SIZE);
+	wait_server();
+
+	zassert_equal(server.put_len, FILE_SIZE);
+	zassert_mem_equal(put_data, file_data, FILE_SIZE);
+}
+
+ZTEST_SUITE(tftp_client, NULL, setup, before, NULL, NULL);
@@ -1383,6 +1383,57 @@ ZTEST(net_socket_udp, test_25_v6_dgram_connected)
 			     (struct sockaddr *)&server_addr_2, sizeof(server_addr_2));
 }
 
+#if defined(SEND_COST_BENCHMARK)
+#define SEND_COST_ROUNDS 100
+
+/* Only built in the send_cost variant, reports the cost of the send()
+ * calls, including the descriptor lookup, for comparison between builds.
+ */
+ZTEST(net_socket_udp, test_26_v4_send_cost)
+{
+	int client_sock;
+	int server_sock;
+	struct sockaddr_in client_addr;
+	struct sockaddr_in server_addr;
+	uint64_t cycles = 0;
+	uint32_t start;
+	ssize_t len;
+	int rv;
+
+	prepare_sock_udp_v4(MY_IPV4_ADDR, ANY_PORT, &client_sock, &client_addr);
+	prepare_sock_udp_v4(MY_IPV4_ADDR, SERVER_PORT, &server_sock, &server_addr);
+
+	rv = bind(server_sock, (struct sockaddr *)&server_addr,
+		  sizeof(server_addr));
+	zassert_equal(rv, 0, "bind failed");
+
+	rv = connect(client_sock, (struct sockaddr *)&server_addr,
+		     sizeof(server_addr));
+	zassert_equal(rv, 0, "connect failed");
+
+	for (int i = 0; i < SEND_COST_ROUNDS; i++) {
+		start = k_cycle_get_32();
+		len = send(client_sock, BUF_AND_SIZE(TEST_STR_SMALL), 0);
+		cycles += k_cycle_get_32() - start;
+
+		zassert_equal(len, STRLEN(TEST_STR_SMALL), "send failed");
+
+		/* Drain the server so that the buffers are not exhausted */
+		len = recv(server_sock, rx_buf, sizeof(rx_buf), 0);
+		zassert_equal(len, STRLEN(TEST_STR_SMALL), "recv failed");
+	}
+
+	TC_PRINT("send(): %u cycles, %u ns per call\n",
+		 (uint32_t)(cycles / SEND_COST_ROUNDS),
+		 (uint32_t)k_cyc_to_ns_floor64(cycles / SEND_COST_ROUNDS));
+
+	rv = close(client_sock);
+	zassert_equal(rv, 0, "close failed");
+	rv = close(server_sock);
+	zassert_equal(rv, 0, "close failed");
+}
+#endif /* SEND_COST_BENCHMARK */
+
 static void after(void *arg)
 {
 	ARG_UNUSED(arg);
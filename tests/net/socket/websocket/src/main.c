@@ -308,28 +308,44 @@ ZTEST(net_websocket, test_recv_two_msg)
 	test_recv_2(sizeof(frame1) + FRAME1_HDR_SIZE / 2);
 }
 
+/* Number of sends before the next one fails, 0 if sending doesn't fail */
+static int sends_before_error;
+
 int verify_sent_and_received_msg(struct msghdr *msg, bool split_msg)
 {
 	static struct websocket_context ctx;
+	static uint64_t remaining;
+	static size_t total_read;
 	uint32_t msg_type = -1;
-	uint64_t remaining = -1;
-	size_t split_len = 0, total_read = 0;
+	size_t split_len = 0, chunk_read = 0;
 	int ret;
 
-	memset(&ctx, 0, sizeof(ctx));
+	if (sends_before_error > 0 && --sends_before_error == 0) {
+		return -EAGAIN;
+	}
 
-	ctx.recv_buf.buf = temp_recv_buf;
-	ctx.recv_buf.size = sizeof(temp_recv_buf);
+	/* Masked payload is sent in several chunks and only the first one
+	 * carries the websocket header.
+	 */
+	if (msg->msg_iov[0].iov_len > 0) {
+		memset(&ctx, 0, sizeof(ctx));
 
-	/* Read first the header */
-	ret = test_recv_buf(msg->msg_iov[0].iov_base,
-			    msg->msg_iov[0].iov_len,
-			    &ctx, &msg_type, &remaining,
-			    recv_buf, sizeof(recv_buf));
-	if (remaining > 0) {
-		zassert_equal(ret, -EAGAIN, "Msg header not found");
-	} else {
-		zassert_equal(ret, 0, "Msg header read error (ret %d)", ret);
+		ctx.recv_buf.buf = temp_recv_buf;
+		ctx.recv_buf.size = sizeof(temp_recv_buf);
+
+		remaining = -1;
+		total_read = 0;
+
+		/* Read first the header */
+		ret = test_recv_buf(msg->msg_iov[0].iov_base,
+				    msg->msg_iov[0].iov_len,
+				    &ctx, &msg_type, &remaining,
+				    recv_buf, sizeof(recv_buf));
+		if (remaining > 0) {
+			zassert_equal(ret, -EAGAIN, "Msg header not found");
+		} else {
+			zassert_equal(ret, 0, "Msg header read error (ret %d)", ret);
+		}
 	}
 
 	/* Then the first split if it is enabled */
@@ -342,14 +358,15 @@ int verify_sent_and_received_msg(struct msghdr *msg, bool split_msg)
 				    recv_buf, sizeof(recv_buf));
 		zassert_true(ret > 0, "Cannot read data (%d)", ret);
 
-		total_read = ret;
+		total_read += ret;
+		chunk_read = ret;
 	}
 
 	/* Then the data */
-	while (remaining > 0) {
+	while (chunk_read < msg->msg_iov[1].iov_len) {
 		ret = test_recv_buf((uint8_t *)msg->msg_iov[1].iov_base +
-								total_read,
-				    msg->msg_iov[1].iov_len - total_read,
+								chunk_read,
+				    msg->msg_iov[1].iov_len - chunk_read,
 				    &ctx, &msg_type, &remaining,
 				    recv_buf, sizeof(recv_buf));
 		zassert_true(ret > 0, "Cannot read data (%d)", ret);
@@ -363,16 +380,19 @@ int verify_sent_and_received_msg(struct msghdr *msg, bool split_msg)
 		}
 
 		total_read += ret;
+		chunk_read += ret;
 	}
 
-	zassert_equal(total_read, test_msg_len,
-		      "Msg body not valid, received %d instead of %zd",
-		      total_read, test_msg_len);
+	if (remaining == 0) {
+		zassert_equal(total_read, test_msg_len,
+			      "Msg body not valid, received %d instead of %zd",
+			      total_read, test_msg_len);
+	}
 
 	NET_DBG("Received %zd header and %zd body",
-		msg->msg_iov[0].iov_len, total_read);
+		msg->msg_iov[0].iov_len, chunk_read);
 
-	return msg->msg_iov[0].iov_len + total_read;
+	return msg->msg_iov[0].iov_len + chunk_read;
 }
 
 ZTEST(net_websocket, test_send_and_recv_lorem_ipsum)
@@ -398,6 +418,93 @@ ZTEST(net_websocket, test_send_and_recv_lorem_ipsum)
 	z_free_fd(fd);
 }
 
+ZTEST(net_websocket, test_send_and_recv_odd_len_masked)
+{
+	static struct websocket_context ctx;
+	int fd, ret;
+
+	memset(&ctx, 0, sizeof(ctx));
+
+	ctx.recv_buf.buf = temp_recv_buf;
+	ctx.recv_buf.size = sizeof(temp_recv_buf);
+
+	/* Length that is not a multiple of the masking key or word size */
+	test_msg_len = sizeof(lorem_ipsum) - 4;
+
+	fd = test_fd_alloc(&ctx);
+	ret = websocket_send_msg(fd, lorem_ipsum, test_msg_len,
+				 WEBSOCKET_OPCODE_DATA_BINARY, true, true,
+				 SYS_FOREVER_MS);
+	zassert_equal(ret, test_msg_len,
+		      "Should have sent %zd bytes but sent %d instead",
+		      test_msg_len, ret);
+
+	z_free_fd(fd);
+}
+
+ZTEST(net_websocket, test_send_masked_cut)
+{
+	static struct websocket_context ctx;
+	int fd, ret;
+
+	memset(&ctx, 0, sizeof(ctx));
+
+	ctx.recv_buf.buf = temp_recv_buf;
+	ctx.recv_buf.size = sizeof(temp_recv_buf);
+
+	test_msg_len = sizeof(lorem_ipsum) - 1;
+	zassert_true(test_msg_len > CONFIG_WEBSOCKET_TX_BUF_SIZE,
+		     "Message is sent in one chunk");
+
+	/* The header and the first chunk are sent, the second chunk fails */
+	sends_before_error = 2;
+
+	fd = test_fd_alloc(&ctx);
+	ret = websocket_send_msg(fd, lorem_ipsum, test_msg_len,
+				 WEBSOCKET_OPCODE_DATA_TEXT, true, true,
+				 SYS_FOREVER_MS);
+	zassert_equal(ret, -ECONNABORTED, "Cut frame not reported (%d)", ret);
+
+	/* Nothing can follow the partial frame */
+	ret = websocket_send_msg(fd, lorem_ipsum, test_msg_len,
+				 WEBSOCKET_OPCODE_DATA_TEXT, true, true,
+				 SYS_FOREVER_MS);
+	zassert_equal(ret, -ENOTCONN, "Send after cut frame (%d)", ret);
+
+	z_free_fd(fd);
+}
+
+ZTEST(net_websocket, test_send_masked_first_chunk_fails)
+{
+	static struct websocket_context ctx;
+	int fd, ret;
+
+	memset(&ctx, 0, sizeof(ctx));
+
+	ctx.recv_buf.buf = temp_recv_buf;
+	ctx.recv_buf.size = sizeof(temp_recv_buf);
+
+	test_msg_len = sizeof(lorem_ipsum) - 1;
+
+	/* Nothing of the frame is sent, so the send can be retried */
+	sends_before_error = 1;
+
+	fd = test_fd_alloc(&ctx);
+	ret = websocket_send_msg(fd, lorem_ipsum, test_msg_len,
+				 WEBSOCKET_OPCODE_DATA_TEXT, true, true,
+				 SYS_FOREVER_MS);
+	zassert_equal(ret, -EAGAIN, "Send error not returned (%d)", ret);
+
+	ret = websocket_send_msg(fd, lorem_ipsum, test_msg_len,
+				 WEBSOCKET_OPCODE_DATA_TEXT, true, true,
+				 SYS_FOREVER_MS);
+	zassert_equal(ret, test_msg_len,
+		      "Should have sent %zd bytes but sent %d instead",
+		      test_msg_len, ret);
+
+	z_free_fd(fd);
+}
+
 ZTEST(net_websocket, test_recv_two_large_split_msg)
 {
 	static struct websocket_context ctx;
@@ -123,3 +123,42 @@ ZTEST(posix_apis, test_realtime)
 	zassert_true(rts.tv_nsec >= tv.tv_usec * NSEC_PER_USEC,
 			"gettimeofday didn't provide correct result");
 }
+
+ZTEST(posix_apis, test_adjtime)
+{
+	struct timeval delta = {
+		.tv_sec = 0,
+		.tv_usec = 100 * USEC_PER_MSEC,
+	};
+	struct timespec nts = {
+		.tv_sec = 1514821501,
+	};
+	struct timespec rts;
+	struct timeval old;
+	int64_t elapsed;
+
+	zassert_ok(clock_settime(CLOCK_REALTIME, &nts));
+	zassert_ok(adjtime(&delta, &old));
+	zassert_true(old.tv_sec == 0 && old.tv_usec == 0, "Unexpected adjustment");
+
+	usleep(USEC_PER_MSEC * 100U);
+
+	zassert_ok(clock_gettime(CLOCK_REALTIME, &rts));
+	elapsed = ((int64_t)rts.tv_sec - nts.tv_sec) * USEC_PER_SEC +
+		  rts.tv_nsec / NSEC_PER_USEC;
+
+	/* The clock is slewed, not stepped by 100 ms */
+	zassert_true(elapsed >= 100 * USEC_PER_MSEC, "Clock slewed backward");
+	zassert_true(elapsed < 110 * USEC_PER_MSEC, "Clock stepped (%lld us)", (long long)elapsed);
+
+	/* Part of the adjustment has been applied */
+	zassert_ok(adjtime(NULL, &old));
+	zassert_equal(old.tv_sec, 0);
+	zassert_true(old.tv_usec > 0 && old.tv_usec < 100 * USEC_PER_MSEC,
+		     "Remaining adjustment %ld us", (long)old.tv_usec);
+
+	/* Setting the time cancels the adjustment */
+	zassert_ok(clock_settime(CLOCK_REALTIME, &nts));
+	zassert_ok(adjtime(NULL, &old));
+	zassert_true(old.tv_sec == 0 && old.tv_usec == 0, "Adjustment not cancelled");
+}